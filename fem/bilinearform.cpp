@@ -13,6 +13,7 @@
 
 #include "fem.hpp"
 #include "../general/device.hpp"
+#include <algorithm>
 #include <cmath>
 
 namespace mfem
@@ -22,13 +23,36 @@ void BilinearForm::AllocMat()
 {
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   ClearScatter();
+   if (precompute_sparsity == 0 && !threaded_assembly && !sparsity_reuse)
    {
       mat = new SparseMatrix(height);
       return;
    }
 
-   const Table &elem_dof = fes->GetElementToDofTable();
+   // The (unsigned) vdofs of the elements
+   Table elem_dof;
+   {
+      const int ne = fes->GetNE();
+      Array<int> vdofs;
+      elem_dof.MakeI(ne);
+      for (int i = 0; i < ne; i++)
+      {
+         fes->GetElementVDofs(i, vdofs);
+         elem_dof.AddColumnsInRow(i, vdofs.Size());
+      }
+      elem_dof.MakeJ();
+      for (int i = 0; i < ne; i++)
+      {
+         fes->GetElementVDofs(i, vdofs);
+         for (int j = 0; j < vdofs.Size(); j++)
+         {
+            if (vdofs[j] < 0) { vdofs[j] = -1 - vdofs[j]; }
+         }
+         elem_dof.AddConnections(i, vdofs.GetData(), vdofs.Size());
+      }
+      elem_dof.ShiftUpI();
+   }
    Table dof_dof;
 
    if (fbfi.Size() > 0)
@@ -74,6 +98,8 @@ BilinearForm::BilinearForm(FiniteElementSpace * f)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = 0;
+   threaded_assembly = false;
+   sparsity_reuse = false;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::FULL;
@@ -92,6 +118,8 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   threaded_assembly = false;
+   sparsity_reuse = false;
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::FULL;
@@ -126,15 +154,13 @@ void BilinearForm::SetAssemblyLevel(AssemblyLevel assembly_level)
          // Use the original BilinearForm implementation for now
          break;
       case AssemblyLevel::ELEMENT:
-         mfem_error("Element assembly not supported yet... stay tuned!");
-         // ext = new EABilinearFormExtension(this);
+         ext = new EABilinearFormExtension(this);
          break;
       case AssemblyLevel::PARTIAL:
          ext = new PABilinearFormExtension(this);
          break;
       case AssemblyLevel::NONE:
-         mfem_error("Matrix-free action not supported yet... stay tuned!");
-         // ext = new MFBilinearFormExtension(this);
+         ext = new MFBilinearFormExtension(this);
          break;
       default:
          mfem_error("Unknown assembly level");
@@ -193,6 +219,7 @@ void BilinearForm::UseSparsity(int *I, int *J, bool isSorted)
       }
       delete mat;
    }
+   ClearScatter();
    height = width = fes->GetVSize();
    mat = new SparseMatrix(I, J, NULL, height, width, false, true, isSorted);
 }
@@ -371,6 +398,220 @@ void BilinearForm::AssembleBdrElementMatrix(
    }
 }
 
+void BilinearForm::AssembleDiagonal(Vector &diag) const
+{
+   const SparseMatrix *cP = fes->GetConformingProlongation();
+   const bool tdiag = cP && diag.Size() == cP->Width() && cP->Width() != height;
+   MFEM_VERIFY(diag.Size() == height || tdiag,
+               "Vector for holding the diagonal has wrong size!");
+   if (!ext)
+   {
+      MFEM_VERIFY(mat, "the BilinearForm is not assembled!");
+      if (!tdiag || mat->Height() == diag.Size())
+      {
+         // The matrix is either local or was already ConformingAssemble'd.
+         mat->GetDiag(diag);
+         return;
+      }
+      Vector local_diag(height);
+      mat->GetDiag(local_diag);
+      cP->MultTranspose(local_diag, diag);
+      return;
+   }
+   if (!tdiag)
+   {
+      ext->AssembleDiagonal(diag);
+      return;
+   }
+   Vector local_diag(height);
+   ext->AssembleDiagonal(local_diag);
+   cP->MultTranspose(local_diag, diag);
+}
+
+// Compute the positions in the CSR data of (I, J) of the entries of a matrix
+// with rows and columns @a vdofs, in column-major order and with the signs of
+// the dofs, see BilinearForm::elem_scatter. The columns of each row must be
+// sorted and must include @a vdofs.
+static void GetScatterPositions(const Array<int> &vdofs,
+                                const int *I, const int *J, int *pos)
+{
+   const int n = vdofs.Size();
+   for (int r = 0; r < n; r++)
+   {
+      const int i = (vdofs[r] >= 0) ? vdofs[r] : -1 - vdofs[r];
+      const int *row = J + I[i], *row_end = J + I[i+1];
+      for (int c = 0; c < n; c++)
+      {
+         const int j = (vdofs[c] >= 0) ? vdofs[c] : -1 - vdofs[c];
+         const int *p = std::lower_bound(row, row_end, j);
+         MFEM_VERIFY(p != row_end && *p == j, "entry (" << i << "," << j
+                     << ") is not in the sparsity pattern");
+         const int k = p - J;
+         pos[r + c*n] = ((vdofs[r] >= 0) == (vdofs[c] >= 0)) ? k : -1 - k;
+      }
+   }
+}
+
+// Add the matrix @a elmat to the CSR data @a A at the positions @a pos given by
+// GetScatterPositions().
+static inline void AddScatteredMatrix(const int *pos, const DenseMatrix &elmat,
+                                      double *A)
+{
+   const int n = elmat.Height()*elmat.Width();
+   const double *data = elmat.Data();
+   for (int k = 0; k < n; k++)
+   {
+      const int p = pos[k];
+      if (p >= 0) { A[p] += data[k]; }
+      else { A[-1-p] -= data[k]; }
+   }
+}
+
+void BilinearForm::BuildScatter(int type, Table &scatter)
+{
+   Mesh *mesh = fes->GetMesh();
+   const int n = (type == 0) ? fes->GetNE() :
+                 (type == 2) ? mesh->GetNumFaces() : fes->GetNBE();
+
+   if (!mat->areColumnsSorted()) { mat->SortColumnIndices(); }
+   const int *I = mat->HostReadI(), *J = mat->HostReadJ();
+
+   Array<int> vdofs, vdofs2, pos;
+   scatter.MakeI(n);
+   for (int pass = 0; pass < 2; pass++)
+   {
+      if (pass == 1) { scatter.MakeJ(); }
+      for (int i = 0; i < n; i++)
+      {
+         int e1, e2;
+         switch (type)
+         {
+            case 0: fes->GetElementVDofs(i, vdofs); break;
+            case 1: fes->GetBdrElementVDofs(i, vdofs); break;
+            case 2:
+               vdofs.SetSize(0);
+               if (mesh->FaceIsInterior(i))
+               {
+                  mesh->GetFaceElements(i, &e1, &e2);
+                  fes->GetElementVDofs(e1, vdofs);
+                  fes->GetElementVDofs(e2, vdofs2);
+                  vdofs.Append(vdofs2);
+               }
+               break;
+            default:
+               mesh->GetFaceElements(mesh->GetBdrElementEdgeIndex(i), &e1, &e2);
+               fes->GetElementVDofs(e1, vdofs);
+         }
+         const int nd = vdofs.Size();
+         if (pass == 0)
+         {
+            scatter.AddColumnsInRow(i, nd*nd);
+         }
+         else
+         {
+            pos.SetSize(nd*nd);
+            GetScatterPositions(vdofs, I, J, pos.GetData());
+            scatter.AddConnections(i, pos.GetData(), nd*nd);
+         }
+      }
+   }
+   scatter.ShiftUpI();
+}
+
+void BilinearForm::ClearScatter()
+{
+   elem_scatter.Clear();
+   bdr_scatter.Clear();
+   face_scatter.Clear();
+   bdr_face_scatter.Clear();
+}
+
+void BilinearForm::ThreadedAssembleElements(bool bdr,
+                                            const Array<int> &bdr_attr_marker)
+{
+   Mesh *mesh = fes->GetMesh();
+   const Array<int> *offsets, *elements;
+   fes->GetElementColoring(offsets, elements, bdr);
+   const int num_colors = std::max(offsets->Size() - 1, 0);
+
+   if (!mat->areColumnsSorted()) { mat->SortColumnIndices(); }
+   const int *I = mat->HostReadI(), *J = mat->HostReadJ();
+   double *A = mat->HostReadWriteData();
+   // Use the stored positions of the entries if available, see BuildScatter()
+   const Table &scatter = bdr ? bdr_scatter : elem_scatter;
+   const int ne = bdr ? fes->GetNBE() : fes->GetNE();
+   const bool use_scatter = (scatter.Size() == ne);
+
+   // The elements of one color are processed in parallel; the implicit barrier
+   // at the end of each "omp for" separates the colors.
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation eltrans;
+      DenseMatrix elmat, elemmat;
+      Array<int> vdofs, pos;
+      for (int c = 0; c < num_colors; c++)
+      {
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+         #pragma omp for schedule(dynamic, 16)
+#endif
+         for (int j = (*offsets)[c]; j < (*offsets)[c+1]; j++)
+         {
+            const int i = (*elements)[j];
+            const DenseMatrix *elmat_p = &elmat;
+            if (bdr)
+            {
+               const int bdr_attr = mesh->GetBdrAttribute(i);
+               if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+
+               const FiniteElement &be = *fes->GetBE(i);
+               fes->GetBdrElementVDofs(i, vdofs);
+               mesh->GetBdrElementTransformation(i, &eltrans);
+               bbfi[0]->AssembleElementMatrix(be, eltrans, elmat);
+               for (int k = 1; k < bbfi.Size(); k++)
+               {
+                  if (bbfi_marker[k] &&
+                      (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+                  bbfi[k]->AssembleElementMatrix(be, eltrans, elemmat);
+                  elmat += elemmat;
+               }
+            }
+            else
+            {
+               fes->GetElementVDofs(i, vdofs);
+               if (element_matrices)
+               {
+                  elmat_p = &(*element_matrices)(i);
+               }
+               else
+               {
+                  const FiniteElement &fe = *fes->GetFE(i);
+                  mesh->GetElementTransformation(i, &eltrans);
+                  dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+                  for (int k = 1; k < dbfi.Size(); k++)
+                  {
+                     dbfi[k]->AssembleElementMatrix(fe, eltrans, elemmat);
+                     elmat += elemmat;
+                  }
+               }
+            }
+            if (use_scatter)
+            {
+               AddScatteredMatrix(scatter.GetRow(i), *elmat_p, A);
+            }
+            else
+            {
+               pos.SetSize(vdofs.Size()*vdofs.Size());
+               GetScatterPositions(vdofs, I, J, pos.GetData());
+               AddScatteredMatrix(pos.GetData(), *elmat_p, A);
+            }
+         }
+      }
+   }
+}
+
 void BilinearForm::Assemble(int skip_zeros)
 {
    if (ext)
@@ -397,7 +638,37 @@ void BilinearForm::Assemble(int skip_zeros)
    }
 #endif
 
-   if (dbfi.Size())
+   // The threaded assembly and the reuse of the positions of the entries need
+   // a matrix in CSR format, see AllocMat()
+   const bool csr = !static_cond && !hybridization && mat->Finalized();
+   const bool threaded = threaded_assembly && csr;
+   const bool reuse = sparsity_reuse && csr;
+   if (reuse)
+   {
+      if (dbfi.Size() && elem_scatter.Size() != fes->GetNE())
+      {
+         BuildScatter(0, elem_scatter);
+      }
+      if (bbfi.Size() && bdr_scatter.Size() != fes->GetNBE())
+      {
+         BuildScatter(1, bdr_scatter);
+      }
+      if (fbfi.Size() && face_scatter.Size() != mesh->GetNumFaces())
+      {
+         BuildScatter(2, face_scatter);
+      }
+      if (bfbfi.Size() && bdr_face_scatter.Size() != fes->GetNBE())
+      {
+         BuildScatter(3, bdr_face_scatter);
+      }
+   }
+   double *A = reuse ? mat->HostReadWriteData() : NULL;
+
+   if (dbfi.Size() && threaded)
+   {
+      ThreadedAssembleElements(false, Array<int>());
+   }
+   else if (dbfi.Size())
    {
       for (int i = 0; i < fes -> GetNE(); i++)
       {
@@ -424,7 +695,14 @@ void BilinearForm::Assemble(int skip_zeros)
          }
          else
          {
-            mat->AddSubMatrix(vdofs, vdofs, *elmat_p, skip_zeros);
+            if (reuse)
+            {
+               AddScatteredMatrix(elem_scatter.GetRow(i), *elmat_p, A);
+            }
+            else
+            {
+               mat->AddSubMatrix(vdofs, vdofs, *elmat_p, skip_zeros);
+            }
             if (hybridization)
             {
                hybridization->AssembleMatrix(i, *elmat_p);
@@ -456,34 +734,48 @@ void BilinearForm::Assemble(int skip_zeros)
          }
       }
 
-      for (int i = 0; i < fes -> GetNBE(); i++)
+      if (threaded)
       {
-         const int bdr_attr = mesh->GetBdrAttribute(i);
-         if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
-
-         const FiniteElement &be = *fes->GetBE(i);
-         fes -> GetBdrElementVDofs (i, vdofs);
-         eltrans = fes -> GetBdrElementTransformation (i);
-         bbfi[0]->AssembleElementMatrix(be, *eltrans, elmat);
-         for (int k = 1; k < bbfi.Size(); k++)
+         ThreadedAssembleElements(true, bdr_attr_marker);
+      }
+      else
+      {
+         for (int i = 0; i < fes -> GetNBE(); i++)
          {
-            if (bbfi_marker[k] &&
-                (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+            const int bdr_attr = mesh->GetBdrAttribute(i);
+            if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+
+            const FiniteElement &be = *fes->GetBE(i);
+            fes -> GetBdrElementVDofs (i, vdofs);
+            eltrans = fes -> GetBdrElementTransformation (i);
+            bbfi[0]->AssembleElementMatrix(be, *eltrans, elmat);
+            for (int k = 1; k < bbfi.Size(); k++)
+            {
+               if (bbfi_marker[k] &&
+                   (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
 
-            bbfi[k]->AssembleElementMatrix(be, *eltrans, elemmat);
-            elmat += elemmat;
-         }
-         if (!static_cond)
-         {
-            mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
-            if (hybridization)
+               bbfi[k]->AssembleElementMatrix(be, *eltrans, elemmat);
+               elmat += elemmat;
+            }
+            if (!static_cond)
             {
-               hybridization->AssembleBdrMatrix(i, elmat);
+               if (reuse)
+               {
+                  AddScatteredMatrix(bdr_scatter.GetRow(i), elmat, A);
+               }
+               else
+               {
+                  mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+               }
+               if (hybridization)
+               {
+                  hybridization->AssembleBdrMatrix(i, elmat);
+               }
+            }
+            else
+            {
+               static_cond->AssembleBdrMatrix(i, elmat);
             }
-         }
-         else
-         {
-            static_cond->AssembleBdrMatrix(i, elmat);
          }
       }
    }
@@ -507,7 +799,14 @@ void BilinearForm::Assemble(int skip_zeros)
                fbfi[k] -> AssembleFaceMatrix (*fes -> GetFE (tr -> Elem1No),
                                               *fes -> GetFE (tr -> Elem2No),
                                               *tr, elemmat);
-               mat -> AddSubMatrix (vdofs, vdofs, elemmat, skip_zeros);
+               if (reuse)
+               {
+                  AddScatteredMatrix(face_scatter.GetRow(i), elemmat, A);
+               }
+               else
+               {
+                  mat -> AddSubMatrix (vdofs, vdofs, elemmat, skip_zeros);
+               }
             }
          }
       }
@@ -559,7 +858,14 @@ void BilinearForm::Assemble(int skip_zeros)
                    (*bfbfi_marker[k])[bdr_attr-1] == 0) { continue; }
 
                bfbfi[k] -> AssembleFaceMatrix (*fe1, *fe2, *tr, elemmat);
-               mat -> AddSubMatrix (vdofs, vdofs, elemmat, skip_zeros);
+               if (reuse)
+               {
+                  AddScatteredMatrix(bdr_face_scatter.GetRow(i), elemmat, A);
+               }
+               else
+               {
+                  mat -> AddSubMatrix (vdofs, vdofs, elemmat, skip_zeros);
+               }
             }
          }
       }
@@ -585,21 +891,14 @@ void BilinearForm::ConformingAssemble()
    const SparseMatrix *P = fes->GetConformingProlongation();
    if (!P) { return; } // conforming mesh
 
-   SparseMatrix *R = Transpose(*P);
-   SparseMatrix *RA = mfem::Mult(*R, *mat);
+   SparseRAP rap(*P, *P);
+   SparseMatrix *RAP = rap.Mult(*mat);
    delete mat;
+   mat = RAP;
+   ClearScatter();
    if (mat_e)
    {
-      SparseMatrix *RAe = mfem::Mult(*R, *mat_e);
-      delete mat_e;
-      mat_e = RAe;
-   }
-   delete R;
-   mat = mfem::Mult(*RA, *P);
-   delete RA;
-   if (mat_e)
-   {
-      SparseMatrix *RAeP = mfem::Mult(*mat_e, *P);
+      SparseMatrix *RAeP = rap.Mult(*mat_e);
       delete mat_e;
       mat_e = RAeP;
    }
@@ -987,6 +1286,7 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    {
       delete mat;
       mat = NULL;
+      ClearScatter();
       delete hybridization;
       hybridization = NULL;
       sequence = fes->GetSequence();
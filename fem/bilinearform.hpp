@@ -104,9 +104,33 @@ protected:
    DiagonalPolicy diag_policy;
 
    int precompute_sparsity;
+   bool threaded_assembly;
+   bool sparsity_reuse;
+
+   /** @brief Positions in the data array of #mat of the entries of the element,
+       boundary element, interior face and boundary face matrices, see
+       EnableSparsityReuse(). */
+   /** Row i lists the positions of the entries of the i-th matrix in
+       column-major order; a negative entry, -1-k, refers to position k with a
+       flipped sign. The rows of the faces that are not interior faces, or not
+       boundary faces, are unused. */
+   Table elem_scatter, bdr_scatter, face_scatter, bdr_face_scatter;
+
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
+   /** @brief Set @a scatter to the positions in #mat of the entries of the
+       element (@a type = 0), boundary element (1), interior face (2), or
+       boundary face (3) matrices. */
+   void BuildScatter(int type, Table &scatter);
+
+   /// Invalidate the positions in #mat, e.g. when #mat is replaced.
+   void ClearScatter();
+
+   /// Add the element matrices of #dbfi, or of #bbfi when @a bdr is true, to
+   /// the finalized #mat, see EnableThreadedAssembly().
+   void ThreadedAssembleElements(bool bdr, const Array<int> &bdr_attr_marker);
+
    void ConformingAssemble();
 
    // may be used in the construction of derived classes
@@ -116,6 +140,8 @@ protected:
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
       precompute_sparsity = 0;
+      threaded_assembly = false;
+      sparsity_reuse = false;
       diag_policy = DIAG_KEEP;
       assembly = AssemblyLevel::FULL;
       batch = 1;
@@ -174,11 +200,41 @@ public:
                             BilinearFormIntegrator *constr_integ,
                             const Array<int> &ess_tdof_list);
 
-   /** For scalar FE spaces, precompute the sparsity pattern of the matrix
-       (assuming dense element matrices) based on the types of integrators
-       present in the bilinear form. */
+   /** Precompute the sparsity pattern of the matrix (assuming dense element
+       matrices) based on the types of integrators present in the bilinear
+       form. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** @brief Enable (or disable) the threaded assembly of the element matrices
+       of the domain and boundary integrators. */
+   /** The matrix is allocated in CSR format with the precomputed sparsity, see
+       UsePrecomputedSparsity(). The elements of each color given by
+       FiniteElementSpace::GetElementColoring() update disjoint rows, so their
+       matrices are computed and added in parallel, with per-thread element
+       transformations and scratch matrices. The threads are used when MFEM is
+       built with MFEM_USE_OPENMP and MFEM_THREAD_SAFE (the finite elements and
+       the integrators keep scratch data as members otherwise); the integrators
+       and their coefficients must then be safe to call concurrently. With
+       static condensation or hybridization the assembly is sequential. This
+       method should be called before assembly. */
+   void EnableThreadedAssembly(bool enable = true)
+   { threaded_assembly = enable; }
+
+   /** @brief Enable (or disable) the reuse of the sparsity pattern of the
+       matrix in repeated assemblies on the same mesh and space. */
+   /** The matrix is allocated in CSR format with the precomputed sparsity, see
+       UsePrecomputedSparsity(). On the first assembly, the positions of the
+       entries of each element and face matrix in the CSR data are computed and
+       stored; the following assemblies add the element and face matrices
+       directly at these positions, without any searching. As usual, Assemble()
+       adds to the current matrix: call Update(), which keeps the pattern and
+       the positions when the space did not change, or assign 0.0 to the form
+       before reassembling. This requires memory for one integer per entry of
+       each element matrix. With static condensation or hybridization, this
+       option has no effect. This method should be called before assembly. */
+   void EnableSparsityReuse(bool enable = true)
+   { sparsity_reuse = enable; }
+
    /** @brief Use the given CSR sparsity pattern to allocate the internal
        SparseMatrix.
 
@@ -229,6 +285,13 @@ public:
    /// Matrix vector multiplication.
    virtual void Mult(const Vector &x, Vector &y) const { mat->Mult(x, y); }
 
+   /// Matrix multiplication with a block of vectors.
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const
+   {
+      if (ext) { ext->MultiMult(X, Y); }
+      else { mat->MultiMult(X, Y); }
+   }
+
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
 
@@ -248,6 +311,17 @@ public:
    virtual void MultTranspose(const Vector & x, Vector & y) const
    { y = 0.0; AddMultTranspose (x, y); }
 
+   /** @brief Assemble the diagonal of the bilinear form into @a diag.
+
+       For AssemblyLevel::PARTIAL the diagonal is computed with the
+       sum-factorized kernels of the integrators, without forming the matrix.
+
+       If @a diag has the size of the true dofs of a space with a conforming
+       prolongation P, the L-vector diagonal is restricted with P^T, which is
+       exact for conforming meshes. Otherwise, @a diag has to be of size
+       Height(). */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
    double InnerProduct(const Vector &x, const Vector &y) const
    { return mat->InnerProduct (x, y); }
 
@@ -268,7 +342,8 @@ public:
       MFEM_VERIFY(mat, "mat is NULL and can't be dereferenced");
       return *mat;
    }
-   SparseMatrix *LoseMat() { SparseMatrix *tmp = mat; mat = NULL; return tmp; }
+   SparseMatrix *LoseMat()
+   { SparseMatrix *tmp = mat; mat = NULL; ClearScatter(); return tmp; }
 
    /// Returns a reference to the sparse matrix of eliminated b.c.
    const SparseMatrix &SpMatElim() const
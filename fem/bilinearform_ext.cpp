@@ -60,6 +60,40 @@ void PABilinearFormExtension::Assemble()
    }
 }
 
+void PABilinearFormExtension::AssembleDiagonal(Vector &diag) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+
+   const int iSz = integrators.Size();
+   if (elem_restrict_lex)
+   {
+      localY = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleDiagonalPA(localY);
+      }
+      const ElementRestriction *elem_restrict =
+         dynamic_cast<const ElementRestriction*>(elem_restrict_lex);
+      if (elem_restrict)
+      {
+         elem_restrict->MultTransposeUnsigned(localY, diag);
+      }
+      else
+      {
+         elem_restrict_lex->MultTranspose(localY, diag);
+      }
+   }
+   else
+   {
+      diag.UseDevice(true);
+      diag = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AssembleDiagonalPA(diag);
+      }
+   }
+}
+
 void PABilinearFormExtension::Update()
 {
    FiniteElementSpace *fes = a->FESpace();
@@ -97,12 +131,41 @@ void PABilinearFormExtension::FormLinearSystem(const Array<int> &ess_tdof_list,
    A.Reset(oper); // A will own oper
 }
 
+bool PABilinearFormExtension::UseFusedMult() const
+{
+   // The fused kernels target the host backends: on GPUs the shared memory
+   // E-vector kernels are faster than the gather/scatter over element colors.
+   if (Device::Allows(Backend::DEVICE_MASK)) { return false; }
+   if (trialFes->GetVDim() != 1) { return false; }
+   if (!dynamic_cast<const ElementRestriction*>(elem_restrict_lex))
+   {
+      return false;
+   }
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   for (int i = 0; i < integrators.Size(); ++i)
+   {
+      if (!integrators[i]->SupportsFusedPA()) { return false; }
+   }
+   return true;
+}
+
 void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
 
    const int iSz = integrators.Size();
-   if (elem_restrict_lex)
+   if (UseFusedMult())
+   {
+      const ElementRestriction &R =
+         static_cast<const ElementRestriction&>(*elem_restrict_lex);
+      y.UseDevice(true);
+      y = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AddMultFusedPA(R, x, y);
+      }
+   }
+   else if (elem_restrict_lex)
    {
       elem_restrict_lex->Mult(x, localX);
       localY = 0.0;
@@ -123,6 +186,50 @@ void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
    }
 }
 
+void PABilinearFormExtension::MultiMult(const MultiVector &X,
+                                        MultiVector &Y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   const int nv = X.NumVectors();
+   MFEM_VERIFY(X.VSize() == width && Y.VSize() == height &&
+               Y.NumVectors() == nv, "incompatible MultiVectors");
+   if (elem_restrict_lex)
+   {
+      const int esize = elem_restrict_lex->Height();
+      localXm.SetSize(esize, nv, Device::GetMemoryType());
+      localYm.SetSize(esize, nv, Device::GetMemoryType());
+      localYm.UseDevice(true);
+      Vector x, y, lx, ly;
+      for (int j = 0; j < nv; j++)
+      {
+         X.GetVector(j, x);
+         localXm.GetVector(j, lx);
+         elem_restrict_lex->Mult(x, lx);
+      }
+      localYm = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AddMultiMultPA(localXm, localYm);
+      }
+      for (int j = 0; j < nv; j++)
+      {
+         localYm.GetVector(j, ly);
+         Y.GetVector(j, y);
+         elem_restrict_lex->MultTranspose(ly, y);
+      }
+   }
+   else
+   {
+      Y.UseDevice(true);
+      Y = 0.0;
+      for (int i = 0; i < iSz; ++i)
+      {
+         integrators[i]->AddMultiMultPA(X, Y);
+      }
+   }
+}
+
 void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
@@ -148,4 +255,160 @@ void PABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
    }
 }
 
+
+// Data and methods for element-assembled bilinear forms
+EABilinearFormExtension::EABilinearFormExtension(BilinearForm *form)
+   : PABilinearFormExtension(form), ne(0), elemDofs(0) { }
+
+void EABilinearFormExtension::Assemble()
+{
+   const FiniteElementSpace &fes = *a->FESpace();
+   ne = fes.GetNE();
+   elemDofs = (ne > 0) ? fes.GetFE(0)->GetDof() * fes.GetVDim() : 0;
+   MFEM_VERIFY(elem_restrict_lex, "element assembly is not supported");
+
+   ea_data.SetSize(elemDofs, elemDofs, ne, Device::GetMemoryType());
+   const int size = ea_data.TotalSize();
+   auto d_ea = ea_data.Write();
+   MFEM_FORALL(i, size, d_ea[i] = 0.0;);
+
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int integratorCount = integrators.Size();
+   for (int i = 0; i < integratorCount; ++i)
+   {
+      integrators[i]->AssembleEA(fes, ea_data);
+   }
+}
+
+void EABilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   elem_restrict_lex->Mult(x, localX);
+   // Apply the element matrices, one thread per row
+   const int NDOFS = elemDofs;
+   auto X = Reshape(localX.Read(), NDOFS, ne);
+   auto Y = Reshape(localY.Write(), NDOFS, ne);
+   auto A = Reshape(ea_data.Read(), NDOFS, NDOFS, ne);
+   MFEM_FORALL(glob_j, ne*NDOFS,
+   {
+      const int e = glob_j/NDOFS;
+      const int j = glob_j%NDOFS;
+      double res = 0.0;
+      for (int i = 0; i < NDOFS; i++)
+      {
+         res += A(j, i, e)*X(i, e);
+      }
+      Y(j, e) = res;
+   });
+   elem_restrict_lex->MultTranspose(localY, y);
+}
+
+void EABilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   elem_restrict_lex->Mult(x, localX);
+   // Apply the transposed element matrices, one thread per column
+   const int NDOFS = elemDofs;
+   auto X = Reshape(localX.Read(), NDOFS, ne);
+   auto Y = Reshape(localY.Write(), NDOFS, ne);
+   auto A = Reshape(ea_data.Read(), NDOFS, NDOFS, ne);
+   MFEM_FORALL(glob_j, ne*NDOFS,
+   {
+      const int e = glob_j/NDOFS;
+      const int j = glob_j%NDOFS;
+      double res = 0.0;
+      for (int i = 0; i < NDOFS; i++)
+      {
+         res += A(i, j, e)*X(i, e);
+      }
+      Y(j, e) = res;
+   });
+   elem_restrict_lex->MultTranspose(localY, y);
+}
+
+void EABilinearFormExtension::AssembleDiagonal(Vector &diag) const
+{
+   const int NDOFS = elemDofs;
+   auto Y = Reshape(localY.Write(), NDOFS, ne);
+   auto A = Reshape(ea_data.Read(), NDOFS, NDOFS, ne);
+   MFEM_FORALL(glob_j, ne*NDOFS,
+   {
+      const int e = glob_j/NDOFS;
+      const int j = glob_j%NDOFS;
+      Y(j, e) = A(j, j, e);
+   });
+   const ElementRestriction *elem_restrict =
+      dynamic_cast<const ElementRestriction*>(elem_restrict_lex);
+   if (elem_restrict)
+   {
+      elem_restrict->MultTransposeUnsigned(localY, diag);
+   }
+   else
+   {
+      elem_restrict_lex->MultTranspose(localY, diag);
+   }
+}
+
+// Data and methods for matrix-free bilinear forms
+MFBilinearFormExtension::MFBilinearFormExtension(BilinearForm *form)
+   : PABilinearFormExtension(form)
+{
+   MFEM_VERIFY(elem_restrict_lex, "matrix-free action is not supported");
+}
+
+void MFBilinearFormExtension::Assemble()
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int integratorCount = integrators.Size();
+   for (int i = 0; i < integratorCount; ++i)
+   {
+      integrators[i]->AssembleMF(*a->FESpace());
+   }
+}
+
+void MFBilinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   elem_restrict_lex->Mult(x, localX);
+   localY = 0.0;
+   for (int i = 0; i < iSz; ++i)
+   {
+      integrators[i]->AddMultMF(localX, localY);
+   }
+   elem_restrict_lex->MultTranspose(localY, y);
+}
+
+void MFBilinearFormExtension::MultTranspose(const Vector &x, Vector &y) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   elem_restrict_lex->Mult(x, localX);
+   localY = 0.0;
+   for (int i = 0; i < iSz; ++i)
+   {
+      integrators[i]->AddMultTransposeMF(localX, localY);
+   }
+   elem_restrict_lex->MultTranspose(localY, y);
+}
+
+void MFBilinearFormExtension::AssembleDiagonal(Vector &diag) const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   const int iSz = integrators.Size();
+   localY = 0.0;
+   for (int i = 0; i < iSz; ++i)
+   {
+      integrators[i]->AssembleDiagonalMF(localY);
+   }
+   const ElementRestriction *elem_restrict =
+      dynamic_cast<const ElementRestriction*>(elem_restrict_lex);
+   if (elem_restrict)
+   {
+      elem_restrict->MultTransposeUnsigned(localY, diag);
+   }
+   else
+   {
+      elem_restrict_lex->MultTranspose(localY, diag);
+   }
+}
+
 } // namespace mfem
@@ -71,34 +71,19 @@ public:
    ~FABilinearFormExtension() {}
 };
 
-/// Data and methods for element-assembled bilinear forms
-class EABilinearFormExtension : public BilinearFormExtension
-{
-public:
-   EABilinearFormExtension(BilinearForm *form)
-      : BilinearFormExtension(form) { }
-
-   /// TODO
-   void Assemble() {}
-   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A) {}
-   void FormLinearSystem(const Array<int> &ess_tdof_list,
-                         Vector &x, Vector &b,
-                         OperatorHandle &A, Vector &X, Vector &B,
-                         int copy_interior = 0) {}
-   void Mult(const Vector &x, Vector &y) const {}
-   void MultTranspose(const Vector &x, Vector &y) const {}
-   void Update() {}
-   ~EABilinearFormExtension() {}
-};
-
 /// Data and methods for partially-assembled bilinear forms
 class PABilinearFormExtension : public BilinearFormExtension
 {
 protected:
    const FiniteElementSpace *trialFes, *testFes; // Not owned
    mutable Vector localX, localY;
+   mutable MultiVector localXm, localYm;
    const Operator *elem_restrict_lex; // Not owned
 
+   /** @brief Return true if Mult() can use the integrators' AddMultFusedPA()
+       on L-vectors, skipping the E-vectors @a localX and @a localY. */
+   bool UseFusedMult() const;
+
 public:
    PABilinearFormExtension(BilinearForm*);
 
@@ -111,27 +96,53 @@ public:
 
    void Mult(const Vector &x, Vector &y) const;
    void MultTranspose(const Vector &x, Vector &y) const;
+   /** @brief Action on a block of vectors: the integrators apply their
+       partially assembled data once to the E-vectors of the whole block. */
+   void MultiMult(const MultiVector &X, MultiVector &Y) const;
+   void AssembleDiagonal(Vector &diag) const;
    void Update();
 };
 
+/// Data and methods for element-assembled bilinear forms
+/** The element matrices of all integrators are summed and stored in a
+    contiguous DenseTensor; the action is a batched dense matrix-vector product
+    between the element restriction and its transpose. */
+class EABilinearFormExtension : public PABilinearFormExtension
+{
+protected:
+   int ne;
+   int elemDofs;
+   DenseTensor ea_data; ///< element matrices, elemDofs x elemDofs x ne
+
+public:
+   EABilinearFormExtension(BilinearForm *form);
+
+   void Assemble();
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+   void MultiMult(const MultiVector &X, MultiVector &Y) const
+   { Operator::MultiMult(X, Y); }
+   void AssembleDiagonal(Vector &diag) const;
+
+   /// Access the assembled element matrices.
+   const DenseTensor &GetElementMatrices() const { return ea_data; }
+};
+
 /// Data and methods for matrix-free bilinear forms
-class MFBilinearFormExtension : public BilinearFormExtension
+/** Unlike partial assembly, no quadrature point data is stored: the integrators
+    keep only the mesh nodes and coefficient values and recompute the geometric
+    factors inside the action kernels, trading flops for memory traffic. */
+class MFBilinearFormExtension : public PABilinearFormExtension
 {
 public:
-   MFBilinearFormExtension(BilinearForm *form)
-      : BilinearFormExtension(form) { }
+   MFBilinearFormExtension(BilinearForm *form);
 
-   /// TODO
-   void Assemble() {}
-   void FormSystemMatrix(const Array<int> &ess_tdof_list, OperatorHandle &A) {}
-   void FormLinearSystem(const Array<int> &ess_tdof_list,
-                         Vector &x, Vector &b,
-                         OperatorHandle &A, Vector &X, Vector &B,
-                         int copy_interior = 0) {}
-   void Mult(const Vector &x, Vector &y) const {}
-   void MultTranspose(const Vector &x, Vector &y) const {}
-   void Update() {}
-   ~MFBilinearFormExtension() {}
+   void Assemble();
+   void Mult(const Vector &x, Vector &y) const;
+   void MultTranspose(const Vector &x, Vector &y) const;
+   void MultiMult(const MultiVector &X, MultiVector &Y) const
+   { Operator::MultiMult(X, Y); }
+   void AssembleDiagonal(Vector &diag) const;
 };
 
 }
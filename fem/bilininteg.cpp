@@ -12,6 +12,8 @@
 // Implementation of Bilinear Form Integrators
 
 #include "fem.hpp"
+#include "bilininteg_pa.hpp"
+#include "../general/forall.hpp"
 #include <cmath>
 #include <algorithm>
 
@@ -20,6 +22,25 @@ using namespace std;
 namespace mfem
 {
 
+void PAToSinglePrecision(Vector &pa_data, Array<float> &pa_data_sp)
+{
+   const int n = pa_data.Size();
+   pa_data_sp.SetSize(n, Device::GetMemoryType());
+   const double *d = pa_data.Read();
+   float *sp = pa_data_sp.Write();
+   MFEM_FORALL(i, n, sp[i] = (float) d[i];);
+   pa_data.Destroy();
+}
+
+void PAToDoublePrecision(const Array<float> &pa_data_sp, Vector &pa_data)
+{
+   const int n = pa_data_sp.Size();
+   pa_data.SetSize(n, Device::GetMemoryType());
+   const float *sp = pa_data_sp.Read();
+   double *d = pa_data.Write();
+   MFEM_FORALL(i, n, d[i] = sp[i];);
+}
+
 void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace&)
 {
    mfem_error ("BilinearFormIntegrator::Assemble (...)\n"
@@ -38,6 +59,199 @@ void BilinearFormIntegrator::AddMultTransposePA(const Vector &, Vector &) const
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AddMultiMultPA(const MultiVector &X,
+                                            MultiVector &Y) const
+{
+   Vector x, y;
+   for (int j = 0; j < X.NumVectors(); j++)
+   {
+      X.GetVector(j, x);
+      Y.GetVector(j, y);
+      AddMultPA(x, y);
+   }
+}
+
+void BilinearFormIntegrator::AddMultFusedPA(const ElementRestriction &,
+                                            const Vector &, Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultFusedPA (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleDiagonalPA(Vector &)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleDiagonalPA (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleMF(const FiniteElementSpace&)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultMF(const Vector &, Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AddMultTransposeMF(const Vector &, Vector &) const
+{
+   mfem_error ("BilinearFormIntegrator::AddMultTransposeMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::AssembleDiagonalMF(Vector &)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleDiagonalMF (...)\n"
+               "   is not implemented for this class.");
+}
+
+// Gather the mesh nodes into a lexicographic E-vector, used by the matrix-free
+// kernels to compute the Jacobians of the element transformations at the
+// quadrature points of @a ir, evaluated with @a geom_maps. A mesh without nodes
+// is not modified: the vertices are gathered as the nodes of the bilinear or
+// trilinear elements.
+void MFNodesSetup(const Mesh &mesh, const IntegrationRule &ir, Vector &enodes,
+                  const DofToQuad *&geom_maps)
+{
+   const int dim = mesh.Dimension();
+   MFEM_VERIFY(mesh.SpaceDimension() == dim,
+               "meshes with space dimension != dimension are not supported");
+   const GridFunction *nodes = mesh.GetNodes();
+   if (nodes)
+   {
+      const FiniteElementSpace *nfes = nodes->FESpace();
+      const Operator *R =
+         nfes->GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+      enodes.SetSize(R->Height(), Device::GetMemoryType());
+      R->Mult(*nodes, enodes);
+      geom_maps = &nfes->GetFE(0)->GetDofToQuad(ir, DofToQuad::TENSOR);
+      return;
+   }
+
+   static const H1_QuadrilateralElement linear_quad(1);
+   static const H1_HexahedronElement linear_hex(1);
+   // Vertices of the square and the cube in lexicographic order
+   static const int lex_vertex[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+   const Geometry::Type geom = (dim == 2) ? Geometry::SQUARE : Geometry::CUBE;
+   const int ne = mesh.GetNE();
+   const int nv = Geometry::NumVerts[geom];
+   enodes.SetSize(nv * dim * ne, Device::GetMemoryType());
+   auto X = Reshape(enodes.HostWrite(), nv, dim, ne);
+   Array<int> v;
+   for (int e = 0; e < ne; e++)
+   {
+      MFEM_VERIFY(mesh.GetElementBaseGeometry(e) == geom,
+                  "only quadrilateral and hexahedral meshes are supported");
+      mesh.GetElementVertices(e, v);
+      for (int i = 0; i < nv; i++)
+      {
+         const double *x = mesh.GetVertex(v[lex_vertex[i]]);
+         for (int c = 0; c < dim; c++) { X(i,c,e) = x[c]; }
+      }
+   }
+   const FiniteElement *linear_fe = &linear_hex;
+   if (dim == 2) { linear_fe = &linear_quad; }
+   geom_maps = &linear_fe->GetDofToQuad(ir, DofToQuad::TENSOR);
+}
+
+// Compute the Jacobians of the element transformations at the quadrature
+// points from the E-vector of the nodes given by MFNodesSetup, in the layout
+// of GeometricFactors::J.
+void MFJacobians(const int dim, const int NE, const DofToQuad &geom_maps,
+                 const Vector &enodes, Vector &jac)
+{
+   const int GD1D = geom_maps.ndof;
+   const int Q1D = geom_maps.nqpt;
+   const int NQ = (dim == 2) ? Q1D*Q1D : Q1D*Q1D*Q1D;
+   const int ND = (dim == 2) ? GD1D*GD1D : GD1D*GD1D*GD1D;
+   jac.SetSize(NQ * dim * dim * NE, Device::GetMemoryType());
+   auto B = Reshape(geom_maps.B.Read(), Q1D, GD1D);
+   auto G = Reshape(geom_maps.G.Read(), Q1D, GD1D);
+   auto X = Reshape(enodes.Read(), ND, dim, NE);
+   auto J = Reshape(jac.Write(), NQ, dim, dim, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         const int qx = q % Q1D, qy = (q / Q1D) % Q1D, qz = q / (Q1D*Q1D);
+         double Jq[3][3] = { { 0.0 } };
+         for (int n = 0; n < ND; n++)
+         {
+            const int dx = n % GD1D, dy = (n / GD1D) % GD1D;
+            const int dz = n / (GD1D*GD1D);
+            double w[3];
+            w[0] = G(qx,dx) * B(qy,dy);
+            w[1] = B(qx,dx) * G(qy,dy);
+            if (dim == 3)
+            {
+               w[2] = B(qx,dx) * B(qy,dy) * G(qz,dz);
+               w[0] *= B(qz,dz);
+               w[1] *= B(qz,dz);
+            }
+            for (int c = 0; c < dim; c++)
+            {
+               for (int d = 0; d < dim; d++) { Jq[c][d] += X(n,c,e) * w[d]; }
+            }
+         }
+         for (int c = 0; c < dim; c++)
+         {
+            for (int d = 0; d < dim; d++) { J(q,c,d,e) = Jq[c][d]; }
+         }
+      }
+   });
+}
+
+void BilinearFormIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                        DenseTensor &emat)
+{
+   const int ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const int vdim = fes.GetVDim();
+   const int nd = fes.GetFE(0)->GetDof();
+   const int ndofs = nd * vdim;
+   MFEM_VERIFY(emat.SizeI() == ndofs && emat.SizeJ() == ndofs &&
+               emat.SizeK() == ne, "invalid element matrices size");
+   // The E-vectors of L2 spaces use the native ordering of the element dofs,
+   // otherwise they use the lexicographic ordering of the tensor elements.
+   const TensorBasisElement *tfe =
+      dynamic_cast<const TensorBasisElement*>(fes.GetFE(0));
+   const bool native = dynamic_cast<const L2_FECollection*>(fes.FEColl());
+   MFEM_VERIFY(native || (tfe && tfe->GetDofMap().Size() == nd),
+               "element assembly requires tensor-product elements");
+
+   // E-vector dof i corresponds to the element dof ldof[i] with sign lsgn[i]
+   Array<int> ldof(ndofs);
+   Array<double> lsgn(ndofs);
+   for (int c = 0; c < vdim; c++)
+   {
+      for (int d = 0; d < nd; d++)
+      {
+         const int sd = native ? d : tfe->GetDofMap()[d];
+         ldof[d + nd*c] = ((sd >= 0) ? sd : -1 - sd) + nd*c;
+         lsgn[d + nd*c] = (sd >= 0) ? 1.0 : -1.0;
+      }
+   }
+
+   DenseMatrix elmat;
+   double *E = emat.HostReadWrite();
+   for (int e = 0; e < ne; e++)
+   {
+      AssembleElementMatrix(*fes.GetFE(e), *fes.GetElementTransformation(e),
+                            elmat);
+      double *Ee = E + ndofs*ndofs*e;
+      for (int j = 0; j < ndofs; j++)
+      {
+         for (int i = 0; i < ndofs; i++)
+         {
+            Ee[i + ndofs*j] += lsgn[i] * lsgn[j] * elmat(ldof[i], ldof[j]);
+         }
+      }
+   }
+}
+
 void BilinearFormIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans,
    DenseMatrix &elmat )
@@ -15,10 +15,71 @@
 #include "../config/config.hpp"
 #include "nonlininteg.hpp"
 #include "fespace.hpp"
+#include <unordered_map>
 
 namespace mfem
 {
 
+// Maximum number of dofs and quadrature points in 1D supported by the partial
+// assembly kernels of the H(curl) and H(div) integrators.
+constexpr int HCURL_MAX_D1D = 8;
+constexpr int HCURL_MAX_Q1D = 10;
+constexpr int HDIV_MAX_D1D = 8;
+constexpr int HDIV_MAX_Q1D = 10;
+
+// Largest number of dofs in 1D (order + 1) for which the partial assembly
+// kernels of the mass and diffusion integrators are specialized at compile
+// time, see PAKernelTable.
+constexpr int PA_SPECIALIZED_MAX_D1D = 9;
+
+/// Return true if the partial assembly kernels should use the SIMD host code.
+/** The SIMD kernels are used when the "simd" backend is configured without any
+    device backend. They are threaded when an OpenMP backend is also enabled. */
+inline bool PAUseSimdKernels()
+{
+   return Device::Allows(Backend::SIMD) &&
+          !Device::Allows(Backend::DEVICE_MASK);
+}
+
+/** @brief Table of compile-time specialized partial assembly kernels, selected
+    at runtime by the dimension and the number of dofs and quadrature points in
+    1D. */
+/** The @a Kernel type is a function pointer; Find() returns NULL for the
+    (dim, D1D, Q1D) triplets without a specialization, in which case the caller
+    falls back to the generic kernel. */
+template <typename Kernel>
+class PAKernelTable
+{
+private:
+   std::unordered_map<int, Kernel> kernels;
+
+   static int Key(int dim, int d1d, int q1d)
+   { return (dim << 16) | (d1d << 8) | q1d; }
+
+public:
+   /// Register the kernel @a k for the given dimension, D1D and Q1D.
+   void Add(int dim, int d1d, int q1d, Kernel k)
+   { kernels[Key(dim, d1d, q1d)] = k; }
+
+   /// Return the specialized kernel, or NULL if there is none.
+   Kernel Find(int dim, int d1d, int q1d) const
+   {
+      auto it = kernels.find(Key(dim, d1d, q1d));
+      return (it == kernels.end()) ? NULL : it->second;
+   }
+
+   /// Return the number of registered kernels.
+   int Size() const { return (int) kernels.size(); }
+};
+
+/** @brief Convert the partially assembled data @a pa_data to single precision
+    in @a pa_data_sp, and free @a pa_data. */
+void PAToSinglePrecision(Vector &pa_data, Array<float> &pa_data_sp);
+
+/** @brief Copy the single precision partially assembled data @a pa_data_sp to
+    @a pa_data. */
+void PAToDoublePrecision(const Array<float> &pa_data_sp, Vector &pa_data);
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
@@ -27,9 +88,6 @@ protected:
       : NonlinearFormIntegrator(ir) { }
 
 public:
-   // TODO: add support for other assembly levels (in addition to PA) and their
-   // actions.
-
    // TODO: for mixed meshes the quadrature rules to be used by methods like
    // AssemblePA() can be given as a QuadratureSpace, e.g. using a new method:
    // SetQuadratureSpace().
@@ -62,6 +120,84 @@ public:
        called. */
    virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
 
+   /// Method for partially assembled action on a block of E-vectors.
+   /** Same as AddMultPA(), applied to each vector of the block @a X and added
+       to the corresponding vector of @a Y. The default implementation calls
+       AddMultPA() for each vector; integrators can override it to read their
+       partially assembled data once for the whole block.
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AddMultiMultPA(const MultiVector &X, MultiVector &Y) const;
+
+   /// Method for partially assembled action on L-vectors.
+   /** Same as AddMultPA(), but @a x and @a y are L-vectors of the space with
+       the element restriction @a R. The element dofs are gathered, the action
+       is applied and the result is scattered in the same pass over the
+       elements of each color of R, without E-vectors.
+
+       This method can be called only after the method AssemblePA() has been
+       called, and only if SupportsFusedPA() returns true. */
+   virtual void AddMultFusedPA(const ElementRestriction &R,
+                               const Vector &x, Vector &y) const;
+
+   /// Return true if AddMultFusedPA() is implemented by this integrator.
+   virtual bool SupportsFusedPA() const { return false; }
+
+   /** @brief Return true if the action of the partially assembled integrator
+       uses a kernel specialized at compile time for its number of dofs and
+       quadrature points in 1D. */
+   /** Valid after AssemblePA(). When false, the action is computed by a generic
+       kernel with runtime loop bounds. */
+   virtual bool HasSpecializedPAKernel() const { return false; }
+
+   /// Assemble the diagonal of the partially assembled operator.
+   /** The diagonal is added to the E-vector @a diag, i.e. the element-wise
+       discontinuous version of the FE space, using the data computed by
+       AssemblePA(). The global diagonal is obtained by applying the transpose
+       of the element restriction to @a diag.
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AssembleDiagonalPA(Vector &diag);
+
+   /// Method defining matrix-free assembly.
+   /** Only the data needed to compute the quadrature point data on the fly is
+       stored, e.g. the mesh nodes and the coefficient values, so that the
+       method AddMultMF() can be used. */
+   virtual void AssembleMF(const FiniteElementSpace &fes);
+
+   /// Method for matrix-free action.
+   /** Perform the action of integrator on the input @a x and add the result to
+       the output @a y. Both @a x and @a y are E-vectors, as in AddMultPA().
+
+       This method can be called only after the method AssembleMF() has been
+       called. */
+   virtual void AddMultMF(const Vector &x, Vector &y) const;
+
+   /// Method for matrix-free transposed action.
+   /** Perform the transpose action of integrator on the input @a x and add the
+       result to the output @a y, see AddMultMF(). */
+   virtual void AddMultTransposeMF(const Vector &x, Vector &y) const;
+
+   /// Assemble the diagonal of the matrix-free operator.
+   /** The diagonal is added to the E-vector @a diag, see AssembleDiagonalPA().
+
+       This method can be called only after the method AssembleMF() has been
+       called. */
+   virtual void AssembleDiagonalMF(Vector &diag);
+
+   /// Method defining element assembly.
+   /** The element matrices of all elements are added to @a emat, of size
+       ndofs x ndofs x ne, where ndofs is the number of dofs of the E-vectors
+       of one element. The element dofs are ordered as in the E-vectors of the
+       lexicographic FiniteElementSpace::GetElementRestriction(), including the
+       signs of the dofs of H(curl) and H(div) spaces.
+
+       The default implementation uses AssembleElementMatrix() element by
+       element on the host. */
+   virtual void AssembleEA(const FiniteElementSpace &fes, DenseTensor &emat);
+
    /// Given a particular Finite Element computes the element matrix elmat.
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -1678,18 +1814,36 @@ private:
    const GeometricFactors *geom;  ///< Not owned
    int dim, ne, dofs1D, quad1D;
    Vector pa_data;
+   bool pa_single;           ///< See SetSinglePrecisionPA()
+   Array<float> pa_data_sp;  ///< pa_data in single precision
+
+   // MF extension
+   const IntegrationRule *mf_ir;   ///< Not owned
+   const DofToQuad *mf_geom_maps;  ///< Not owned
+   Vector mf_nodes, mf_coeff;
 
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
-   DiffusionIntegrator() { Q = NULL; MQ = NULL; maps = NULL; geom = NULL; }
+   DiffusionIntegrator()
+   { Q = NULL; MQ = NULL; maps = NULL; geom = NULL; pa_single = false; }
 
    /// Construct a diffusion integrator with a scalar coefficient q
    DiffusionIntegrator(Coefficient &q)
-      : Q(&q) { MQ = NULL; maps = NULL; geom = NULL; }
+      : Q(&q) { MQ = NULL; maps = NULL; geom = NULL; pa_single = false; }
 
    /// Construct a diffusion integrator with a matrix coefficient q
    DiffusionIntegrator(MatrixCoefficient &q)
-      : MQ(&q) { Q = NULL; maps = NULL; geom = NULL; }
+      : MQ(&q) { Q = NULL; maps = NULL; geom = NULL; pa_single = false; }
+
+   /** @brief Store the partially assembled data in single precision, halving
+       its memory footprint and the memory traffic of AddMultPA(). */
+   /** The data is computed in double precision and converted in AssemblePA(),
+       so this method must be called before the assembly. The action is
+       computed in double precision, but its relative accuracy is about 1e-7,
+       which is suited to preconditioners, smoothers and the inner solver of
+       IterativeRefinementSolver. The fused L-vector action, AddMultFusedPA(),
+       is not supported with single precision data. */
+   void SetSinglePrecisionPA(bool sp = true) { pa_single = sp; }
 
    /** Given a particular Finite Element
        computes the element stiffness matrix elmat. */
@@ -1721,6 +1875,25 @@ public:
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultiMultPA(const MultiVector &X, MultiVector &Y) const;
+
+   virtual void AddMultFusedPA(const ElementRestriction &R,
+                               const Vector &x, Vector &y) const;
+
+   virtual bool SupportsFusedPA() const { return !pa_single; }
+
+   virtual bool HasSpecializedPAKernel() const;
+
+   virtual void AssembleDiagonalPA(Vector &diag);
+
+   virtual void AssembleMF(const FiniteElementSpace &fes);
+
+   virtual void AddMultMF(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalMF(Vector &diag);
+
+   virtual void AssembleEA(const FiniteElementSpace &fes, DenseTensor &emat);
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe);
 };
@@ -1735,17 +1908,30 @@ protected:
    Coefficient *Q;
    // PA extension
    Vector pa_data;
+   bool pa_single;           ///< See SetSinglePrecisionPA()
+   Array<float> pa_data_sp;  ///< pa_data in single precision
    const DofToQuad *maps;         ///< Not owned
    const GeometricFactors *geom;  ///< Not owned
    int dim, ne, nq, dofs1D, quad1D;
 
+   // MF extension
+   const IntegrationRule *mf_ir;   ///< Not owned
+   const DofToQuad *mf_geom_maps;  ///< Not owned
+   Vector mf_nodes, mf_coeff;
+
 public:
    MassIntegrator(const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir) { Q = NULL; maps = NULL; geom = NULL; }
+      : BilinearFormIntegrator(ir)
+   { Q = NULL; maps = NULL; geom = NULL; pa_single = false; }
 
    /// Construct a mass integrator with coefficient q
    MassIntegrator(Coefficient &q, const IntegrationRule *ir = NULL)
-      : BilinearFormIntegrator(ir), Q(&q) { maps = NULL; geom = NULL; }
+      : BilinearFormIntegrator(ir), Q(&q)
+   { maps = NULL; geom = NULL; pa_single = false; }
+
+   /** @brief Store the partially assembled data in single precision, see
+       DiffusionIntegrator::SetSinglePrecisionPA(). */
+   void SetSinglePrecisionPA(bool sp = true) { pa_single = sp; }
 
    /** Given a particular Finite Element
        computes the element mass matrix elmat. */
@@ -1761,6 +1947,25 @@ public:
 
    virtual void AddMultPA(const Vector&, Vector&) const;
 
+   virtual void AddMultiMultPA(const MultiVector &X, MultiVector &Y) const;
+
+   virtual void AddMultFusedPA(const ElementRestriction &R,
+                               const Vector &x, Vector &y) const;
+
+   virtual bool SupportsFusedPA() const { return !pa_single; }
+
+   virtual bool HasSpecializedPAKernel() const;
+
+   virtual void AssembleDiagonalPA(Vector &diag);
+
+   virtual void AssembleMF(const FiniteElementSpace &fes);
+
+   virtual void AddMultMF(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalMF(Vector &diag);
+
+   virtual void AssembleEA(const FiniteElementSpace &fes, DenseTensor &emat);
+
    static const IntegrationRule &GetRule(const FiniteElement &trial_fe,
                                          const FiniteElement &test_fe,
                                          ElementTransformation &Trans);
@@ -1989,11 +2194,21 @@ protected:
    Coefficient *Q;
    MatrixCoefficient *MQ;
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;        ///< Not owned, open basis
+   const DofToQuad *mapsC;        ///< Not owned, closed basis
+   const GeometricFactors *geom;  ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
+
 public:
-   CurlCurlIntegrator() { Q = NULL; MQ = NULL; }
+   CurlCurlIntegrator()
+   { Q = NULL; MQ = NULL; mapsO = mapsC = NULL; geom = NULL; }
    /// Construct a bilinear form integrator for Nedelec elements
-   CurlCurlIntegrator(Coefficient &q) : Q(&q) { MQ = NULL; }
-   CurlCurlIntegrator(MatrixCoefficient &m) : MQ(&m) { Q = NULL; }
+   CurlCurlIntegrator(Coefficient &q) : Q(&q)
+   { MQ = NULL; mapsO = mapsC = NULL; geom = NULL; }
+   CurlCurlIntegrator(MatrixCoefficient &m) : MQ(&m)
+   { Q = NULL; mapsO = mapsC = NULL; geom = NULL; }
 
    /* Given a particular Finite Element, compute the
       element curl-curl matrix elmat */
@@ -2009,6 +2224,14 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   /** @brief Partial assembly for Nedelec elements on quadrilaterals and
+       hexahedra, with a scalar coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag);
 };
 
 /** Integrator for (curl u, curl v) for FE spaces defined by 'dim' copies of a
@@ -2043,7 +2266,7 @@ class VectorFEMassIntegrator: public BilinearFormIntegrator
 {
 private:
    void Init(Coefficient *q, VectorCoefficient *vq, MatrixCoefficient *mq)
-   { Q = q; VQ = vq; MQ = mq; }
+   { Q = q; VQ = vq; MQ = mq; mapsO = mapsC = NULL; geom = NULL; }
 
 #ifndef MFEM_THREAD_SAFE
    Vector shape;
@@ -2058,6 +2281,13 @@ protected:
    VectorCoefficient *VQ;
    MatrixCoefficient *MQ;
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;        ///< Not owned, open basis
+   const DofToQuad *mapsC;        ///< Not owned, closed basis
+   const GeometricFactors *geom;  ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D, map_type;
+
 public:
    VectorFEMassIntegrator() { Init(NULL, NULL, NULL); }
    VectorFEMassIntegrator(Coefficient *_q) { Init(_q, NULL, NULL); }
@@ -2074,6 +2304,14 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   /** @brief Partial assembly for Nedelec and Raviart-Thomas elements on
+       quadrilaterals and hexahedra, with a scalar coefficient. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag);
 };
 
 /** Integrator for (Q div u, p) where u=(v1,...,vn) and all vi are in the same
@@ -2112,13 +2350,29 @@ private:
    Vector divshape;
 #endif
 
+   // PA extension
+   Vector pa_data;
+   const DofToQuad *mapsO;        ///< Not owned, open basis
+   const DofToQuad *mapsC;        ///< Not owned, closed basis
+   const GeometricFactors *geom;  ///< Not owned
+   int dim, ne, nq, dofs1D, quad1D;
+
 public:
-   DivDivIntegrator() { Q = NULL; }
-   DivDivIntegrator(Coefficient &q) : Q(&q) { }
+   DivDivIntegrator() { Q = NULL; mapsO = mapsC = NULL; geom = NULL; }
+   DivDivIntegrator(Coefficient &q) : Q(&q)
+   { mapsO = mapsC = NULL; geom = NULL; }
 
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
                                       DenseMatrix &elmat);
+
+   /** @brief Partial assembly for Raviart-Thomas elements on quadrilaterals
+       and hexahedra. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag);
 };
 
 /** Integrator for
@@ -2138,9 +2392,16 @@ private:
    DenseMatrix gshape;
    DenseMatrix pelmat;
 
+   // PA extension
+   const DofToQuad *maps;         ///< Not owned
+   const GeometricFactors *geom;  ///< Not owned
+   int dim, ne, dofs1D, quad1D;
+   Vector pa_data;
+
 public:
-   VectorDiffusionIntegrator() { Q = NULL; }
-   VectorDiffusionIntegrator(Coefficient &q) { Q = &q; }
+   VectorDiffusionIntegrator() { Q = NULL; maps = NULL; geom = NULL; }
+   VectorDiffusionIntegrator(Coefficient &q)
+   { Q = &q; maps = NULL; geom = NULL; }
 
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -2148,6 +2409,14 @@ public:
    virtual void AssembleElementVector(const FiniteElement &el,
                                       ElementTransformation &Tr,
                                       const Vector &elfun, Vector &elvect);
+
+   /** @brief Partial assembly on quadrilaterals and hexahedra; the vector
+       dimension of the space must be equal to the mesh dimension. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   virtual void AssembleDiagonalPA(Vector &diag);
 };
 
 /** Integrator for the linear elasticity form:
@@ -10,7 +10,9 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "../general/forall.hpp"
+#include "../linalg/simd.hpp"
 #include "bilininteg.hpp"
+#include "bilininteg_pa.hpp"
 #include "gridfunc.hpp"
 
 using namespace std;
@@ -165,14 +167,16 @@ static void PADiffusionSetup3D(const int Q1D,
    });
 }
 
-static void PADiffusionSetup(const int dim,
-                             const int D1D,
-                             const int Q1D,
-                             const int NE,
-                             const Array<double> &W,
-                             const Vector &J,
-                             const Vector &C,
-                             Vector &D)
+// PA Diffusion Assemble kernel, also used by the PA kernels of the H(curl)
+// mass and vector diffusion integrators, which use the same quadrature data.
+void PADiffusionSetup(const int dim,
+                      const int D1D,
+                      const int Q1D,
+                      const int NE,
+                      const Array<double> &W,
+                      const Vector &J,
+                      const Vector &C,
+                      Vector &D)
 {
    if (dim == 1) { MFEM_ABORT("dim==1 not supported in PADiffusionSetup"); }
    if (dim == 2)
@@ -241,6 +245,7 @@ void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
    }
    PADiffusionSetup(dim, dofs1D, quad1D, ne, ir->GetWeights(), geom->J, coeff,
                     pa_data);
+   if (pa_single) { PAToSinglePrecision(pa_data, pa_data_sp); }
 }
 
 #ifdef MFEM_USE_OCCA
@@ -344,17 +349,18 @@ static void OccaPADiffusionApply3D(const int D1D,
 #endif // MFEM_USE_OCCA
 
 // PA Diffusion Apply 2D kernel
-template<int T_D1D = 0, int T_Q1D = 0> static
+template<int T_D1D = 0, int T_Q1D = 0, typename OP = Vector> static
 void PADiffusionApply2D(const int NE,
                         const Array<double> &b,
                         const Array<double> &g,
                         const Array<double> &bt,
                         const Array<double> &gt,
-                        const Vector &_op,
+                        const OP &_op,
                         const Vector &_x,
                         Vector &_y,
                         const int d1d = 0,
-                        const int q1d = 0)
+                        const int q1d = 0,
+                        const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -365,10 +371,11 @@ void PADiffusionApply2D(const int NE,
    auto Bt = Reshape(bt.Read(), D1D, Q1D);
    auto Gt = Reshape(gt.Read(), D1D, Q1D);
    auto op = Reshape(_op.Read(), Q1D*Q1D, 3, NE);
-   auto x = Reshape(_x.Read(), D1D, D1D, NE);
-   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   auto x = Reshape(_x.Read(), D1D, D1D, NE*nv);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE*nv);
+   MFEM_FORALL(ev, NE*nv,
    {
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       // the following variables are evaluated at compile time
@@ -394,7 +401,7 @@ void PADiffusionApply2D(const int NE,
          }
          for (int dx = 0; dx < D1D; ++dx)
          {
-            const double s = x(dx,dy,e);
+            const double s = x(dx,dy,ex);
             for (int qx = 0; qx < Q1D; ++qx)
             {
                gradX[qx][0] += s * B(qx,dx);
@@ -456,7 +463,7 @@ void PADiffusionApply2D(const int NE,
             const double wDy = Gt(dy,qy);
             for (int dx = 0; dx < D1D; ++dx)
             {
-               y(dx,dy,e) += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
+               y(dx,dy,ex) += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
             }
          }
       }
@@ -466,17 +473,19 @@ void PADiffusionApply2D(const int NE,
 // Shared memory PA Diffusion Apply 2D kernel
 template<const int T_D1D = 0,
          const int T_Q1D = 0,
-         const int T_NBZ = 0>
+         const int T_NBZ = 0,
+         typename OP = Vector>
 static void SmemPADiffusionApply2D(const int NE,
                                    const Array<double> &_b,
                                    const Array<double> &_g,
                                    const Array<double> &_bt,
                                    const Array<double> &_gt,
-                                   const Vector &_op,
+                                   const OP &_op,
                                    const Vector &_x,
                                    Vector &_y,
                                    const int d1d = 0,
-                                   const int q1d = 0)
+                                   const int q1d = 0,
+                                   const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -488,11 +497,12 @@ static void SmemPADiffusionApply2D(const int NE,
    auto b = Reshape(_b.Read(), Q1D, D1D);
    auto g = Reshape(_g.Read(), Q1D, D1D);
    auto op = Reshape(_op.Read(), Q1D*Q1D, 3, NE);
-   auto x = Reshape(_x.Read(), D1D, D1D, NE);
-   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL_2D(e, NE, Q1D, Q1D, NBZ,
+   auto x = Reshape(_x.Read(), D1D, D1D, NE*nv);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE*nv);
+   MFEM_FORALL_2D(ev, NE*nv, Q1D, Q1D, NBZ,
    {
       const int tidz = MFEM_THREAD_ID(z);
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int NBZ = T_NBZ ? T_NBZ : 1;
@@ -504,18 +514,20 @@ static void SmemPADiffusionApply2D(const int NE,
       double (*Bt)[MQ1] = (double (*)[MQ1]) (sBG+0);
       double (*Gt)[MQ1] = (double (*)[MQ1]) (sBG+1);
       MFEM_SHARED double Xz[NBZ][MD1][MD1];
-      MFEM_SHARED double GD[2][NBZ][MD1][MQ1];
-      MFEM_SHARED double GQ[2][NBZ][MD1][MQ1];
+      // The rows of DQ0 and DQ1 are indexed by dy, then by qy, and their
+      // columns by qx, then by dx: use MQ1 x MQ1 arrays for both
+      MFEM_SHARED double GD[2][NBZ][MQ1][MQ1];
+      MFEM_SHARED double GQ[2][NBZ][MQ1][MQ1];
       double (*X)[MD1] = (double (*)[MD1])(Xz + tidz);
-      double (*DQ0)[MD1] = (double (*)[MD1])(GD[0] + tidz);
-      double (*DQ1)[MD1] = (double (*)[MD1])(GD[1] + tidz);
-      double (*QQ0)[MD1] = (double (*)[MD1])(GQ[0] + tidz);
-      double (*QQ1)[MD1] = (double (*)[MD1])(GQ[1] + tidz);
+      double (*DQ0)[MQ1] = (double (*)[MQ1])(GD[0] + tidz);
+      double (*DQ1)[MQ1] = (double (*)[MQ1])(GD[1] + tidz);
+      double (*QQ0)[MQ1] = (double (*)[MQ1])(GQ[0] + tidz);
+      double (*QQ1)[MQ1] = (double (*)[MQ1])(GQ[1] + tidz);
       MFEM_FOREACH_THREAD(dy,y,D1D)
       {
          MFEM_FOREACH_THREAD(dx,x,D1D)
          {
-            X[dy][dx] = x(dx,dy,e);
+            X[dy][dx] = x(dx,dy,ex);
          }
       }
       if (tidz == 0)
@@ -617,25 +629,39 @@ static void SmemPADiffusionApply2D(const int NE,
                u += DQ0[qy][dx] * Bt[dy][qy];
                v += DQ1[qy][dx] * Gt[dy][qy];
             }
-            y(dx,dy,e) += (u + v);
+            y(dx,dy,ex) += (u + v);
          }
       }
    });
 }
 
 
+// Estimates of the floating point operations and of the bytes moved per
+// element by the 3D PA diffusion action, see MFEM_KERNEL_INFO.
+static double PADiffusionApply3DFlops(const int D1D, const int Q1D)
+{
+   const double D = D1D, Q = Q1D;
+   return 2.0*(4*D*D*D*Q + 6*D*D*Q*Q + 6*D*Q*Q*Q) + 15*Q*Q*Q;
+}
+
+static double PADiffusionApply3DBytes(const int D1D, const int Q1D)
+{
+   return sizeof(double)*(3.0*D1D*D1D*D1D + 6.0*Q1D*Q1D*Q1D);
+}
+
 // PA Diffusion Apply 3D kernel
 template<const int T_D1D = 0,
-         const int T_Q1D = 0> static
+         const int T_Q1D = 0,
+         typename OP = Vector> static
 void PADiffusionApply3D(const int NE,
                         const Array<double> &b,
                         const Array<double> &g,
                         const Array<double> &bt,
                         const Array<double> &gt,
-                        const Vector &_op,
+                        const OP &_op,
                         const Vector &_x,
                         Vector &_y,
-                        int d1d = 0, int q1d = 0)
+                        int d1d = 0, int q1d = 0, int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -646,10 +672,13 @@ void PADiffusionApply3D(const int NE,
    auto Bt = Reshape(bt.Read(), D1D, Q1D);
    auto Gt = Reshape(gt.Read(), D1D, Q1D);
    auto op = Reshape(_op.Read(), Q1D*Q1D*Q1D, 6, NE);
-   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
-   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE*nv);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE*nv);
+   MFEM_KERNEL_INFO("PADiffusionApply3D", PADiffusionApply3DFlops(D1D, Q1D),
+                    PADiffusionApply3DBytes(D1D, Q1D));
+   MFEM_FORALL(ev, NE*nv,
    {
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
@@ -689,7 +718,7 @@ void PADiffusionApply3D(const int NE,
             }
             for (int dx = 0; dx < D1D; ++dx)
             {
-               const double s = x(dx,dy,dz,e);
+               const double s = x(dx,dy,dz,ex);
                for (int qx = 0; qx < Q1D; ++qx)
                {
                   gradX[qx][0] += s * B(qx,dx);
@@ -803,7 +832,7 @@ void PADiffusionApply3D(const int NE,
             {
                for (int dx = 0; dx < D1D; ++dx)
                {
-                  y(dx,dy,dz,e) +=
+                  y(dx,dy,dz,ex) +=
                      ((gradXY[dy][dx][0] * wz) +
                       (gradXY[dy][dx][1] * wz) +
                       (gradXY[dy][dx][2] * wDz));
@@ -816,17 +845,19 @@ void PADiffusionApply3D(const int NE,
 
 // Shared memory PA Diffusion Apply 3D kernel
 template<const int T_D1D = 0,
-         const int T_Q1D = 0>
+         const int T_Q1D = 0,
+         typename OP = Vector>
 static void SmemPADiffusionApply3D(const int NE,
                                    const Array<double> &_b,
                                    const Array<double> &_g,
                                    const Array<double> &_bt,
                                    const Array<double> &_gt,
-                                   const Vector &_op,
+                                   const OP &_op,
                                    const Vector &_x,
                                    Vector &_y,
                                    const int d1d = 0,
-                                   const int q1d = 0)
+                                   const int q1d = 0,
+                                   const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -837,11 +868,15 @@ static void SmemPADiffusionApply3D(const int NE,
    auto b = Reshape(_b.Read(), Q1D, D1D);
    auto g = Reshape(_g.Read(), Q1D, D1D);
    auto op = Reshape(_op.Read(), Q1D*Q1D*Q1D, 6, NE);
-   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
-   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE*nv);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE*nv);
+   MFEM_KERNEL_INFO("SmemPADiffusionApply3D",
+                    PADiffusionApply3DFlops(D1D, Q1D),
+                    PADiffusionApply3DBytes(D1D, Q1D));
+   MFEM_FORALL_3D(ev, NE*nv, Q1D, Q1D, Q1D,
    {
       const int tidz = MFEM_THREAD_ID(z);
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int MQ1 = T_Q1D ? T_Q1D : MAX_Q1D;
@@ -875,7 +910,7 @@ static void SmemPADiffusionApply3D(const int NE,
          {
             MFEM_FOREACH_THREAD(dx,x,D1D)
             {
-               X[dz][dy][dx] = x(dx,dy,dz,e);
+               X[dz][dy][dx] = x(dx,dy,dz,ex);
             }
          }
       }
@@ -1049,13 +1084,408 @@ static void SmemPADiffusionApply3D(const int NE,
                   v += QDD1[qz][dy][dx] * Bt[dz][qz];
                   w += QDD2[qz][dy][dx] * Gt[dz][qz];
                }
-               y(dx,dy,dz,e) += (u + v + w);
+               y(dx,dy,dz,ex) += (u + v + w);
             }
          }
       }
    });
 }
 
+// SIMD PA Diffusion Apply 3D kernel for the host. The NC elements listed in
+// elements (all elements if NULL) are processed in batches of SIMD_DOUBLES, one
+// element per lane of the simd_double values, and the batches are distributed
+// statically over the OpenMP threads when an OpenMP backend is enabled. The
+// element dofs are read from the E-vector x when gather is NULL, or else from
+// the L-vector x with the signed indices of gather, and the result is added to
+// y in the same layout: with gather, the listed elements must not share dofs.
+template<const int T_D1D, const int T_Q1D> static
+void SimdPADiffusionApply3D(const int NE,
+                            const int NC,
+                            const int *elements,
+                            const int *gather,
+                            const Array<double> &b,
+                            const Array<double> &g,
+                            const Vector &_op,
+                            const Vector &_x,
+                            Vector &_y)
+{
+   constexpr int D1D = T_D1D;
+   constexpr int Q1D = T_Q1D;
+   constexpr int ND = D1D*D1D*D1D;
+   constexpr int VL = SIMD_DOUBLES;
+   auto B = Reshape(b.HostRead(), Q1D, D1D);
+   auto G = Reshape(g.HostRead(), Q1D, D1D);
+   auto op = Reshape(_op.HostRead(), Q1D*Q1D*Q1D, 6, NE);
+   const double *x = _x.HostRead();
+   double *y = _y.HostReadWrite();
+   const int NB = (NC + VL - 1) / VL;
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int k = 0; k < NB; k++)
+   {
+      // Elements of the batch
+      const int NV = (NC - k*VL < VL) ? NC - k*VL : VL;
+      int e[VL];
+      for (int v = 0; v < NV; ++v)
+      {
+         e[v] = elements ? elements[k*VL + v] : k*VL + v;
+      }
+      // Dofs of the batch, zero in the unused lanes
+      simd_double u[D1D][D1D][D1D];
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               simd_double s = simd_double();
+               for (int v = 0; v < NV; ++v)
+               {
+                  const int i = dx + D1D*(dy + D1D*dz) + ND*e[v];
+                  const int j = gather ? gather[i] : i;
+                  s[v] = (j >= 0) ? x[j] : -x[-1-j];
+               }
+               u[dz][dy][dx] = s;
+            }
+         }
+      }
+      simd_double grad[Q1D][Q1D][Q1D][3];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = simd_double();
+               grad[qz][qy][qx][1] = simd_double();
+               grad[qz][qy][qx][2] = simd_double();
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         simd_double gradXY[Q1D][Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = simd_double();
+               gradXY[qy][qx][1] = simd_double();
+               gradXY[qy][qx][2] = simd_double();
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            simd_double gradX[Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = simd_double();
+               gradX[qx][1] = simd_double();
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const simd_double s = u[dz][dy][dx];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * B(qx,dx);
+                  gradX[qx][1] += s * G(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const simd_double wx  = gradX[qx][0];
+                  const simd_double wDx = gradX[qx][1];
+                  gradXY[qy][qx][0] += wDx * wy;
+                  gradXY[qy][qx][1] += wx  * wDy;
+                  gradXY[qy][qx][2] += wx  * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0] * wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1] * wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2] * wDz;
+               }
+            }
+         }
+      }
+      // Calculate Dxyz, xDyz, xyDz in plane
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const int q = qx + (qy + qz * Q1D) * Q1D;
+               simd_double O[6];
+               for (int c = 0; c < 6; ++c)
+               {
+                  O[c] = simd_double();
+                  for (int v = 0; v < NV; ++v) { O[c][v] = op(q,c,e[v]); }
+               }
+               const simd_double gradX = grad[qz][qy][qx][0];
+               const simd_double gradY = grad[qz][qy][qx][1];
+               const simd_double gradZ = grad[qz][qy][qx][2];
+               grad[qz][qy][qx][0] = (O[0]*gradX)+(O[1]*gradY)+(O[2]*gradZ);
+               grad[qz][qy][qx][1] = (O[1]*gradX)+(O[3]*gradY)+(O[4]*gradZ);
+               grad[qz][qy][qx][2] = (O[2]*gradX)+(O[4]*gradY)+(O[5]*gradZ);
+            }
+         }
+      }
+      // The result of the batch is accumulated in u
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               u[dz][dy][dx] = simd_double();
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         simd_double gradXY[D1D][D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = simd_double();
+               gradXY[dy][dx][1] = simd_double();
+               gradXY[dy][dx][2] = simd_double();
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            simd_double gradX[D1D][3];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = simd_double();
+               gradX[dx][1] = simd_double();
+               gradX[dx][2] = simd_double();
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const simd_double gX = grad[qz][qy][qx][0];
+               const simd_double gY = grad[qz][qy][qx][1];
+               const simd_double gZ = grad[qz][qy][qx][2];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const double wx  = B(qx,dx);
+                  const double wDx = G(qx,dx);
+                  gradX[dx][0] += gX * wDx;
+                  gradX[dx][1] += gY * wx;
+                  gradX[dx][2] += gZ * wx;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += gradX[dx][0] * wy;
+                  gradXY[dy][dx][1] += gradX[dx][1] * wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  u[dz][dy][dx] +=
+                     ((gradXY[dy][dx][0] * wz) +
+                      (gradXY[dy][dx][1] * wz) +
+                      (gradXY[dy][dx][2] * wDz));
+               }
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               for (int v = 0; v < NV; ++v)
+               {
+                  const int i = dx + D1D*(dy + D1D*dz) + ND*e[v];
+                  const int j = gather ? gather[i] : i;
+                  if (j >= 0) { y[j] += u[dz][dy][dx][v]; }
+                  else { y[-1-j] -= u[dz][dy][dx][v]; }
+               }
+            }
+         }
+      }
+   }
+}
+
+// Signature of the SIMD PA Diffusion Apply kernels
+typedef void (*PADiffusionApplySimdKernel)(const int NE,
+                                           const int NC,
+                                           const int *elements,
+                                           const int *gather,
+                                           const Array<double> &B,
+                                           const Array<double> &G,
+                                           const Vector &op,
+                                           const Vector &x,
+                                           Vector &y);
+
+// Register the 3D SIMD kernels for D1D = 2,...,T_D1D with Q1D = D1D and
+// Q1D = D1D + 1.
+template<int T_D1D>
+struct PADiffusionApplySimdRegistrar
+{
+   static void Add(PAKernelTable<PADiffusionApplySimdKernel> &table)
+   {
+      constexpr int D = T_D1D;
+      table.Add(3, D, D, SimdPADiffusionApply3D<D,D>);
+      table.Add(3, D, D+1, SimdPADiffusionApply3D<D,D+1>);
+      PADiffusionApplySimdRegistrar<T_D1D-1>::Add(table);
+   }
+};
+
+template<>
+struct PADiffusionApplySimdRegistrar<1>
+{
+   static void Add(PAKernelTable<PADiffusionApplySimdKernel> &) { }
+};
+
+// Table of the SIMD PA Diffusion Apply kernels
+static const PAKernelTable<PADiffusionApplySimdKernel>
+&PADiffusionApplySimdKernels()
+{
+   struct Table : PAKernelTable<PADiffusionApplySimdKernel>
+   {
+      Table()
+      {
+         PADiffusionApplySimdRegistrar<PA_SPECIALIZED_MAX_D1D>::Add(*this);
+      }
+   };
+   static const Table table;
+   return table;
+}
+
+// Signature of the PA Diffusion Apply kernels
+typedef void (*PADiffusionApplyKernel)(const int NE,
+                                       const Array<double> &B,
+                                       const Array<double> &G,
+                                       const Array<double> &Bt,
+                                       const Array<double> &Gt,
+                                       const Vector &op,
+                                       const Vector &x,
+                                       Vector &y,
+                                       const int d1d,
+                                       const int q1d,
+                                       const int nv);
+
+// Signature of the PA Diffusion Apply kernels with single precision data
+typedef void (*PADiffusionApplySPKernel)(const int NE,
+                                         const Array<double> &B,
+                                         const Array<double> &G,
+                                         const Array<double> &Bt,
+                                         const Array<double> &Gt,
+                                         const Array<float> &op,
+                                         const Vector &x,
+                                         Vector &y,
+                                         const int d1d,
+                                         const int q1d,
+                                         const int nv);
+
+// Number of elements per thread block of the 2D shared memory kernels
+static constexpr int PADiffusionNBZ(const int D1D)
+{
+   return D1D <= 3 ? 16 : D1D <= 5 ? 8 : D1D <= 7 ? 4 : 2;
+}
+
+// Select the 3D kernel for the given sizes: the shared memory kernel, except
+// for (9,10), whose shared memory exceeds the limit of the CUDA devices.
+template<int D, int Q>
+struct PADiffusionApply3DSelector
+{
+   template<typename Kernel> static Kernel Get()
+   { return SmemPADiffusionApply3D<D,Q>; }
+};
+
+template<>
+struct PADiffusionApply3DSelector<9,10>
+{
+   template<typename Kernel> static Kernel Get()
+   { return PADiffusionApply3D<9,10>; }
+};
+
+// Register the specialized kernels for D1D = 2,...,T_D1D with Q1D = D1D (e.g.
+// Gauss-Lobatto rules) and Q1D = D1D + 1 (the default Gauss rules), for double
+// (PADiffusionApplyKernel) or single (PADiffusionApplySPKernel) precision
+// data.
+template<int T_D1D, typename Kernel = PADiffusionApplyKernel>
+struct PADiffusionApplyRegistrar
+{
+   static void Add(PAKernelTable<Kernel> &table)
+   {
+      constexpr int D = T_D1D, NBZ = PADiffusionNBZ(T_D1D);
+      table.Add(2, D, D, SmemPADiffusionApply2D<D,D,NBZ>);
+      table.Add(2, D, D+1, SmemPADiffusionApply2D<D,D+1,NBZ>);
+      table.Add(3, D, D,
+                PADiffusionApply3DSelector<D,D>::template Get<Kernel>());
+      table.Add(3, D, D+1,
+                PADiffusionApply3DSelector<D,D+1>::template Get<Kernel>());
+      PADiffusionApplyRegistrar<T_D1D-1,Kernel>::Add(table);
+   }
+};
+
+template<typename Kernel>
+struct PADiffusionApplyRegistrar<1,Kernel>
+{
+   static void Add(PAKernelTable<Kernel> &) { }
+};
+
+// Table of the specialized PA Diffusion Apply kernels, built on first use
+static const PAKernelTable<PADiffusionApplyKernel> &PADiffusionApplyKernels()
+{
+   struct Table : PAKernelTable<PADiffusionApplyKernel>
+   {
+      Table() { PADiffusionApplyRegistrar<PA_SPECIALIZED_MAX_D1D>::Add(*this); }
+   };
+   static const Table table;
+   return table;
+}
+
+// Table of the specialized PA Diffusion Apply kernels with single precision
+// data
+static const PAKernelTable<PADiffusionApplySPKernel> &
+PADiffusionApplySPKernels()
+{
+   struct Table : PAKernelTable<PADiffusionApplySPKernel>
+   {
+      Table()
+      {
+         PADiffusionApplyRegistrar<PA_SPECIALIZED_MAX_D1D,
+                                   PADiffusionApplySPKernel>::Add(*this);
+      }
+   };
+   static const Table table;
+   return table;
+}
+
 static void PADiffusionApply(const int dim,
                              const int D1D,
                              const int Q1D,
@@ -1066,7 +1496,8 @@ static void PADiffusionApply(const int dim,
                              const Array<double> &Gt,
                              const Vector &op,
                              const Vector &x,
-                             Vector &y)
+                             Vector &y,
+                             const int nv = 1)
 {
 #ifdef MFEM_USE_OCCA
    if (DeviceCanUseOcca())
@@ -1084,44 +1515,1549 @@ static void PADiffusionApply(const int dim,
       MFEM_ABORT("OCCA PADiffusionApply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
-   if (dim == 2)
+   if (nv == 1 && PAUseSimdKernels())
    {
-      switch ((D1D << 4 ) | Q1D)
-      {
-         case 0x22: return SmemPADiffusionApply2D<2,2,16>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x33: return SmemPADiffusionApply2D<3,3,16>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x44: return SmemPADiffusionApply2D<4,4,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x55: return SmemPADiffusionApply2D<5,5,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x66: return SmemPADiffusionApply2D<6,6,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x77: return SmemPADiffusionApply2D<7,7,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x88: return SmemPADiffusionApply2D<8,8,2>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x99: return SmemPADiffusionApply2D<9,9,2>(NE,B,G,Bt,Gt,op,x,y);
-         default:   return PADiffusionApply2D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
-      }
-   }
-   else if (dim == 3)
-   {
-      switch ((D1D << 4 ) | Q1D)
-      {
-         case 0x23: return SmemPADiffusionApply3D<2,3>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x34: return SmemPADiffusionApply3D<3,4>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x45: return SmemPADiffusionApply3D<4,5>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x56: return SmemPADiffusionApply3D<5,6>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x67: return SmemPADiffusionApply3D<6,7>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x78: return SmemPADiffusionApply3D<7,8>(NE,B,G,Bt,Gt,op,x,y);
-         case 0x89: return SmemPADiffusionApply3D<8,9>(NE,B,G,Bt,Gt,op,x,y);
-         default:   return PADiffusionApply3D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D);
-      }
+      const PADiffusionApplySimdKernel simd =
+         PADiffusionApplySimdKernels().Find(dim, D1D, Q1D);
+      if (simd) { return simd(NE,NE,NULL,NULL,B,G,op,x,y); }
    }
+   const PADiffusionApplyKernel kernel =
+      PADiffusionApplyKernels().Find(dim, D1D, Q1D);
+   if (kernel) { return kernel(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D,nv); }
+   if (dim == 2)
+   { return PADiffusionApply2D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D,nv); }
+   if (dim == 3)
+   { return PADiffusionApply3D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D,nv); }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Diffusion Apply with single precision data, see SetSinglePrecisionPA()
+static void PADiffusionApplySP(const int dim,
+                               const int D1D,
+                               const int Q1D,
+                               const int NE,
+                               const Array<double> &B,
+                               const Array<double> &G,
+                               const Array<double> &Bt,
+                               const Array<double> &Gt,
+                               const Array<float> &op,
+                               const Vector &x,
+                               Vector &y,
+                               const int nv = 1)
+{
+   const PADiffusionApplySPKernel kernel =
+      PADiffusionApplySPKernels().Find(dim, D1D, Q1D);
+   if (kernel) { return kernel(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D,nv); }
+   if (dim == 2)
+   { return PADiffusionApply2D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D,nv); }
+   if (dim == 3)
+   { return PADiffusionApply3D(NE,B,G,Bt,Gt,op,x,y,D1D,Q1D,nv); }
    MFEM_ABORT("Unknown kernel.");
 }
 
 // PA Diffusion Apply kernel
 void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
 {
+   if (pa_single)
+   {
+      PADiffusionApplySP(dim, dofs1D, quad1D, ne,
+                         maps->B, maps->G, maps->Bt, maps->Gt,
+                         pa_data_sp, x, y);
+      return;
+   }
    PADiffusionApply(dim, dofs1D, quad1D, ne,
                     maps->B, maps->G, maps->Bt, maps->Gt,
                     pa_data, x, y);
 }
 
+// PA Diffusion Apply kernel on a block of E-vectors: the quadrature data of
+// each element is used for all the vectors of the block in turn.
+void DiffusionIntegrator::AddMultiMultPA(const MultiVector &X,
+                                         MultiVector &Y) const
+{
+#ifdef MFEM_USE_OCCA
+   if (DeviceCanUseOcca())
+   {
+      BilinearFormIntegrator::AddMultiMultPA(X, Y);
+      return;
+   }
+#endif // MFEM_USE_OCCA
+   if (pa_single)
+   {
+      PADiffusionApplySP(dim, dofs1D, quad1D, ne,
+                         maps->B, maps->G, maps->Bt, maps->Gt,
+                         pa_data_sp, X, Y, X.NumVectors());
+      return;
+   }
+   PADiffusionApply(dim, dofs1D, quad1D, ne,
+                    maps->B, maps->G, maps->Bt, maps->Gt,
+                    pa_data, X, Y, X.NumVectors());
+}
+
+// PA Diffusion Apply 2D kernel on L-vectors: gathers the element dofs with
+// the map of the element restriction, applies the quadrature data and
+// scatters the result, for the NC elements of one color (all elements if
+// elements is NULL).
+template<const int T_D1D = 0,
+         const int T_Q1D = 0> static
+void PADiffusionApplyFused2D(const int NE,
+                             const int NC,
+                             const int *elements,
+                             const Array<int> &gather,
+                             const Array<double> &b,
+                             const Array<double> &g,
+                             const Array<double> &bt,
+                             const Array<double> &gt,
+                             const Vector &_op,
+                             const Vector &_x,
+                             Vector &_y,
+                             const int d1d = 0,
+                             const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D*Q1D, 3, NE);
+   auto map = Reshape(gather.Read(), D1D, D1D, NE);
+   auto x = _x.Read();
+   auto y = _y.ReadWrite();
+   MFEM_FORALL(k, NC,
+   {
+      const int e = elements ? elements[k] : k;
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      double sol[max_D1D][max_D1D];
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            sol[dy][dx] = 0.0;
+         }
+      }
+      double grad[max_Q1D][max_Q1D][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qy][qx][0] = 0.0;
+            grad[qy][qx][1] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double gradX[max_Q1D][2];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            gradX[qx][0] = 0.0;
+            gradX[qx][1] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const int j = map(dx,dy,e);
+            const double s = (j >= 0) ? x[j] : -x[-1-j];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] += s * B(qx,dx);
+               gradX[qx][1] += s * G(qx,dx);
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy  = B(qy,dy);
+            const double wDy = G(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qy][qx][0] += gradX[qx][1] * wy;
+               grad[qy][qx][1] += gradX[qx][0] * wDy;
+            }
+         }
+      }
+      // Calculate Dxy, xDy in plane
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const int q = qx + qy * Q1D;
+
+            const double O11 = op(q,0,e);
+            const double O12 = op(q,1,e);
+            const double O22 = op(q,2,e);
+
+            const double gradX = grad[qy][qx][0];
+            const double gradY = grad[qy][qx][1];
+
+            grad[qy][qx][0] = (O11 * gradX) + (O12 * gradY);
+            grad[qy][qx][1] = (O12 * gradX) + (O22 * gradY);
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double gradX[max_D1D][2];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            gradX[dx][0] = 0;
+            gradX[dx][1] = 0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double gX = grad[qy][qx][0];
+            const double gY = grad[qy][qx][1];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double wx  = Bt(dx,qx);
+               const double wDx = Gt(dx,qx);
+               gradX[dx][0] += gX * wDx;
+               gradX[dx][1] += gY * wx;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy  = Bt(dy,qy);
+            const double wDy = Gt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol[dy][dx] += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
+            }
+         }
+      }
+      // Scatter to the L-vector, no other element of this color shares dofs
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const int j = map(dx,dy,e);
+            if (j >= 0) { y[j] += sol[dy][dx]; }
+            else { y[-1-j] -= sol[dy][dx]; }
+         }
+      }
+   });
+}
+
+// PA Diffusion Apply 3D kernel on L-vectors
+template<const int T_D1D = 0,
+         const int T_Q1D = 0> static
+void PADiffusionApplyFused3D(const int NE,
+                             const int NC,
+                             const int *elements,
+                             const Array<int> &gather,
+                             const Array<double> &b,
+                             const Array<double> &g,
+                             const Array<double> &bt,
+                             const Array<double> &gt,
+                             const Vector &_op,
+                             const Vector &_x,
+                             Vector &_y,
+                             const int d1d = 0,
+                             const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto op = Reshape(_op.Read(), Q1D*Q1D*Q1D, 6, NE);
+   auto map = Reshape(gather.Read(), D1D, D1D, D1D, NE);
+   auto x = _x.Read();
+   auto y = _y.ReadWrite();
+   MFEM_FORALL(k, NC,
+   {
+      const int e = elements ? elements[k] : k;
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double sol[max_D1D][max_D1D][max_D1D];
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol[dz][dy][dx] = 0.0;
+            }
+         }
+      }
+      double grad[max_Q1D][max_Q1D][max_Q1D][3];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = 0.0;
+               grad[qz][qy][qx][1] = 0.0;
+               grad[qz][qy][qx][2] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double gradXY[max_Q1D][max_Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = 0.0;
+               gradXY[qy][qx][1] = 0.0;
+               gradXY[qy][qx][2] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const int j = map(dx,dy,dz,e);
+               const double s = (j >= 0) ? x[j] : -x[-1-j];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * B(qx,dx);
+                  gradX[qx][1] += s * G(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx  = gradX[qx][0];
+                  const double wDx = gradX[qx][1];
+                  gradXY[qy][qx][0] += wDx * wy;
+                  gradXY[qy][qx][1] += wx  * wDy;
+                  gradXY[qy][qx][2] += wx  * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0] * wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1] * wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2] * wDz;
+               }
+            }
+         }
+      }
+      // Calculate Dxyz, xDyz, xyDz in plane
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const int q = qx + (qy + qz * Q1D) * Q1D;
+               const double O11 = op(q,0,e);
+               const double O12 = op(q,1,e);
+               const double O13 = op(q,2,e);
+               const double O22 = op(q,3,e);
+               const double O23 = op(q,4,e);
+               const double O33 = op(q,5,e);
+               const double gradX = grad[qz][qy][qx][0];
+               const double gradY = grad[qz][qy][qx][1];
+               const double gradZ = grad[qz][qy][qx][2];
+               grad[qz][qy][qx][0] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
+               grad[qz][qy][qx][1] = (O12*gradX)+(O22*gradY)+(O23*gradZ);
+               grad[qz][qy][qx][2] = (O13*gradX)+(O23*gradY)+(O33*gradZ);
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double gradXY[max_D1D][max_D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = 0;
+               gradXY[dy][dx][1] = 0;
+               gradXY[dy][dx][2] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[max_D1D][3];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0;
+               gradX[dx][1] = 0;
+               gradX[dx][2] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double gX = grad[qz][qy][qx][0];
+               const double gY = grad[qz][qy][qx][1];
+               const double gZ = grad[qz][qy][qx][2];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const double wx  = Bt(dx,qx);
+                  const double wDx = Gt(dx,qx);
+                  gradX[dx][0] += gX * wDx;
+                  gradX[dx][1] += gY * wx;
+                  gradX[dx][2] += gZ * wx;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = Bt(dy,qy);
+               const double wDy = Gt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += gradX[dx][0] * wy;
+                  gradXY[dy][dx][1] += gradX[dx][1] * wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = Bt(dz,qz);
+            const double wDz = Gt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol[dz][dy][dx] +=
+                     ((gradXY[dy][dx][0] * wz) +
+                      (gradXY[dy][dx][1] * wz) +
+                      (gradXY[dy][dx][2] * wDz));
+               }
+            }
+         }
+      }
+      // Scatter to the L-vector, no other element of this color shares dofs
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const int j = map(dx,dy,dz,e);
+               if (j >= 0) { y[j] += sol[dz][dy][dx]; }
+               else { y[-1-j] -= sol[dz][dy][dx]; }
+            }
+         }
+      }
+   });
+}
+
+// Signature of the fused PA Diffusion Apply kernels
+typedef void (*PADiffusionApplyFusedKernel)(const int NE,
+                                            const int NC,
+                                            const int *elements,
+                                            const Array<int> &gather,
+                                            const Array<double> &B,
+                                            const Array<double> &G,
+                                            const Array<double> &Bt,
+                                            const Array<double> &Gt,
+                                            const Vector &op,
+                                            const Vector &x,
+                                            Vector &y,
+                                            const int d1d,
+                                            const int q1d);
+
+// Register the fused kernels for D1D = 2,...,T_D1D with Q1D = D1D and
+// Q1D = D1D + 1, see PADiffusionApplyRegistrar.
+template<int T_D1D>
+struct PADiffusionApplyFusedRegistrar
+{
+   static void Add(PAKernelTable<PADiffusionApplyFusedKernel> &table)
+   {
+      constexpr int D = T_D1D;
+      table.Add(2, D, D, PADiffusionApplyFused2D<D,D>);
+      table.Add(2, D, D+1, PADiffusionApplyFused2D<D,D+1>);
+      table.Add(3, D, D, PADiffusionApplyFused3D<D,D>);
+      table.Add(3, D, D+1, PADiffusionApplyFused3D<D,D+1>);
+      PADiffusionApplyFusedRegistrar<T_D1D-1>::Add(table);
+   }
+};
+
+template<>
+struct PADiffusionApplyFusedRegistrar<1>
+{
+   static void Add(PAKernelTable<PADiffusionApplyFusedKernel> &) { }
+};
+
+// Table of the specialized fused PA Diffusion Apply kernels
+static const PAKernelTable<PADiffusionApplyFusedKernel>
+&PADiffusionApplyFusedKernels()
+{
+   struct Table : PAKernelTable<PADiffusionApplyFusedKernel>
+   {
+      Table()
+      {
+         PADiffusionApplyFusedRegistrar<PA_SPECIALIZED_MAX_D1D>::Add(*this);
+      }
+   };
+   static const Table table;
+   return table;
+}
+
+void DiffusionIntegrator::AddMultFusedPA(const ElementRestriction &R,
+                                         const Vector &x, Vector &y) const
+{
+   // Sequential backends process all elements in order in a single pass, the
+   // parallel ones process the elements of each color concurrently. The
+   // elements of a color are in increasing order, so the static partition of
+   // each color over the threads follows the partition of the elements used
+   // to set up (and first touch) the quadrature data.
+   const bool colored = Device::Allows(Backend::OMP_MASK);
+   const Array<int> *offsets = NULL, *elements = NULL;
+   if (colored) { R.GetElementColoring(offsets, elements); }
+   const int num_colors = colored ? offsets->Size() - 1 : 1;
+   const Array<int> &map = R.GatherMap();
+   const Array<double> &B = maps->B, &G = maps->G;
+   const Array<double> &Bt = maps->Bt, &Gt = maps->Gt;
+   const int *E = colored ? elements->Read() : NULL;
+   PADiffusionApplySimdKernel simd = NULL;
+   if (PAUseSimdKernels())
+   {
+      simd = PADiffusionApplySimdKernels().Find(dim, dofs1D, quad1D);
+   }
+   const PADiffusionApplyFusedKernel kernel =
+      PADiffusionApplyFusedKernels().Find(dim, dofs1D, quad1D);
+   for (int c = 0; c < num_colors; c++)
+   {
+      const int *Ec = colored ? E + (*offsets)[c] : NULL;
+      const int NC = colored ? (*offsets)[c+1] - (*offsets)[c] : ne;
+      const Vector &D = pa_data;
+      if (simd)
+      {
+         simd(ne,NC,Ec,map.HostRead(),B,G,D,x,y);
+      }
+      else if (kernel)
+      {
+         kernel(ne,NC,Ec,map,B,G,Bt,Gt,D,x,y,dofs1D,quad1D);
+      }
+      else if (dim == 2)
+      {
+         PADiffusionApplyFused2D(ne,NC,Ec,map,B,G,Bt,Gt,D,x,y,dofs1D,quad1D);
+      }
+      else if (dim == 3)
+      {
+         PADiffusionApplyFused3D(ne,NC,Ec,map,B,G,Bt,Gt,D,x,y,dofs1D,quad1D);
+      }
+      else { MFEM_ABORT("Unknown kernel."); }
+   }
+}
+
+bool DiffusionIntegrator::HasSpecializedPAKernel() const
+{
+   return PADiffusionApplyKernels().Find(dim, dofs1D, quad1D) &&
+          PADiffusionApplyFusedKernels().Find(dim, dofs1D, quad1D);
+}
+
+// PA Diffusion Diagonal 2D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PADiffusionDiagonal2D(const int NE,
+                           const Array<double> &b,
+                           const Array<double> &g,
+                           const Vector &_op,
+                           Vector &_y,
+                           const int d1d = 0,
+                           const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // contract in y: QD[k][qx][dy] = sum_qy (op_k * (B or G)^2)(qx,qy)
+      double QD0[max_Q1D][max_D1D];
+      double QD1[max_Q1D][max_D1D];
+      double QD2[max_Q1D][max_D1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            QD0[qx][dy] = 0.0;
+            QD1[qx][dy] = 0.0;
+            QD2[qx][dy] = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double By = B(qy,dy);
+               const double Gy = G(qy,dy);
+               QD0[qx][dy] += By * By * op(qx,qy,0,e);
+               QD1[qx][dy] += By * Gy * op(qx,qy,1,e);
+               QD2[qx][dy] += Gy * Gy * op(qx,qy,2,e);
+            }
+         }
+      }
+      // contract in x
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double temp = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double Bx = B(qx,dx);
+               const double Gx = G(qx,dx);
+               temp += Gx * Gx * QD0[qx][dy];
+               temp += 2.0 * Gx * Bx * QD1[qx][dy];
+               temp += Bx * Bx * QD2[qx][dy];
+            }
+            y(dx,dy,e) += temp;
+         }
+      }
+   });
+}
+
+// PA Diffusion Diagonal 3D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void PADiffusionDiagonal3D(const int NE,
+                           const Array<double> &b,
+                           const Array<double> &g,
+                           const Vector &_op,
+                           Vector &_y,
+                           const int d1d = 0,
+                           const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // index of the (i,j) entry in the symmetric 3x3 quadrature data
+      const int sym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+      double QQD[max_Q1D][max_Q1D][max_D1D];
+      double QDD[max_Q1D][max_D1D][max_D1D];
+      for (int i = 0; i < 3; ++i)
+      {
+         for (int j = 0; j < 3; ++j)
+         {
+            const int k = sym[i][j];
+            // first tensor contraction, along z direction
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int dz = 0; dz < D1D; ++dz)
+                  {
+                     QQD[qx][qy][dz] = 0.0;
+                     for (int qz = 0; qz < Q1D; ++qz)
+                     {
+                        const double Bz = B(qz,dz);
+                        const double Gz = G(qz,dz);
+                        const double L = (i == 2) ? Gz : Bz;
+                        const double R = (j == 2) ? Gz : Bz;
+                        QQD[qx][qy][dz] += L * op(qx,qy,qz,k,e) * R;
+                     }
+                  }
+               }
+            }
+            // second tensor contraction, along y direction
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int dz = 0; dz < D1D; ++dz)
+               {
+                  for (int dy = 0; dy < D1D; ++dy)
+                  {
+                     QDD[qx][dy][dz] = 0.0;
+                     for (int qy = 0; qy < Q1D; ++qy)
+                     {
+                        const double By = B(qy,dy);
+                        const double Gy = G(qy,dy);
+                        const double L = (i == 1) ? Gy : By;
+                        const double R = (j == 1) ? Gy : By;
+                        QDD[qx][dy][dz] += L * QQD[qx][qy][dz] * R;
+                     }
+                  }
+               }
+            }
+            // third tensor contraction, along x direction
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               for (int dy = 0; dy < D1D; ++dy)
+               {
+                  for (int dx = 0; dx < D1D; ++dx)
+                  {
+                     double temp = 0.0;
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        const double Bx = B(qx,dx);
+                        const double Gx = G(qx,dx);
+                        const double L = (i == 0) ? Gx : Bx;
+                        const double R = (j == 0) ? Gx : Bx;
+                        temp += L * QDD[qx][dy][dz] * R;
+                     }
+                     y(dx,dy,dz,e) += temp;
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+void PADiffusionAssembleDiagonal(const int dim,
+                                 const int D1D,
+                                 const int Q1D,
+                                 const int NE,
+                                 const Array<double> &B,
+                                 const Array<double> &G,
+                                 const Vector &op,
+                                 Vector &y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x22: return PADiffusionDiagonal2D<2,2>(NE,B,G,op,y);
+         case 0x33: return PADiffusionDiagonal2D<3,3>(NE,B,G,op,y);
+         case 0x44: return PADiffusionDiagonal2D<4,4>(NE,B,G,op,y);
+         case 0x55: return PADiffusionDiagonal2D<5,5>(NE,B,G,op,y);
+         case 0x66: return PADiffusionDiagonal2D<6,6>(NE,B,G,op,y);
+         case 0x77: return PADiffusionDiagonal2D<7,7>(NE,B,G,op,y);
+         case 0x88: return PADiffusionDiagonal2D<8,8>(NE,B,G,op,y);
+         case 0x99: return PADiffusionDiagonal2D<9,9>(NE,B,G,op,y);
+         default:   return PADiffusionDiagonal2D(NE,B,G,op,y,D1D,Q1D);
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((D1D << 4 ) | Q1D)
+      {
+         case 0x23: return PADiffusionDiagonal3D<2,3>(NE,B,G,op,y);
+         case 0x34: return PADiffusionDiagonal3D<3,4>(NE,B,G,op,y);
+         case 0x45: return PADiffusionDiagonal3D<4,5>(NE,B,G,op,y);
+         case 0x56: return PADiffusionDiagonal3D<5,6>(NE,B,G,op,y);
+         case 0x67: return PADiffusionDiagonal3D<6,7>(NE,B,G,op,y);
+         case 0x78: return PADiffusionDiagonal3D<7,8>(NE,B,G,op,y);
+         case 0x89: return PADiffusionDiagonal3D<8,9>(NE,B,G,op,y);
+         default:   return PADiffusionDiagonal3D(NE,B,G,op,y,D1D,Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Diffusion Diagonal kernel
+void DiffusionIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (pa_single)
+   {
+      Vector D;
+      PAToDoublePrecision(pa_data_sp, D);
+      PADiffusionAssembleDiagonal(dim, dofs1D, quad1D, ne,
+                                  maps->B, maps->G, D, diag);
+      return;
+   }
+   PADiffusionAssembleDiagonal(dim, dofs1D, quad1D, ne,
+                               maps->B, maps->G, pa_data, diag);
+}
+
+// EA Diffusion Assemble 2D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void EADiffusionAssemble2D(const int NE,
+                           const Array<double> &b,
+                           const Array<double> &g,
+                           const Vector &padata,
+                           DenseTensor &eadata,
+                           const int d1d = 0,
+                           const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(padata.Read(), Q1D, Q1D, 3, NE);
+   auto A = Reshape(eadata.ReadWrite(), D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            // contract in x the four terms of grad(phi_i)^T O grad(phi_j)
+            double T11[max_Q1D], T12[max_Q1D], T21[max_Q1D], T22[max_Q1D];
+            for (int q2 = 0; q2 < Q1D; ++q2)
+            {
+               T11[q2] = T12[q2] = T21[q2] = T22[q2] = 0.0;
+               for (int q1 = 0; q1 < Q1D; ++q1)
+               {
+                  const double Bi = B(q1,i1), Gi = G(q1,i1);
+                  const double Bj = B(q1,j1), Gj = G(q1,j1);
+                  T11[q2] += Gi * Gj * op(q1,q2,0,e);
+                  T12[q2] += Gi * Bj * op(q1,q2,1,e);
+                  T21[q2] += Bi * Gj * op(q1,q2,1,e);
+                  T22[q2] += Bi * Bj * op(q1,q2,2,e);
+               }
+            }
+            // contract in y
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  double val = 0.0;
+                  for (int q2 = 0; q2 < Q1D; ++q2)
+                  {
+                     const double Bi = B(q2,i2), Gi = G(q2,i2);
+                     const double Bj = B(q2,j2), Gj = G(q2,j2);
+                     val += Bi * Bj * T11[q2] + Bi * Gj * T12[q2] +
+                            Gi * Bj * T21[q2] + Gi * Gj * T22[q2];
+                  }
+                  A(i1,i2,j1,j2,e) += val;
+               }
+            }
+         }
+      }
+   });
+}
+
+// EA Diffusion Assemble 3D kernel
+template<int T_D1D = 0, int T_Q1D = 0> static
+void EADiffusionAssemble3D(const int NE,
+                           const Array<double> &b,
+                           const Array<double> &g,
+                           const Vector &padata,
+                           DenseTensor &eadata,
+                           const int d1d = 0,
+                           const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto op = Reshape(padata.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto A = Reshape(eadata.ReadWrite(), D1D, D1D, D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // index of the entry (k,l) in the symmetric 3x3 quadrature data
+      const int sym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+      // The entry (i,j) is the sum over k,l of the separable terms
+      // O(k,l) d_k(phi_i) d_l(phi_j), where the derivative d_k uses G in the
+      // direction k and B in the other directions.
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            double T1[3][3][max_Q1D][max_Q1D];
+            for (int k = 0; k < 3; ++k)
+            {
+               for (int l = 0; l < 3; ++l)
+               {
+                  const int o = sym[k][l];
+                  for (int q3 = 0; q3 < Q1D; ++q3)
+                  {
+                     for (int q2 = 0; q2 < Q1D; ++q2)
+                     {
+                        double t = 0.0;
+                        for (int q1 = 0; q1 < Q1D; ++q1)
+                        {
+                           const double wi = (k == 0) ? G(q1,i1) : B(q1,i1);
+                           const double wj = (l == 0) ? G(q1,j1) : B(q1,j1);
+                           t += wi * wj * op(q1,q2,q3,o,e);
+                        }
+                        T1[k][l][q3][q2] = t;
+                     }
+                  }
+               }
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  double T2[3][3][max_Q1D];
+                  for (int k = 0; k < 3; ++k)
+                  {
+                     for (int l = 0; l < 3; ++l)
+                     {
+                        for (int q3 = 0; q3 < Q1D; ++q3)
+                        {
+                           double t = 0.0;
+                           for (int q2 = 0; q2 < Q1D; ++q2)
+                           {
+                              const double wi = (k == 1) ? G(q2,i2) : B(q2,i2);
+                              const double wj = (l == 1) ? G(q2,j2) : B(q2,j2);
+                              t += wi * wj * T1[k][l][q3][q2];
+                           }
+                           T2[k][l][q3] = t;
+                        }
+                     }
+                  }
+                  for (int i3 = 0; i3 < D1D; ++i3)
+                  {
+                     for (int j3 = 0; j3 < D1D; ++j3)
+                     {
+                        double val = 0.0;
+                        for (int k = 0; k < 3; ++k)
+                        {
+                           for (int l = 0; l < 3; ++l)
+                           {
+                              for (int q3 = 0; q3 < Q1D; ++q3)
+                              {
+                                 const double wi =
+                                    (k == 2) ? G(q3,i3) : B(q3,i3);
+                                 const double wj =
+                                    (l == 2) ? G(q3,j3) : B(q3,j3);
+                                 val += wi * wj * T2[k][l][q3];
+                              }
+                           }
+                        }
+                        A(i1,i2,i3,j1,j2,j3,e) += val;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+void DiffusionIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                     DenseTensor &emat)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   if (fes.GetVDim() != 1 || !dynamic_cast<const TensorBasisElement*>(&el) ||
+       fes.GetMesh()->Dimension() == 1)
+   {
+      return BilinearFormIntegrator::AssembleEA(fes, emat);
+   }
+   // The element matrices are computed from double precision data
+   const bool single = pa_single;
+   pa_single = false;
+   AssemblePA(fes);
+   pa_single = single;
+   if (ne == 0) { return; }
+   const Array<double> &B = maps->B;
+   const Array<double> &G = maps->G;
+   if (dim == 2)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x22: return EADiffusionAssemble2D<2,2>(ne,B,G,pa_data,emat);
+         case 0x33: return EADiffusionAssemble2D<3,3>(ne,B,G,pa_data,emat);
+         case 0x44: return EADiffusionAssemble2D<4,4>(ne,B,G,pa_data,emat);
+         default:   return EADiffusionAssemble2D(ne,B,G,pa_data,emat,
+                                                    dofs1D,quad1D);
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x23: return EADiffusionAssemble3D<2,3>(ne,B,G,pa_data,emat);
+         case 0x34: return EADiffusionAssemble3D<3,4>(ne,B,G,pa_data,emat);
+         case 0x45: return EADiffusionAssemble3D<4,5>(ne,B,G,pa_data,emat);
+         default:   return EADiffusionAssemble3D(ne,B,G,pa_data,emat,
+                                                    dofs1D,quad1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// MF Diffusion Apply 2D kernel. The Jacobians of the element transformation
+// are computed from the mesh nodes at the quadrature points instead of being
+// read from the partially assembled data.
+template<const int T_D1D = 0,
+         const int T_Q1D = 0> static
+void MFDiffusionApply2D(const int NE,
+                        const int GD1D,
+                        const Array<double> &b,
+                        const Array<double> &g,
+                        const Array<double> &bt,
+                        const Array<double> &gt,
+                        const Array<double> &gb,
+                        const Array<double> &gg,
+                        const Array<double> &w,
+                        const Vector &_nodes,
+                        const Vector &_c,
+                        const Vector &_x,
+                        Vector &_y,
+                        const int d1d = 0,
+                        const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(GD1D <= MAX_D1D, "");
+   const bool const_c = _c.Size() == 1;
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto GB = Reshape(gb.Read(), Q1D, GD1D);
+   auto GG = Reshape(gg.Read(), Q1D, GD1D);
+   auto W = Reshape(w.Read(), Q1D, Q1D);
+   auto X = Reshape(_nodes.Read(), GD1D, GD1D, 2, NE);
+   auto C = const_c ? Reshape(_c.Read(), 1, 1, 1) :
+            Reshape(_c.Read(), Q1D, Q1D, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // jac[qy][qx][i][j] = d(x_i)/d(xi_j) at the quadrature point (qx,qy)
+      double jac[max_Q1D][max_Q1D][2][2];
+      for (int c = 0; c < 2; ++c)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               jac[qy][qx][c][0] = 0.0;
+               jac[qy][qx][c][1] = 0.0;
+            }
+         }
+         for (int gy = 0; gy < GD1D; ++gy)
+         {
+            double nodesX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               nodesX[qx][0] = 0.0;
+               nodesX[qx][1] = 0.0;
+            }
+            for (int gx = 0; gx < GD1D; ++gx)
+            {
+               const double s = X(gx,gy,c,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  nodesX[qx][0] += s * GB(qx,gx);
+                  nodesX[qx][1] += s * GG(qx,gx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = GB(qy,gy);
+               const double wDy = GG(qy,gy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  jac[qy][qx][c][0] += nodesX[qx][1] * wy;
+                  jac[qy][qx][c][1] += nodesX[qx][0] * wDy;
+               }
+            }
+         }
+      }
+
+      double grad[max_Q1D][max_Q1D][2];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            grad[qy][qx][0] = 0.0;
+            grad[qy][qx][1] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double gradX[max_Q1D][2];
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            gradX[qx][0] = 0.0;
+            gradX[qx][1] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = x(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] += s * B(qx,dx);
+               gradX[qx][1] += s * G(qx,dx);
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double wy  = B(qy,dy);
+            const double wDy = G(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qy][qx][0] += gradX[qx][1] * wy;
+               grad[qy][qx][1] += gradX[qx][0] * wDy;
+            }
+         }
+      }
+      // Compute the quadrature data and apply it in the same pass
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double J11 = jac[qy][qx][0][0];
+            const double J21 = jac[qy][qx][1][0];
+            const double J12 = jac[qy][qx][0][1];
+            const double J22 = jac[qy][qx][1][1];
+            const double coeff = const_c ? C(0,0,0) : C(qx,qy,e);
+            const double c_detJ = W(qx,qy) * coeff / ((J11*J22)-(J21*J12));
+            const double O11 =  c_detJ * (J12*J12 + J22*J22);
+            const double O12 = -c_detJ * (J12*J11 + J22*J21);
+            const double O22 =  c_detJ * (J11*J11 + J21*J21);
+
+            const double gradX = grad[qy][qx][0];
+            const double gradY = grad[qy][qx][1];
+
+            grad[qy][qx][0] = (O11 * gradX) + (O12 * gradY);
+            grad[qy][qx][1] = (O12 * gradX) + (O22 * gradY);
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double gradX[max_D1D][2];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            gradX[dx][0] = 0;
+            gradX[dx][1] = 0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double gX = grad[qy][qx][0];
+            const double gY = grad[qy][qx][1];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double wx  = Bt(dx,qx);
+               const double wDx = Gt(dx,qx);
+               gradX[dx][0] += gX * wDx;
+               gradX[dx][1] += gY * wx;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double wy  = Bt(dy,qy);
+            const double wDy = Gt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               y(dx,dy,e) += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
+            }
+         }
+      }
+   });
+}
+
+// MF Diffusion Apply 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0> static
+void MFDiffusionApply3D(const int NE,
+                        const int GD1D,
+                        const Array<double> &b,
+                        const Array<double> &g,
+                        const Array<double> &bt,
+                        const Array<double> &gt,
+                        const Array<double> &gb,
+                        const Array<double> &gg,
+                        const Array<double> &w,
+                        const Vector &_nodes,
+                        const Vector &_c,
+                        const Vector &_x,
+                        Vector &_y,
+                        const int d1d = 0,
+                        const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(GD1D <= MAX_D1D, "");
+   const bool const_c = _c.Size() == 1;
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto G = Reshape(g.Read(), Q1D, D1D);
+   auto Bt = Reshape(bt.Read(), D1D, Q1D);
+   auto Gt = Reshape(gt.Read(), D1D, Q1D);
+   auto GB = Reshape(gb.Read(), Q1D, GD1D);
+   auto GG = Reshape(gg.Read(), Q1D, GD1D);
+   auto W = Reshape(w.Read(), Q1D, Q1D, Q1D);
+   auto X = Reshape(_nodes.Read(), GD1D, GD1D, GD1D, 3, NE);
+   auto C = const_c ? Reshape(_c.Read(), 1, 1, 1, 1) :
+            Reshape(_c.Read(), Q1D, Q1D, Q1D, NE);
+   auto x = Reshape(_x.Read(), D1D, D1D, D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // jac[qz][qy][qx][i][j] = d(x_i)/d(xi_j) at the quadrature point
+      double jac[max_Q1D][max_Q1D][max_Q1D][3][3];
+      for (int c = 0; c < 3; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  jac[qz][qy][qx][c][0] = 0.0;
+                  jac[qz][qy][qx][c][1] = 0.0;
+                  jac[qz][qy][qx][c][2] = 0.0;
+               }
+            }
+         }
+         for (int gz = 0; gz < GD1D; ++gz)
+         {
+            double nodesXY[max_Q1D][max_Q1D][3];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  nodesXY[qy][qx][0] = 0.0;
+                  nodesXY[qy][qx][1] = 0.0;
+                  nodesXY[qy][qx][2] = 0.0;
+               }
+            }
+            for (int gy = 0; gy < GD1D; ++gy)
+            {
+               double nodesX[max_Q1D][2];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  nodesX[qx][0] = 0.0;
+                  nodesX[qx][1] = 0.0;
+               }
+               for (int gx = 0; gx < GD1D; ++gx)
+               {
+                  const double s = X(gx,gy,gz,c,e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     nodesX[qx][0] += s * GB(qx,gx);
+                     nodesX[qx][1] += s * GG(qx,gx);
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy  = GB(qy,gy);
+                  const double wDy = GG(qy,gy);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     nodesXY[qy][qx][0] += nodesX[qx][1] * wy;
+                     nodesXY[qy][qx][1] += nodesX[qx][0] * wDy;
+                     nodesXY[qy][qx][2] += nodesX[qx][0] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz  = GB(qz,gz);
+               const double wDz = GG(qz,gz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     jac[qz][qy][qx][c][0] += nodesXY[qy][qx][0] * wz;
+                     jac[qz][qy][qx][c][1] += nodesXY[qy][qx][1] * wz;
+                     jac[qz][qy][qx][c][2] += nodesXY[qy][qx][2] * wDz;
+                  }
+               }
+            }
+         }
+      }
+
+      double grad[max_Q1D][max_Q1D][max_Q1D][3];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               grad[qz][qy][qx][0] = 0.0;
+               grad[qz][qy][qx][1] = 0.0;
+               grad[qz][qy][qx][2] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double gradXY[max_Q1D][max_Q1D][3];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradXY[qy][qx][0] = 0.0;
+               gradXY[qy][qx][1] = 0.0;
+               gradXY[qy][qx][2] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double gradX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               gradX[qx][0] = 0.0;
+               gradX[qx][1] = 0.0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = x(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  gradX[qx][0] += s * B(qx,dx);
+                  gradX[qx][1] += s * G(qx,dx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = B(qy,dy);
+               const double wDy = G(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx  = gradX[qx][0];
+                  const double wDx = gradX[qx][1];
+                  gradXY[qy][qx][0] += wDx * wy;
+                  gradXY[qy][qx][1] += wx  * wDy;
+                  gradXY[qy][qx][2] += wx  * wy;
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz  = B(qz,dz);
+            const double wDz = G(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  grad[qz][qy][qx][0] += gradXY[qy][qx][0] * wz;
+                  grad[qz][qy][qx][1] += gradXY[qy][qx][1] * wz;
+                  grad[qz][qy][qx][2] += gradXY[qy][qx][2] * wDz;
+               }
+            }
+         }
+      }
+      // Compute the quadrature data and apply it in the same pass
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double J11 = jac[qz][qy][qx][0][0];
+               const double J21 = jac[qz][qy][qx][1][0];
+               const double J31 = jac[qz][qy][qx][2][0];
+               const double J12 = jac[qz][qy][qx][0][1];
+               const double J22 = jac[qz][qy][qx][1][1];
+               const double J32 = jac[qz][qy][qx][2][1];
+               const double J13 = jac[qz][qy][qx][0][2];
+               const double J23 = jac[qz][qy][qx][1][2];
+               const double J33 = jac[qz][qy][qx][2][2];
+               const double detJ = J11 * (J22 * J33 - J32 * J23) -
+               /* */               J21 * (J12 * J33 - J32 * J13) +
+               /* */               J31 * (J12 * J23 - J22 * J13);
+               const double coeff = const_c ? C(0,0,0,0) : C(qx,qy,qz,e);
+               const double c_detJ = W(qx,qy,qz) * coeff / detJ;
+               // adj(J)
+               const double A11 = (J22 * J33) - (J23 * J32);
+               const double A12 = (J32 * J13) - (J12 * J33);
+               const double A13 = (J12 * J23) - (J22 * J13);
+               const double A21 = (J31 * J23) - (J21 * J33);
+               const double A22 = (J11 * J33) - (J13 * J31);
+               const double A23 = (J21 * J13) - (J11 * J23);
+               const double A31 = (J21 * J32) - (J31 * J22);
+               const double A32 = (J31 * J12) - (J11 * J32);
+               const double A33 = (J11 * J22) - (J12 * J21);
+               const double O11 = c_detJ * (A11*A11 + A12*A12 + A13*A13);
+               const double O12 = c_detJ * (A11*A21 + A12*A22 + A13*A23);
+               const double O13 = c_detJ * (A11*A31 + A12*A32 + A13*A33);
+               const double O22 = c_detJ * (A21*A21 + A22*A22 + A23*A23);
+               const double O23 = c_detJ * (A21*A31 + A22*A32 + A23*A33);
+               const double O33 = c_detJ * (A31*A31 + A32*A32 + A33*A33);
+               const double gradX = grad[qz][qy][qx][0];
+               const double gradY = grad[qz][qy][qx][1];
+               const double gradZ = grad[qz][qy][qx][2];
+               grad[qz][qy][qx][0] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
+               grad[qz][qy][qx][1] = (O12*gradX)+(O22*gradY)+(O23*gradZ);
+               grad[qz][qy][qx][2] = (O13*gradX)+(O23*gradY)+(O33*gradZ);
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double gradXY[max_D1D][max_D1D][3];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradXY[dy][dx][0] = 0;
+               gradXY[dy][dx][1] = 0;
+               gradXY[dy][dx][2] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double gradX[max_D1D][3];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               gradX[dx][0] = 0;
+               gradX[dx][1] = 0;
+               gradX[dx][2] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double gX = grad[qz][qy][qx][0];
+               const double gY = grad[qz][qy][qx][1];
+               const double gZ = grad[qz][qy][qx][2];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  const double wx  = Bt(dx,qx);
+                  const double wDx = Gt(dx,qx);
+                  gradX[dx][0] += gX * wDx;
+                  gradX[dx][1] += gY * wx;
+                  gradX[dx][2] += gZ * wx;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy  = Bt(dy,qy);
+               const double wDy = Gt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  gradXY[dy][dx][0] += gradX[dx][0] * wy;
+                  gradXY[dy][dx][1] += gradX[dx][1] * wDy;
+                  gradXY[dy][dx][2] += gradX[dx][2] * wy;
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz  = Bt(dz,qz);
+            const double wDz = Gt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,dz,e) +=
+                     ((gradXY[dy][dx][0] * wz) +
+                      (gradXY[dy][dx][1] * wz) +
+                      (gradXY[dy][dx][2] * wDz));
+               }
+            }
+         }
+      }
+   });
+}
+
+void DiffusionIntegrator::AssembleMF(const FiniteElementSpace &fes)
+{
+   // Assumes tensor-product elements
+   MFEM_VERIFY(MQ == NULL, "matrix coefficients are not supported");
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   mf_ir = IntRule ? IntRule : &GetRule(el, el);
+   dim = mesh->Dimension();
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   maps = &el.GetDofToQuad(*mf_ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   MFNodesSetup(*mesh, *mf_ir, mf_nodes, mf_geom_maps);
+   PAEvalCoefficient(fes, *mf_ir, Q, mf_coeff);
+}
+
+void DiffusionIntegrator::AddMultMF(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   const int GD1D = mf_geom_maps->ndof;
+   const Array<double> &B = maps->B, &G = maps->G;
+   const Array<double> &Bt = maps->Bt, &Gt = maps->Gt;
+   const Array<double> &GB = mf_geom_maps->B, &GG = mf_geom_maps->G;
+   const Array<double> &W = mf_ir->GetWeights();
+   const Vector &N = mf_nodes, &C = mf_coeff;
+   if (dim == 2)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x22:
+            return MFDiffusionApply2D<2,2>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         case 0x33:
+            return MFDiffusionApply2D<3,3>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         case 0x44:
+            return MFDiffusionApply2D<4,4>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         case 0x55:
+            return MFDiffusionApply2D<5,5>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         default:
+            return MFDiffusionApply2D(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y,
+                                      dofs1D,quad1D);
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x23:
+            return MFDiffusionApply3D<2,3>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         case 0x34:
+            return MFDiffusionApply3D<3,4>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         case 0x45:
+            return MFDiffusionApply3D<4,5>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         case 0x56:
+            return MFDiffusionApply3D<5,6>(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y);
+         default:
+            return MFDiffusionApply3D(ne,GD1D,B,G,Bt,Gt,GB,GG,W,N,C,x,y,
+                                      dofs1D,quad1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void DiffusionIntegrator::AssembleDiagonalMF(Vector &diag)
+{
+   if (ne == 0) { return; }
+   // The quadrature data only lives for the duration of this call; the
+   // Jacobians are computed from the nodes gathered by AssembleMF().
+   Vector J;
+   MFJacobians(dim, ne, *mf_geom_maps, mf_nodes, J);
+   Vector op;
+   op.SetSize((dim*(dim+1)/2) * mf_ir->GetNPoints() * ne,
+              Device::GetMemoryType());
+   PADiffusionSetup(dim, dofs1D, quad1D, ne, mf_ir->GetWeights(), J,
+                    mf_coeff, op);
+   PADiffusionAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, maps->G, op,
+                               diag);
+}
+
 } // namespace mfem
@@ -0,0 +1,1100 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "bilininteg_pa.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA H(curl) Mass Integrator and PA Curl-Curl Integrator
+
+// The E-vectors of the Nedelec elements on quadrilaterals and hexahedra store
+// the x, y (and z) components one after the other. Each component is ordered
+// lexicographically, using the open basis (D1D-1 dofs) in its own direction
+// and the closed basis (D1D dofs) in the other directions.
+
+// PA H(curl) Mass Apply 2D kernel
+static void PAHcurlMassApply2D(const int D1D,
+                               const int Q1D,
+                               const int NE,
+                               const Array<double> &_Bo,
+                               const Array<double> &_Bc,
+                               const Vector &_op,
+                               const Vector &_x,
+                               Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto x = Reshape(_x.Read(), 2*(D1D-1)*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 2;
+      constexpr int MD1 = HCURL_MAX_D1D;
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+
+      double mass[MQ1][MQ1][VDIM];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            for (int c = 0; c < VDIM; ++c)
+            {
+               mass[qy][qx][c] = 0.0;
+            }
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double massX[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               massX[qx] = 0.0;
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               const double t = x(dx + (dy * D1Dx) + osc, e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  massX[qx] += t * ((c == 0) ? Bo(qx,dx) : Bc(qx,dx));
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  mass[qy][qx][c] += massX[qx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+
+      // apply the quadrature data
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double O11 = op(qx,qy,0,e);
+            const double O12 = op(qx,qy,1,e);
+            const double O22 = op(qx,qy,2,e);
+            const double massX = mass[qy][qx][0];
+            const double massY = mass[qy][qx][1];
+            mass[qy][qx][0] = (O11*massX)+(O12*massY);
+            mass[qy][qx][1] = (O12*massX)+(O22*massY);
+         }
+      }
+
+      osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double massX[MD1];
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               massX[dx] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  massX[dx] += mass[qy][qx][c] *
+                               ((c == 0) ? Bo(qx,dx) : Bc(qx,dx));
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  y(dx + (dy * D1Dx) + osc, e) += massX[dx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA H(curl) Mass Apply 3D kernel
+static void PAHcurlMassApply3D(const int D1D,
+                               const int Q1D,
+                               const int NE,
+                               const Array<double> &_Bo,
+                               const Array<double> &_Bc,
+                               const Vector &_op,
+                               const Vector &_x,
+                               Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto x = Reshape(_x.Read(), 3*(D1D-1)*D1D*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 3*(D1D-1)*D1D*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 3;
+      constexpr int MD1 = HCURL_MAX_D1D;
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+
+      double mass[MQ1][MQ1][MQ1][VDIM];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int c = 0; c < VDIM; ++c)
+               {
+                  mass[qz][qy][qx][c] = 0.0;
+               }
+            }
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            double massXY[MQ1][MQ1];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  massXY[qy][qx] = 0.0;
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               double massX[MQ1];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  massX[qx] = 0.0;
+               }
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  const double t = x(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     massX[qx] += t * ((c == 0) ? Bo(qx,dx) : Bc(qx,dx));
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     massXY[qy][qx] += massX[qx] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz = (c == 2) ? Bo(qz,dz) : Bc(qz,dz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     mass[qz][qy][qx][c] += massXY[qy][qx] * wz;
+                  }
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+
+      // apply the quadrature data
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double O11 = op(qx,qy,qz,0,e);
+               const double O12 = op(qx,qy,qz,1,e);
+               const double O13 = op(qx,qy,qz,2,e);
+               const double O22 = op(qx,qy,qz,3,e);
+               const double O23 = op(qx,qy,qz,4,e);
+               const double O33 = op(qx,qy,qz,5,e);
+               const double massX = mass[qz][qy][qx][0];
+               const double massY = mass[qz][qy][qx][1];
+               const double massZ = mass[qz][qy][qx][2];
+               mass[qz][qy][qx][0] = (O11*massX)+(O12*massY)+(O13*massZ);
+               mass[qz][qy][qx][1] = (O12*massX)+(O22*massY)+(O23*massZ);
+               mass[qz][qy][qx][2] = (O13*massX)+(O23*massY)+(O33*massZ);
+            }
+         }
+      }
+
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double massXY[MD1][MD1];
+
+         osc = 0;
+         for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+         {
+            const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+            const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+            const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  massXY[dy][dx] = 0.0;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               double massX[MD1];
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  massX[dx] = 0.0;
+               }
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     massX[dx] += mass[qz][qy][qx][c] *
+                                  ((c == 0) ? Bo(qx,dx) : Bc(qx,dx));
+                  }
+               }
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     massXY[dy][dx] += massX[dx] * wy;
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1Dz; ++dz)
+            {
+               const double wz = (c == 2) ? Bo(qz,dz) : Bc(qz,dz);
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     y(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) +=
+                        massXY[dy][dx] * wz;
+                  }
+               }
+            }
+            osc += D1Dx * D1Dy * D1Dz;
+         }
+      }
+   });
+}
+
+// PA H(curl) Mass Diagonal 2D kernel
+static void PAHcurlMassAssembleDiagonal2D(const int D1D,
+                                          const int Q1D,
+                                          const int NE,
+                                          const Array<double> &_Bo,
+                                          const Array<double> &_Bc,
+                                          const Vector &_op,
+                                          Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 2; ++c)  // loop over x, y components
+      {
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+         const int k = (c == 0) ? 0 : 2; // diagonal entry of the 2x2 data
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double QD[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               QD[qx] = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                  QD[qx] += wy * wy * op(qx,qy,k,e);
+               }
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               double val = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx = (c == 0) ? Bo(qx,dx) : Bc(qx,dx);
+                  val += wx * wx * QD[qx];
+               }
+               diag(dx + (dy * D1Dx) + osc, e) += val;
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA H(curl) Mass Diagonal 3D kernel
+static void PAHcurlMassAssembleDiagonal3D(const int D1D,
+                                          const int Q1D,
+                                          const int NE,
+                                          const Array<double> &_Bo,
+                                          const Array<double> &_Bc,
+                                          const Vector &_op,
+                                          Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 3*(D1D-1)*D1D*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 3; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+         const int k = (c == 0) ? 0 : ((c == 1) ? 3 : 5);
+
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            double QQD[MQ1][MQ1];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  QQD[qy][qx] = 0.0;
+                  for (int qz = 0; qz < Q1D; ++qz)
+                  {
+                     const double wz = (c == 2) ? Bo(qz,dz) : Bc(qz,dz);
+                     QQD[qy][qx] += wz * wz * op(qx,qy,qz,k,e);
+                  }
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               double QDD[MQ1];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  QDD[qx] = 0.0;
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     const double wy = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                     QDD[qx] += wy * wy * QQD[qy][qx];
+                  }
+               }
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  double val = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     const double wx = (c == 0) ? Bo(qx,dx) : Bc(qx,dx);
+                     val += wx * wx * QDD[qx];
+                  }
+                  diag(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) += val;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+   });
+}
+
+void VectorFEMassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assumes tensor-product elements
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement *fel = fes.GetFE(0);
+   const VectorTensorFiniteElement *el =
+      dynamic_cast<const VectorTensorFiniteElement*>(fel);
+   MFEM_VERIFY(el != NULL, "PA is only supported for Nedelec and "
+               "Raviart-Thomas elements on quadrilaterals and hexahedra");
+   MFEM_VERIFY(VQ == NULL && MQ == NULL,
+               "PA supports only scalar coefficients");
+   ElementTransformation &T = *mesh->GetElementTransformation(0);
+   const IntegrationRule *ir = IntRule ? IntRule :
+                               &IntRules.Get(fel->GetGeomType(),
+                                             T.OrderW() + 2*fel->GetOrder());
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   map_type = fel->GetMapType();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   mapsC = &el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   MFEM_VERIFY(dofs1D == mapsO->ndof + 1 && quad1D == mapsO->nqpt, "");
+   const int symmDims = (dim * (dim + 1)) / 2; // 2x2: 3, 3x3: 6
+   pa_data.SetSize(symmDims * nq * ne, Device::GetMemoryType());
+   Vector coeff;
+   PAEvalCoefficient(fes, *ir, Q, coeff);
+   if (map_type == FiniteElement::H_CURL)
+   {
+      // W * coeff * adj(J) adj(J)^T / det(J), as in the diffusion integrator
+      PADiffusionSetup(dim, dofs1D, quad1D, ne, ir->GetWeights(), geom->J,
+                       coeff, pa_data);
+   }
+   else if (map_type == FiniteElement::H_DIV)
+   {
+      if (dim == 3)
+      {
+         PAHdivSetup3D(quad1D, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+      }
+      else
+      {
+         PAHdivSetup2D(quad1D, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+      }
+   }
+   else
+   {
+      MFEM_ABORT("Unknown kernel.");
+   }
+}
+
+void VectorFEMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (map_type == FiniteElement::H_CURL)
+   {
+      if (dim == 3)
+      {
+         PAHcurlMassApply3D(dofs1D, quad1D, ne, mapsO->B, mapsC->B, pa_data,
+                            x, y);
+      }
+      else
+      {
+         PAHcurlMassApply2D(dofs1D, quad1D, ne, mapsO->B, mapsC->B, pa_data,
+                            x, y);
+      }
+   }
+   else
+   {
+      if (dim == 3)
+      {
+         PAHdivMassApply3D(dofs1D, quad1D, ne, mapsO->B, mapsC->B, pa_data,
+                           x, y);
+      }
+      else
+      {
+         PAHdivMassApply2D(dofs1D, quad1D, ne, mapsO->B, mapsC->B, pa_data,
+                           x, y);
+      }
+   }
+}
+
+void VectorFEMassIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (map_type == FiniteElement::H_CURL)
+   {
+      if (dim == 3)
+      {
+         PAHcurlMassAssembleDiagonal3D(dofs1D, quad1D, ne, mapsO->B,
+                                       mapsC->B, pa_data, diag);
+      }
+      else
+      {
+         PAHcurlMassAssembleDiagonal2D(dofs1D, quad1D, ne, mapsO->B,
+                                       mapsC->B, pa_data, diag);
+      }
+   }
+   else
+   {
+      PAHdivMassAssembleDiagonal(dim, dofs1D, quad1D, ne, mapsO->B, mapsC->B,
+                                 pa_data, diag);
+   }
+}
+
+// PA Curl-Curl Apply 2D kernel
+static void PACurlCurlApply2D(const int D1D,
+                              const int Q1D,
+                              const int NE,
+                              const Array<double> &_Bo,
+                              const Array<double> &_Gc,
+                              const Vector &_op,
+                              const Vector &_x,
+                              Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
+   auto x = Reshape(_x.Read(), 2*(D1D-1)*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 2;
+      constexpr int MD1 = HCURL_MAX_D1D;
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+
+      // reference curl at the quadrature points: the x-component contributes
+      // -d/dy and the y-component +d/dx
+      double curl[MQ1][MQ1];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            curl[qy][qx] = 0.0;
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+         const double sign = (c == 0) ? -1.0 : 1.0;
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double aX[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               aX[qx] = 0.0;
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               const double t = x(dx + (dy * D1Dx) + osc, e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  aX[qx] += t * ((c == 0) ? Bo(qx,dx) : Gc(qx,dx));
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = sign * ((c == 1) ? Bo(qy,dy) : Gc(qy,dy));
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  curl[qy][qx] += aX[qx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+
+      // apply the quadrature data
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            curl[qy][qx] *= op(qx,qy,e);
+         }
+      }
+
+      osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+         const double sign = (c == 0) ? -1.0 : 1.0;
+
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double aX[MD1];
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               aX[dx] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  aX[dx] += curl[qy][qx] * ((c == 0) ? Bo(qx,dx) : Gc(qx,dx));
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               const double wy = sign * ((c == 1) ? Bo(qy,dy) : Gc(qy,dy));
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  y(dx + (dy * D1Dx) + osc, e) += aX[dx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA Curl-Curl Apply 3D kernel
+static void PACurlCurlApply3D(const int D1D,
+                              const int Q1D,
+                              const int NE,
+                              const Array<double> &_Bo,
+                              const Array<double> &_Bc,
+                              const Array<double> &_Gc,
+                              const Vector &_op,
+                              const Vector &_x,
+                              Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto x = Reshape(_x.Read(), 3*(D1D-1)*D1D*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 3*(D1D-1)*D1D*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 3;
+      constexpr int MD1 = HCURL_MAX_D1D;
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+      // The reference curl of the component c has two nonzero entries,
+      // curl_idx[c][k], given by sign[c][k] times the derivative of the basis
+      // along the direction der[c][k].
+      const int curl_idx[3][2] = {{1, 2}, {0, 2}, {0, 1}};
+      const double sign[3][2] = {{1.0, -1.0}, {-1.0, 1.0}, {1.0, -1.0}};
+      const int der[3][2] = {{2, 1}, {2, 0}, {1, 0}};
+
+      double curl[MQ1][MQ1][MQ1][VDIM];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int c = 0; c < VDIM; ++c)
+               {
+                  curl[qz][qy][qx][c] = 0.0;
+               }
+            }
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         for (int k = 0; k < 2; ++k)
+         {
+            const int i = curl_idx[c][k];
+            const int d = der[c][k];
+            for (int dz = 0; dz < D1Dz; ++dz)
+            {
+               double aXY[MQ1][MQ1];
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     aXY[qy][qx] = 0.0;
+                  }
+               }
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  double aX[MQ1];
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     aX[qx] = 0.0;
+                  }
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     const double t =
+                        x(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e);
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        aX[qx] += t * ((d == 0) ? Gc(qx,dx) :
+                                       (c == 0) ? Bo(qx,dx) : Bc(qx,dx));
+                     }
+                  }
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     const double wy = (d == 1) ? Gc(qy,dy) :
+                                       (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        aXY[qy][qx] += aX[qx] * wy;
+                     }
+                  }
+               }
+               for (int qz = 0; qz < Q1D; ++qz)
+               {
+                  const double wz = sign[c][k] *
+                                    ((d == 2) ? Gc(qz,dz) :
+                                     (c == 2) ? Bo(qz,dz) : Bc(qz,dz));
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        curl[qz][qy][qx][i] += aXY[qy][qx] * wz;
+                     }
+                  }
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+
+      // apply the quadrature data
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double O11 = op(qx,qy,qz,0,e);
+               const double O12 = op(qx,qy,qz,1,e);
+               const double O13 = op(qx,qy,qz,2,e);
+               const double O22 = op(qx,qy,qz,3,e);
+               const double O23 = op(qx,qy,qz,4,e);
+               const double O33 = op(qx,qy,qz,5,e);
+               const double c1 = curl[qz][qy][qx][0];
+               const double c2 = curl[qz][qy][qx][1];
+               const double c3 = curl[qz][qy][qx][2];
+               curl[qz][qy][qx][0] = (O11*c1)+(O12*c2)+(O13*c3);
+               curl[qz][qy][qx][1] = (O12*c1)+(O22*c2)+(O23*c3);
+               curl[qz][qy][qx][2] = (O13*c1)+(O23*c2)+(O33*c3);
+            }
+         }
+      }
+
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double aXY[MD1][MD1];
+
+         osc = 0;
+         for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+         {
+            const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+            const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+            const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+            for (int k = 0; k < 2; ++k)
+            {
+               const int i = curl_idx[c][k];
+               const int d = der[c][k];
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     aXY[dy][dx] = 0.0;
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  double aX[MD1];
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     aX[dx] = 0.0;
+                  }
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     for (int dx = 0; dx < D1Dx; ++dx)
+                     {
+                        aX[dx] += curl[qz][qy][qx][i] *
+                                  ((d == 0) ? Gc(qx,dx) :
+                                   (c == 0) ? Bo(qx,dx) : Bc(qx,dx));
+                     }
+                  }
+                  for (int dy = 0; dy < D1Dy; ++dy)
+                  {
+                     const double wy = (d == 1) ? Gc(qy,dy) :
+                                       (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                     for (int dx = 0; dx < D1Dx; ++dx)
+                     {
+                        aXY[dy][dx] += aX[dx] * wy;
+                     }
+                  }
+               }
+               for (int dz = 0; dz < D1Dz; ++dz)
+               {
+                  const double wz = sign[c][k] *
+                                    ((d == 2) ? Gc(qz,dz) :
+                                     (c == 2) ? Bo(qz,dz) : Bc(qz,dz));
+                  for (int dy = 0; dy < D1Dy; ++dy)
+                  {
+                     for (int dx = 0; dx < D1Dx; ++dx)
+                     {
+                        y(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) +=
+                           aXY[dy][dx] * wz;
+                     }
+                  }
+               }
+            }
+            osc += D1Dx * D1Dy * D1Dz;
+         }
+      }
+   });
+}
+
+// PA Curl-Curl Diagonal 2D kernel
+static void PACurlCurlAssembleDiagonal2D(const int D1D,
+                                         const int Q1D,
+                                         const int NE,
+                                         const Array<double> &_Bo,
+                                         const Array<double> &_Gc,
+                                         const Vector &_op,
+                                         Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 2; ++c)  // loop over x, y components
+      {
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double QD[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               QD[qx] = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Bo(qy,dy) : Gc(qy,dy);
+                  QD[qx] += wy * wy * op(qx,qy,e);
+               }
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               double val = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx = (c == 0) ? Bo(qx,dx) : Gc(qx,dx);
+                  val += wx * wx * QD[qx];
+               }
+               diag(dx + (dy * D1Dx) + osc, e) += val;
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA Curl-Curl Diagonal 3D kernel
+static void PACurlCurlAssembleDiagonal3D(const int D1D,
+                                         const int Q1D,
+                                         const int NE,
+                                         const Array<double> &_Bo,
+                                         const Array<double> &_Bc,
+                                         const Array<double> &_Gc,
+                                         const Vector &_op,
+                                         Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HCURL_MAX_D1D, "Error: D1D > HCURL_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HCURL_MAX_Q1D, "Error: Q1D > HCURL_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 3*(D1D-1)*D1D*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HCURL_MAX_Q1D;
+      const int curl_idx[3][2] = {{1, 2}, {0, 2}, {0, 1}};
+      const double sign[3][2] = {{1.0, -1.0}, {-1.0, 1.0}, {1.0, -1.0}};
+      const int der[3][2] = {{2, 1}, {2, 0}, {1, 0}};
+      // index of the entry (i,j), i <= j, in the symmetric 3x3 data
+      const int sym[3][3] = {{0, 1, 2}, {1, 3, 4}, {2, 4, 5}};
+
+      int osc = 0;
+      for (int c = 0; c < 3; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D - 1 : D1D;
+         const int D1Dy = (c == 1) ? D1D - 1 : D1D;
+         const int D1Dx = (c == 0) ? D1D - 1 : D1D;
+
+         // The diagonal entry is the sum of the separable terms
+         // s_k s_l O(i_k,i_l) curl_k curl_l over the pairs (k,l).
+         for (int k = 0; k < 2; ++k)
+         {
+            for (int l = k; l < 2; ++l)
+            {
+               const int o = sym[curl_idx[c][k]][curl_idx[c][l]];
+               const int dk = der[c][k], dl = der[c][l];
+               const double f = ((k == l) ? 1.0 : 2.0) *
+                                sign[c][k] * sign[c][l];
+
+               for (int dz = 0; dz < D1Dz; ++dz)
+               {
+                  double QQD[MQ1][MQ1];
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        QQD[qy][qx] = 0.0;
+                        for (int qz = 0; qz < Q1D; ++qz)
+                        {
+                           const double b = (c == 2) ? Bo(qz,dz) : Bc(qz,dz);
+                           const double wk = (dk == 2) ? Gc(qz,dz) : b;
+                           const double wl = (dl == 2) ? Gc(qz,dz) : b;
+                           QQD[qy][qx] += wk * wl * op(qx,qy,qz,o,e);
+                        }
+                     }
+                  }
+                  for (int dy = 0; dy < D1Dy; ++dy)
+                  {
+                     double QDD[MQ1];
+                     for (int qx = 0; qx < Q1D; ++qx)
+                     {
+                        QDD[qx] = 0.0;
+                        for (int qy = 0; qy < Q1D; ++qy)
+                        {
+                           const double b = (c == 1) ? Bo(qy,dy) : Bc(qy,dy);
+                           const double wk = (dk == 1) ? Gc(qy,dy) : b;
+                           const double wl = (dl == 1) ? Gc(qy,dy) : b;
+                           QDD[qx] += wk * wl * QQD[qy][qx];
+                        }
+                     }
+                     for (int dx = 0; dx < D1Dx; ++dx)
+                     {
+                        double val = 0.0;
+                        for (int qx = 0; qx < Q1D; ++qx)
+                        {
+                           const double b = (c == 0) ? Bo(qx,dx) : Bc(qx,dx);
+                           const double wk = (dk == 0) ? Gc(qx,dx) : b;
+                           const double wl = (dl == 0) ? Gc(qx,dx) : b;
+                           val += wk * wl * QDD[qx];
+                        }
+                        diag(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) +=
+                           f * val;
+                     }
+                  }
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+   });
+}
+
+void CurlCurlIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assumes tensor-product elements
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement *fel = fes.GetFE(0);
+   const VectorTensorFiniteElement *el =
+      dynamic_cast<const VectorTensorFiniteElement*>(fel);
+   MFEM_VERIFY(el != NULL && fel->GetMapType() == FiniteElement::H_CURL,
+               "PA is only supported for Nedelec elements on quadrilaterals "
+               "and hexahedra");
+   MFEM_VERIFY(MQ == NULL, "PA supports only scalar coefficients");
+   const IntegrationRule *ir = IntRule ? IntRule :
+                               &IntRules.Get(fel->GetGeomType(),
+                                             2*fel->GetOrder());
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   mapsC = &el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   MFEM_VERIFY(dofs1D == mapsO->ndof + 1 && quad1D == mapsO->nqpt, "");
+   Vector coeff;
+   PAEvalCoefficient(fes, *ir, Q, coeff);
+   if (dim == 3)
+   {
+      // W * coeff * J^T J / det(J), as in the H(div) mass integrator
+      pa_data.SetSize(6 * nq * ne, Device::GetMemoryType());
+      PAHdivSetup3D(quad1D, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   }
+   else
+   {
+      // W * coeff / det(J), as in the div-div integrator
+      pa_data.SetSize(nq * ne, Device::GetMemoryType());
+      PADivDivSetup(dim, nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   }
+}
+
+void CurlCurlIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (dim == 3)
+   {
+      PACurlCurlApply3D(dofs1D, quad1D, ne, mapsO->B, mapsC->B, mapsC->G,
+                        pa_data, x, y);
+   }
+   else if (dim == 2)
+   {
+      PACurlCurlApply2D(dofs1D, quad1D, ne, mapsO->B, mapsC->G, pa_data, x, y);
+   }
+   else
+   {
+      MFEM_ABORT("Unsupported dimension!");
+   }
+}
+
+void CurlCurlIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (dim == 3)
+   {
+      PACurlCurlAssembleDiagonal3D(dofs1D, quad1D, ne, mapsO->B, mapsC->B,
+                                   mapsC->G, pa_data, diag);
+   }
+   else if (dim == 2)
+   {
+      PACurlCurlAssembleDiagonal2D(dofs1D, quad1D, ne, mapsO->B, mapsC->G,
+                                   pa_data, diag);
+   }
+   else
+   {
+      MFEM_ABORT("Unsupported dimension!");
+   }
+}
+
+} // namespace mfem
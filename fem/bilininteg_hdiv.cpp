@@ -0,0 +1,1094 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "../general/forall.hpp"
+#include "bilininteg.hpp"
+#include "bilininteg_pa.hpp"
+#include "gridfunc.hpp"
+
+using namespace std;
+
+namespace mfem
+{
+
+// PA H(div) Mass Integrator and PA Div-Div Integrator
+
+// The E-vectors of the Raviart-Thomas elements on quadrilaterals and hexahedra
+// store the x, y (and z) components one after the other. Each component is
+// ordered lexicographically, using the closed basis (D1D dofs) in its own
+// direction and the open basis (D1D-1 dofs) in the other directions.
+
+// PA H(div) Mass Assemble 2D kernel, also used for the curl-curl operator of
+// the 3D Nedelec elements: W * coeff * J^T J / det(J).
+void PAHdivSetup2D(const int Q1D,
+                   const int NE,
+                   const Array<double> &w,
+                   const Vector &j,
+                   const Vector &c,
+                   Vector &op)
+{
+   const int NQ = Q1D*Q1D;
+   const bool const_c = c.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 2, 2, NE);
+   auto C = const_c ? Reshape(c.Read(), 1, 1) : Reshape(c.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, 3, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e);
+         const double J21 = J(q,1,0,e);
+         const double J12 = J(q,0,1,e);
+         const double J22 = J(q,1,1,e);
+         const double coeff = const_c ? C(0,0) : C(q,e);
+         const double c_detJ = W[q] * coeff / ((J11*J22)-(J21*J12));
+         y(q,0,e) = c_detJ * (J11*J11 + J21*J21); // 1,1
+         y(q,1,e) = c_detJ * (J11*J12 + J21*J22); // 1,2
+         y(q,2,e) = c_detJ * (J12*J12 + J22*J22); // 2,2
+      }
+   });
+}
+
+// PA H(div) Mass Assemble 3D kernel, see PAHdivSetup2D.
+void PAHdivSetup3D(const int Q1D,
+                   const int NE,
+                   const Array<double> &w,
+                   const Vector &j,
+                   const Vector &c,
+                   Vector &op)
+{
+   const int NQ = Q1D*Q1D*Q1D;
+   const bool const_c = c.Size() == 1;
+   auto W = w.Read();
+   auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+   auto C = const_c ? Reshape(c.Read(), 1, 1) : Reshape(c.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, 6, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int q = 0; q < NQ; ++q)
+      {
+         const double J11 = J(q,0,0,e);
+         const double J21 = J(q,1,0,e);
+         const double J31 = J(q,2,0,e);
+         const double J12 = J(q,0,1,e);
+         const double J22 = J(q,1,1,e);
+         const double J32 = J(q,2,1,e);
+         const double J13 = J(q,0,2,e);
+         const double J23 = J(q,1,2,e);
+         const double J33 = J(q,2,2,e);
+         const double detJ = J11 * (J22 * J33 - J32 * J23) -
+         /* */               J21 * (J12 * J33 - J32 * J13) +
+         /* */               J31 * (J12 * J23 - J22 * J13);
+         const double coeff = const_c ? C(0,0) : C(q,e);
+         const double c_detJ = W[q] * coeff / detJ;
+         y(q,0,e) = c_detJ * (J11*J11 + J21*J21 + J31*J31); // 1,1
+         y(q,1,e) = c_detJ * (J11*J12 + J21*J22 + J31*J32); // 1,2
+         y(q,2,e) = c_detJ * (J11*J13 + J21*J23 + J31*J33); // 1,3
+         y(q,3,e) = c_detJ * (J12*J12 + J22*J22 + J32*J32); // 2,2
+         y(q,4,e) = c_detJ * (J12*J13 + J22*J23 + J32*J33); // 2,3
+         y(q,5,e) = c_detJ * (J13*J13 + J23*J23 + J33*J33); // 3,3
+      }
+   });
+}
+
+// PA Div-Div Assemble kernel, also used for the curl-curl operator of the 2D
+// Nedelec elements: W * coeff / det(J).
+void PADivDivSetup(const int dim,
+                   const int NQ,
+                   const int NE,
+                   const Array<double> &w,
+                   const Vector &j,
+                   const Vector &c,
+                   Vector &op)
+{
+   const bool const_c = c.Size() == 1;
+   auto W = w.Read();
+   auto C = const_c ? Reshape(c.Read(), 1, 1) : Reshape(c.Read(), NQ, NE);
+   auto y = Reshape(op.Write(), NQ, NE);
+   if (dim == 2)
+   {
+      auto J = Reshape(j.Read(), NQ, 2, 2, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e);
+            const double J21 = J(q,1,0,e);
+            const double J12 = J(q,0,1,e);
+            const double J22 = J(q,1,1,e);
+            const double coeff = const_c ? C(0,0) : C(q,e);
+            y(q,e) = W[q] * coeff / ((J11*J22)-(J21*J12));
+         }
+      });
+   }
+   else if (dim == 3)
+   {
+      auto J = Reshape(j.Read(), NQ, 3, 3, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
+            const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
+            const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
+            const double detJ = J11 * (J22 * J33 - J32 * J23) -
+            /* */               J21 * (J12 * J33 - J32 * J13) +
+            /* */               J31 * (J12 * J23 - J22 * J13);
+            const double coeff = const_c ? C(0,0) : C(q,e);
+            y(q,e) = W[q] * coeff / detJ;
+         }
+      });
+   }
+   else
+   {
+      MFEM_ABORT("dim==" << dim << " is not supported");
+   }
+}
+
+// Evaluate the scalar coefficient Q at the quadrature points. A constant (or
+// NULL) coefficient is stored as a single value.
+void PAEvalCoefficient(const FiniteElementSpace &fes,
+                       const IntegrationRule &ir,
+                       Coefficient *Q,
+                       Vector &coeff)
+{
+   if (Q == NULL)
+   {
+      coeff.SetSize(1);
+      coeff(0) = 1.0;
+   }
+   else if (ConstantCoefficient* cQ = dynamic_cast<ConstantCoefficient*>(Q))
+   {
+      coeff.SetSize(1);
+      coeff(0) = cQ->constant;
+   }
+   else
+   {
+      const int ne = fes.GetNE();
+      const int nq = ir.GetNPoints();
+      coeff.SetSize(nq * ne);
+      auto C = Reshape(coeff.HostWrite(), nq, ne);
+      for (int e = 0; e < ne; ++e)
+      {
+         ElementTransformation& T = *fes.GetElementTransformation(e);
+         for (int q = 0; q < nq; ++q)
+         {
+            C(q,e) = Q->Eval(T, ir.IntPoint(q));
+         }
+      }
+   }
+}
+
+// PA H(div) Mass Apply 2D kernel
+void PAHdivMassApply2D(const int D1D,
+                       const int Q1D,
+                       const int NE,
+                       const Array<double> &_Bo,
+                       const Array<double> &_Bc,
+                       const Vector &_op,
+                       const Vector &_x,
+                       Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto x = Reshape(_x.Read(), 2*(D1D-1)*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 2;
+      constexpr int MD1 = HDIV_MAX_D1D;
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+
+      double mass[MQ1][MQ1][VDIM];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            for (int c = 0; c < VDIM; ++c)
+            {
+               mass[qy][qx][c] = 0.0;
+            }
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double massX[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               massX[qx] = 0.0;
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               const double t = x(dx + (dy * D1Dx) + osc, e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  massX[qx] += t * ((c == 0) ? Bc(qx,dx) : Bo(qx,dx));
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = (c == 1) ? Bc(qy,dy) : Bo(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  mass[qy][qx][c] += massX[qx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+
+      // apply the quadrature data
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double O11 = op(qx,qy,0,e);
+            const double O12 = op(qx,qy,1,e);
+            const double O22 = op(qx,qy,2,e);
+            const double massX = mass[qy][qx][0];
+            const double massY = mass[qy][qx][1];
+            mass[qy][qx][0] = (O11*massX)+(O12*massY);
+            mass[qy][qx][1] = (O12*massX)+(O22*massY);
+         }
+      }
+
+      osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double massX[MD1];
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               massX[dx] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  massX[dx] += mass[qy][qx][c] *
+                               ((c == 0) ? Bc(qx,dx) : Bo(qx,dx));
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               const double wy = (c == 1) ? Bc(qy,dy) : Bo(qy,dy);
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  y(dx + (dy * D1Dx) + osc, e) += massX[dx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA H(div) Mass Apply 3D kernel
+void PAHdivMassApply3D(const int D1D,
+                       const int Q1D,
+                       const int NE,
+                       const Array<double> &_Bo,
+                       const Array<double> &_Bc,
+                       const Vector &_op,
+                       const Vector &_x,
+                       Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto x = Reshape(_x.Read(), 3*(D1D-1)*(D1D-1)*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 3*(D1D-1)*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 3;
+      constexpr int MD1 = HDIV_MAX_D1D;
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+
+      double mass[MQ1][MQ1][MQ1][VDIM];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int c = 0; c < VDIM; ++c)
+               {
+                  mass[qz][qy][qx][c] = 0.0;
+               }
+            }
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            double massXY[MQ1][MQ1];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  massXY[qy][qx] = 0.0;
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               double massX[MQ1];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  massX[qx] = 0.0;
+               }
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  const double t = x(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     massX[qx] += t * ((c == 0) ? Bc(qx,dx) : Bo(qx,dx));
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Bc(qy,dy) : Bo(qy,dy);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     massXY[qy][qx] += massX[qx] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz = (c == 2) ? Bc(qz,dz) : Bo(qz,dz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     mass[qz][qy][qx][c] += massXY[qy][qx] * wz;
+                  }
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+
+      // apply the quadrature data
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double O11 = op(qx,qy,qz,0,e);
+               const double O12 = op(qx,qy,qz,1,e);
+               const double O13 = op(qx,qy,qz,2,e);
+               const double O22 = op(qx,qy,qz,3,e);
+               const double O23 = op(qx,qy,qz,4,e);
+               const double O33 = op(qx,qy,qz,5,e);
+               const double massX = mass[qz][qy][qx][0];
+               const double massY = mass[qz][qy][qx][1];
+               const double massZ = mass[qz][qy][qx][2];
+               mass[qz][qy][qx][0] = (O11*massX)+(O12*massY)+(O13*massZ);
+               mass[qz][qy][qx][1] = (O12*massX)+(O22*massY)+(O23*massZ);
+               mass[qz][qy][qx][2] = (O13*massX)+(O23*massY)+(O33*massZ);
+            }
+         }
+      }
+
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double massXY[MD1][MD1];
+
+         osc = 0;
+         for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+         {
+            const int D1Dz = (c == 2) ? D1D : D1D - 1;
+            const int D1Dy = (c == 1) ? D1D : D1D - 1;
+            const int D1Dx = (c == 0) ? D1D : D1D - 1;
+
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  massXY[dy][dx] = 0.0;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               double massX[MD1];
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  massX[dx] = 0.0;
+               }
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     massX[dx] += mass[qz][qy][qx][c] *
+                                  ((c == 0) ? Bc(qx,dx) : Bo(qx,dx));
+                  }
+               }
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  const double wy = (c == 1) ? Bc(qy,dy) : Bo(qy,dy);
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     massXY[dy][dx] += massX[dx] * wy;
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1Dz; ++dz)
+            {
+               const double wz = (c == 2) ? Bc(qz,dz) : Bo(qz,dz);
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     y(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) +=
+                        massXY[dy][dx] * wz;
+                  }
+               }
+            }
+            osc += D1Dx * D1Dy * D1Dz;
+         }
+      }
+   });
+}
+
+// PA H(div) Mass Diagonal 2D kernel
+static void PAHdivMassAssembleDiagonal2D(const int D1D,
+                                         const int Q1D,
+                                         const int NE,
+                                         const Array<double> &_Bo,
+                                         const Array<double> &_Bc,
+                                         const Vector &_op,
+                                         Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, 3, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 2; ++c)  // loop over x, y components
+      {
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+         const int k = (c == 0) ? 0 : 2; // diagonal entry of the 2x2 data
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double QD[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               QD[qx] = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Bc(qy,dy) : Bo(qy,dy);
+                  QD[qx] += wy * wy * op(qx,qy,k,e);
+               }
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               double val = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx = (c == 0) ? Bc(qx,dx) : Bo(qx,dx);
+                  val += wx * wx * QD[qx];
+               }
+               diag(dx + (dy * D1Dx) + osc, e) += val;
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA H(div) Mass Diagonal 3D kernel
+static void PAHdivMassAssembleDiagonal3D(const int D1D,
+                                         const int Q1D,
+                                         const int NE,
+                                         const Array<double> &_Bo,
+                                         const Array<double> &_Bc,
+                                         const Vector &_op,
+                                         Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Bc = Reshape(_Bc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, 6, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 3*(D1D-1)*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 3; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int k = (c == 0) ? 0 : ((c == 1) ? 3 : 5);
+
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            double QQD[MQ1][MQ1];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  QQD[qy][qx] = 0.0;
+                  for (int qz = 0; qz < Q1D; ++qz)
+                  {
+                     const double wz = (c == 2) ? Bc(qz,dz) : Bo(qz,dz);
+                     QQD[qy][qx] += wz * wz * op(qx,qy,qz,k,e);
+                  }
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               double QDD[MQ1];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  QDD[qx] = 0.0;
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     const double wy = (c == 1) ? Bc(qy,dy) : Bo(qy,dy);
+                     QDD[qx] += wy * wy * QQD[qy][qx];
+                  }
+               }
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  double val = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     const double wx = (c == 0) ? Bc(qx,dx) : Bo(qx,dx);
+                     val += wx * wx * QDD[qx];
+                  }
+                  diag(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) += val;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+   });
+}
+
+void PAHdivMassAssembleDiagonal(const int dim,
+                                const int D1D,
+                                const int Q1D,
+                                const int NE,
+                                const Array<double> &Bo,
+                                const Array<double> &Bc,
+                                const Vector &op,
+                                Vector &diag)
+{
+   if (dim == 2)
+   {
+      return PAHdivMassAssembleDiagonal2D(D1D, Q1D, NE, Bo, Bc, op, diag);
+   }
+   else if (dim == 3)
+   {
+      return PAHdivMassAssembleDiagonal3D(D1D, Q1D, NE, Bo, Bc, op, diag);
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Div-Div Apply 2D kernel
+static void PADivDivApply2D(const int D1D,
+                            const int Q1D,
+                            const int NE,
+                            const Array<double> &_Bo,
+                            const Array<double> &_Gc,
+                            const Vector &_op,
+                            const Vector &_x,
+                            Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
+   auto x = Reshape(_x.Read(), 2*(D1D-1)*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 2;
+      constexpr int MD1 = HDIV_MAX_D1D;
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+
+      // reference divergence at the quadrature points
+      double div[MQ1][MQ1];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            div[qy][qx] = 0.0;
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double aX[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               aX[qx] = 0.0;
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               const double t = x(dx + (dy * D1Dx) + osc, e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  aX[qx] += t * ((c == 0) ? Gc(qx,dx) : Bo(qx,dx));
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = (c == 1) ? Gc(qy,dy) : Bo(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  div[qy][qx] += aX[qx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+
+      // apply the quadrature data
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            div[qy][qx] *= op(qx,qy,e);
+         }
+      }
+
+      osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y components
+      {
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double aX[MD1];
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               aX[dx] = 0.0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  aX[dx] += div[qy][qx] * ((c == 0) ? Gc(qx,dx) : Bo(qx,dx));
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               const double wy = (c == 1) ? Gc(qy,dy) : Bo(qy,dy);
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  y(dx + (dy * D1Dx) + osc, e) += aX[dx] * wy;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA Div-Div Apply 3D kernel
+static void PADivDivApply3D(const int D1D,
+                            const int Q1D,
+                            const int NE,
+                            const Array<double> &_Bo,
+                            const Array<double> &_Gc,
+                            const Vector &_op,
+                            const Vector &_x,
+                            Vector &_y)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, NE);
+   auto x = Reshape(_x.Read(), 3*(D1D-1)*(D1D-1)*D1D, NE);
+   auto y = Reshape(_y.ReadWrite(), 3*(D1D-1)*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int VDIM = 3;
+      constexpr int MD1 = HDIV_MAX_D1D;
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+
+      // reference divergence at the quadrature points
+      double div[MQ1][MQ1][MQ1];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               div[qz][qy][qx] = 0.0;
+            }
+         }
+      }
+
+      int osc = 0;
+      for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            double aXY[MQ1][MQ1];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  aXY[qy][qx] = 0.0;
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               double aX[MQ1];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  aX[qx] = 0.0;
+               }
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  const double t = x(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     aX[qx] += t * ((c == 0) ? Gc(qx,dx) : Bo(qx,dx));
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Gc(qy,dy) : Bo(qy,dy);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     aXY[qy][qx] += aX[qx] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz = (c == 2) ? Gc(qz,dz) : Bo(qz,dz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     div[qz][qy][qx] += aXY[qy][qx] * wz;
+                  }
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+
+      // apply the quadrature data
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               div[qz][qy][qx] *= op(qx,qy,qz,e);
+            }
+         }
+      }
+
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double aXY[MD1][MD1];
+
+         osc = 0;
+         for (int c = 0; c < VDIM; ++c)  // loop over x, y, z components
+         {
+            const int D1Dz = (c == 2) ? D1D : D1D - 1;
+            const int D1Dy = (c == 1) ? D1D : D1D - 1;
+            const int D1Dx = (c == 0) ? D1D : D1D - 1;
+
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  aXY[dy][dx] = 0.0;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               double aX[MD1];
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  aX[dx] = 0.0;
+               }
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     aX[dx] += div[qz][qy][qx] *
+                               ((c == 0) ? Gc(qx,dx) : Bo(qx,dx));
+                  }
+               }
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  const double wy = (c == 1) ? Gc(qy,dy) : Bo(qy,dy);
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     aXY[dy][dx] += aX[dx] * wy;
+                  }
+               }
+            }
+            for (int dz = 0; dz < D1Dz; ++dz)
+            {
+               const double wz = (c == 2) ? Gc(qz,dz) : Bo(qz,dz);
+               for (int dy = 0; dy < D1Dy; ++dy)
+               {
+                  for (int dx = 0; dx < D1Dx; ++dx)
+                  {
+                     y(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) +=
+                        aXY[dy][dx] * wz;
+                  }
+               }
+            }
+            osc += D1Dx * D1Dy * D1Dz;
+         }
+      }
+   });
+}
+
+// PA Div-Div Diagonal 2D kernel
+static void PADivDivAssembleDiagonal2D(const int D1D,
+                                       const int Q1D,
+                                       const int NE,
+                                       const Array<double> &_Bo,
+                                       const Array<double> &_Gc,
+                                       const Vector &_op,
+                                       Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 2*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 2; ++c)  // loop over x, y components
+      {
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+
+         for (int dy = 0; dy < D1Dy; ++dy)
+         {
+            double QD[MQ1];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               QD[qx] = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy = (c == 1) ? Gc(qy,dy) : Bo(qy,dy);
+                  QD[qx] += wy * wy * op(qx,qy,e);
+               }
+            }
+            for (int dx = 0; dx < D1Dx; ++dx)
+            {
+               double val = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  const double wx = (c == 0) ? Gc(qx,dx) : Bo(qx,dx);
+                  val += wx * wx * QD[qx];
+               }
+               diag(dx + (dy * D1Dx) + osc, e) += val;
+            }
+         }
+         osc += D1Dx * D1Dy;
+      }
+   });
+}
+
+// PA Div-Div Diagonal 3D kernel
+static void PADivDivAssembleDiagonal3D(const int D1D,
+                                       const int Q1D,
+                                       const int NE,
+                                       const Array<double> &_Bo,
+                                       const Array<double> &_Gc,
+                                       const Vector &_op,
+                                       Vector &_diag)
+{
+   MFEM_VERIFY(D1D <= HDIV_MAX_D1D, "Error: D1D > HDIV_MAX_D1D");
+   MFEM_VERIFY(Q1D <= HDIV_MAX_Q1D, "Error: Q1D > HDIV_MAX_Q1D");
+   auto Bo = Reshape(_Bo.Read(), Q1D, D1D-1);
+   auto Gc = Reshape(_Gc.Read(), Q1D, D1D);
+   auto op = Reshape(_op.Read(), Q1D, Q1D, Q1D, NE);
+   auto diag = Reshape(_diag.ReadWrite(), 3*(D1D-1)*(D1D-1)*D1D, NE);
+
+   MFEM_FORALL(e, NE,
+   {
+      constexpr int MQ1 = HDIV_MAX_Q1D;
+      int osc = 0;
+      for (int c = 0; c < 3; ++c)  // loop over x, y, z components
+      {
+         const int D1Dz = (c == 2) ? D1D : D1D - 1;
+         const int D1Dy = (c == 1) ? D1D : D1D - 1;
+         const int D1Dx = (c == 0) ? D1D : D1D - 1;
+
+         for (int dz = 0; dz < D1Dz; ++dz)
+         {
+            double QQD[MQ1][MQ1];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  QQD[qy][qx] = 0.0;
+                  for (int qz = 0; qz < Q1D; ++qz)
+                  {
+                     const double wz = (c == 2) ? Gc(qz,dz) : Bo(qz,dz);
+                     QQD[qy][qx] += wz * wz * op(qx,qy,qz,e);
+                  }
+               }
+            }
+            for (int dy = 0; dy < D1Dy; ++dy)
+            {
+               double QDD[MQ1];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  QDD[qx] = 0.0;
+                  for (int qy = 0; qy < Q1D; ++qy)
+                  {
+                     const double wy = (c == 1) ? Gc(qy,dy) : Bo(qy,dy);
+                     QDD[qx] += wy * wy * QQD[qy][qx];
+                  }
+               }
+               for (int dx = 0; dx < D1Dx; ++dx)
+               {
+                  double val = 0.0;
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     const double wx = (c == 0) ? Gc(qx,dx) : Bo(qx,dx);
+                     val += wx * wx * QDD[qx];
+                  }
+                  diag(dx + ((dy + (dz * D1Dy)) * D1Dx) + osc, e) += val;
+               }
+            }
+         }
+         osc += D1Dx * D1Dy * D1Dz;
+      }
+   });
+}
+
+void DivDivIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   // Assumes tensor-product elements
+   Mesh *mesh = fes.GetMesh();
+   if (mesh->GetNE() == 0) { return; }
+   const FiniteElement *fel = fes.GetFE(0);
+   const VectorTensorFiniteElement *el =
+      dynamic_cast<const VectorTensorFiniteElement*>(fel);
+   MFEM_VERIFY(el != NULL && fel->GetMapType() == FiniteElement::H_DIV,
+               "PA is only supported for Raviart-Thomas elements on "
+               "quadrilaterals and hexahedra");
+   const IntegrationRule *ir = IntRule ? IntRule :
+                               &IntRules.Get(fel->GetGeomType(),
+                                             2*fel->GetOrder() - 2);
+   dim = mesh->Dimension();
+   ne = fes.GetNE();
+   nq = ir->GetNPoints();
+   geom = mesh->GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+   mapsC = &el->GetDofToQuad(*ir, DofToQuad::TENSOR);
+   mapsO = &el->GetDofToQuadOpen(*ir, DofToQuad::TENSOR);
+   dofs1D = mapsC->ndof;
+   quad1D = mapsC->nqpt;
+   MFEM_VERIFY(dofs1D == mapsO->ndof + 1 && quad1D == mapsO->nqpt, "");
+   pa_data.SetSize(nq * ne, Device::GetMemoryType());
+   Vector coeff;
+   PAEvalCoefficient(fes, *ir, Q, coeff);
+   PADivDivSetup(dim, nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+}
+
+void DivDivIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (dim == 3)
+   {
+      PADivDivApply3D(dofs1D, quad1D, ne, mapsO->B, mapsC->G, pa_data, x, y);
+   }
+   else if (dim == 2)
+   {
+      PADivDivApply2D(dofs1D, quad1D, ne, mapsO->B, mapsC->G, pa_data, x, y);
+   }
+   else
+   {
+      MFEM_ABORT("Unsupported dimension!");
+   }
+}
+
+void DivDivIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (dim == 3)
+   {
+      PADivDivAssembleDiagonal3D(dofs1D, quad1D, ne, mapsO->B, mapsC->G,
+                                 pa_data, diag);
+   }
+   else if (dim == 2)
+   {
+      PADivDivAssembleDiagonal2D(dofs1D, quad1D, ne, mapsO->B, mapsC->G,
+                                 pa_data, diag);
+   }
+   else
+   {
+      MFEM_ABORT("Unsupported dimension!");
+   }
+}
+
+} // namespace mfem
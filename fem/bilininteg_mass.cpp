@@ -10,7 +10,9 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "../general/forall.hpp"
+#include "../linalg/simd.hpp"
 #include "bilininteg.hpp"
+#include "bilininteg_pa.hpp"
 #include "gridfunc.hpp"
 
 using namespace std;
@@ -20,7 +22,62 @@ namespace mfem
 
 // PA Mass Integrator
 
-// PA Mass Assemble kernel
+// PA Mass Assemble kernel, also used by the matrix-free diagonal
+static void PAMassSetup(const int dim,
+                        const int NQ,
+                        const int NE,
+                        const Array<double> &w,
+                        const Vector &j,
+                        const Vector &coeff,
+                        Vector &op)
+{
+   if (dim==2)
+   {
+      const bool const_c = coeff.Size() == 1;
+      auto W = w.Read();
+      auto J = Reshape(j.Read(), NQ,2,2,NE);
+      auto C =
+         const_c ? Reshape(coeff.Read(), 1,1) : Reshape(coeff.Read(), NQ,NE);
+      auto v = Reshape(op.Write(), NQ, NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e);
+            const double J12 = J(q,1,0,e);
+            const double J21 = J(q,0,1,e);
+            const double J22 = J(q,1,1,e);
+            const double detJ = (J11*J22)-(J21*J12);
+            const double coeff = const_c ? C(0,0) : C(q,e);
+            v(q,e) =  W[q] * coeff * detJ;
+         }
+      });
+   }
+   if (dim==3)
+   {
+      const bool const_c = coeff.Size() == 1;
+      auto W = w.Read();
+      auto J = Reshape(j.Read(), NQ,3,3,NE);
+      auto C =
+         const_c ? Reshape(coeff.Read(), 1,1) : Reshape(coeff.Read(), NQ,NE);
+      auto v = Reshape(op.Write(), NQ,NE);
+      MFEM_FORALL(e, NE,
+      {
+         for (int q = 0; q < NQ; ++q)
+         {
+            const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
+            const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
+            const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
+            const double detJ = J11 * (J22 * J33 - J32 * J23) -
+            /* */               J21 * (J12 * J33 - J32 * J13) +
+            /* */               J31 * (J12 * J23 - J22 * J13);
+            const double coeff = const_c ? C(0,0) : C(q,e);
+            v(q,e) = W[q] * coeff * detJ;
+         }
+      });
+   }
+}
+
 void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
 {
    // Assuming the same element type
@@ -63,55 +120,8 @@ void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
       }
    }
    if (dim==1) { MFEM_ABORT("Not supported yet... stay tuned!"); }
-   if (dim==2)
-   {
-      const int NE = ne;
-      const int NQ = nq;
-      const bool const_c = coeff.Size() == 1;
-      auto w = ir->GetWeights().Read();
-      auto J = Reshape(geom->J.Read(), NQ,2,2,NE);
-      auto C =
-         const_c ? Reshape(coeff.Read(), 1,1) : Reshape(coeff.Read(), NQ,NE);
-      auto v = Reshape(pa_data.Write(), NQ, NE);
-      MFEM_FORALL(e, NE,
-      {
-         for (int q = 0; q < NQ; ++q)
-         {
-            const double J11 = J(q,0,0,e);
-            const double J12 = J(q,1,0,e);
-            const double J21 = J(q,0,1,e);
-            const double J22 = J(q,1,1,e);
-            const double detJ = (J11*J22)-(J21*J12);
-            const double coeff = const_c ? C(0,0) : C(q,e);
-            v(q,e) =  w[q] * coeff * detJ;
-         }
-      });
-   }
-   if (dim==3)
-   {
-      const int NE = ne;
-      const int NQ = nq;
-      const bool const_c = coeff.Size() == 1;
-      auto W = ir->GetWeights().Read();
-      auto J = Reshape(geom->J.Read(), NQ,3,3,NE);
-      auto C =
-         const_c ? Reshape(coeff.Read(), 1,1) : Reshape(coeff.Read(), NQ,NE);
-      auto v = Reshape(pa_data.Write(), NQ,NE);
-      MFEM_FORALL(e, NE,
-      {
-         for (int q = 0; q < NQ; ++q)
-         {
-            const double J11 = J(q,0,0,e), J12 = J(q,0,1,e), J13 = J(q,0,2,e);
-            const double J21 = J(q,1,0,e), J22 = J(q,1,1,e), J23 = J(q,1,2,e);
-            const double J31 = J(q,2,0,e), J32 = J(q,2,1,e), J33 = J(q,2,2,e);
-            const double detJ = J11 * (J22 * J33 - J32 * J23) -
-            /* */               J21 * (J12 * J33 - J32 * J13) +
-            /* */               J31 * (J12 * J23 - J22 * J13);
-            const double coeff = const_c ? C(0,0) : C(q,e);
-            v(q,e) = W[q] * coeff * detJ;
-         }
-      });
-   }
+   PAMassSetup(dim, nq, ne, ir->GetWeights(), geom->J, coeff, pa_data);
+   if (pa_single) { PAToSinglePrecision(pa_data, pa_data_sp); }
 }
 
 #ifdef MFEM_USE_OCCA
@@ -207,15 +217,17 @@ static void OccaPAMassApply3D(const int D1D,
 #endif // MFEM_USE_OCCA
 
 template<const int T_D1D = 0,
-         const int T_Q1D = 0>
+         const int T_Q1D = 0,
+         typename OP = Vector>
 static void PAMassApply2D(const int NE,
                           const Array<double> &B_,
                           const Array<double> &Bt_,
-                          const Vector &op_,
+                          const OP &op_,
                           const Vector &x_,
                           Vector &y_,
                           const int d1d = 0,
-                          const int q1d = 0)
+                          const int q1d = 0,
+                          const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -224,10 +236,11 @@ static void PAMassApply2D(const int NE,
    auto B = Reshape(B_.Read(), Q1D, D1D);
    auto Bt = Reshape(Bt_.Read(), D1D, Q1D);
    auto op = Reshape(op_.Read(), Q1D, Q1D, NE);
-   auto x = Reshape(x_.Read(), D1D, D1D, NE);
-   auto y = Reshape(y_.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   auto x = Reshape(x_.Read(), D1D, D1D, NE*nv);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, NE*nv);
+   MFEM_FORALL(ev, NE*nv,
    {
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       // the following variables are evaluated at compile time
@@ -250,7 +263,7 @@ static void PAMassApply2D(const int NE,
          }
          for (int dx = 0; dx < D1D; ++dx)
          {
-            const double s = x(dx,dy,e);
+            const double s = x(dx,dy,ex);
             for (int qx = 0; qx < Q1D; ++qx)
             {
                sol_x[qx] += B(qx,dx)* s;
@@ -292,7 +305,7 @@ static void PAMassApply2D(const int NE,
             const double q2d = Bt(dy,qy);
             for (int dx = 0; dx < D1D; ++dx)
             {
-               y(dx,dy,e) += q2d * sol_x[dx];
+               y(dx,dy,ex) += q2d * sol_x[dx];
             }
          }
       }
@@ -301,15 +314,17 @@ static void PAMassApply2D(const int NE,
 
 template<const int T_D1D = 0,
          const int T_Q1D = 0,
-         const int T_NBZ = 0>
+         const int T_NBZ = 0,
+         typename OP = Vector>
 static void SmemPAMassApply2D(const int NE,
                               const Array<double> &b_,
                               const Array<double> &bt_,
-                              const Vector &op_,
+                              const OP &op_,
                               const Vector &x_,
                               Vector &y_,
                               const int d1d = 0,
-                              const int q1d = 0)
+                              const int q1d = 0,
+                              const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -320,11 +335,12 @@ static void SmemPAMassApply2D(const int NE,
    MFEM_VERIFY(Q1D <= MQ1, "");
    auto b = Reshape(b_.Read(), Q1D, D1D);
    auto op = Reshape(op_.Read(), Q1D, Q1D, NE);
-   auto x = Reshape(x_.Read(), D1D, D1D, NE);
-   auto y = Reshape(y_.ReadWrite(), D1D, D1D, NE);
-   MFEM_FORALL_2D(e, NE, Q1D, Q1D, NBZ,
+   auto x = Reshape(x_.Read(), D1D, D1D, NE*nv);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, NE*nv);
+   MFEM_FORALL_2D(ev, NE*nv, Q1D, Q1D, NBZ,
    {
       const int tidz = MFEM_THREAD_ID(z);
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int NBZ = T_NBZ ? T_NBZ : 1;
@@ -344,7 +360,7 @@ static void SmemPAMassApply2D(const int NE,
       {
          MFEM_FOREACH_THREAD(dx,x,D1D)
          {
-            X[dy][dx] = x(dx,dy,e);
+            X[dy][dx] = x(dx,dy,ex);
          }
       }
       if (tidz == 0)
@@ -417,22 +433,37 @@ static void SmemPAMassApply2D(const int NE,
             {
                dd += (QD[qy][dx] * Bt[dy][qy]);
             }
-            y(dx, dy, e) += dd;
+            y(dx, dy, ex) += dd;
          }
       }
    });
 }
 
+// Estimates of the floating point operations and of the bytes moved per
+// element by the 3D PA mass action, see MFEM_KERNEL_INFO.
+static double PAMassApply3DFlops(const int D1D, const int Q1D)
+{
+   const double D = D1D, Q = Q1D;
+   return 4.0*(D*D*D*Q + D*D*Q*Q + D*Q*Q*Q) + Q*Q*Q;
+}
+
+static double PAMassApply3DBytes(const int D1D, const int Q1D)
+{
+   return sizeof(double)*(3.0*D1D*D1D*D1D + 1.0*Q1D*Q1D*Q1D);
+}
+
 template<const int T_D1D = 0,
-         const int T_Q1D = 0>
+         const int T_Q1D = 0,
+         typename OP = Vector>
 static void PAMassApply3D(const int NE,
                           const Array<double> &B_,
                           const Array<double> &Bt_,
-                          const Vector &op_,
+                          const OP &op_,
                           const Vector &x_,
                           Vector &y_,
                           const int d1d = 0,
-                          const int q1d = 0)
+                          const int q1d = 0,
+                          const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -441,10 +472,13 @@ static void PAMassApply3D(const int NE,
    auto B = Reshape(B_.Read(), Q1D, D1D);
    auto Bt = Reshape(Bt_.Read(), D1D, Q1D);
    auto op = Reshape(op_.Read(), Q1D, Q1D, Q1D, NE);
-   auto x = Reshape(x_.Read(), D1D, D1D, D1D, NE);
-   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL(e, NE,
+   auto x = Reshape(x_.Read(), D1D, D1D, D1D, NE*nv);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE*nv);
+   MFEM_KERNEL_INFO("PAMassApply3D", PAMassApply3DFlops(D1D, Q1D),
+                    PAMassApply3DBytes(D1D, Q1D));
+   MFEM_FORALL(ev, NE*nv,
    {
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
@@ -479,7 +513,7 @@ static void PAMassApply3D(const int NE,
             }
             for (int dx = 0; dx < D1D; ++dx)
             {
-               const double s = x(dx,dy,dz,e);
+               const double s = x(dx,dy,dz,ex);
                for (int qx = 0; qx < Q1D; ++qx)
                {
                   sol_x[qx] += B(qx,dx) * s;
@@ -557,7 +591,7 @@ static void PAMassApply3D(const int NE,
             {
                for (int dx = 0; dx < D1D; ++dx)
                {
-                  y(dx,dy,dz,e) += wz * sol_xy[dy][dx];
+                  y(dx,dy,dz,ex) += wz * sol_xy[dy][dx];
                }
             }
          }
@@ -566,15 +600,17 @@ static void PAMassApply3D(const int NE,
 }
 
 template<const int T_D1D = 0,
-         const int T_Q1D = 0>
+         const int T_Q1D = 0,
+         typename OP = Vector>
 static void SmemPAMassApply3D(const int NE,
                               const Array<double> &b_,
                               const Array<double> &bt_,
-                              const Vector &op_,
+                              const OP &op_,
                               const Vector &x_,
                               Vector &y_,
                               const int d1d = 0,
-                              const int q1d = 0)
+                              const int q1d = 0,
+                              const int nv = 1)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
    const int Q1D = T_Q1D ? T_Q1D : q1d;
@@ -584,11 +620,14 @@ static void SmemPAMassApply3D(const int NE,
    MFEM_VERIFY(Q1D <= M1Q, "");
    auto b = Reshape(b_.Read(), Q1D, D1D);
    auto op = Reshape(op_.Read(), Q1D, Q1D, Q1D, NE);
-   auto x = Reshape(x_.Read(), D1D, D1D, D1D, NE);
-   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE);
-   MFEM_FORALL_3D(e, NE, Q1D, Q1D, Q1D,
+   auto x = Reshape(x_.Read(), D1D, D1D, D1D, NE*nv);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE*nv);
+   MFEM_KERNEL_INFO("SmemPAMassApply3D", PAMassApply3DFlops(D1D, Q1D),
+                    PAMassApply3DBytes(D1D, Q1D));
+   MFEM_FORALL_3D(ev, NE*nv, Q1D, Q1D, Q1D,
    {
       const int tidz = MFEM_THREAD_ID(z);
+      const int e = ev / nv, ex = ev % nv * NE + e;
       const int D1D = T_D1D ? T_D1D : d1d;
       const int Q1D = T_Q1D ? T_Q1D : q1d;
       constexpr int MQ1 = T_Q1D ? T_Q1D : MAX_Q1D;
@@ -611,7 +650,7 @@ static void SmemPAMassApply3D(const int NE,
          {
             MFEM_FOREACH_THREAD(dx,x,D1D)
             {
-               X[dz][dy][dx] = x(dx,dy,dz,e);
+               X[dz][dy][dx] = x(dx,dy,dz,ex);
             }
          }
       }
@@ -728,74 +767,1607 @@ static void SmemPAMassApply3D(const int NE,
                {
                   u += QDD[qz][dy][dx] * Bt[dz][qz];
                }
-               y(dx,dy,dz,e) += u;
+               y(dx,dy,dz,ex) += u;
             }
          }
       }
    });
 }
 
-static void PAMassApply(const int dim,
-                        const int D1D,
-                        const int Q1D,
-                        const int NE,
-                        const Array<double> &B,
-                        const Array<double> &Bt,
-                        const Vector &op,
-                        const Vector &x,
-                        Vector &y)
+// SIMD PA Mass Apply 3D kernel for the host, processing the elements in
+// batches of SIMD_DOUBLES, see SimdPADiffusionApply3D.
+template<const int T_D1D, const int T_Q1D> static
+void SimdPAMassApply3D(const int NE,
+                       const int NC,
+                       const int *elements,
+                       const int *gather,
+                       const Array<double> &B_,
+                       const Vector &op_,
+                       const Vector &x_,
+                       Vector &y_)
 {
-#ifdef MFEM_USE_OCCA
-   if (DeviceCanUseOcca())
+   constexpr int D1D = T_D1D;
+   constexpr int Q1D = T_Q1D;
+   constexpr int ND = D1D*D1D*D1D;
+   constexpr int VL = SIMD_DOUBLES;
+   auto B = Reshape(B_.HostRead(), Q1D, D1D);
+   auto op = Reshape(op_.HostRead(), Q1D, Q1D, Q1D, NE);
+   const double *x = x_.HostRead();
+   double *y = y_.HostReadWrite();
+   const int NB = (NC + VL - 1) / VL;
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int k = 0; k < NB; k++)
    {
-      if (dim == 2)
+      // Elements of the batch
+      const int NV = (NC - k*VL < VL) ? NC - k*VL : VL;
+      int e[VL];
+      for (int v = 0; v < NV; ++v)
       {
-         OccaPAMassApply2D(D1D, Q1D, NE, B, Bt, op, x, y);
-         return;
+         e[v] = elements ? elements[k*VL + v] : k*VL + v;
       }
-      if (dim == 3)
+      // Dofs of the batch, zero in the unused lanes
+      simd_double u[D1D][D1D][D1D];
+      for (int dz = 0; dz < D1D; ++dz)
       {
-         OccaPAMassApply3D(D1D, Q1D, NE, B, Bt, op, x, y);
-         return;
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               simd_double s = simd_double();
+               for (int v = 0; v < NV; ++v)
+               {
+                  const int i = dx + D1D*(dy + D1D*dz) + ND*e[v];
+                  const int j = gather ? gather[i] : i;
+                  s[v] = (j >= 0) ? x[j] : -x[-1-j];
+               }
+               u[dz][dy][dx] = s;
+            }
+         }
       }
-      MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
-   }
-#endif // MFEM_USE_OCCA
-   if (dim == 2)
-   {
-      switch ((D1D << 4) | Q1D)
+      simd_double sol_xyz[Q1D][Q1D][Q1D];
+      for (int qz = 0; qz < Q1D; ++qz)
       {
-         case 0x22: return SmemPAMassApply2D<2,2,16>(NE, B, Bt, op, x, y);
-         case 0x33: return SmemPAMassApply2D<3,3,16>(NE, B, Bt, op, x, y);
-         case 0x44: return SmemPAMassApply2D<4,4,8>(NE, B, Bt, op, x, y);
-         case 0x55: return SmemPAMassApply2D<5,5,8>(NE, B, Bt, op, x, y);
-         case 0x66: return SmemPAMassApply2D<6,6,4>(NE, B, Bt, op, x, y);
-         case 0x77: return SmemPAMassApply2D<7,7,4>(NE, B, Bt, op, x, y);
-         case 0x88: return SmemPAMassApply2D<8,8,2>(NE, B, Bt, op, x, y);
-         case 0x99: return SmemPAMassApply2D<9,9,2>(NE, B, Bt, op, x, y);
-         default:   return PAMassApply2D(NE, B, Bt, op, x, y, D1D, Q1D);
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] = simd_double();
+            }
+         }
       }
-   }
-   else if (dim == 3)
-   {
-      switch ((D1D << 4) | Q1D)
+      for (int dz = 0; dz < D1D; ++dz)
       {
-         case 0x23: return SmemPAMassApply3D<2,3>(NE, B, Bt, op, x, y);
-         case 0x34: return SmemPAMassApply3D<3,4>(NE, B, Bt, op, x, y);
-         case 0x45: return SmemPAMassApply3D<4,5>(NE, B, Bt, op, x, y);
-         case 0x56: return SmemPAMassApply3D<5,6>(NE, B, Bt, op, x, y);
-         case 0x67: return SmemPAMassApply3D<6,7>(NE, B, Bt, op, x, y);
-         case 0x78: return SmemPAMassApply3D<7,8>(NE, B, Bt, op, x, y);
-         case 0x89: return SmemPAMassApply3D<8,9>(NE, B, Bt, op, x, y);
-         default:   return PAMassApply3D(NE, B, Bt, op, x, y, D1D, Q1D);
+         simd_double sol_xy[Q1D][Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] = simd_double();
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            simd_double sol_x[Q1D];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] = simd_double();
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const simd_double s = u[dz][dy][dx];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_x[qx] += B(qx,dx) * s;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = B(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xy[qy][qx] += wy * sol_x[qx];
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz = B(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xyz[qz][qy][qx] += wz * sol_xy[qy][qx];
+               }
+            }
+         }
       }
-   }
-   MFEM_ABORT("Unknown kernel.");
-}
-
-void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
-{
-   PAMassApply(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data, x, y);
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               simd_double D = simd_double();
+               for (int v = 0; v < NV; ++v) { D[v] = op(qx,qy,qz,e[v]); }
+               sol_xyz[qz][qy][qx] *= D;
+            }
+         }
+      }
+      // The result of the batch is accumulated in u
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               u[dz][dy][dx] = simd_double();
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         simd_double sol_xy[D1D][D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_xy[dy][dx] = simd_double();
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            simd_double sol_x[D1D];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] = simd_double();
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const simd_double s = sol_xyz[qz][qy][qx];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_x[dx] += B(qx,dx) * s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy = B(qy,dy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_xy[dy][dx] += wy * sol_x[dx];
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz = B(qz,dz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  u[dz][dy][dx] += wz * sol_xy[dy][dx];
+               }
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               for (int v = 0; v < NV; ++v)
+               {
+                  const int i = dx + D1D*(dy + D1D*dz) + ND*e[v];
+                  const int j = gather ? gather[i] : i;
+                  if (j >= 0) { y[j] += u[dz][dy][dx][v]; }
+                  else { y[-1-j] -= u[dz][dy][dx][v]; }
+               }
+            }
+         }
+      }
+   }
+}
+
+// Signature of the SIMD PA Mass Apply kernels
+typedef void (*PAMassApplySimdKernel)(const int NE,
+                                      const int NC,
+                                      const int *elements,
+                                      const int *gather,
+                                      const Array<double> &B,
+                                      const Vector &op,
+                                      const Vector &x,
+                                      Vector &y);
+
+// Register the 3D SIMD kernels for D1D = 2,...,T_D1D with Q1D = D1D and
+// Q1D = D1D + 1.
+template<int T_D1D>
+struct PAMassApplySimdRegistrar
+{
+   static void Add(PAKernelTable<PAMassApplySimdKernel> &table)
+   {
+      constexpr int D = T_D1D;
+      table.Add(3, D, D, SimdPAMassApply3D<D,D>);
+      table.Add(3, D, D+1, SimdPAMassApply3D<D,D+1>);
+      PAMassApplySimdRegistrar<T_D1D-1>::Add(table);
+   }
+};
+
+template<>
+struct PAMassApplySimdRegistrar<1>
+{
+   static void Add(PAKernelTable<PAMassApplySimdKernel> &) { }
+};
+
+// Table of the SIMD PA Mass Apply kernels
+static const PAKernelTable<PAMassApplySimdKernel> &PAMassApplySimdKernels()
+{
+   struct Table : PAKernelTable<PAMassApplySimdKernel>
+   {
+      Table() { PAMassApplySimdRegistrar<PA_SPECIALIZED_MAX_D1D>::Add(*this); }
+   };
+   static const Table table;
+   return table;
+}
+
+// Signature of the PA Mass Apply kernels
+typedef void (*PAMassApplyKernel)(const int NE,
+                                  const Array<double> &B,
+                                  const Array<double> &Bt,
+                                  const Vector &op,
+                                  const Vector &x,
+                                  Vector &y,
+                                  const int d1d,
+                                  const int q1d,
+                                  const int nv);
+
+// Signature of the PA Mass Apply kernels with single precision data
+typedef void (*PAMassApplySPKernel)(const int NE,
+                                    const Array<double> &B,
+                                    const Array<double> &Bt,
+                                    const Array<float> &op,
+                                    const Vector &x,
+                                    Vector &y,
+                                    const int d1d,
+                                    const int q1d,
+                                    const int nv);
+
+// Number of elements per thread block of the 2D shared memory kernels
+static constexpr int PAMassNBZ(const int D1D)
+{
+   return D1D <= 3 ? 16 : D1D <= 5 ? 8 : D1D <= 7 ? 4 : 2;
+}
+
+// Register the shared memory kernels for D1D = 2,...,T_D1D with Q1D = D1D
+// (e.g. Gauss-Lobatto rules) and Q1D = D1D + 1 (the default Gauss rules), for
+// double (PAMassApplyKernel) or single (PAMassApplySPKernel) precision data.
+template<int T_D1D, typename Kernel = PAMassApplyKernel>
+struct PAMassApplyRegistrar
+{
+   static void Add(PAKernelTable<Kernel> &table)
+   {
+      constexpr int D = T_D1D, NBZ = PAMassNBZ(T_D1D);
+      table.Add(2, D, D, SmemPAMassApply2D<D,D,NBZ>);
+      table.Add(2, D, D+1, SmemPAMassApply2D<D,D+1,NBZ>);
+      table.Add(3, D, D, SmemPAMassApply3D<D,D>);
+      table.Add(3, D, D+1, SmemPAMassApply3D<D,D+1>);
+      PAMassApplyRegistrar<T_D1D-1,Kernel>::Add(table);
+   }
+};
+
+template<typename Kernel>
+struct PAMassApplyRegistrar<1,Kernel>
+{
+   static void Add(PAKernelTable<Kernel> &) { }
+};
+
+// Table of the specialized PA Mass Apply kernels, built on first use
+static const PAKernelTable<PAMassApplyKernel> &PAMassApplyKernels()
+{
+   struct Table : PAKernelTable<PAMassApplyKernel>
+   {
+      Table() { PAMassApplyRegistrar<PA_SPECIALIZED_MAX_D1D>::Add(*this); }
+   };
+   static const Table table;
+   return table;
+}
+
+// Table of the specialized PA Mass Apply kernels with single precision data
+static const PAKernelTable<PAMassApplySPKernel> &PAMassApplySPKernels()
+{
+   struct Table : PAKernelTable<PAMassApplySPKernel>
+   {
+      Table()
+      {
+         PAMassApplyRegistrar<PA_SPECIALIZED_MAX_D1D,
+                              PAMassApplySPKernel>::Add(*this);
+      }
+   };
+   static const Table table;
+   return table;
+}
+
+static void PAMassApply(const int dim,
+                        const int D1D,
+                        const int Q1D,
+                        const int NE,
+                        const Array<double> &B,
+                        const Array<double> &Bt,
+                        const Vector &op,
+                        const Vector &x,
+                        Vector &y,
+                        const int nv = 1)
+{
+#ifdef MFEM_USE_OCCA
+   if (DeviceCanUseOcca())
+   {
+      if (dim == 2)
+      {
+         OccaPAMassApply2D(D1D, Q1D, NE, B, Bt, op, x, y);
+         return;
+      }
+      if (dim == 3)
+      {
+         OccaPAMassApply3D(D1D, Q1D, NE, B, Bt, op, x, y);
+         return;
+      }
+      MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
+   }
+#endif // MFEM_USE_OCCA
+   if (nv == 1 && PAUseSimdKernels())
+   {
+      const PAMassApplySimdKernel simd =
+         PAMassApplySimdKernels().Find(dim, D1D, Q1D);
+      if (simd) { return simd(NE, NE, NULL, NULL, B, op, x, y); }
+   }
+   const PAMassApplyKernel kernel = PAMassApplyKernels().Find(dim, D1D, Q1D);
+   if (kernel) { return kernel(NE, B, Bt, op, x, y, D1D, Q1D, nv); }
+   if (dim == 2) { return PAMassApply2D(NE, B, Bt, op, x, y, D1D, Q1D, nv); }
+   if (dim == 3) { return PAMassApply3D(NE, B, Bt, op, x, y, D1D, Q1D, nv); }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// PA Mass Apply with single precision data, see SetSinglePrecisionPA()
+static void PAMassApplySP(const int dim,
+                          const int D1D,
+                          const int Q1D,
+                          const int NE,
+                          const Array<double> &B,
+                          const Array<double> &Bt,
+                          const Array<float> &op,
+                          const Vector &x,
+                          Vector &y,
+                          const int nv = 1)
+{
+   const PAMassApplySPKernel kernel =
+      PAMassApplySPKernels().Find(dim, D1D, Q1D);
+   if (kernel) { return kernel(NE, B, Bt, op, x, y, D1D, Q1D, nv); }
+   if (dim == 2) { return PAMassApply2D(NE, B, Bt, op, x, y, D1D, Q1D, nv); }
+   if (dim == 3) { return PAMassApply3D(NE, B, Bt, op, x, y, D1D, Q1D, nv); }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_single)
+   {
+      PAMassApplySP(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data_sp,
+                    x, y);
+      return;
+   }
+   PAMassApply(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data, x, y);
+}
+
+// PA Mass Apply kernel on a block of E-vectors: the quadrature data of each
+// element is used for all the vectors of the block in turn.
+void MassIntegrator::AddMultiMultPA(const MultiVector &X, MultiVector &Y) const
+{
+#ifdef MFEM_USE_OCCA
+   if (DeviceCanUseOcca())
+   {
+      BilinearFormIntegrator::AddMultiMultPA(X, Y);
+      return;
+   }
+#endif // MFEM_USE_OCCA
+   if (pa_single)
+   {
+      PAMassApplySP(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data_sp,
+                    X, Y, X.NumVectors());
+      return;
+   }
+   PAMassApply(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, pa_data,
+               X, Y, X.NumVectors());
+}
+
+// PA Mass Apply 2D kernel on L-vectors: gathers the element dofs with the
+// map of the element restriction, applies the quadrature data and scatters
+// the result, for the NC elements of one color (all elements if elements
+// is NULL).
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void PAMassApplyFused2D(const int NE,
+                               const int NC,
+                               const int *elements,
+                               const Array<int> &gather,
+                               const Array<double> &B_,
+                               const Array<double> &Bt_,
+                               const Vector &op_,
+                               const Vector &x_,
+                               Vector &y_,
+                               const int d1d = 0,
+                               const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(B_.Read(), Q1D, D1D);
+   auto Bt = Reshape(Bt_.Read(), D1D, Q1D);
+   auto op = Reshape(op_.Read(), Q1D, Q1D, NE);
+   auto map = Reshape(gather.Read(), D1D, D1D, NE);
+   auto x = x_.Read();
+   auto y = y_.ReadWrite();
+   MFEM_FORALL(k, NC,
+   {
+      const int e = elements ? elements[k] : k;
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double sol[max_D1D][max_D1D];
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            sol[dy][dx] = 0.0;
+         }
+      }
+      double sol_xy[max_Q1D][max_Q1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_xy[qy][qx] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double sol_x[max_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            sol_x[qy] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const int j = map(dx,dy,e);
+            const double s = (j >= 0) ? x[j] : -x[-1-j];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] += B(qx,dx)* s;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double d2q = B(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] += d2q * sol_x[qx];
+            }
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_xy[qy][qx] *= op(qx,qy,e);
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double sol_x[max_D1D];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            sol_x[dx] = 0.0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double s = sol_xy[qy][qx];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] += Bt(dx,qx) * s;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double q2d = Bt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol[dy][dx] += q2d * sol_x[dx];
+            }
+         }
+      }
+      // Scatter to the L-vector, no other element of this color shares dofs
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const int j = map(dx,dy,e);
+            if (j >= 0) { y[j] += sol[dy][dx]; }
+            else { y[-1-j] -= sol[dy][dx]; }
+         }
+      }
+   });
+}
+
+// PA Mass Apply 3D kernel on L-vectors
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void PAMassApplyFused3D(const int NE,
+                               const int NC,
+                               const int *elements,
+                               const Array<int> &gather,
+                               const Array<double> &B_,
+                               const Array<double> &Bt_,
+                               const Vector &op_,
+                               const Vector &x_,
+                               Vector &y_,
+                               const int d1d = 0,
+                               const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(B_.Read(), Q1D, D1D);
+   auto Bt = Reshape(Bt_.Read(), D1D, Q1D);
+   auto op = Reshape(op_.Read(), Q1D, Q1D, Q1D, NE);
+   auto map = Reshape(gather.Read(), D1D, D1D, D1D, NE);
+   auto x = x_.Read();
+   auto y = y_.ReadWrite();
+   MFEM_FORALL(k, NC,
+   {
+      const int e = elements ? elements[k] : k;
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double sol[max_D1D][max_D1D][max_D1D];
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol[dz][dy][dx] = 0.0;
+            }
+         }
+      }
+      double sol_xyz[max_Q1D][max_Q1D][max_Q1D];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double sol_xy[max_Q1D][max_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double sol_x[max_Q1D];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] = 0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const int j = map(dx,dy,dz,e);
+               const double s = (j >= 0) ? x[j] : -x[-1-j];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_x[qx] += B(qx,dx) * s;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = B(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xy[qy][qx] += wy * sol_x[qx];
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz = B(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xyz[qz][qy][qx] += wz * sol_xy[qy][qx];
+               }
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] *= op(qx,qy,qz,e);
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double sol_xy[max_D1D][max_D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_xy[dy][dx] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double sol_x[max_D1D];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double s = sol_xyz[qz][qy][qx];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_x[dx] += Bt(dx,qx) * s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy = Bt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_xy[dy][dx] += wy * sol_x[dx];
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz = Bt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol[dz][dy][dx] += wz * sol_xy[dy][dx];
+               }
+            }
+         }
+      }
+      // Scatter to the L-vector, no other element of this color shares dofs
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const int j = map(dx,dy,dz,e);
+               if (j >= 0) { y[j] += sol[dz][dy][dx]; }
+               else { y[-1-j] -= sol[dz][dy][dx]; }
+            }
+         }
+      }
+   });
+}
+
+// Signature of the fused PA Mass Apply kernels
+typedef void (*PAMassApplyFusedKernel)(const int NE,
+                                       const int NC,
+                                       const int *elements,
+                                       const Array<int> &gather,
+                                       const Array<double> &B,
+                                       const Array<double> &Bt,
+                                       const Vector &op,
+                                       const Vector &x,
+                                       Vector &y,
+                                       const int d1d,
+                                       const int q1d);
+
+// Register the fused kernels for D1D = 2,...,T_D1D with Q1D = D1D and
+// Q1D = D1D + 1, see PAMassApplyRegistrar.
+template<int T_D1D>
+struct PAMassApplyFusedRegistrar
+{
+   static void Add(PAKernelTable<PAMassApplyFusedKernel> &table)
+   {
+      constexpr int D = T_D1D;
+      table.Add(2, D, D, PAMassApplyFused2D<D,D>);
+      table.Add(2, D, D+1, PAMassApplyFused2D<D,D+1>);
+      table.Add(3, D, D, PAMassApplyFused3D<D,D>);
+      table.Add(3, D, D+1, PAMassApplyFused3D<D,D+1>);
+      PAMassApplyFusedRegistrar<T_D1D-1>::Add(table);
+   }
+};
+
+template<>
+struct PAMassApplyFusedRegistrar<1>
+{
+   static void Add(PAKernelTable<PAMassApplyFusedKernel> &) { }
+};
+
+// Table of the specialized fused PA Mass Apply kernels
+static const PAKernelTable<PAMassApplyFusedKernel> &PAMassApplyFusedKernels()
+{
+   struct Table : PAKernelTable<PAMassApplyFusedKernel>
+   {
+      Table() { PAMassApplyFusedRegistrar<PA_SPECIALIZED_MAX_D1D>::Add(*this); }
+   };
+   static const Table table;
+   return table;
+}
+
+void MassIntegrator::AddMultFusedPA(const ElementRestriction &R,
+                                    const Vector &x, Vector &y) const
+{
+   // Sequential backends process all elements in order in a single pass, the
+   // parallel ones process the elements of each color concurrently, see
+   // DiffusionIntegrator::AddMultFusedPA().
+   const bool colored = Device::Allows(Backend::OMP_MASK);
+   const Array<int> *offsets = NULL, *elements = NULL;
+   if (colored) { R.GetElementColoring(offsets, elements); }
+   const int num_colors = colored ? offsets->Size() - 1 : 1;
+   const Array<int> &map = R.GatherMap();
+   const Array<double> &B = maps->B, &Bt = maps->Bt;
+   const Vector &D = pa_data;
+   const int *E = colored ? elements->Read() : NULL;
+   PAMassApplySimdKernel simd = NULL;
+   if (PAUseSimdKernels())
+   {
+      simd = PAMassApplySimdKernels().Find(dim, dofs1D, quad1D);
+   }
+   const PAMassApplyFusedKernel kernel =
+      PAMassApplyFusedKernels().Find(dim, dofs1D, quad1D);
+   for (int c = 0; c < num_colors; c++)
+   {
+      const int *Ec = colored ? E + (*offsets)[c] : NULL;
+      const int NC = colored ? (*offsets)[c+1] - (*offsets)[c] : ne;
+      if (simd)
+      {
+         simd(ne,NC,Ec,map.HostRead(),B,D,x,y);
+      }
+      else if (kernel)
+      {
+         kernel(ne,NC,Ec,map,B,Bt,D,x,y,dofs1D,quad1D);
+      }
+      else if (dim == 2)
+      {
+         PAMassApplyFused2D(ne,NC,Ec,map,B,Bt,D,x,y,dofs1D,quad1D);
+      }
+      else if (dim == 3)
+      {
+         PAMassApplyFused3D(ne,NC,Ec,map,B,Bt,D,x,y,dofs1D,quad1D);
+      }
+      else { MFEM_ABORT("Unknown kernel."); }
+   }
+}
+
+bool MassIntegrator::HasSpecializedPAKernel() const
+{
+   return PAMassApplyKernels().Find(dim, dofs1D, quad1D) &&
+          PAMassApplyFusedKernels().Find(dim, dofs1D, quad1D);
+}
+
+template<const int T_D1D = 0, const int T_Q1D = 0>
+static void PAMassAssembleDiagonal2D(const int NE,
+                                     const Array<double> &b,
+                                     const Vector &op_,
+                                     Vector &diag_,
+                                     const int d1d = 0,
+                                     const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto op = Reshape(op_.Read(), Q1D, Q1D, NE);
+   auto y = Reshape(diag_.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double QD[max_Q1D][max_D1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            QD[qx][dy] = 0.0;
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               QD[qx][dy] += B(qy,dy) * B(qy,dy) * op(qx,qy,e);
+            }
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            double temp = 0.0;
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               temp += B(qx,dx) * B(qx,dx) * QD[qx][dy];
+            }
+            y(dx,dy,e) += temp;
+         }
+      }
+   });
+}
+
+template<const int T_D1D = 0, const int T_Q1D = 0>
+static void PAMassAssembleDiagonal3D(const int NE,
+                                     const Array<double> &b,
+                                     const Vector &op_,
+                                     Vector &diag_,
+                                     const int d1d = 0,
+                                     const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto op = Reshape(op_.Read(), Q1D, Q1D, Q1D, NE);
+   auto y = Reshape(diag_.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      double QQD[max_Q1D][max_Q1D][max_D1D];
+      double QDD[max_Q1D][max_D1D][max_D1D];
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int dz = 0; dz < D1D; ++dz)
+            {
+               QQD[qx][qy][dz] = 0.0;
+               for (int qz = 0; qz < Q1D; ++qz)
+               {
+                  QQD[qx][qy][dz] += B(qz,dz) * B(qz,dz) * op(qx,qy,qz,e);
+               }
+            }
+         }
+      }
+      for (int qx = 0; qx < Q1D; ++qx)
+      {
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               QDD[qx][dy][dz] = 0.0;
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  QDD[qx][dy][dz] += B(qy,dy) * B(qy,dy) * QQD[qx][qy][dz];
+               }
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               double temp = 0.0;
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  temp += B(qx,dx) * B(qx,dx) * QDD[qx][dy][dz];
+               }
+               y(dx,dy,dz,e) += temp;
+            }
+         }
+      }
+   });
+}
+
+static void PAMassAssembleDiagonal(const int dim,
+                                   const int D1D,
+                                   const int Q1D,
+                                   const int NE,
+                                   const Array<double> &B,
+                                   const Vector &op,
+                                   Vector &y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4) | Q1D)
+      {
+         case 0x22: return PAMassAssembleDiagonal2D<2,2>(NE, B, op, y);
+         case 0x33: return PAMassAssembleDiagonal2D<3,3>(NE, B, op, y);
+         case 0x44: return PAMassAssembleDiagonal2D<4,4>(NE, B, op, y);
+         case 0x55: return PAMassAssembleDiagonal2D<5,5>(NE, B, op, y);
+         case 0x66: return PAMassAssembleDiagonal2D<6,6>(NE, B, op, y);
+         case 0x77: return PAMassAssembleDiagonal2D<7,7>(NE, B, op, y);
+         case 0x88: return PAMassAssembleDiagonal2D<8,8>(NE, B, op, y);
+         case 0x99: return PAMassAssembleDiagonal2D<9,9>(NE, B, op, y);
+         default:   return PAMassAssembleDiagonal2D(NE, B, op, y, D1D, Q1D);
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((D1D << 4) | Q1D)
+      {
+         case 0x23: return PAMassAssembleDiagonal3D<2,3>(NE, B, op, y);
+         case 0x34: return PAMassAssembleDiagonal3D<3,4>(NE, B, op, y);
+         case 0x45: return PAMassAssembleDiagonal3D<4,5>(NE, B, op, y);
+         case 0x56: return PAMassAssembleDiagonal3D<5,6>(NE, B, op, y);
+         case 0x67: return PAMassAssembleDiagonal3D<6,7>(NE, B, op, y);
+         case 0x78: return PAMassAssembleDiagonal3D<7,8>(NE, B, op, y);
+         case 0x89: return PAMassAssembleDiagonal3D<8,9>(NE, B, op, y);
+         default:   return PAMassAssembleDiagonal3D(NE, B, op, y, D1D, Q1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AssembleDiagonalPA(Vector &diag)
+{
+   if (pa_single)
+   {
+      Vector D;
+      PAToDoublePrecision(pa_data_sp, D);
+      PAMassAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, D, diag);
+      return;
+   }
+   PAMassAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, pa_data, diag);
+}
+
+// EA Mass Assemble 2D kernel
+template<const int T_D1D = 0, const int T_Q1D = 0>
+static void EAMassAssemble2D(const int NE,
+                             const Array<double> &b,
+                             const Vector &padata,
+                             DenseTensor &eadata,
+                             const int d1d = 0,
+                             const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto D = Reshape(padata.Read(), Q1D, Q1D, NE);
+   auto M = Reshape(eadata.ReadWrite(), D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      // M(i1,i2,j1,j2) = sum_q2 B(q2,i2) B(q2,j2) T(i1,j1,q2), with
+      // T(i1,j1,q2) = sum_q1 B(q1,i1) B(q1,j1) D(q1,q2)
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            double T[max_Q1D];
+            for (int q2 = 0; q2 < Q1D; ++q2)
+            {
+               T[q2] = 0.0;
+               for (int q1 = 0; q1 < Q1D; ++q1)
+               {
+                  T[q2] += B(q1,i1) * B(q1,j1) * D(q1,q2,e);
+               }
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  double val = 0.0;
+                  for (int q2 = 0; q2 < Q1D; ++q2)
+                  {
+                     val += B(q2,i2) * B(q2,j2) * T[q2];
+                  }
+                  M(i1,i2,j1,j2,e) += val;
+               }
+            }
+         }
+      }
+   });
+}
+
+// EA Mass Assemble 3D kernel
+template<const int T_D1D = 0, const int T_Q1D = 0>
+static void EAMassAssemble3D(const int NE,
+                             const Array<double> &b,
+                             const Vector &padata,
+                             DenseTensor &eadata,
+                             const int d1d = 0,
+                             const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   auto B = Reshape(b.Read(), Q1D, D1D);
+   auto D = Reshape(padata.Read(), Q1D, Q1D, Q1D, NE);
+   auto M = Reshape(eadata.ReadWrite(), D1D, D1D, D1D, D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      for (int i1 = 0; i1 < D1D; ++i1)
+      {
+         for (int j1 = 0; j1 < D1D; ++j1)
+         {
+            double T1[max_Q1D][max_Q1D];
+            for (int q3 = 0; q3 < Q1D; ++q3)
+            {
+               for (int q2 = 0; q2 < Q1D; ++q2)
+               {
+                  T1[q3][q2] = 0.0;
+                  for (int q1 = 0; q1 < Q1D; ++q1)
+                  {
+                     T1[q3][q2] += B(q1,i1) * B(q1,j1) * D(q1,q2,q3,e);
+                  }
+               }
+            }
+            for (int i2 = 0; i2 < D1D; ++i2)
+            {
+               for (int j2 = 0; j2 < D1D; ++j2)
+               {
+                  double T2[max_Q1D];
+                  for (int q3 = 0; q3 < Q1D; ++q3)
+                  {
+                     T2[q3] = 0.0;
+                     for (int q2 = 0; q2 < Q1D; ++q2)
+                     {
+                        T2[q3] += B(q2,i2) * B(q2,j2) * T1[q3][q2];
+                     }
+                  }
+                  for (int i3 = 0; i3 < D1D; ++i3)
+                  {
+                     for (int j3 = 0; j3 < D1D; ++j3)
+                     {
+                        double val = 0.0;
+                        for (int q3 = 0; q3 < Q1D; ++q3)
+                        {
+                           val += B(q3,i3) * B(q3,j3) * T2[q3];
+                        }
+                        M(i1,i2,i3,j1,j2,j3,e) += val;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   });
+}
+
+void MassIntegrator::AssembleEA(const FiniteElementSpace &fes,
+                                DenseTensor &emat)
+{
+   const FiniteElement &el = *fes.GetFE(0);
+   if (fes.GetVDim() != 1 || !dynamic_cast<const TensorBasisElement*>(&el) ||
+       fes.GetMesh()->Dimension() == 1)
+   {
+      return BilinearFormIntegrator::AssembleEA(fes, emat);
+   }
+   // The element matrices are computed from double precision data
+   const bool single = pa_single;
+   pa_single = false;
+   AssemblePA(fes);
+   pa_single = single;
+   if (ne == 0) { return; }
+   if (dim == 2)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x22: return EAMassAssemble2D<2,2>(ne, maps->B, pa_data, emat);
+         case 0x33: return EAMassAssemble2D<3,3>(ne, maps->B, pa_data, emat);
+         case 0x44: return EAMassAssemble2D<4,4>(ne, maps->B, pa_data, emat);
+         default:   return EAMassAssemble2D(ne, maps->B, pa_data, emat,
+                                               dofs1D, quad1D);
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x23: return EAMassAssemble3D<2,3>(ne, maps->B, pa_data, emat);
+         case 0x34: return EAMassAssemble3D<3,4>(ne, maps->B, pa_data, emat);
+         case 0x45: return EAMassAssemble3D<4,5>(ne, maps->B, pa_data, emat);
+         default:   return EAMassAssemble3D(ne, maps->B, pa_data, emat,
+                                               dofs1D, quad1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+// MF Mass Apply 2D kernel. The determinants of the Jacobians of the element
+// transformation are computed from the mesh nodes at the quadrature points
+// instead of being read from the partially assembled data.
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void MFMassApply2D(const int NE,
+                          const int GD1D,
+                          const Array<double> &B_,
+                          const Array<double> &Bt_,
+                          const Array<double> &GB_,
+                          const Array<double> &GG_,
+                          const Array<double> &W_,
+                          const Vector &nodes_,
+                          const Vector &c_,
+                          const Vector &x_,
+                          Vector &y_,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(GD1D <= MAX_D1D, "");
+   const bool const_c = c_.Size() == 1;
+   auto B = Reshape(B_.Read(), Q1D, D1D);
+   auto Bt = Reshape(Bt_.Read(), D1D, Q1D);
+   auto GB = Reshape(GB_.Read(), Q1D, GD1D);
+   auto GG = Reshape(GG_.Read(), Q1D, GD1D);
+   auto W = Reshape(W_.Read(), Q1D, Q1D);
+   auto X = Reshape(nodes_.Read(), GD1D, GD1D, 2, NE);
+   auto C = const_c ? Reshape(c_.Read(), 1, 1, 1) :
+            Reshape(c_.Read(), Q1D, Q1D, NE);
+   auto x = Reshape(x_.Read(), D1D, D1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      // the following variables are evaluated at compile time
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // jac[qy][qx][i][j] = d(x_i)/d(xi_j) at the quadrature point (qx,qy)
+      double jac[max_Q1D][max_Q1D][2][2];
+      for (int c = 0; c < 2; ++c)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               jac[qy][qx][c][0] = 0.0;
+               jac[qy][qx][c][1] = 0.0;
+            }
+         }
+         for (int gy = 0; gy < GD1D; ++gy)
+         {
+            double nodesX[max_Q1D][2];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               nodesX[qx][0] = 0.0;
+               nodesX[qx][1] = 0.0;
+            }
+            for (int gx = 0; gx < GD1D; ++gx)
+            {
+               const double s = X(gx,gy,c,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  nodesX[qx][0] += s * GB(qx,gx);
+                  nodesX[qx][1] += s * GG(qx,gx);
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy  = GB(qy,gy);
+               const double wDy = GG(qy,gy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  jac[qy][qx][c][0] += nodesX[qx][1] * wy;
+                  jac[qy][qx][c][1] += nodesX[qx][0] * wDy;
+               }
+            }
+         }
+      }
+
+      double sol_xy[max_Q1D][max_Q1D];
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            sol_xy[qy][qx] = 0.0;
+         }
+      }
+      for (int dy = 0; dy < D1D; ++dy)
+      {
+         double sol_x[max_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            sol_x[qy] = 0.0;
+         }
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            const double s = x(dx,dy,e);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] += B(qx,dx)* s;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            const double d2q = B(qy,dy);
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] += d2q * sol_x[qx];
+            }
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double J11 = jac[qy][qx][0][0];
+            const double J21 = jac[qy][qx][1][0];
+            const double J12 = jac[qy][qx][0][1];
+            const double J22 = jac[qy][qx][1][1];
+            const double detJ = (J11*J22)-(J21*J12);
+            const double coeff = const_c ? C(0,0,0) : C(qx,qy,e);
+            sol_xy[qy][qx] *= W(qx,qy) * coeff * detJ;
+         }
+      }
+      for (int qy = 0; qy < Q1D; ++qy)
+      {
+         double sol_x[max_D1D];
+         for (int dx = 0; dx < D1D; ++dx)
+         {
+            sol_x[dx] = 0.0;
+         }
+         for (int qx = 0; qx < Q1D; ++qx)
+         {
+            const double s = sol_xy[qy][qx];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] += Bt(dx,qx) * s;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            const double q2d = Bt(dy,qy);
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               y(dx,dy,e) += q2d * sol_x[dx];
+            }
+         }
+      }
+   });
+}
+
+// MF Mass Apply 3D kernel
+template<const int T_D1D = 0,
+         const int T_Q1D = 0>
+static void MFMassApply3D(const int NE,
+                          const int GD1D,
+                          const Array<double> &B_,
+                          const Array<double> &Bt_,
+                          const Array<double> &GB_,
+                          const Array<double> &GG_,
+                          const Array<double> &W_,
+                          const Vector &nodes_,
+                          const Vector &c_,
+                          const Vector &x_,
+                          Vector &y_,
+                          const int d1d = 0,
+                          const int q1d = 0)
+{
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(GD1D <= MAX_D1D, "");
+   const bool const_c = c_.Size() == 1;
+   auto B = Reshape(B_.Read(), Q1D, D1D);
+   auto Bt = Reshape(Bt_.Read(), D1D, Q1D);
+   auto GB = Reshape(GB_.Read(), Q1D, GD1D);
+   auto GG = Reshape(GG_.Read(), Q1D, GD1D);
+   auto W = Reshape(W_.Read(), Q1D, Q1D, Q1D);
+   auto X = Reshape(nodes_.Read(), GD1D, GD1D, GD1D, 3, NE);
+   auto C = const_c ? Reshape(c_.Read(), 1, 1, 1, 1) :
+            Reshape(c_.Read(), Q1D, Q1D, Q1D, NE);
+   auto x = Reshape(x_.Read(), D1D, D1D, D1D, NE);
+   auto y = Reshape(y_.ReadWrite(), D1D, D1D, D1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+
+      // jac[qz][qy][qx][i][j] = d(x_i)/d(xi_j) at the quadrature point
+      double jac[max_Q1D][max_Q1D][max_Q1D][3][3];
+      for (int c = 0; c < 3; ++c)
+      {
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  jac[qz][qy][qx][c][0] = 0.0;
+                  jac[qz][qy][qx][c][1] = 0.0;
+                  jac[qz][qy][qx][c][2] = 0.0;
+               }
+            }
+         }
+         for (int gz = 0; gz < GD1D; ++gz)
+         {
+            double nodesXY[max_Q1D][max_Q1D][3];
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  nodesXY[qy][qx][0] = 0.0;
+                  nodesXY[qy][qx][1] = 0.0;
+                  nodesXY[qy][qx][2] = 0.0;
+               }
+            }
+            for (int gy = 0; gy < GD1D; ++gy)
+            {
+               double nodesX[max_Q1D][2];
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  nodesX[qx][0] = 0.0;
+                  nodesX[qx][1] = 0.0;
+               }
+               for (int gx = 0; gx < GD1D; ++gx)
+               {
+                  const double s = X(gx,gy,gz,c,e);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     nodesX[qx][0] += s * GB(qx,gx);
+                     nodesX[qx][1] += s * GG(qx,gx);
+                  }
+               }
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  const double wy  = GB(qy,gy);
+                  const double wDy = GG(qy,gy);
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     nodesXY[qy][qx][0] += nodesX[qx][1] * wy;
+                     nodesXY[qy][qx][1] += nodesX[qx][0] * wDy;
+                     nodesXY[qy][qx][2] += nodesX[qx][0] * wy;
+                  }
+               }
+            }
+            for (int qz = 0; qz < Q1D; ++qz)
+            {
+               const double wz  = GB(qz,gz);
+               const double wDz = GG(qz,gz);
+               for (int qy = 0; qy < Q1D; ++qy)
+               {
+                  for (int qx = 0; qx < Q1D; ++qx)
+                  {
+                     jac[qz][qy][qx][c][0] += nodesXY[qy][qx][0] * wz;
+                     jac[qz][qy][qx][c][1] += nodesXY[qy][qx][1] * wz;
+                     jac[qz][qy][qx][c][2] += nodesXY[qy][qx][2] * wDz;
+                  }
+               }
+            }
+         }
+      }
+
+      double sol_xyz[max_Q1D][max_Q1D][max_Q1D];
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xyz[qz][qy][qx] = 0.0;
+            }
+         }
+      }
+      for (int dz = 0; dz < D1D; ++dz)
+      {
+         double sol_xy[max_Q1D][max_Q1D];
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_xy[qy][qx] = 0.0;
+            }
+         }
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            double sol_x[max_Q1D];
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               sol_x[qx] = 0;
+            }
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               const double s = x(dx,dy,dz,e);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_x[qx] += B(qx,dx) * s;
+               }
+            }
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               const double wy = B(qy,dy);
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xy[qy][qx] += wy * sol_x[qx];
+               }
+            }
+         }
+         for (int qz = 0; qz < Q1D; ++qz)
+         {
+            const double wz = B(qz,dz);
+            for (int qy = 0; qy < Q1D; ++qy)
+            {
+               for (int qx = 0; qx < Q1D; ++qx)
+               {
+                  sol_xyz[qz][qy][qx] += wz * sol_xy[qy][qx];
+               }
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double J11 = jac[qz][qy][qx][0][0];
+               const double J21 = jac[qz][qy][qx][1][0];
+               const double J31 = jac[qz][qy][qx][2][0];
+               const double J12 = jac[qz][qy][qx][0][1];
+               const double J22 = jac[qz][qy][qx][1][1];
+               const double J32 = jac[qz][qy][qx][2][1];
+               const double J13 = jac[qz][qy][qx][0][2];
+               const double J23 = jac[qz][qy][qx][1][2];
+               const double J33 = jac[qz][qy][qx][2][2];
+               const double detJ = J11 * (J22 * J33 - J32 * J23) -
+               /* */               J21 * (J12 * J33 - J32 * J13) +
+               /* */               J31 * (J12 * J23 - J22 * J13);
+               const double coeff = const_c ? C(0,0,0,0) : C(qx,qy,qz,e);
+               sol_xyz[qz][qy][qx] *= W(qx,qy,qz) * coeff * detJ;
+            }
+         }
+      }
+      for (int qz = 0; qz < Q1D; ++qz)
+      {
+         double sol_xy[max_D1D][max_D1D];
+         for (int dy = 0; dy < D1D; ++dy)
+         {
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_xy[dy][dx] = 0;
+            }
+         }
+         for (int qy = 0; qy < Q1D; ++qy)
+         {
+            double sol_x[max_D1D];
+            for (int dx = 0; dx < D1D; ++dx)
+            {
+               sol_x[dx] = 0;
+            }
+            for (int qx = 0; qx < Q1D; ++qx)
+            {
+               const double s = sol_xyz[qz][qy][qx];
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_x[dx] += Bt(dx,qx) * s;
+               }
+            }
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               const double wy = Bt(dy,qy);
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  sol_xy[dy][dx] += wy * sol_x[dx];
+               }
+            }
+         }
+         for (int dz = 0; dz < D1D; ++dz)
+         {
+            const double wz = Bt(dz,qz);
+            for (int dy = 0; dy < D1D; ++dy)
+            {
+               for (int dx = 0; dx < D1D; ++dx)
+               {
+                  y(dx,dy,dz,e) += wz * sol_xy[dy][dx];
+               }
+            }
+         }
+      }
+   });
+}
+
+void MassIntegrator::AssembleMF(const FiniteElementSpace &fes)
+{
+   // Assuming the same element type
+   Mesh *mesh = fes.GetMesh();
+   ne = fes.GetNE();
+   if (ne == 0) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   ElementTransformation *T = mesh->GetElementTransformation(0);
+   mf_ir = IntRule ? IntRule : &GetRule(el, el, *T);
+   dim = mesh->Dimension();
+   MFEM_VERIFY(dim == 2 || dim == 3, "dim = " << dim << " is not supported");
+   nq = mf_ir->GetNPoints();
+   maps = &el.GetDofToQuad(*mf_ir, DofToQuad::TENSOR);
+   dofs1D = maps->ndof;
+   quad1D = maps->nqpt;
+   MFNodesSetup(*mesh, *mf_ir, mf_nodes, mf_geom_maps);
+   PAEvalCoefficient(fes, *mf_ir, Q, mf_coeff);
+}
+
+void MassIntegrator::AddMultMF(const Vector &x, Vector &y) const
+{
+   if (ne == 0) { return; }
+   const int GD1D = mf_geom_maps->ndof;
+   const Array<double> &B = maps->B, &Bt = maps->Bt;
+   const Array<double> &GB = mf_geom_maps->B, &GG = mf_geom_maps->G;
+   const Array<double> &W = mf_ir->GetWeights();
+   const Vector &N = mf_nodes, &C = mf_coeff;
+   if (dim == 2)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x22: return MFMassApply2D<2,2>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         case 0x33: return MFMassApply2D<3,3>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         case 0x44: return MFMassApply2D<4,4>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         case 0x55: return MFMassApply2D<5,5>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         default:   return MFMassApply2D(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y,
+                                            dofs1D,quad1D);
+      }
+   }
+   else if (dim == 3)
+   {
+      switch ((dofs1D << 4) | quad1D)
+      {
+         case 0x23: return MFMassApply3D<2,3>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         case 0x34: return MFMassApply3D<3,4>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         case 0x45: return MFMassApply3D<4,5>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         case 0x56: return MFMassApply3D<5,6>(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y);
+         default:   return MFMassApply3D(ne,GD1D,B,Bt,GB,GG,W,N,C,x,y,
+                                            dofs1D,quad1D);
+      }
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
+void MassIntegrator::AssembleDiagonalMF(Vector &diag)
+{
+   if (ne == 0) { return; }
+   // The quadrature data only lives for the duration of this call; the
+   // Jacobians are computed from the nodes gathered by AssembleMF().
+   Vector J;
+   MFJacobians(dim, ne, *mf_geom_maps, mf_nodes, J);
+   Vector op(nq * ne, Device::GetMemoryType());
+   PAMassSetup(dim, nq, ne, mf_ir->GetWeights(), J, mf_coeff, op);
+   PAMassAssembleDiagonal(dim, dofs1D, quad1D, ne, maps->B, op, diag);
 }
 
 } // namespace mfem
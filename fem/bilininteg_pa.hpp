@@ -0,0 +1,86 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BILININTEG_PA
+#define MFEM_BILININTEG_PA
+
+// Internal header: the partial and matrix-free assembly kernels shared by the
+// implementations of several integrators, in the bilininteg_*.cpp files. It is
+// not included by fem.hpp.
+
+#include "../config/config.hpp"
+#include "bilininteg.hpp"
+
+namespace mfem
+{
+
+/// Evaluate the scalar coefficient @a Q at the quadrature points of @a ir in
+/// all elements of @a fes; a constant (or NULL) coefficient gives one value.
+void PAEvalCoefficient(const FiniteElementSpace &fes,
+                       const IntegrationRule &ir, Coefficient *Q,
+                       Vector &coeff);
+
+/// Gather the nodes of @a mesh, or its vertices if it has no nodes, into a
+/// lexicographic E-vector, and return the maps evaluating them at the points
+/// of @a ir (matrix-free assembly).
+void MFNodesSetup(const Mesh &mesh, const IntegrationRule &ir, Vector &enodes,
+                  const DofToQuad *&geom_maps);
+
+/// Jacobians, in the layout of GeometricFactors::J, of the element
+/// transformations given by the E-vector of MFNodesSetup.
+void MFJacobians(const int dim, const int NE, const DofToQuad &geom_maps,
+                 const Vector &enodes, Vector &jac);
+
+/// Quadrature data of the diffusion operator: W * C * adj(J) adj(J)^T / det(J),
+/// stored as the symmetric part of the matrix at each point.
+void PADiffusionSetup(const int dim, const int D1D, const int Q1D,
+                      const int NE, const Array<double> &W, const Vector &J,
+                      const Vector &C, Vector &D);
+
+/// Add the diagonal of the diffusion operator with quadrature data @a op to
+/// the E-vector @a y.
+void PADiffusionAssembleDiagonal(const int dim, const int D1D, const int Q1D,
+                                 const int NE, const Array<double> &B,
+                                 const Array<double> &G, const Vector &op,
+                                 Vector &y);
+
+/// Quadrature data of the H(div) mass operator in 2D: W * C * J^T J / det(J).
+void PAHdivSetup2D(const int Q1D, const int NE, const Array<double> &w,
+                   const Vector &j, const Vector &c, Vector &op);
+
+/// Quadrature data of the H(div) mass operator in 3D: W * C * J^T J / det(J).
+void PAHdivSetup3D(const int Q1D, const int NE, const Array<double> &w,
+                   const Vector &j, const Vector &c, Vector &op);
+
+/// Quadrature data of the div-div operator: W * C / det(J).
+void PADivDivSetup(const int dim, const int NQ, const int NE,
+                   const Array<double> &w, const Vector &j, const Vector &c,
+                   Vector &op);
+
+/// Add the action of the H(div) mass operator in 2D to the E-vector @a y.
+void PAHdivMassApply2D(const int D1D, const int Q1D, const int NE,
+                       const Array<double> &Bo, const Array<double> &Bc,
+                       const Vector &op, const Vector &x, Vector &y);
+
+/// Add the action of the H(div) mass operator in 3D to the E-vector @a y.
+void PAHdivMassApply3D(const int D1D, const int Q1D, const int NE,
+                       const Array<double> &Bo, const Array<double> &Bc,
+                       const Vector &op, const Vector &x, Vector &y);
+
+/// Add the diagonal of the H(div) mass operator to the E-vector @a diag.
+void PAHdivMassAssembleDiagonal(const int dim, const int D1D, const int Q1D,
+                                const int NE, const Array<double> &Bo,
+                                const Array<double> &Bc, const Vector &op,
+                                Vector &diag);
+
+} // namespace mfem
+
+#endif
@@ -1882,6 +1882,46 @@ public:
    }
 };
 
+/** @brief Base class for the tensor-product H(curl) and H(div) elements on
+    quadrilaterals and hexahedra, built from a "closed" and an "open" 1D basis.
+
+    The closed basis has degree equal to the order of the element and the open
+    basis has degree one less. The dof map returned by GetDofMap() is signed:
+    a negative entry k corresponds to the basis function -1-k with a flipped
+    sign. */
+class VectorTensorFiniteElement : public VectorFiniteElement,
+   public TensorBasisElement
+{
+private:
+   mutable Array<DofToQuad*> dof2quad_array_open;
+
+protected:
+   Poly_1D::Basis &cbasis1d, &obasis1d;
+
+public:
+   VectorTensorFiniteElement(const int dims, const int d, const int p,
+                             const int cbtype, const int obtype,
+                             const int M, const DofMapType dmtype);
+
+   /** @brief Return the DofToQuad structure of the closed 1D basis; only the
+       DofToQuad::TENSOR mode is supported. */
+   const DofToQuad &GetDofToQuad(const IntegrationRule &ir,
+                                 DofToQuad::Mode mode) const
+   { return GetTensorDofToQuad(ir, mode, true); }
+
+   /** @brief Return the DofToQuad structure of the open 1D basis; only the
+       DofToQuad::TENSOR mode is supported. */
+   const DofToQuad &GetDofToQuadOpen(const IntegrationRule &ir,
+                                     DofToQuad::Mode mode) const
+   { return GetTensorDofToQuad(ir, mode, false); }
+
+   const DofToQuad &GetTensorDofToQuad(const IntegrationRule &ir,
+                                       DofToQuad::Mode mode,
+                                       const bool closed) const;
+
+   ~VectorTensorFiniteElement();
+};
+
 class H1_SegmentElement : public NodalTensorFiniteElement
 {
 private:
@@ -2368,17 +2408,16 @@ public:
 };
 
 
-class RT_QuadrilateralElement : public VectorFiniteElement
+class RT_QuadrilateralElement : public VectorTensorFiniteElement
 {
 private:
    static const double nk[8];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy;
    mutable Vector dshape_cx, dshape_cy;
 #endif
-   Array<int> dof_map, dof2nk;
+   Array<int> dof2nk;
 
 public:
    RT_QuadrilateralElement(const int p,
@@ -2424,16 +2463,15 @@ public:
 };
 
 
-class RT_HexahedronElement : public VectorFiniteElement
+class RT_HexahedronElement : public VectorTensorFiniteElement
 {
    static const double nk[18];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy, shape_cz, shape_oz;
    mutable Vector dshape_cx, dshape_cy, dshape_cz;
 #endif
-   Array<int> dof_map, dof2nk;
+   Array<int> dof2nk;
 
 public:
    RT_HexahedronElement(const int p,
@@ -2578,16 +2616,15 @@ public:
 };
 
 
-class ND_HexahedronElement : public VectorFiniteElement
+class ND_HexahedronElement : public VectorTensorFiniteElement
 {
    static const double tk[18];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy, shape_cz, shape_oz;
    mutable Vector dshape_cx, dshape_cy, dshape_cz;
 #endif
-   Array<int> dof_map, dof2tk;
+   Array<int> dof2tk;
 
 public:
    ND_HexahedronElement(const int p,
@@ -2644,16 +2681,15 @@ public:
 };
 
 
-class ND_QuadrilateralElement : public VectorFiniteElement
+class ND_QuadrilateralElement : public VectorTensorFiniteElement
 {
    static const double tk[8];
 
-   Poly_1D::Basis &cbasis1d, &obasis1d;
 #ifndef MFEM_THREAD_SAFE
    mutable Vector shape_cx, shape_ox, shape_cy, shape_oy;
    mutable Vector dshape_cx, dshape_cy;
 #endif
-   Array<int> dof_map, dof2tk;
+   Array<int> dof2tk;
 
 public:
    ND_QuadrilateralElement(const int p,
@@ -233,6 +233,74 @@ void FiniteElementSpace::BuildElementToDofTable() const
    elem_dof = el_dof;
 }
 
+void FiniteElementSpace::GetElementColoring(const Array<int> *&offsets,
+                                            const Array<int> *&elements,
+                                            bool bdr) const
+{
+   Array<int> &c_offsets = bdr ? bdr_color_offsets : elem_color_offsets;
+   Array<int> &c_elements = bdr ? bdr_color_elements : elem_color_elements;
+   const int ne = bdr ? GetNBE() : GetNE();
+   if (c_offsets.Size() == 0 && ne > 0)
+   {
+      // The (unsigned) dofs of the elements and the elements of the dofs
+      Table el_dof, dof_el;
+      Array<int> dofs;
+      el_dof.MakeI(ne);
+      for (int e = 0; e < ne; e++)
+      {
+         if (bdr) { GetBdrElementDofs(e, dofs); }
+         else { GetElementDofs(e, dofs); }
+         el_dof.AddColumnsInRow(e, dofs.Size());
+      }
+      el_dof.MakeJ();
+      for (int e = 0; e < ne; e++)
+      {
+         if (bdr) { GetBdrElementDofs(e, dofs); }
+         else { GetElementDofs(e, dofs); }
+         for (int d = 0; d < dofs.Size(); d++)
+         {
+            if (dofs[d] < 0) { dofs[d] = -1 - dofs[d]; }
+         }
+         el_dof.AddConnections(e, dofs.GetData(), dofs.Size());
+      }
+      el_dof.ShiftUpI();
+      Transpose(el_dof, dof_el, ndofs);
+
+      // Greedy coloring: each element gets the smallest color not used by the
+      // already colored elements it shares a dof with.
+      Array<int> color(ne), mark;
+      int num_colors = 0;
+      for (int e = 0; e < ne; e++)
+      {
+         mark.SetSize(num_colors + 1);
+         mark = 0;
+         const int *row = el_dof.GetRow(e);
+         for (int d = 0; d < el_dof.RowSize(e); d++)
+         {
+            const int *elems = dof_el.GetRow(row[d]);
+            for (int j = 0; j < dof_el.RowSize(row[d]); j++)
+            {
+               if (elems[j] < e) { mark[color[elems[j]]] = 1; }
+            }
+         }
+         int c = 0;
+         while (mark[c]) { c++; }
+         color[e] = c;
+         if (c == num_colors) { num_colors++; }
+      }
+      c_offsets.SetSize(num_colors + 1);
+      c_offsets = 0;
+      for (int e = 0; e < ne; e++) { c_offsets[color[e] + 1]++; }
+      c_offsets.PartialSum();
+      c_elements.SetSize(ne);
+      Array<int> next(num_colors);
+      for (int c = 0; c < num_colors; c++) { next[c] = c_offsets[c]; }
+      for (int e = 0; e < ne; e++) { c_elements[next[color[e]]++] = e; }
+   }
+   offsets = &c_offsets;
+   elements = &c_elements;
+}
+
 void FiniteElementSpace::RebuildElementToDofTable()
 {
    delete elem_dof;
@@ -1078,6 +1146,159 @@ void FiniteElementSpace::RefinementOperator
    }
 }
 
+void FiniteElementSpace::RefinementOperator
+::MultTranspose(const Vector &x, Vector &y) const
+{
+   Mesh* mesh = fespace->GetMesh();
+   const CoarseFineTransformations &rtrans = mesh->GetRefinementTransforms();
+
+   Array<int> dofs, old_dofs, old_vdofs;
+
+   Array<char> processed(fespace->GetVSize());
+   processed = 0;
+
+   int vdim = fespace->GetVDim();
+   int old_ndofs = width / vdim;
+
+   y = 0.0;
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const Embedding &emb = rtrans.embeddings[k];
+      const Geometry::Type geom = mesh->GetElementBaseGeometry(k);
+      const DenseMatrix &lP = localP[geom](emb.matrix);
+
+      fespace->GetElementDofs(k, dofs);
+      old_elem_dof->GetRow(emb.parent, old_dofs);
+
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         old_dofs.Copy(old_vdofs);
+         fespace->DofsToVDofs(vd, old_vdofs, old_ndofs);
+
+         for (int i = 0; i < dofs.Size(); i++)
+         {
+            double rsign, osign;
+            int r = fespace->DofToVDof(dofs[i], vd);
+            r = DecodeDof(r, rsign);
+
+            // Only the first element containing a fine dof defines its value
+            // in Mult(), so only that element contributes to the transpose.
+            if (!processed[r])
+            {
+               const double value = x[r] * rsign;
+               for (int j = 0; j < old_vdofs.Size(); j++)
+               {
+                  int o = DecodeDof(old_vdofs[j], osign);
+                  y[o] += value * lP(i, j) * osign;
+               }
+               processed[r] = 1;
+            }
+         }
+      }
+   }
+}
+
+FiniteElementSpace::PRefinementOperator::PRefinementOperator(
+   const FiniteElementSpace *f_fes, const FiniteElementSpace *c_fes)
+   : Operator(f_fes->GetVSize(), c_fes->GetVSize()),
+     fine_fes(f_fes), coarse_fes(c_fes)
+{
+   MFEM_VERIFY(f_fes->GetMesh() == c_fes->GetMesh(),
+               "the FE spaces must be defined on the same mesh");
+   MFEM_VERIFY(c_fes->GetOrdering() == f_fes->GetOrdering() &&
+               c_fes->GetVDim() == f_fes->GetVDim(),
+               "incompatible coarse and fine FE spaces");
+
+   IsoparametricTransformation isotr;
+   Mesh::GeometryList elem_geoms(*f_fes->GetMesh());
+   for (int i = 0; i < elem_geoms.Size(); i++)
+   {
+      const Geometry::Type geom = elem_geoms[i];
+      const FiniteElement *fine_fe =
+         f_fes->FEColl()->FiniteElementForGeometry(geom);
+      const FiniteElement *coarse_fe =
+         c_fes->FEColl()->FiniteElementForGeometry(geom);
+      isotr.SetIdentityTransformation(geom);
+      localP[geom].SetSize(fine_fe->GetDof(), coarse_fe->GetDof());
+      fine_fe->GetTransferMatrix(*coarse_fe, isotr, localP[geom]);
+   }
+}
+
+void FiniteElementSpace::PRefinementOperator::Mult(const Vector &x,
+                                                   Vector &y) const
+{
+   Mesh *mesh = fine_fes->GetMesh();
+   Array<int> f_vdofs, c_vdofs;
+   Vector loc_x, loc_y;
+
+   Array<char> processed(fine_fes->GetVSize());
+   processed = 0;
+
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(k)];
+      fine_fes->GetElementVDofs(k, f_vdofs);
+      coarse_fes->GetElementVDofs(k, c_vdofs);
+      const int vdim = fine_fes->GetVDim();
+      const int fnd = lP.Height(), cnd = lP.Width();
+
+      x.GetSubVector(c_vdofs, loc_x);
+      loc_y.SetSize(fnd);
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         Vector cx(loc_x.GetData() + vd*cnd, cnd);
+         lP.Mult(cx, loc_y);
+         for (int i = 0; i < fnd; i++)
+         {
+            double rsign;
+            const int r = DecodeDof(f_vdofs[i + vd*fnd], rsign);
+            if (!processed[r])
+            {
+               y[r] = rsign * loc_y(i);
+               processed[r] = 1;
+            }
+         }
+      }
+   }
+}
+
+void FiniteElementSpace::PRefinementOperator::MultTranspose(const Vector &x,
+                                                            Vector &y) const
+{
+   Mesh *mesh = fine_fes->GetMesh();
+   Array<int> f_vdofs, c_vdofs;
+   Vector loc_x, loc_y;
+
+   Array<char> processed(fine_fes->GetVSize());
+   processed = 0;
+
+   y = 0.0;
+   for (int k = 0; k < mesh->GetNE(); k++)
+   {
+      const DenseMatrix &lP = localP[mesh->GetElementBaseGeometry(k)];
+      fine_fes->GetElementVDofs(k, f_vdofs);
+      coarse_fes->GetElementVDofs(k, c_vdofs);
+      const int vdim = fine_fes->GetVDim();
+      const int fnd = lP.Height(), cnd = lP.Width();
+
+      loc_x.SetSize(fnd);
+      loc_y.SetSize(cnd*vdim);
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         for (int i = 0; i < fnd; i++)
+         {
+            double rsign;
+            const int r = DecodeDof(f_vdofs[i + vd*fnd], rsign);
+            loc_x(i) = processed[r] ? 0.0 : rsign * x[r];
+            processed[r] = 1;
+         }
+         Vector cy(loc_y.GetData() + vd*cnd, cnd);
+         lP.MultTranspose(loc_x, cy);
+      }
+      y.AddElementVector(c_vdofs, loc_y);
+   }
+}
+
 FiniteElementSpace::DerefinementOperator::DerefinementOperator(
    const FiniteElementSpace *f_fes, const FiniteElementSpace *c_fes,
    BilinearFormIntegrator *mass_integ)
@@ -1900,6 +2121,10 @@ void FiniteElementSpace::Destroy()
 
    dof_elem_array.DeleteAll();
    dof_ldof_array.DeleteAll();
+   elem_color_offsets.DeleteAll();
+   elem_color_elements.DeleteAll();
+   bdr_color_offsets.DeleteAll();
+   bdr_color_elements.DeleteAll();
 
    if (NURBSext)
    {
@@ -2426,7 +2651,15 @@ const Operator &InterpolationGridTransfer::ForwardOperator()
    }
 
    // Costruct F
-   if (oper_type == Operator::ANY_TYPE)
+   if (ran_fes.GetMesh() == dom_fes.GetMesh())
+   {
+      // Order transfer on the same mesh, e.g. for p-multigrid.
+      MFEM_VERIFY(oper_type == Operator::ANY_TYPE,
+                  "Operator::Type is not supported for the same mesh: "
+                  << oper_type);
+      F.Reset(new FiniteElementSpace::PRefinementOperator(&ran_fes, &dom_fes));
+   }
+   else if (oper_type == Operator::ANY_TYPE)
    {
       F.Reset(new FiniteElementSpace::RefinementOperator(&ran_fes, &dom_fes));
    }
@@ -2458,6 +2691,9 @@ const Operator &InterpolationGridTransfer::BackwardOperator()
       return *B.Ptr();
    }
 
+   MFEM_VERIFY(ran_fes.GetMesh() != dom_fes.GetMesh(),
+               "the backward operator is not supported for the same mesh");
+
    // Construct B, if not set, define a suitable mass_integ
    if (!mass_integ && ran_fes.GetNE() > 0)
    {
@@ -2754,7 +2990,8 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
      dof(ne > 0 ? fes.GetFE(0)->GetDof() : 0),
      nedofs(ne*dof),
      offsets(ndofs+1),
-     indices(ne*dof)
+     indices(ne*dof),
+     gather_map(ne*dof)
 {
    // Assuming all finite elements are the same.
    height = vdim*ne*dof;
@@ -2789,7 +3026,8 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    {
       for (int d = 0; d < dof; ++d)
       {
-         const int gid = elementMap[dof*e + d];
+         const int sgid = elementMap[dof*e + d];
+         const int gid = (sgid >= 0) ? sgid : -1 - sgid;
          ++offsets[gid + 1];
       }
    }
@@ -2798,15 +3036,22 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    {
       offsets[i] += offsets[i - 1];
    }
-   // For each global dof, fill in all local nodes that point to it
+   // For each global dof, fill in all local nodes that point to it. The signs
+   // of the dofs of H(curl) and H(div) spaces, from the element-to-dof table
+   // and from the lexicographic dof map, are stored in the indices: a local
+   // node with a flipped sign is encoded as -1-lid.
    for (int e = 0; e < ne; ++e)
    {
       for (int d = 0; d < dof; ++d)
       {
-         const int did = (!dof_reorder)?d:dof_map[d];
-         const int gid = elementMap[dof*e + did];
+         const int sdid = (!dof_reorder)?d:dof_map[d];
+         const int did = (sdid >= 0) ? sdid : -1 - sdid;
+         const int sgid = elementMap[dof*e + did];
+         const int gid = (sgid >= 0) ? sgid : -1 - sgid;
          const int lid = dof*e + d;
-         indices[offsets[gid]++] = lid;
+         const bool plus = (sdid >= 0) == (sgid >= 0);
+         indices[offsets[gid]++] = plus ? lid : -1 - lid;
+         gather_map[lid] = plus ? gid : -1 - gid;
       }
    }
    // We shifted the offsets vector by 1 by using it as a counter.
@@ -2818,6 +3063,51 @@ ElementRestriction::ElementRestriction(const FiniteElementSpace &f,
    offsets[0] = 0;
 }
 
+void ElementRestriction::GetElementColoring(const Array<int> *&offsets_,
+                                            const Array<int> *&elements) const
+{
+   if (color_offsets.Size() == 0 && ne > 0)
+   {
+      // Greedy coloring: each element gets the smallest color not used by the
+      // already colored elements it shares a dof with.
+      const int *h_offsets = offsets.HostRead();
+      const int *h_indices = indices.HostRead();
+      const int *h_map = gather_map.HostRead();
+      Array<int> color(ne), mark;
+      int num_colors = 0;
+      for (int e = 0; e < ne; e++)
+      {
+         mark.SetSize(num_colors + 1);
+         mark = 0;
+         for (int d = 0; d < dof; d++)
+         {
+            const int sgid = h_map[dof*e + d];
+            const int gid = (sgid >= 0) ? sgid : -1 - sgid;
+            for (int j = h_offsets[gid]; j < h_offsets[gid+1]; j++)
+            {
+               const int sl = h_indices[j];
+               const int e2 = ((sl >= 0) ? sl : -1 - sl) / dof;
+               if (e2 < e) { mark[color[e2]] = 1; }
+            }
+         }
+         int c = 0;
+         while (mark[c]) { c++; }
+         color[e] = c;
+         if (c == num_colors) { num_colors++; }
+      }
+      color_offsets.SetSize(num_colors + 1);
+      color_offsets = 0;
+      for (int e = 0; e < ne; e++) { color_offsets[color[e] + 1]++; }
+      color_offsets.PartialSum();
+      color_elements.SetSize(ne);
+      Array<int> next(num_colors);
+      for (int c = 0; c < num_colors; c++) { next[c] = color_offsets[c]; }
+      for (int e = 0; e < ne; e++) { color_elements[next[color[e]]++] = e; }
+   }
+   offsets_ = &color_offsets;
+   elements = &color_elements;
+}
+
 void ElementRestriction::Mult(const Vector& x, Vector& y) const
 {
    // Assumes all elements have the same number of dofs
@@ -2837,8 +3127,10 @@ void ElementRestriction::Mult(const Vector& x, Vector& y) const
          const double dofValue = d_x(t?c:i,t?i:c);
          for (int j = offset; j < nextOffset; ++j)
          {
-            const int idx_j = d_indices[j];
-            d_y(idx_j % nd, c, idx_j / nd) = dofValue;
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            d_y(idx_j % nd, c, idx_j / nd) =
+               (d_indices[j] >= 0) ? dofValue : -dofValue;
          }
       }
    });
@@ -2863,8 +3155,39 @@ void ElementRestriction::MultTranspose(const Vector& x, Vector& y) const
          double dofValue = 0;
          for (int j = offset; j < nextOffset; ++j)
          {
-            const int idx_j = d_indices[j];
-            dofValue +=  d_x(idx_j % nd, c, idx_j / nd);
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            dofValue += (d_indices[j] >= 0) ? d_x(idx_j % nd, c, idx_j / nd) :
+                        -d_x(idx_j % nd, c, idx_j / nd);
+         }
+         d_y(t?c:i,t?i:c) = dofValue;
+      }
+   });
+}
+
+void ElementRestriction::MultTransposeUnsigned(const Vector& x,
+                                               Vector& y) const
+{
+   // Assumes all elements have the same number of dofs
+   const int nd = dof;
+   const int vd = vdim;
+   const bool t = byvdim;
+   auto d_offsets = offsets.Read();
+   auto d_indices = indices.Read();
+   auto d_x = Reshape(x.Read(), nd, vd, ne);
+   auto d_y = Reshape(y.Write(), t?vd:ndofs, t?ndofs:vd);
+   MFEM_FORALL(i, ndofs,
+   {
+      const int offset = d_offsets[i];
+      const int nextOffset = d_offsets[i + 1];
+      for (int c = 0; c < vd; ++c)
+      {
+         double dofValue = 0;
+         for (int j = offset; j < nextOffset; ++j)
+         {
+            const int idx_j = (d_indices[j] >= 0) ? d_indices[j] :
+                              -1 - d_indices[j];
+            dofValue += d_x(idx_j % nd, c, idx_j / nd);
          }
          d_y(t?c:i,t?i:c) = dofValue;
       }
@@ -2878,7 +3201,7 @@ QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
    fespace = &fes;
    qspace = NULL;
    IntRule = &ir;
-   use_tensor_products = true; // not implemented yet (not used)
+   use_tensor_products = true;
 
    if (fespace->GetNE() == 0) { return; }
    const FiniteElement *fe = fespace->GetFE(0);
@@ -2892,7 +3215,7 @@ QuadratureInterpolator::QuadratureInterpolator(const FiniteElementSpace &fes,
    fespace = &fes;
    qspace = &qs;
    IntRule = NULL;
-   use_tensor_products = true; // not implemented yet (not used)
+   use_tensor_products = true;
 
    if (fespace->GetNE() == 0) { return; }
    const FiniteElement *fe = fespace->GetFE(0);
@@ -3081,6 +3404,560 @@ void QuadratureInterpolator::Eval3D(
    });
 }
 
+void QuadratureInterpolator::EvalTranspose(
+   const int NE,
+   const int dim,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int ND = maps.ndof;
+   const int NQ = maps.nqpt;
+   const int DIM = dim;
+   const int VDIM = vdim;
+   const bool eval_val = eval_flags & VALUES;
+   const bool eval_der = eval_flags & DERIVATIVES;
+   auto B = Reshape(maps.B.Read(), NQ, ND);
+   auto G = Reshape(maps.G.Read(), NQ, DIM, ND);
+   auto val = Reshape(q_val.Read(), NQ, VDIM, NE);
+   auto der = Reshape(q_der.Read(), NQ, VDIM, DIM, NE);
+   auto E = Reshape(e_vec.Write(), ND, VDIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      for (int c = 0; c < VDIM; c++)
+      {
+         for (int d = 0; d < ND; d++)
+         {
+            double s = 0.0;
+            for (int q = 0; q < NQ; q++)
+            {
+               if (eval_val) { s += B(q,d)*val(q,c,e); }
+               if (eval_der)
+               {
+                  for (int k = 0; k < DIM; k++) { s += G(q,k,d)*der(q,c,k,e); }
+               }
+            }
+            E(d,c,e) = s;
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEval2D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(VDIM == 2 || !(eval_flags & DETERMINANTS), "");
+   const bool eval_val = eval_flags & VALUES;
+   const bool eval_der = eval_flags & (DERIVATIVES | DETERMINANTS);
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto E = Reshape(e_vec.Read(), D1D, D1D, VDIM, NE);
+   auto val = Reshape(q_val.Write(), Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Write(), Q1D, Q1D, VDIM, 2, NE);
+   auto det = Reshape(q_det.Write(), Q1D, Q1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      for (int c = 0; c < VDIM; c++)
+      {
+         // Contraction in x: Bu = B u and Gu = G u
+         double Bu[max_D1D][max_Q1D], Gu[max_D1D][max_Q1D];
+         for (int dy = 0; dy < D1D; dy++)
+         {
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double bu = 0.0, gu = 0.0;
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  const double u = E(dx,dy,c,e);
+                  bu += B(qx,dx)*u;
+                  if (eval_der) { gu += G(qx,dx)*u; }
+               }
+               Bu[dy][qx] = bu;
+               Gu[dy][qx] = gu;
+            }
+         }
+         // Contraction in y
+         for (int qy = 0; qy < Q1D; qy++)
+         {
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double u = 0.0, du_dx = 0.0, du_dy = 0.0;
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  const double by = B(qy,dy);
+                  u += by*Bu[dy][qx];
+                  if (eval_der)
+                  {
+                     du_dx += by*Gu[dy][qx];
+                     du_dy += G(qy,dy)*Bu[dy][qx];
+                  }
+               }
+               if (eval_val) { val(qx,qy,c,e) = u; }
+               if (eval_der)
+               {
+                  der(qx,qy,c,0,e) = du_dx;
+                  der(qx,qy,c,1,e) = du_dy;
+               }
+            }
+         }
+      }
+      if (VDIM == 2 && (eval_flags & DETERMINANTS))
+      {
+         for (int qy = 0; qy < Q1D; qy++)
+         {
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               det(qx,qy,e) = der(qx,qy,0,0,e)*der(qx,qy,1,1,e) -
+                              der(qx,qy,1,0,e)*der(qx,qy,0,1,e);
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEval3D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &e_vec,
+   Vector &q_val,
+   Vector &q_der,
+   Vector &q_det,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   MFEM_VERIFY(VDIM == 3 || !(eval_flags & DETERMINANTS), "");
+   const bool eval_val = eval_flags & VALUES;
+   const bool eval_der = eval_flags & (DERIVATIVES | DETERMINANTS);
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto E = Reshape(e_vec.Read(), D1D, D1D, D1D, VDIM, NE);
+   auto val = Reshape(q_val.Write(), Q1D, Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Write(), Q1D, Q1D, Q1D, VDIM, 3, NE);
+   auto det = Reshape(q_det.Write(), Q1D, Q1D, Q1D, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      for (int c = 0; c < VDIM; c++)
+      {
+         // Contraction in x: Bu = B u and Gu = G u
+         double Bu[max_D1D][max_D1D][max_Q1D], Gu[max_D1D][max_D1D][max_Q1D];
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double bu = 0.0, gu = 0.0;
+                  for (int dx = 0; dx < D1D; dx++)
+                  {
+                     const double u = E(dx,dy,dz,c,e);
+                     bu += B(qx,dx)*u;
+                     if (eval_der) { gu += G(qx,dx)*u; }
+                  }
+                  Bu[dz][dy][qx] = bu;
+                  Gu[dz][dy][qx] = gu;
+               }
+            }
+         }
+         // Contraction in y: BBu = B B u, BGu = B G u, GBu = G B u
+         double BBu[max_D1D][max_Q1D][max_Q1D];
+         double BGu[max_D1D][max_Q1D][max_Q1D], GBu[max_D1D][max_Q1D][max_Q1D];
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double bbu = 0.0, bgu = 0.0, gbu = 0.0;
+                  for (int dy = 0; dy < D1D; dy++)
+                  {
+                     const double by = B(qy,dy);
+                     bbu += by*Bu[dz][dy][qx];
+                     if (eval_der)
+                     {
+                        bgu += by*Gu[dz][dy][qx];
+                        gbu += G(qy,dy)*Bu[dz][dy][qx];
+                     }
+                  }
+                  BBu[dz][qy][qx] = bbu;
+                  BGu[dz][qy][qx] = bgu;
+                  GBu[dz][qy][qx] = gbu;
+               }
+            }
+         }
+         // Contraction in z
+         for (int qz = 0; qz < Q1D; qz++)
+         {
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double u = 0.0, du_dx = 0.0, du_dy = 0.0, du_dz = 0.0;
+                  for (int dz = 0; dz < D1D; dz++)
+                  {
+                     const double bz = B(qz,dz);
+                     u += bz*BBu[dz][qy][qx];
+                     if (eval_der)
+                     {
+                        du_dx += bz*BGu[dz][qy][qx];
+                        du_dy += bz*GBu[dz][qy][qx];
+                        du_dz += G(qz,dz)*BBu[dz][qy][qx];
+                     }
+                  }
+                  if (eval_val) { val(qx,qy,qz,c,e) = u; }
+                  if (eval_der)
+                  {
+                     der(qx,qy,qz,c,0,e) = du_dx;
+                     der(qx,qy,qz,c,1,e) = du_dy;
+                     der(qx,qy,qz,c,2,e) = du_dz;
+                  }
+               }
+            }
+         }
+      }
+      if (VDIM == 3 && (eval_flags & DETERMINANTS))
+      {
+         for (int qz = 0; qz < Q1D; qz++)
+         {
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  // use MAX_VDIM3D to avoid "subscript out of range" warnings
+                  double D[MAX_VDIM3D*3];
+                  for (int i = 0; i < 9; i++)
+                  {
+                     D[i] = der(qx,qy,qz,i%3,i/3,e);
+                  }
+                  det(qx,qy,qz,e) = D[0] * (D[4] * D[8] - D[5] * D[7]) +
+                                    D[3] * (D[2] * D[7] - D[1] * D[8]) +
+                                    D[6] * (D[1] * D[5] - D[2] * D[4]);
+               }
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEvalTranspose2D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const bool eval_val = eval_flags & VALUES;
+   const bool eval_der = eval_flags & DERIVATIVES;
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto val = Reshape(q_val.Read(), Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Read(), Q1D, Q1D, VDIM, 2, NE);
+   auto E = Reshape(e_vec.Write(), D1D, D1D, VDIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      for (int c = 0; c < VDIM; c++)
+      {
+         // Contraction in y: U is multiplied by B and X by G in x
+         double U[max_D1D][max_Q1D], X[max_D1D][max_Q1D];
+         for (int dy = 0; dy < D1D; dy++)
+         {
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               double u = 0.0, x = 0.0;
+               for (int qy = 0; qy < Q1D; qy++)
+               {
+                  const double by = B(qy,dy);
+                  if (eval_val) { u += by*val(qx,qy,c,e); }
+                  if (eval_der)
+                  {
+                     u += G(qy,dy)*der(qx,qy,c,1,e);
+                     x += by*der(qx,qy,c,0,e);
+                  }
+               }
+               U[dy][qx] = u;
+               X[dy][qx] = x;
+            }
+         }
+         // Contraction in x
+         for (int dy = 0; dy < D1D; dy++)
+         {
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               double s = 0.0;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  s += B(qx,dx)*U[dy][qx] + G(qx,dx)*X[dy][qx];
+               }
+               E(dx,dy,c,e) = s;
+            }
+         }
+      }
+   });
+}
+
+template<const int T_VDIM, const int T_D1D, const int T_Q1D>
+void QuadratureInterpolator::TensorEvalTranspose3D(
+   const int NE,
+   const int vdim,
+   const DofToQuad &maps,
+   const Vector &q_val,
+   const Vector &q_der,
+   Vector &e_vec,
+   const int eval_flags)
+{
+   const int d1d = maps.ndof;
+   const int q1d = maps.nqpt;
+   const int D1D = T_D1D ? T_D1D : d1d;
+   const int Q1D = T_Q1D ? T_Q1D : q1d;
+   const int VDIM = T_VDIM ? T_VDIM : vdim;
+   MFEM_VERIFY(D1D <= MAX_D1D, "");
+   MFEM_VERIFY(Q1D <= MAX_Q1D, "");
+   const bool eval_val = eval_flags & VALUES;
+   const bool eval_der = eval_flags & DERIVATIVES;
+   auto B = Reshape(maps.B.Read(), Q1D, D1D);
+   auto G = Reshape(maps.G.Read(), Q1D, D1D);
+   auto val = Reshape(q_val.Read(), Q1D, Q1D, Q1D, VDIM, NE);
+   auto der = Reshape(q_der.Read(), Q1D, Q1D, Q1D, VDIM, 3, NE);
+   auto E = Reshape(e_vec.Write(), D1D, D1D, D1D, VDIM, NE);
+   MFEM_FORALL(e, NE,
+   {
+      const int D1D = T_D1D ? T_D1D : d1d;
+      const int Q1D = T_Q1D ? T_Q1D : q1d;
+      const int VDIM = T_VDIM ? T_VDIM : vdim;
+      constexpr int max_D1D = T_D1D ? T_D1D : MAX_D1D;
+      constexpr int max_Q1D = T_Q1D ? T_Q1D : MAX_Q1D;
+      for (int c = 0; c < VDIM; c++)
+      {
+         // Contraction in z: U1 is multiplied by B in x and y, X1 by G in x
+         // and B in y, Y1 by B in x and G in y
+         double U1[max_D1D][max_Q1D][max_Q1D];
+         double X1[max_D1D][max_Q1D][max_Q1D], Y1[max_D1D][max_Q1D][max_Q1D];
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double u = 0.0, x = 0.0, y = 0.0;
+                  for (int qz = 0; qz < Q1D; qz++)
+                  {
+                     const double bz = B(qz,dz);
+                     if (eval_val) { u += bz*val(qx,qy,qz,c,e); }
+                     if (eval_der)
+                     {
+                        u += G(qz,dz)*der(qx,qy,qz,c,2,e);
+                        x += bz*der(qx,qy,qz,c,0,e);
+                        y += bz*der(qx,qy,qz,c,1,e);
+                     }
+                  }
+                  U1[dz][qy][qx] = u;
+                  X1[dz][qy][qx] = x;
+                  Y1[dz][qy][qx] = y;
+               }
+            }
+         }
+         // Contraction in y: U2 is multiplied by B in x and X2 by G in x
+         double U2[max_D1D][max_D1D][max_Q1D], X2[max_D1D][max_D1D][max_Q1D];
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  double u = 0.0, x = 0.0;
+                  for (int qy = 0; qy < Q1D; qy++)
+                  {
+                     const double by = B(qy,dy);
+                     u += by*U1[dz][qy][qx] + G(qy,dy)*Y1[dz][qy][qx];
+                     x += by*X1[dz][qy][qx];
+                  }
+                  U2[dz][dy][qx] = u;
+                  X2[dz][dy][qx] = x;
+               }
+            }
+         }
+         // Contraction in x
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  double s = 0.0;
+                  for (int qx = 0; qx < Q1D; qx++)
+                  {
+                     s += B(qx,dx)*U2[dz][dy][qx] + G(qx,dx)*X2[dz][dy][qx];
+                  }
+                  E(dx,dy,dz,c,e) = s;
+               }
+            }
+         }
+      }
+   });
+}
+
+// The tensor kernels of QuadratureInterpolator, with a common signature for
+// the specializations selected by TensorKernel().
+typedef void (*TensorEvalKernel)(const int NE, const int vdim,
+                                 const DofToQuad &maps, const Vector &e_vec,
+                                 Vector &q_val, Vector &q_der, Vector &q_det,
+                                 const int eval_flags);
+typedef void (*TensorEvalTransposeKernel)(const int NE, const int vdim,
+                                          const DofToQuad &maps,
+                                          const Vector &q_val,
+                                          const Vector &q_der,
+                                          Vector &e_vec,
+                                          const int eval_flags);
+
+#define MFEM_TENSOR_KERNELS(Name, KernelType, Method)                   \
+   struct Name                                                          \
+   {                                                                    \
+      typedef KernelType Kernel;                                        \
+      template<int VDIM, int D1D, int Q1D> static Kernel Get()          \
+      { return &QuadratureInterpolator::Method<VDIM,D1D,Q1D>; }         \
+   }
+
+MFEM_TENSOR_KERNELS(TensorEval2DKernels, TensorEvalKernel, TensorEval2D);
+MFEM_TENSOR_KERNELS(TensorEval3DKernels, TensorEvalKernel, TensorEval3D);
+MFEM_TENSOR_KERNELS(TensorEvalTranspose2DKernels, TensorEvalTransposeKernel,
+                    TensorEvalTranspose2D);
+MFEM_TENSOR_KERNELS(TensorEvalTranspose3DKernels, TensorEvalTransposeKernel,
+                    TensorEvalTranspose3D);
+
+#undef MFEM_TENSOR_KERNELS
+
+// Return the specialization of the kernels K for the given sizes, or the
+// generic kernel.
+template<class K, int VDIM>
+static typename K::Kernel TensorKernel(const int d1d, const int q1d)
+{
+   switch (100*d1d + q1d)
+   {
+      // Q1
+      case 202: return K::template Get<VDIM,2,2>();
+      case 203: return K::template Get<VDIM,2,3>();
+      // Q2
+      case 303: return K::template Get<VDIM,3,3>();
+      case 304: return K::template Get<VDIM,3,4>();
+      // Q3
+      case 404: return K::template Get<VDIM,4,4>();
+      case 405: return K::template Get<VDIM,4,5>();
+      case 406: return K::template Get<VDIM,4,6>();
+      // Q4
+      case 505: return K::template Get<VDIM,5,5>();
+      case 506: return K::template Get<VDIM,5,6>();
+      case 507: return K::template Get<VDIM,5,7>();
+      case 508: return K::template Get<VDIM,5,8>();
+      default: return K::template Get<VDIM,0,0>();
+   }
+}
+
+template<class K2, class K3>
+static typename K2::Kernel TensorKernel(const int dim, const int vdim,
+                                        const int d1d, const int q1d)
+{
+   if (dim == 2)
+   {
+      if (vdim == 1) { return TensorKernel<K2,1>(d1d, q1d); }
+      if (vdim == 2) { return TensorKernel<K2,2>(d1d, q1d); }
+      return K2::template Get<0,0,0>();
+   }
+   if (vdim == 1) { return TensorKernel<K3,1>(d1d, q1d); }
+   if (vdim == 3) { return TensorKernel<K3,3>(d1d, q1d); }
+   return K3::template Get<0,0,0>();
+}
+
+// Check if the points of @a ir are the tensor product of the points of a 1D
+// rule with at most @a max_q1d points, ordered lexicographically, as assumed
+// by the tensor DofToQuad maps.
+static bool IsTensorRule(const IntegrationRule &ir, const int dim,
+                         const int max_q1d)
+{
+   const int nq = ir.GetNPoints();
+   const int q1d = (int)floor(pow(nq, 1.0/dim) + 0.5);
+   if (q1d > max_q1d || (dim == 2 ? q1d*q1d : q1d*q1d*q1d) != nq)
+   {
+      return false;
+   }
+   for (int q = 0; q < nq; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      if (ip.x != ir.IntPoint(q % q1d).x ||
+          ip.y != ir.IntPoint((q / q1d) % q1d).x ||
+          (dim == 3 && ip.z != ir.IntPoint(q / (q1d*q1d)).x))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool QuadratureInterpolator::UsesTensorProducts() const
+{
+   if (!use_tensor_products || fespace->GetNE() == 0) { return false; }
+   const FiniteElement *fe = fespace->GetFE(0);
+   const int dim = fe->GetDim();
+   if ((dim != 2 && dim != 3) ||
+       dynamic_cast<const TensorBasisElement*>(fe) == NULL ||
+       fe->GetOrder() + 1 > MAX_D1D)
+   {
+      return false;
+   }
+   const IntegrationRule &ir =
+      IntRule ? *IntRule : qspace->GetElementIntRule(0);
+   return IsTensorRule(ir, dim, MAX_Q1D);
+}
+
 void QuadratureInterpolator::Mult(
    const Vector &e_vec, unsigned eval_flags,
    Vector &q_val, Vector &q_der, Vector &q_det) const
@@ -3092,6 +3969,25 @@ void QuadratureInterpolator::Mult(
    const FiniteElement *fe = fespace->GetFE(0);
    const IntegrationRule *ir =
       IntRule ? IntRule : &qspace->GetElementIntRule(0);
+   if (UsesTensorProducts())
+   {
+      const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::TENSOR);
+      // The tensor kernels compute the determinants from the derivatives
+      Vector der_tmp;
+      const bool need_tmp =
+         (eval_flags & DETERMINANTS) && !(eval_flags & DERIVATIVES);
+      if (need_tmp)
+      {
+         der_tmp.SetSize(ir->GetNPoints()*vdim*dim*ne);
+         der_tmp.UseDevice(true);
+      }
+      const TensorEvalKernel kernel =
+         TensorKernel<TensorEval2DKernels,TensorEval3DKernels>(
+            dim, vdim, maps.ndof, maps.nqpt);
+      kernel(ne, vdim, maps, e_vec, q_val, need_tmp ? der_tmp : q_der, q_det,
+             eval_flags);
+      return;
+   }
    const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::FULL);
    const int nd = maps.ndof;
    const int nq = maps.nqpt;
@@ -3226,7 +4122,27 @@ void QuadratureInterpolator::MultTranspose(
    unsigned eval_flags, const Vector &q_val, const Vector &q_der,
    Vector &e_vec) const
 {
-   MFEM_ABORT("this method is not implemented yet");
+   MFEM_VERIFY(!(eval_flags & DETERMINANTS),
+               "the transpose of the determinants is not supported");
+   const int ne = fespace->GetNE();
+   if (ne == 0) { return; }
+   const int vdim = fespace->GetVDim();
+   const int dim = fespace->GetMesh()->Dimension();
+   const FiniteElement *fe = fespace->GetFE(0);
+   const IntegrationRule *ir =
+      IntRule ? IntRule : &qspace->GetElementIntRule(0);
+   if (UsesTensorProducts())
+   {
+      const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::TENSOR);
+      const TensorEvalTransposeKernel kernel =
+         TensorKernel<TensorEvalTranspose2DKernels,
+                      TensorEvalTranspose3DKernels>(dim, vdim, maps.ndof,
+                                                    maps.nqpt);
+      kernel(ne, vdim, maps, q_val, q_der, e_vec, eval_flags);
+      return;
+   }
+   const DofToQuad &maps = fe->GetDofToQuad(*ir, DofToQuad::FULL);
+   EvalTranspose(ne, dim, vdim, maps, q_val, q_der, e_vec, eval_flags);
 }
 
 } // namespace mfem
@@ -131,6 +131,11 @@ protected:
 
    mutable Array<QuadratureInterpolator*> E2Q_array;
 
+   /// Colorings of the elements and boundary elements, see
+   /// GetElementColoring().
+   mutable Array<int> elem_color_offsets, elem_color_elements;
+   mutable Array<int> bdr_color_offsets, bdr_color_elements;
+
    long sequence; // should match Mesh::GetSequence
 
    void UpdateNURBS();
@@ -176,9 +181,26 @@ protected:
       RefinementOperator(const FiniteElementSpace *fespace,
                          const FiniteElementSpace *coarse_fes);
       virtual void Mult(const Vector &x, Vector &y) const;
+      virtual void MultTranspose(const Vector &x, Vector &y) const;
       virtual ~RefinementOperator();
    };
 
+   /** @brief GridFunction interpolation operator between two spaces of
+       different order defined on the same mesh, used by the friend class
+       InterpolationGridTransfer. */
+   class PRefinementOperator : public Operator
+   {
+      const FiniteElementSpace *fine_fes;   // Not owned.
+      const FiniteElementSpace *coarse_fes; // Not owned.
+      DenseMatrix localP[Geometry::NumGeom];
+
+   public:
+      PRefinementOperator(const FiniteElementSpace *f_fes,
+                          const FiniteElementSpace *c_fes);
+      virtual void Mult(const Vector &x, Vector &y) const;
+      virtual void MultTranspose(const Vector &x, Vector &y) const;
+   };
+
    // Derefinement operator, used by the friend class InterpolationGridTransfer.
    class DerefinementOperator : public Operator
    {
@@ -485,6 +507,17 @@ public:
    const Table &GetElementToDofTable() const { return *elem_dof; }
    const Table &GetBdrElementToDofTable() const { return *bdrElem_dof; }
 
+   /** @brief Get a coloring of the elements, or of the boundary elements when
+       @a bdr is true, such that elements with the same color do not share any
+       dofs, computed on the first call. */
+   /** The elements of color c are @a elements[@a offsets[c]] to
+       @a elements[@a offsets[c+1]-1], in increasing order. Assembly loops can
+       process the elements of one color in parallel: their contributions go to
+       disjoint rows of the global matrix and entries of the global vector. */
+   void GetElementColoring(const Array<int> *&offsets,
+                           const Array<int> *&elements,
+                           bool bdr = false) const;
+
    int GetElementForDof(int i) const { return dof_elem_array[i]; }
    int GetLocalDofForDof(int i) const { return dof_ldof_array[i]; }
 
@@ -764,7 +797,11 @@ public:
     (VALUE, INTEGRAL, H_DIV, H_CURL - see class FiniteElement). Generally, the
     FE spaces can have different orders, however, in order for the backward
     operator to be well-defined, the (local) number of the fine dofs should not
-    be smaller than the number of coarse dofs. */
+    be smaller than the number of coarse dofs.
+
+    The two FE spaces can also be defined on the same mesh with different
+    orders, e.g. for p-multigrid. In that case only the matrix-free forward
+    operator is supported. */
 class InterpolationGridTransfer : public GridTransfer
 {
 protected:
@@ -893,11 +930,35 @@ protected:
    const int nedofs;
    Array<int> offsets;
    Array<int> indices;
+   Array<int> gather_map;
+   mutable Array<int> color_offsets, color_elements;
 
 public:
    ElementRestriction(const FiniteElementSpace&, ElementDofOrdering);
    void Mult(const Vector &x, Vector &y) const;
+   /** @brief Sum the E-vector entries of each dof into the L-vector @a y. */
+   /** Each dof gathers its own entries ("owner computes"), so the loop over the
+       dofs runs in parallel on all backends without atomics. */
    void MultTranspose(const Vector &x, Vector &y) const;
+   /** @brief Same as MultTranspose(), but ignoring the signs of the dofs of
+       H(curl) and H(div) spaces; used to assemble the diagonal. */
+   void MultTransposeUnsigned(const Vector &x, Vector &y) const;
+
+   /** @brief Return the map from the E-vector entries of the first vector
+       component to the scalar dofs, of size (element dofs) x ne. */
+   /** A negative entry, -1-i, refers to the dof i with a flipped sign. Kernels
+       that gather from and scatter to L-vectors with this map do not need the
+       E-vectors used by Mult() and MultTranspose(). */
+   const Array<int> &GatherMap() const { return gather_map; }
+
+   /** @brief Get a coloring of the elements such that elements with the same
+       color do not share any dofs, computed on the first call. */
+   /** The elements of color c are @a elements[@a offsets[c]] to
+       @a elements[@a offsets[c+1]-1], in increasing order. Kernels scattering
+       to L-vectors can process the elements of one color in parallel without
+       atomics. */
+   void GetElementColoring(const Array<int> *&offsets,
+                           const Array<int> *&elements) const;
 };
 
 /// Operator that converts L2 FiniteElementSpace L-vectors to E-vectors.
@@ -964,11 +1025,23 @@ public:
 
    /** @brief Disable the use of tensor product evaluations, for tensor-product
        elements, e.g. quads and hexes. */
-   /** Currently, tensor product evaluations are not implemented and this method
-       has no effect. */
+   /** Tensor product evaluations are used by default; see
+       UsesTensorProducts() for the conditions and for the ordering of the
+       E-vectors they require. */
    void DisableTensorProducts(bool disable = true) const
    { use_tensor_products = !disable; }
 
+   /** @brief Return true if Mult() and MultTranspose() use tensor product
+       (sum factorization) evaluations. */
+   /** This is the case, unless disabled with DisableTensorProducts(), when the
+       elements are tensor-product elements of dimension 2 or 3 and the
+       integration rule is the tensor product of a 1D rule, e.g. the rules
+       from IntRules on quads and hexes. The E-vectors must then use the
+       ElementDofOrdering::LEXICOGRAPHIC ordering; otherwise they use the
+       ElementDofOrdering::NATIVE ordering. The quadrature points are in the
+       order of the integration rule in both cases. */
+   bool UsesTensorProducts() const;
+
    /// Interpolate the E-vector @a e_vec to quadrature points.
    /** The @a eval_flags are a bitwise mask of constants from the EvalFlags
        enumeration. When the VALUES flag is set, the values at quadrature points
@@ -981,7 +1054,13 @@ public:
    void Mult(const Vector &e_vec, unsigned eval_flags,
              Vector &q_val, Vector &q_der, Vector &q_det) const;
 
-   /// Perform the transpose operation of Mult(). (TODO)
+   /// Perform the transpose operation of Mult().
+   /** The E-vector @a e_vec is set to the sum of the transposed interpolation
+       of the values @a q_val, when the VALUES flag is set in @a eval_flags, and
+       of the derivatives @a q_der, when the DERIVATIVES flag is set. The
+       DETERMINANTS flag is not supported. Together with Mult(), this expresses
+       the evaluation of a nonlinear form as interpolation, pointwise
+       operations at the quadrature points, and transposed interpolation. */
    void MultTranspose(unsigned eval_flags, const Vector &q_val,
                       const Vector &q_der, Vector &e_vec) const;
 
@@ -1008,6 +1087,62 @@ public:
                       Vector &q_der,
                       Vector &q_det,
                       const int eval_flags);
+
+   /// Compute kernel for the transpose of Eval2D() and Eval3D().
+   static void EvalTranspose(const int NE,
+                             const int dim,
+                             const int vdim,
+                             const DofToQuad &maps,
+                             const Vector &q_val,
+                             const Vector &q_der,
+                             Vector &e_vec,
+                             const int eval_flags);
+
+   /// Template compute kernel for 2D, using tensor products.
+   /** The derivatives are stored in @a q_der also when only the DETERMINANTS
+       flag is set. */
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEval2D(const int NE,
+                            const int vdim,
+                            const DofToQuad &maps,
+                            const Vector &e_vec,
+                            Vector &q_val,
+                            Vector &q_der,
+                            Vector &q_det,
+                            const int eval_flags);
+
+   /// Template compute kernel for 3D, using tensor products.
+   /** The derivatives are stored in @a q_der also when only the DETERMINANTS
+       flag is set. */
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEval3D(const int NE,
+                            const int vdim,
+                            const DofToQuad &maps,
+                            const Vector &e_vec,
+                            Vector &q_val,
+                            Vector &q_der,
+                            Vector &q_det,
+                            const int eval_flags);
+
+   /// Template compute kernel for the transpose of TensorEval2D().
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEvalTranspose2D(const int NE,
+                                     const int vdim,
+                                     const DofToQuad &maps,
+                                     const Vector &q_val,
+                                     const Vector &q_der,
+                                     Vector &e_vec,
+                                     const int eval_flags);
+
+   /// Template compute kernel for the transpose of TensorEval3D().
+   template<const int T_VDIM = 0, const int T_D1D = 0, const int T_Q1D = 0>
+   static void TensorEvalTranspose3D(const int NE,
+                                     const int vdim,
+                                     const DofToQuad &maps,
+                                     const Vector &q_val,
+                                     const Vector &q_der,
+                                     Vector &e_vec,
+                                     const int eval_flags);
 };
 
 }
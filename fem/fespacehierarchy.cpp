@@ -0,0 +1,104 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "fespacehierarchy.hpp"
+
+namespace mfem
+{
+
+FiniteElementSpaceHierarchy::FiniteElementSpaceHierarchy(
+   Mesh *mesh, FiniteElementSpace *fespace, bool own_mesh, bool own_fespace)
+{
+   AddLevel(mesh, fespace, own_mesh, own_fespace);
+}
+
+FiniteElementSpaceHierarchy::~FiniteElementSpaceHierarchy()
+{
+   for (int l = 0; l < transfers.Size(); l++)
+   {
+      delete transfers[l];
+   }
+   for (int l = 0; l < fespaces.Size(); l++)
+   {
+      if (own_fespaces[l]) { delete fespaces[l]; }
+      if (own_meshes[l]) { delete meshes[l]; }
+   }
+   for (int i = 0; i < fecs.Size(); i++)
+   {
+      delete fecs[i];
+   }
+}
+
+void FiniteElementSpaceHierarchy::AddLevel(Mesh *mesh,
+                                           FiniteElementSpace *fespace,
+                                           bool own_mesh, bool own_fespace)
+{
+   if (fespaces.Size() > 0)
+   {
+      transfers.Append(
+         new InterpolationGridTransfer(*fespaces.Last(), *fespace));
+      // Construct the (matrix-free) true-dof prolongation
+      transfers.Last()->TrueForwardOperator();
+   }
+   meshes.Append(mesh);
+   fespaces.Append(fespace);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fespace);
+}
+
+void FiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   const FiniteElementSpace &coarse = GetFinestFESpace();
+   Mesh *mesh = new Mesh(*meshes.Last());
+   mesh->UniformRefinement();
+   FiniteElementSpace *fespace =
+      new FiniteElementSpace(mesh, coarse.FEColl(), coarse.GetVDim(),
+                             coarse.GetOrdering());
+   AddLevel(mesh, fespace, true, true);
+}
+
+void FiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   FiniteElementCollection *fec)
+{
+   const FiniteElementSpace &coarse = GetFinestFESpace();
+   fecs.Append(fec);
+   FiniteElementSpace *fespace =
+      new FiniteElementSpace(meshes.Last(), fec, coarse.GetVDim(),
+                             coarse.GetOrdering());
+   AddLevel(meshes.Last(), fespace, false, true);
+}
+
+#ifdef MFEM_USE_MPI
+void ParFiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   const ParFiniteElementSpace &coarse = GetFinestFESpace();
+   ParMesh *mesh = new ParMesh(*static_cast<ParMesh*>(meshes.Last()));
+   mesh->UniformRefinement();
+   ParFiniteElementSpace *fespace =
+      new ParFiniteElementSpace(mesh, coarse.FEColl(), coarse.GetVDim(),
+                                coarse.GetOrdering());
+   AddLevel(mesh, fespace, true, true);
+}
+
+void ParFiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   FiniteElementCollection *fec)
+{
+   const ParFiniteElementSpace &coarse = GetFinestFESpace();
+   fecs.Append(fec);
+   ParMesh *mesh = static_cast<ParMesh*>(meshes.Last());
+   ParFiniteElementSpace *fespace =
+      new ParFiniteElementSpace(mesh, fec, coarse.GetVDim(),
+                                coarse.GetOrdering());
+   AddLevel(mesh, fespace, false, true);
+}
+#endif
+
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_FESPACEHIERARCHY
+#define MFEM_FESPACEHIERARCHY
+
+#include "../config/config.hpp"
+#include "fespace.hpp"
+#ifdef MFEM_USE_MPI
+#include "pfespace.hpp"
+#endif
+
+namespace mfem
+{
+
+/** @brief A hierarchy of finite element spaces, from the coarsest (level 0) to
+    the finest, connected by true-dof prolongation operators. */
+/** New levels are obtained either by uniform refinement of the mesh of the
+    finest level (h-refinement), or by changing the FiniteElementCollection on
+    the same mesh (p-refinement). The prolongations are the matrix-free
+    InterpolationGridTransfer true-dof forward operators between consecutive
+    levels. */
+class FiniteElementSpaceHierarchy
+{
+protected:
+   Array<Mesh*> meshes;
+   Array<FiniteElementSpace*> fespaces;
+   Array<FiniteElementCollection*> fecs; ///< Owned collections
+   Array<GridTransfer*> transfers;       ///< Size: number of levels - 1
+   Array<bool> own_meshes, own_fespaces;
+
+   /// Append a level and construct the prolongation to it, if not the first.
+   void AddLevel(Mesh *mesh, FiniteElementSpace *fespace, bool own_mesh,
+                 bool own_fespace);
+
+public:
+   /** @brief Construct a hierarchy with the given coarsest @a mesh and
+       @a fespace. The ownership flags determine if they are destroyed with the
+       hierarchy. */
+   FiniteElementSpaceHierarchy(Mesh *mesh, FiniteElementSpace *fespace,
+                               bool own_mesh, bool own_fespace);
+
+   /// Destroy the owned meshes, spaces, collections and prolongations.
+   virtual ~FiniteElementSpaceHierarchy();
+
+   /// Return the number of levels.
+   int GetNumLevels() const { return fespaces.Size(); }
+
+   /// Return the index of the finest level.
+   int GetFinestLevelIndex() const { return GetNumLevels() - 1; }
+
+   /** @brief Add a level by uniformly refining a copy of the mesh of the
+       finest level, using the same FiniteElementCollection. */
+   virtual void AddUniformlyRefinedLevel();
+
+   /** @brief Add a level on the mesh of the finest level using the given
+       collection @a fec, e.g. with a higher polynomial order. The hierarchy
+       takes ownership of @a fec. */
+   virtual void AddOrderRefinedLevel(FiniteElementCollection *fec);
+
+   /// Return the FiniteElementSpace on the given @a level.
+   FiniteElementSpace &GetFESpaceAtLevel(int level) const
+   { return *fespaces[level]; }
+
+   /// Return the FiniteElementSpace on the finest level.
+   FiniteElementSpace &GetFinestFESpace() const
+   { return *fespaces.Last(); }
+
+   /// Return the true-dof prolongation from @a level to @a level + 1.
+   const Operator *GetProlongationAtLevel(int level) const
+   { return &transfers[level]->TrueForwardOperator(); }
+};
+
+#ifdef MFEM_USE_MPI
+/// Parallel version of FiniteElementSpaceHierarchy.
+class ParFiniteElementSpaceHierarchy : public FiniteElementSpaceHierarchy
+{
+public:
+   ParFiniteElementSpaceHierarchy(ParMesh *mesh, ParFiniteElementSpace *fespace,
+                                  bool own_mesh, bool own_fespace)
+      : FiniteElementSpaceHierarchy(mesh, fespace, own_mesh, own_fespace) { }
+
+   virtual void AddUniformlyRefinedLevel();
+
+   virtual void AddOrderRefinedLevel(FiniteElementCollection *fec);
+
+   /// Return the ParFiniteElementSpace on the given @a level.
+   ParFiniteElementSpace &GetFESpaceAtLevel(int level) const
+   { return static_cast<ParFiniteElementSpace&>(*fespaces[level]); }
+
+   /// Return the ParFiniteElementSpace on the finest level.
+   ParFiniteElementSpace &GetFinestFESpace() const
+   { return static_cast<ParFiniteElementSpace&>(*fespaces.Last()); }
+};
+#endif
+
+}
+
+#endif
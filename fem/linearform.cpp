@@ -12,6 +12,7 @@
 // Implementation of class LinearForm
 
 #include "fem.hpp"
+#include <algorithm>
 
 namespace mfem
 {
@@ -24,6 +25,7 @@ LinearForm::LinearForm(FiniteElementSpace *f, LinearForm *lf)
 
    fes = f;
    extern_lfs = 1;
+   threaded_assembly = lf->threaded_assembly;
 
    // Copy the pointers to the integrators
    dlfi = lf->dlfi;
@@ -90,7 +92,11 @@ void LinearForm::Assemble()
    // The first use of AddElementVector() below will move it back to host
    // because both 'vdofs' and 'elemvect' are on host.
 
-   if (dlfi.Size())
+   if (dlfi.Size() && threaded_assembly)
+   {
+      ThreadedAssembleElements(false, Array<int>());
+   }
+   else if (dlfi.Size())
    {
       for (i = 0; i < fes -> GetNE(); i++)
       {
@@ -130,20 +136,27 @@ void LinearForm::Assemble()
          }
       }
 
-      for (i = 0; i < fes -> GetNBE(); i++)
+      if (threaded_assembly)
       {
-         const int bdr_attr = mesh->GetBdrAttribute(i);
-         if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
-         fes -> GetBdrElementVDofs (i, vdofs);
-         eltrans = fes -> GetBdrElementTransformation (i);
-         for (int k=0; k < blfi.Size(); k++)
+         ThreadedAssembleElements(true, bdr_attr_marker);
+      }
+      else
+      {
+         for (i = 0; i < fes -> GetNBE(); i++)
          {
-            if (blfi_marker[k] &&
-                (*blfi_marker[k])[bdr_attr-1] == 0) { continue; }
+            const int bdr_attr = mesh->GetBdrAttribute(i);
+            if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+            fes -> GetBdrElementVDofs (i, vdofs);
+            eltrans = fes -> GetBdrElementTransformation (i);
+            for (int k=0; k < blfi.Size(); k++)
+            {
+               if (blfi_marker[k] &&
+                   (*blfi_marker[k])[bdr_attr-1] == 0) { continue; }
 
-            blfi[k]->AssembleRHSElementVect(*fes->GetBE(i), *eltrans, elemvect);
+               blfi[k]->AssembleRHSElementVect(*fes->GetBE(i), *eltrans, elemvect);
 
-            AddElementVector (vdofs, elemvect);
+               AddElementVector (vdofs, elemvect);
+            }
          }
       }
    }
@@ -196,6 +209,67 @@ void LinearForm::Assemble()
    }
 }
 
+void LinearForm::ThreadedAssembleElements(bool bdr,
+                                          const Array<int> &bdr_attr_marker)
+{
+   Mesh *mesh = fes->GetMesh();
+   const Array<int> *offsets, *elements;
+   fes->GetElementColoring(offsets, elements, bdr);
+   const int num_colors = std::max(offsets->Size() - 1, 0);
+   double *b = HostReadWrite();
+
+   // The elements of one color are processed in parallel; the implicit barrier
+   // at the end of each "omp for" separates the colors.
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation eltrans;
+      Vector elemvect;
+      Array<int> vdofs;
+      for (int c = 0; c < num_colors; c++)
+      {
+#if defined(MFEM_USE_OPENMP) && defined(MFEM_THREAD_SAFE)
+         #pragma omp for schedule(dynamic, 16)
+#endif
+         for (int j = (*offsets)[c]; j < (*offsets)[c+1]; j++)
+         {
+            const int i = (*elements)[j];
+            const Array<LinearFormIntegrator*> &integs = bdr ? blfi : dlfi;
+            const FiniteElement *fe;
+            int bdr_attr = 0;
+            if (bdr)
+            {
+               bdr_attr = mesh->GetBdrAttribute(i);
+               if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+               fe = fes->GetBE(i);
+               fes->GetBdrElementVDofs(i, vdofs);
+               mesh->GetBdrElementTransformation(i, &eltrans);
+            }
+            else
+            {
+               fe = fes->GetFE(i);
+               fes->GetElementVDofs(i, vdofs);
+               mesh->GetElementTransformation(i, &eltrans);
+            }
+            for (int k = 0; k < integs.Size(); k++)
+            {
+               if (bdr && blfi_marker[k] &&
+                   (*blfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+               integs[k]->AssembleRHSElementVect(*fe, eltrans, elemvect);
+               for (int d = 0; d < vdofs.Size(); d++)
+               {
+                  const int vd = vdofs[d];
+                  if (vd >= 0) { b[vd] += elemvect(d); }
+                  else { b[-1-vd] -= elemvect(d); }
+               }
+            }
+         }
+      }
+   }
+}
+
 void LinearForm::Update(FiniteElementSpace *f, Vector &v, int v_offset)
 {
    fes = f;
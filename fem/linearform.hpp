@@ -56,6 +56,12 @@ protected:
    /// Force (re)computation of delta locations.
    void ResetDeltaLocations() { dlfi_delta_elem_id.SetSize(0); }
 
+   /// Use the threaded element loops, see EnableThreadedAssembly().
+   bool threaded_assembly;
+
+   /// Add the element vectors of #dlfi, or of #blfi when @a bdr is true.
+   void ThreadedAssembleElements(bool bdr, const Array<int> &bdr_attr_marker);
+
 private:
    /// Copy construction is not supported; body is undefined.
    LinearForm(const LinearForm &);
@@ -64,7 +70,7 @@ public:
    /// Creates linear form associated with FE space @a *f.
    /** The pointer @a f is not owned by the newly constructed object. */
    LinearForm(FiniteElementSpace *f) : Vector(f->GetVSize())
-   { fes = f; extern_lfs = 0; UseDevice(true); }
+   { fes = f; extern_lfs = 0; threaded_assembly = false; UseDevice(true); }
 
    /** @brief Create a LinearForm on the FiniteElementSpace @a f, using the
        same integrators as the LinearForm @a lf.
@@ -79,7 +85,8 @@ public:
    /** The associated FiniteElementSpace can be set later using one of the
        methods: Update(FiniteElementSpace *) or
        Update(FiniteElementSpace *, Vector &, int). */
-   LinearForm() { fes = NULL; extern_lfs = 0; UseDevice(true); }
+   LinearForm()
+   { fes = NULL; extern_lfs = 0; threaded_assembly = false; UseDevice(true); }
 
    /// Copy assignment. Only the data of the base class Vector is copied.
    /** It is assumed that this object and @a rhs use FiniteElementSpace%s that
@@ -144,6 +151,14 @@ public:
        corresponding pointer (to Array<int>) will be NULL. */
    Array<Array<int>*> *GetFLFI_Marker() { return &flfi_marker; }
 
+   /** @brief Enable (or disable) the threaded assembly of the element vectors
+       of the domain and boundary integrators. */
+   /** The elements of each color given by
+       FiniteElementSpace::GetElementColoring() are processed in parallel, see
+       BilinearForm::EnableThreadedAssembly() for the requirements. */
+   void EnableThreadedAssembly(bool enable = true)
+   { threaded_assembly = enable; }
+
    /// Assembles the linear form i.e. sums over all domain/bdr integrators.
    void Assemble();
 
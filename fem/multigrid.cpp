@@ -0,0 +1,156 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "multigrid.hpp"
+#include "../linalg/sparsesmoothers.hpp"
+#include "../linalg/solvers.hpp"
+#ifdef MFEM_USE_MPI
+#include "pbilinearform.hpp"
+#include "../linalg/hypre.hpp"
+#endif
+
+namespace mfem
+{
+
+GeometricMultigrid::GeometricMultigrid(FiniteElementSpaceHierarchy &fespaces_,
+                                       const Array<int> &ess_bdr_)
+   : fespaces(fespaces_), coarse_prec(NULL), smoother_order(2)
+{
+   ess_bdr_.Copy(ess_bdr);
+}
+
+GeometricMultigrid::~GeometricMultigrid()
+{
+   // The operators in 'opers' are referenced by the Multigrid base class,
+   // which is destroyed after this class, so they are not owned by it.
+   for (int l = 0; l < forms.Size(); l++)
+   {
+      delete opers[l];
+      delete forms[l];
+      delete ess_tdofs[l];
+   }
+   delete coarse_prec;
+}
+
+BilinearForm *GeometricMultigrid::NewForm(FiniteElementSpace &fes) const
+{
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes = dynamic_cast<ParFiniteElementSpace*>(&fes);
+   if (pfes) { return new ParBilinearForm(pfes); }
+#endif
+   return new BilinearForm(&fes);
+}
+
+Solver *GeometricMultigrid::ConstructCoarseSolver(OperatorHandle &A)
+{
+#ifdef MFEM_USE_MPI
+   if (A.Type() == Operator::Hypre_ParCSR)
+   {
+      HypreBoomerAMG *amg = new HypreBoomerAMG(*A.As<HypreParMatrix>());
+      amg->SetPrintLevel(0);
+      return amg;
+   }
+#endif
+   SparseMatrix *mat = A.As<SparseMatrix>();
+   MFEM_VERIFY(mat, "the coarse operator is not a SparseMatrix");
+   coarse_prec = new GSSmoother(*mat);
+   CGSolver *cg = new CGSolver;
+   cg->SetRelTol(1e-8);
+   cg->SetMaxIter(500);
+   cg->SetPrintLevel(-1);
+   cg->SetPreconditioner(*coarse_prec);
+   cg->SetOperator(*mat);
+   return cg;
+}
+
+void GeometricMultigrid::AssembleLevel(int level)
+{
+   MFEM_VERIFY(level == forms.Size() && level < fespaces.GetNumLevels(),
+               "invalid level: " << level);
+   FiniteElementSpace &fes = fespaces.GetFESpaceAtLevel(level);
+
+   Array<int> *ess_list = new Array<int>;
+   if (fes.GetMesh()->bdr_attributes.Size())
+   {
+      fes.GetEssentialTrueDofs(ess_bdr, *ess_list);
+   }
+   ess_tdofs.Append(ess_list);
+
+   BilinearForm *form = NewForm(fes);
+   forms.Append(form);
+   OperatorHandle *A = new OperatorHandle;
+   opers.Append(A);
+
+   if (level == 0)
+   {
+#ifdef MFEM_USE_MPI
+      if (dynamic_cast<ParBilinearForm*>(form))
+      {
+         A->SetType(Operator::Hypre_ParCSR);
+      }
+#endif
+      AddIntegrators(*form);
+      form->Assemble();
+      form->FormSystemMatrix(*ess_list, *A);
+      AddCoarsestLevel(A->Ptr(), ConstructCoarseSolver(*A), false, true);
+      return;
+   }
+
+   form->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   AddIntegrators(*form);
+   form->Assemble();
+   form->FormSystemMatrix(*ess_list, *A);
+
+   Vector diag(A->Ptr()->Height());
+   A->Ptr()->AssembleDiagonal(diag);
+   Solver *smoother;
+#ifdef MFEM_USE_MPI
+   ParFiniteElementSpace *pfes = dynamic_cast<ParFiniteElementSpace*>(&fes);
+   if (pfes)
+   {
+      smoother = new OperatorChebyshevSmoother(pfes->GetComm(), *A->Ptr(),
+                                               diag, *ess_list,
+                                               smoother_order);
+   }
+   else
+#endif
+   {
+      smoother = new OperatorChebyshevSmoother(*A->Ptr(), diag, *ess_list,
+                                               smoother_order);
+   }
+   AddLevel(A->Ptr(), smoother, fespaces.GetProlongationAtLevel(level-1),
+            false, true, false);
+}
+
+void GeometricMultigrid::Assemble()
+{
+   for (int l = forms.Size(); l < fespaces.GetNumLevels(); l++)
+   {
+      AssembleLevel(l);
+   }
+}
+
+void GeometricMultigrid::FormFineLinearSystem(Vector &x, Vector &b,
+                                              OperatorHandle &A,
+                                              Vector &X, Vector &B)
+{
+   MFEM_VERIFY(forms.Size() == fespaces.GetNumLevels(),
+               "the multigrid levels are not assembled");
+   forms.Last()->FormLinearSystem(*ess_tdofs.Last(), x, b, A, X, B);
+}
+
+void GeometricMultigrid::RecoverFineFEMSolution(const Vector &X,
+                                                const Vector &b, Vector &x)
+{
+   forms.Last()->RecoverFEMSolution(X, b, x);
+}
+
+}
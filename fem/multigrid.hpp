@@ -0,0 +1,94 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_FEM_MULTIGRID
+#define MFEM_FEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../linalg/multigrid.hpp"
+#include "fespacehierarchy.hpp"
+#include "bilinearform.hpp"
+
+namespace mfem
+{
+
+/** @brief Geometric (h- and p-) multigrid solver for a BilinearForm, based on
+    a FiniteElementSpaceHierarchy. */
+/** On all levels except the coarsest one, the BilinearForm is partially
+    assembled (AssemblyLevel::PARTIAL) and smoothed with an
+    OperatorChebyshevSmoother based on the PA diagonal. Only the coarsest level
+    is fully assembled and solved with the solver returned by
+    ConstructCoarseSolver(): by default, CG preconditioned with GSSmoother in
+    serial, and HypreBoomerAMG in parallel.
+
+    The integrators of the form are defined by derived classes, see
+    AddIntegrators(). The levels are assembled with AssembleLevel() or
+    Assemble(), which must be called before the solver is used. */
+class GeometricMultigrid : public Multigrid
+{
+protected:
+   FiniteElementSpaceHierarchy &fespaces;
+   Array<int> ess_bdr;
+   Array<Array<int>*> ess_tdofs;
+   Array<BilinearForm*> forms;
+   Array<OperatorHandle*> opers;
+   Solver *coarse_prec; ///< Preconditioner used by the coarse solver, if any
+   int smoother_order;
+
+   /// Return a new (Par)BilinearForm on the (Par)FiniteElementSpace @a fes.
+   BilinearForm *NewForm(FiniteElementSpace &fes) const;
+
+   /** @brief Add the domain (and boundary) integrators defining the form on
+       every level. This method is called for each level. */
+   virtual void AddIntegrators(BilinearForm &form) = 0;
+
+   /// Construct the solver for the assembled coarsest level operator @a A.
+   virtual Solver *ConstructCoarseSolver(OperatorHandle &A);
+
+public:
+   /** @brief Construct the multigrid solver for the given hierarchy. The
+       boundary attributes marked in @a ess_bdr are essential. */
+   GeometricMultigrid(FiniteElementSpaceHierarchy &fespaces,
+                      const Array<int> &ess_bdr);
+
+   virtual ~GeometricMultigrid();
+
+   /// Set the order of the Chebyshev smoothers, the default is 2.
+   void SetSmootherOrder(int order) { smoother_order = order; }
+
+   /** @brief Assemble the operator and the smoother (coarse solver, on level
+       0) of the next level. The levels are assembled in order, starting from
+       the coarsest one; @a level is checked for consistency. */
+   void AssembleLevel(int level);
+
+   /// Assemble all levels that have not been assembled yet.
+   void Assemble();
+
+   /// Return the list of essential true dofs on the finest level.
+   const Array<int> &GetFineEssentialTrueDofs() const
+   { return *ess_tdofs.Last(); }
+
+   /// Return the BilinearForm on the given @a level.
+   BilinearForm &GetFormAtLevel(int level) const { return *forms[level]; }
+
+   /** @brief Form the linear system on the finest level, see
+       BilinearForm::FormLinearSystem(). */
+   void FormFineLinearSystem(Vector &x, Vector &b, OperatorHandle &A,
+                             Vector &X, Vector &B);
+
+   /** @brief Recover the solution of the linear system on the finest level,
+       see BilinearForm::RecoverFEMSolution(). */
+   void RecoverFineFEMSolution(const Vector &X, const Vector &b, Vector &x);
+};
+
+}
+
+#endif
@@ -14,6 +14,37 @@
 namespace mfem
 {
 
+void NonlinearForm::SetAssemblyLevel(AssemblyLevel assembly_level)
+{
+   if (ext)
+   {
+      MFEM_ABORT("the assembly level has already been set!");
+   }
+   assembly = assembly_level;
+   switch (assembly)
+   {
+      case AssemblyLevel::FULL:
+         // This is the default
+         break;
+      case AssemblyLevel::PARTIAL:
+         ext = new PANonlinearFormExtension(this);
+         break;
+      default:
+         MFEM_ABORT("Unsupported assembly level for NonlinearForm");
+   }
+}
+
+void NonlinearForm::Setup()
+{
+   if (ext)
+   {
+      MFEM_VERIFY(fnfi.Size() == 0 && bfnfi.Size() == 0,
+                  "face integrators are not supported with "
+                  "AssemblyLevel::PARTIAL");
+      ext->Assemble();
+   }
+}
+
 void NonlinearForm::SetEssentialBC(const Array<int> &bdr_attr_is_ess,
                                    Vector *rhs)
 {
@@ -117,6 +148,21 @@ void NonlinearForm::Mult(const Vector &x, Vector &y) const
    const Vector &px = Prolongate(x);
    Vector &py = P ? aux2.SetSize(P->Height()), aux2 : y;
 
+   if (ext)
+   {
+      ext->Mult(px, py);
+      if (Serial())
+      {
+         if (cP) { cP->MultTranspose(py, y); }
+         for (int i = 0; i < ess_tdof_list.Size(); i++)
+         {
+            y(ess_tdof_list[i]) = 0.0;
+         }
+      }
+      // In parallel, the result is in py, i.e. aux2, see ParNonlinearForm
+      return;
+   }
+
    py = 0.0;
 
    if (dnfi.Size())
@@ -241,6 +287,17 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
    Mesh *mesh = fes->GetMesh();
    const Vector &px = Prolongate(x);
 
+   if (ext)
+   {
+      // The gradient on true dofs with the boundary conditions, in serial and
+      // in parallel
+      hGrad.Clear();
+      Operator *Gop;
+      ext->GetGradient(px).FormSystemOperator(ess_tdof_list, Gop);
+      hGrad.Reset(Gop);
+      return *hGrad;
+   }
+
    if (Grad == NULL)
    {
       Grad = new SparseMatrix(fes->GetVSize());
@@ -360,8 +417,15 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
    {
       if (cP)
       {
-         delete cGrad;
-         cGrad = RAP(*cP, *Grad, *cP);
+         // The sparsity pattern of Grad is fixed after the first call, so the
+         // pattern of cGrad is computed once and only its values are updated.
+         if (cGrad == NULL)
+         {
+            delete cGrad_rap;
+            cGrad_rap = new SparseRAP(*cP, *cP);
+            cGrad = cGrad_rap->Symbolic(*Grad);
+         }
+         cGrad_rap->Numeric(*Grad, *cGrad);
          mGrad = cGrad;
       }
       for (int i = 0; i < ess_tdof_list.Size(); i++)
@@ -379,17 +443,22 @@ void NonlinearForm::Update()
 
    height = width = fes->GetTrueVSize();
    delete cGrad; cGrad = NULL;
+   delete cGrad_rap; cGrad_rap = NULL;
    delete Grad; Grad = NULL;
    ess_tdof_list.SetSize(0); // essential b.c. will need to be set again
    sequence = fes->GetSequence();
    // Do not modify aux1 and aux2, their size will be set before use.
    P = fes->GetProlongationMatrix();
    cP = dynamic_cast<const SparseMatrix*>(P);
+   hGrad.Clear();
+   if (ext) { ext->Update(); } // Setup() will need to be called again
 }
 
 NonlinearForm::~NonlinearForm()
 {
+   delete ext;
    delete cGrad;
+   delete cGrad_rap;
    delete Grad;
    for (int i = 0; i <  dnfi.Size(); i++) { delete  dnfi[i]; }
    for (int i = 0; i <  fnfi.Size(); i++) { delete  fnfi[i]; }
@@ -14,6 +14,8 @@
 
 #include "../config/config.hpp"
 #include "nonlininteg.hpp"
+#include "nonlinearform_ext.hpp"
+#include "bilinearform.hpp"
 #include "gridfunc.hpp"
 
 namespace mfem
@@ -22,6 +24,14 @@ namespace mfem
 class NonlinearForm : public Operator
 {
 protected:
+   /// The assembly level.
+   AssemblyLevel assembly;
+
+   /** Extension for supporting different assembly levels; the default
+       AssemblyLevel::FULL uses the element matrices and a SparseMatrix
+       gradient. Owned. */
+   NonlinearFormExtension *ext;
+
    /// FE space on which the form lives.
    FiniteElementSpace *fes; // not owned
 
@@ -36,6 +46,10 @@ protected:
    Array<Array<int>*>              bfnfi_marker; // not owned
 
    mutable SparseMatrix *Grad, *cGrad; // owned
+   /// Triple product P^T Grad P computing cGrad, with P = cP.
+   mutable SparseRAP *cGrad_rap; // owned
+   /// Gradient on true dofs, with boundary conditions, when ext is set.
+   mutable OperatorHandle hGrad; // owned
 
    /// A list of all essential true dofs
    Array<int> ess_tdof_list;
@@ -59,11 +73,31 @@ public:
    /** As an Operator, the NonlinearForm has input and output size equal to the
        number of true degrees of freedom, i.e. f->GetTrueVSize(). */
    NonlinearForm(FiniteElementSpace *f)
-      : Operator(f->GetTrueVSize()), fes(f), Grad(NULL), cGrad(NULL),
+      : Operator(f->GetTrueVSize()), assembly(AssemblyLevel::FULL), ext(NULL),
+        fes(f), Grad(NULL), cGrad(NULL), cGrad_rap(NULL),
         sequence(f->GetSequence()), P(f->GetProlongationMatrix()),
         cP(dynamic_cast<const SparseMatrix*>(P))
    { }
 
+   /// Set the desired assembly level. The default is AssemblyLevel::FULL.
+   /** With AssemblyLevel::PARTIAL, the domain integrators must implement the
+       partial assembly methods of NonlinearFormIntegrator, face integrators are
+       not supported, and GetGradient() returns an Operator that applies the
+       gradient without assembling a matrix. Setup() must be called after
+       adding the integrators.
+
+       This method must be called before assembly. */
+   void SetAssemblyLevel(AssemblyLevel assembly_level);
+
+   /// Return the assembly level.
+   AssemblyLevel GetAssemblyLevel() const { return assembly; }
+
+   /// Setup the NonlinearForm for the current AssemblyLevel and mesh.
+   /** With AssemblyLevel::PARTIAL, this precomputes the data used by Mult()
+       and GetGradient(), e.g. the geometric factors; it must be called again
+       when the mesh nodes change. With AssemblyLevel::FULL, it does nothing. */
+   void Setup();
+
    FiniteElementSpace *FESpace() { return fes; }
    const FiniteElementSpace *FESpace() const { return fes; }
 
@@ -71,6 +105,9 @@ public:
    void AddDomainIntegrator(NonlinearFormIntegrator *nlfi)
    { dnfi.Append(nlfi); }
 
+   /// Access all integrators added with AddDomainIntegrator().
+   Array<NonlinearFormIntegrator*> *GetDNFI() { return &dnfi; }
+
    /// Adds new Interior Face Integrator.
    void AddInteriorFaceIntegrator(NonlinearFormIntegrator *nlfi)
    { fnfi.Append(nlfi); }
@@ -132,7 +169,9 @@ public:
        automatically imposed on the gradient operator.
 
        The returned object is valid until the next call to this method or the
-       destruction of this object.
+       destruction of this object. With AssemblyLevel::FULL it is a
+       SparseMatrix, in serial; with AssemblyLevel::PARTIAL it is a matrix-free
+       Operator on true dofs, in serial and in parallel.
 
        In general, @a x may have non-homogeneous essential boundary values.
 
@@ -0,0 +1,104 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementations of classes NonlinearFormExtension and
+// PANonlinearFormExtension.
+
+#include "nonlinearform.hpp"
+
+namespace mfem
+{
+
+NonlinearFormExtension::NonlinearFormExtension(NonlinearForm *form)
+   : Operator(form->FESpace()->GetVSize()), nlf(form)
+{
+   // empty
+}
+
+
+// Data and methods for partially-assembled nonlinear forms
+PANonlinearFormExtension::PANonlinearFormExtension(NonlinearForm *form)
+   : NonlinearFormExtension(form), fes(*form->FESpace()),
+     dnfi(*form->GetDNFI()), elem_restrict(NULL), grad(NULL),
+     assembled(false)
+{
+   Setup();
+}
+
+void PANonlinearFormExtension::Setup()
+{
+   height = width = fes.GetVSize();
+   // Use the lexicographic ordering, as the tensor product evaluations in the
+   // integrators require, when the elements support it
+   const bool tensor = fes.GetNE() > 0 &&
+                       dynamic_cast<const TensorBasisElement*>(fes.GetFE(0));
+   elem_restrict = fes.GetElementRestriction(
+                      tensor ? ElementDofOrdering::LEXICOGRAPHIC :
+                      ElementDofOrdering::NATIVE);
+   MFEM_VERIFY(elem_restrict, "the space has no element restriction");
+   xe.SetSize(elem_restrict->Height(), Device::GetMemoryType());
+   ye.SetSize(elem_restrict->Height(), Device::GetMemoryType());
+   ye.UseDevice(true); // ensure 'ye = 0.0' is done on device
+   delete grad;
+   grad = new Gradient(*this);
+   assembled = false;
+}
+
+void PANonlinearFormExtension::Assemble()
+{
+   for (int i = 0; i < dnfi.Size(); ++i)
+   {
+      dnfi[i]->AssemblePA(fes);
+   }
+   assembled = true;
+}
+
+void PANonlinearFormExtension::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(assembled, "NonlinearForm::Setup() must be called first");
+   elem_restrict->Mult(x, xe);
+   ye = 0.0;
+   for (int i = 0; i < dnfi.Size(); ++i)
+   {
+      dnfi[i]->AddMultPA(xe, ye);
+   }
+   elem_restrict->MultTranspose(ye, y);
+}
+
+Operator &PANonlinearFormExtension::GetGradient(const Vector &x) const
+{
+   MFEM_VERIFY(assembled, "NonlinearForm::Setup() must be called first");
+   elem_restrict->Mult(x, xe);
+   for (int i = 0; i < dnfi.Size(); ++i)
+   {
+      dnfi[i]->AssembleGradPA(xe, fes);
+   }
+   return *grad;
+}
+
+void PANonlinearFormExtension::Update()
+{
+   Setup();
+}
+
+void PANonlinearFormExtension::Gradient::Mult(const Vector &x,
+                                              Vector &y) const
+{
+   ext.elem_restrict->Mult(x, ext.xe);
+   ext.ye = 0.0;
+   for (int i = 0; i < ext.dnfi.Size(); ++i)
+   {
+      ext.dnfi[i]->AddMultGradPA(ext.xe, ext.ye);
+   }
+   ext.elem_restrict->MultTranspose(ext.ye, y);
+}
+
+}
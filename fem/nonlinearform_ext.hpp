@@ -0,0 +1,109 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_NONLINEARFORM_EXT
+#define MFEM_NONLINEARFORM_EXT
+
+#include "../config/config.hpp"
+#include "fespace.hpp"
+#include "../general/device.hpp"
+
+namespace mfem
+{
+
+class NonlinearForm;
+class NonlinearFormIntegrator;
+
+
+/** @brief Class extending the NonlinearForm class to support the different
+    AssemblyLevel%s. */
+/** The extension acts on L-vectors, i.e. on vectors of size
+    FiniteElementSpace::GetVSize(); the NonlinearForm applies the prolongation
+    and the essential boundary conditions. */
+class NonlinearFormExtension : public Operator
+{
+protected:
+   NonlinearForm *nlf; ///< Not owned
+
+public:
+   NonlinearFormExtension(NonlinearForm *form);
+
+   virtual MemoryClass GetMemoryClass() const
+   { return Device::GetMemoryClass(); }
+
+   /// Assemble the data used by Mult() and GetGradient().
+   virtual void Assemble() = 0;
+
+   /** @brief Return the gradient at the state @a x, an L-vector, as an Operator
+       on L-vectors, without essential boundary conditions. */
+   /** The returned object is valid until the next call to this method or to
+       Update(). Its GetProlongation() and GetRestriction() are those of the
+       FiniteElementSpace of the form. */
+   virtual Operator &GetGradient(const Vector &x) const = 0;
+
+   virtual void Update() = 0;
+};
+
+/// Data and methods for partially-assembled nonlinear forms
+/** The domain integrators act on E-vectors through AddMultPA(), and their
+    gradient through AssembleGradPA() and AddMultGradPA(): the gradient is
+    applied from data stored at the quadrature points, without assembling a
+    matrix. The E-vectors use the ElementDofOrdering::LEXICOGRAPHIC ordering
+    for tensor-product elements and the ElementDofOrdering::NATIVE ordering
+    otherwise. Face integrators are not supported. */
+class PANonlinearFormExtension : public NonlinearFormExtension
+{
+protected:
+   /// The gradient of the form, acting on L-vectors.
+   class Gradient : public Operator
+   {
+   protected:
+      const PANonlinearFormExtension &ext;
+
+   public:
+      Gradient(const PANonlinearFormExtension &e)
+         : Operator(e.Height()), ext(e) { }
+
+      virtual MemoryClass GetMemoryClass() const
+      { return Device::GetMemoryClass(); }
+
+      virtual void Mult(const Vector &x, Vector &y) const;
+
+      virtual const Operator *GetProlongation() const
+      { return ext.fes.GetProlongationMatrix(); }
+
+      virtual const Operator *GetRestriction() const
+      { return ext.fes.GetRestrictionMatrix(); }
+   };
+
+   const FiniteElementSpace &fes;                ///< Not owned
+   const Array<NonlinearFormIntegrator*> &dnfi;  ///< Not owned
+   const Operator *elem_restrict;                ///< Not owned
+   mutable Vector xe, ye;
+   Gradient *grad;
+   bool assembled;
+
+   void Setup();
+
+public:
+   PANonlinearFormExtension(NonlinearForm *form);
+
+   void Assemble();
+   void Mult(const Vector &x, Vector &y) const;
+   Operator &GetGradient(const Vector &x) const;
+   void Update();
+
+   virtual ~PANonlinearFormExtension() { delete grad; }
+};
+
+}
+
+#endif
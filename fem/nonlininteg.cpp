@@ -10,6 +10,7 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "fem.hpp"
+#include "../general/forall.hpp"
 
 namespace mfem
 {
@@ -55,6 +56,31 @@ double NonlinearFormIntegrator::GetElementEnergy(
    return 0.0;
 }
 
+void NonlinearFormIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   mfem_error("NonlinearFormIntegrator::AssemblePA"
+              " is not overloaded!");
+}
+
+void NonlinearFormIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   mfem_error("NonlinearFormIntegrator::AddMultPA"
+              " is not overloaded!");
+}
+
+void NonlinearFormIntegrator::AssembleGradPA(const Vector &x,
+                                             const FiniteElementSpace &fes)
+{
+   mfem_error("NonlinearFormIntegrator::AssembleGradPA"
+              " is not overloaded!");
+}
+
+void NonlinearFormIntegrator::AddMultGradPA(const Vector &x, Vector &y) const
+{
+   mfem_error("NonlinearFormIntegrator::AddMultGradPA"
+              " is not overloaded!");
+}
+
 
 void BlockNonlinearFormIntegrator::AssembleElementVector(
    const Array<const FiniteElement *> &el,
@@ -439,6 +465,198 @@ void HyperelasticNLFIntegrator::AssembleElementGrad(const FiniteElement &el,
    }
 }
 
+void HyperelasticNLFIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   Mesh *mesh = fes.GetMesh();
+   const FiniteElement &el = *fes.GetFE(0);
+   const int dim = el.GetDim();
+   MFEM_VERIFY(fes.GetVDim() == dim && mesh->SpaceDimension() == dim,
+               "the vector dimension of the space must be the mesh dimension");
+
+   pa_fes = &fes;
+   pa_ir = IntRule;
+   if (!pa_ir)
+   {
+      pa_ir = &(IntRules.Get(el.GetGeomType(), 2*el.GetOrder() + 3)); // <---
+   }
+   qi = fes.GetQuadratureInterpolator(*pa_ir);
+   MFEM_VERIFY(qi->UsesTensorProducts() ||
+               dynamic_cast<const TensorBasisElement*>(&el) == NULL,
+               "tensor-product elements require a tensor-product rule");
+
+   const int NE = fes.GetNE();
+   const int NQ = pa_ir->GetNPoints();
+   const int geom_size = dim*dim + 1;
+   const GeometricFactors *geom =
+      mesh->GetGeometricFactors(*pa_ir, GeometricFactors::JACOBIANS |
+                                GeometricFactors::DETERMINANTS);
+   const double *J = geom->J.HostRead();
+   const double *detJ = geom->detJ.HostRead();
+   pa_geom.SetSize(geom_size*NQ*NE);
+   double *G = pa_geom.HostWrite();
+   DenseMatrix Jtr(dim), Jrt;
+   for (int e = 0; e < NE; e++)
+   {
+      for (int q = 0; q < NQ; q++)
+      {
+         for (int j = 0; j < dim; j++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               Jtr(i,j) = J[q + NQ*(i + dim*(j + dim*e))];
+            }
+         }
+         double *g = G + geom_size*(q + NQ*e);
+         Jrt.UseExternalData(g, dim, dim);
+         CalcInverse(Jtr, Jrt);
+         g[dim*dim] = pa_ir->IntPoint(q).weight * detJ[q + NQ*e];
+      }
+   }
+   pa_grad.Destroy();
+}
+
+void HyperelasticNLFIntegrator::InterpolateDerivatives(const Vector &x) const
+{
+   const int dim = pa_fes->GetMesh()->Dimension();
+   const int NQ = pa_ir->GetNPoints();
+   Vector empty;
+   q_der.SetSize(NQ*dim*dim*pa_fes->GetNE());
+   qi->Mult(x, QuadratureInterpolator::DERIVATIVES, empty, q_der, empty);
+}
+
+void HyperelasticNLFIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(qi != NULL, "AssemblePA() must be called first");
+   Mesh *mesh = pa_fes->GetMesh();
+   const int dim = mesh->Dimension();
+   const int NE = pa_fes->GetNE();
+   const int NQ = pa_ir->GetNPoints();
+   const int geom_size = dim*dim + 1;
+
+   InterpolateDerivatives(x);
+   q_out.SetSize(q_der.Size());
+   const double *D = q_der.HostRead();
+   const double *G = pa_geom.HostRead();
+   double *Q = q_out.HostWrite();
+   DenseMatrix Jpr(dim), Jpt(dim), Jrt, P(dim), PJ(dim);
+   for (int e = 0; e < NE; e++)
+   {
+      ElementTransformation *T = mesh->GetElementTransformation(e);
+      model->SetTransformation(*T);
+      for (int q = 0; q < NQ; q++)
+      {
+         T->SetIntPoint(&pa_ir->IntPoint(q));
+         const double *g = G + geom_size*(q + NQ*e);
+         Jrt.UseExternalData(const_cast<double*>(g), dim, dim);
+         for (int m = 0; m < dim; m++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               Jpr(i,m) = D[q + NQ*(i + dim*(m + dim*e))];
+            }
+         }
+         Mult(Jpr, Jrt, Jpt);
+         model->EvalP(Jpt, P);
+         P *= g[dim*dim];
+         // The reference derivatives of the test functions are mapped by Jrt
+         MultABt(P, Jrt, PJ);
+         for (int m = 0; m < dim; m++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               Q[q + NQ*(i + dim*(m + dim*e))] = PJ(i,m);
+            }
+         }
+      }
+   }
+   Vector empty;
+   e_out.SetSize(y.Size());
+   qi->MultTranspose(QuadratureInterpolator::DERIVATIVES, empty, q_out, e_out);
+   y += e_out;
+}
+
+void HyperelasticNLFIntegrator::AssembleGradPA(const Vector &x,
+                                               const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(pa_fes == &fes, "AssemblePA() must be called first");
+   Mesh *mesh = fes.GetMesh();
+   const int dim = mesh->Dimension();
+   const int dim2 = dim*dim;
+   const int NE = fes.GetNE();
+   const int NQ = pa_ir->GetNPoints();
+   const int geom_size = dim2 + 1;
+
+   InterpolateDerivatives(x);
+   pa_grad.SetSize(dim2*dim2*NQ*NE);
+   const double *D = q_der.HostRead();
+   const double *G = pa_geom.HostRead();
+   double *H = pa_grad.HostWrite();
+   DenseMatrix Jpr(dim), Jpt(dim), Jrt, A;
+   for (int e = 0; e < NE; e++)
+   {
+      ElementTransformation *T = mesh->GetElementTransformation(e);
+      model->SetTransformation(*T);
+      for (int q = 0; q < NQ; q++)
+      {
+         T->SetIntPoint(&pa_ir->IntPoint(q));
+         const double *g = G + geom_size*(q + NQ*e);
+         Jrt.UseExternalData(const_cast<double*>(g), dim, dim);
+         for (int m = 0; m < dim; m++)
+         {
+            for (int i = 0; i < dim; i++)
+            {
+               Jpr(i,m) = D[q + NQ*(i + dim*(m + dim*e))];
+            }
+         }
+         Mult(Jpr, Jrt, Jpt);
+         // With DS = Jrt, i.e. one "dof" per reference direction, AssembleH()
+         // computes the tangent with respect to the reference gradients
+         A.UseExternalData(H + dim2*dim2*(q + NQ*e), dim2, dim2);
+         A = 0.0;
+         model->AssembleH(Jpt, Jrt, g[dim2], A);
+      }
+   }
+}
+
+void HyperelasticNLFIntegrator::AddMultGradPA(const Vector &x,
+                                              Vector &y) const
+{
+   MFEM_VERIFY(pa_grad.Size() > 0, "AssembleGradPA() must be called first");
+   const int DIM = pa_fes->GetMesh()->Dimension();
+   const int NE = pa_fes->GetNE();
+   const int NQ = pa_ir->GetNPoints();
+
+   InterpolateDerivatives(x);
+   q_out.SetSize(q_der.Size());
+   auto H = Reshape(pa_grad.Read(), DIM, DIM, DIM, DIM, NQ, NE);
+   auto D = Reshape(q_der.Read(), NQ, DIM, DIM, NE);
+   auto Q = Reshape(q_out.Write(), NQ, DIM, DIM, NE);
+   MFEM_FORALL(qe, NQ*NE,
+   {
+      const int q = qe % NQ;
+      const int e = qe / NQ;
+      for (int i = 0; i < DIM; i++)
+      {
+         for (int m = 0; m < DIM; m++)
+         {
+            double s = 0.0;
+            for (int j = 0; j < DIM; j++)
+            {
+               for (int n = 0; n < DIM; n++)
+               {
+                  s += H(m,i,n,j,q,e)*D(q,j,n,e);
+               }
+            }
+            Q(q,i,m,e) = s;
+         }
+      }
+   });
+   Vector empty;
+   e_out.SetSize(y.Size());
+   qi->MultTranspose(QuadratureInterpolator::DERIVATIVES, empty, q_out, e_out);
+   y += e_out;
+}
+
 double IncompressibleNeoHookeanIntegrator::GetElementEnergy(
    const Array<const FiniteElement *>&el,
    ElementTransformation &Tr,
@@ -15,6 +15,7 @@
 #include "../config/config.hpp"
 #include "fe.hpp"
 #include "coefficient.hpp"
+#include "fespace.hpp"
 
 namespace mfem
 {
@@ -68,6 +69,37 @@ public:
                                    ElementTransformation &Tr,
                                    const Vector &elfun);
 
+   /// Method defining partial assembly.
+   /** The result of the partial assembly is stored internally so that it can
+       be used later in the methods AddMultPA(), AssembleGradPA() and
+       AddMultGradPA(). */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   /// Method for partially assembled action.
+   /** Perform the action of the integrator on the input E-vector @a x and add
+       the result to the output E-vector @a y. For nonlinear forms, the
+       E-vectors use the ElementDofOrdering::LEXICOGRAPHIC ordering for
+       tensor-product elements and the ElementDofOrdering::NATIVE ordering
+       otherwise, see PANonlinearFormExtension.
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Prepare the partially assembled gradient at the state @a x.
+   /** Compute and store the quadrature point data defining the action of the
+       gradient of the integrator at the state given by the E-vector @a x, as
+       in AddMultPA(), for use in AddMultGradPA().
+
+       This method can be called only after the method AssemblePA() has been
+       called. */
+   virtual void AssembleGradPA(const Vector &x, const FiniteElementSpace &fes);
+
+   /// Method for partially assembled gradient action.
+   /** Add to the E-vector @a y the action on the E-vector @a x of the gradient
+       at the state given to the last call of AssembleGradPA(). */
+   virtual void AddMultGradPA(const Vector &x, Vector &y) const;
+
    virtual ~NonlinearFormIntegrator() { }
 };
 
@@ -233,9 +265,25 @@ private:
    //        output - the result of AssembleElementVector() (dof x dim).
    DenseMatrix DSh, DS, Jrt, Jpr, Jpt, P, PMatI, PMatO;
 
+   // Partial assembly data
+   const FiniteElementSpace *pa_fes;  // not owned
+   const IntegrationRule *pa_ir;      // not owned
+   const QuadratureInterpolator *qi;  // not owned
+   // At each quadrature point: Jrt and the integration weight, the quadrature
+   // weight times det(Jtr)
+   Vector pa_geom;
+   // At each quadrature point: the derivative of P with respect to the
+   // reference gradient of the state, multiplied by Jrt^t and the weight
+   Vector pa_grad;
+   mutable Vector q_der, q_out, e_out;
+
+   /// Set q_der to the reference gradients of the state @a x.
+   void InterpolateDerivatives(const Vector &x) const;
+
 public:
    /** @param[in] m  HyperelasticModel that will be integrated. */
-   HyperelasticNLFIntegrator(HyperelasticModel *m) : model(m) { }
+   HyperelasticNLFIntegrator(HyperelasticModel *m)
+      : model(m), pa_fes(NULL), pa_ir(NULL), qi(NULL) { }
 
    /** @brief Computes the integral of W(Jacobian(Trt)) over a target zone
        @param[in] el     Type of FiniteElement.
@@ -252,6 +300,28 @@ public:
    virtual void AssembleElementGrad(const FiniteElement &el,
                                     ElementTransformation &Ttr,
                                     const Vector &elfun, DenseMatrix &elmat);
+
+   /** @brief Store the target geometry, given by the current mesh, at the
+       quadrature points. */
+   /** The space @a fes must have vector dimension equal to the mesh
+       dimension. The integration rule must be a tensor-product rule for
+       tensor-product elements. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   /// Evaluate the residual at the quadrature points of all elements.
+   /** The stress tensors are computed by the HyperelasticModel point by point,
+       on the host; the interpolation to and from the quadrature points uses
+       the QuadratureInterpolator of the space. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Store the tangent moduli of the HyperelasticModel at the state @a x.
+   /** The tangent at each quadrature point is computed by
+       HyperelasticModel::AssembleH(), and stored as a dim^2 x dim^2 matrix
+       acting on the reference gradients of the state. */
+   virtual void AssembleGradPA(const Vector &x, const FiniteElementSpace &fes);
+
+   /// Apply the stored tangent moduli, without assembling a matrix.
+   virtual void AddMultGradPA(const Vector &x, Vector &y) const;
 };
 
 /** Hyperelastic incompressible Neo-Hookean integrator with the PK1 stress
@@ -12,6 +12,7 @@
 #include "forall.hpp"
 #include "cuda.hpp"
 #include "occa.hpp"
+#include "profiler.hpp"
 
 #include <string>
 #include <map>
@@ -35,14 +36,14 @@ static const Backend::Id backend_list[Backend::NUM_BACKENDS] =
    Backend::OCCA_CUDA, Backend::RAJA_CUDA, Backend::CUDA,
    Backend::HIP,
    Backend::OCCA_OMP, Backend::RAJA_OMP, Backend::OMP,
-   Backend::OCCA_CPU, Backend::RAJA_CPU, Backend::CPU
+   Backend::OCCA_CPU, Backend::RAJA_CPU, Backend::SIMD, Backend::CPU
 };
 
 // Backend names listed by priority, high to low:
 static const char *backend_name[Backend::NUM_BACKENDS] =
 {
    "occa-cuda", "raja-cuda", "cuda", "hip", "occa-omp", "raja-omp", "omp",
-   "occa-cpu", "raja-cpu", "cpu"
+   "occa-cpu", "raja-cpu", "simd", "cpu"
 };
 
 } // namespace mfem::internal
@@ -54,6 +55,7 @@ Device Device::device_singleton;
 
 Device::~Device()
 {
+   KernelProfiler::Finalize();
    if (destroy_mm) { mm.Destroy(); }
 }
 
@@ -54,7 +54,11 @@ struct Backend
       OCCA_OMP = 1 << 8,
       /** @brief [device] OCCA CUDA backend. Enabled when MFEM_USE_OCCA = YES
           and MFEM_USE_CUDA = YES. */
-      OCCA_CUDA = 1 << 9
+      OCCA_CUDA = 1 << 9,
+      /** @brief [host] SIMD CPU backend: sequential execution on each MPI rank,
+          where the partial assembly kernels of the mass and diffusion
+          integrators process several elements at once in the SIMD lanes. */
+      SIMD = 1 << 10
    };
 
    /** @brief Additional useful constants. For example, the *_MASK constants can
@@ -62,7 +66,7 @@ struct Backend
    enum
    {
       /// Number of backends: from (1 << 0) to (1 << (NUM_BACKENDS-1)).
-      NUM_BACKENDS = 10,
+      NUM_BACKENDS = 11,
 
       /// Biwise-OR of all CPU backends
       CPU_MASK = CPU | RAJA_CPU | OCCA_CPU,
@@ -183,7 +187,7 @@ public:
        * The 'cpu' backend is always enabled with lowest priority.
        * The current backend priority from highest to lowest is: 'occa-cuda',
          'raja-cuda', 'cuda', 'hip', 'occa-omp', 'raja-omp', 'omp', 'occa-cpu',
-         'raja-cpu', 'cpu'.
+         'raja-cpu', 'simd', 'cpu'.
        * Multiple backends can be configured at the same time.
        * Only one 'occa-*' backend can be configured at a time.
        * The backend 'occa-cuda' enables the 'cuda' backend unless 'raja-cuda'
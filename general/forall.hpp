@@ -19,6 +19,7 @@
 #include "occa.hpp"
 #include "device.hpp"
 #include "mem_manager.hpp"
+#include "profiler.hpp"
 #include "../linalg/dtensor.hpp"
 
 #ifdef MFEM_USE_RAJA
@@ -40,20 +41,20 @@ const int MAX_Q1D = 16;
 
 // The MFEM_FORALL wrapper
 #define MFEM_FORALL(i,N,...)                             \
-   ForallWrap<1>(true,N,                                 \
+   ForallWrap<1>(__FILE__,__LINE__,true,N,               \
                  [=] MFEM_DEVICE (int i) {__VA_ARGS__},  \
                  [&]             (int i) {__VA_ARGS__})
 
 // MFEM_FORALL with a 2D CUDA block
 #define MFEM_FORALL_2D(i,N,X,Y,BZ,...)                   \
-   ForallWrap<2>(true,N,                                 \
+   ForallWrap<2>(__FILE__,__LINE__,true,N,               \
                  [=] MFEM_DEVICE (int i) {__VA_ARGS__},  \
                  [&]             (int i) {__VA_ARGS__},  \
                  X,Y,BZ)
 
 // MFEM_FORALL with a 3D CUDA block
 #define MFEM_FORALL_3D(i,N,X,Y,Z,...)                    \
-   ForallWrap<3>(true,N,                                 \
+   ForallWrap<3>(__FILE__,__LINE__,true,N,               \
                  [=] MFEM_DEVICE (int i) {__VA_ARGS__},  \
                  [&]             (int i) {__VA_ARGS__},  \
                  X,Y,Z)
@@ -62,17 +63,22 @@ const int MAX_Q1D = 16;
 // example the functions in vector.cpp, where we don't want to use the mfem
 // device for operations on small vectors.
 #define MFEM_FORALL_SWITCH(use_dev,i,N,...)              \
-   ForallWrap<1>(use_dev,N,                              \
+   ForallWrap<1>(__FILE__,__LINE__,use_dev,N,            \
                  [=] MFEM_DEVICE (int i) {__VA_ARGS__},  \
                  [&]             (int i) {__VA_ARGS__})
 
 
-/// OpenMP backend
+/** @brief OpenMP backend. */
+/** The iterations are partitioned statically, so that loops of the same length
+    give each thread the same range of indices. Since the pages of a new Vector
+    are placed on the NUMA node of the thread that first writes to them, e.g.
+    the quadrature data of partial assembly, later kernels on the same data
+    access memory local to their threads. */
 template <typename HBODY>
 void OmpWrap(const int N, HBODY &&h_body)
 {
 #ifdef MFEM_USE_OPENMP
-   #pragma omp parallel for
+   #pragma omp parallel for schedule(static)
    for (int k = 0; k < N; k++)
    {
       h_body(k);
@@ -290,11 +296,11 @@ void HipWrap3D(const int N, DBODY &&d_body,
 #endif // MFEM_USE_HIP
 
 
-/// The forall kernel body wrapper
+/// Run the forall kernel body with the highest priority allowed backend
 template <const int DIM, typename DBODY, typename HBODY>
-inline void ForallWrap(const bool use_dev, const int N,
-                       DBODY &&d_body, HBODY &&h_body,
-                       const int X=0, const int Y=0, const int Z=0)
+inline void ForallRun(const bool use_dev, const int N,
+                      DBODY &&d_body, HBODY &&h_body,
+                      const int X, const int Y, const int Z)
 {
    if (!use_dev) { goto backend_cpu; }
 
@@ -358,6 +364,23 @@ backend_cpu:
    for (int k = 0; k < N; k++) { h_body(k); }
 }
 
+/** @brief The forall kernel body wrapper. The kernel launch is recorded for
+    the site @a file:@a line when the KernelProfiler is enabled. */
+template <const int DIM, typename DBODY, typename HBODY>
+inline void ForallWrap(const char *file, const int line,
+                       const bool use_dev, const int N,
+                       DBODY &&d_body, HBODY &&h_body,
+                       const int X=0, const int Y=0, const int Z=0)
+{
+   if (KernelProfiler::IsEnabled())
+   {
+      KernelProfilerScope scope(file, line, N);
+      ForallRun<DIM>(use_dev, N, d_body, h_body, X, Y, Z);
+      return;
+   }
+   ForallRun<DIM>(use_dev, N, d_body, h_body, X, Y, Z);
+}
+
 } // namespace mfem
 
 #endif // MFEM_FORALL_HPP
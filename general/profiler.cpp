@@ -0,0 +1,237 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "profiler.hpp"
+#include "device.hpp"
+#include "cuda.hpp"
+#include "hip.hpp"
+#include "error.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace mfem
+{
+
+namespace internal
+{
+
+struct KernelRecord
+{
+   std::string name; // empty: use file:line
+   long calls = 0;
+   double iterations = 0.0, time = 0.0, flops = 0.0, bytes = 0.0;
+};
+
+// The records are keyed by the file name and line of the kernel site; the same
+// file name may have several addresses, e.g. in different translation units.
+typedef std::map<std::pair<std::string, int>, KernelRecord> KernelRecords;
+
+// The records and the report file name are allocated on first use and never
+// deleted, so that they are still available in the destructor of the static
+// Device::device_singleton.
+static KernelRecords &GetKernelRecords()
+{
+   static KernelRecords *records = new KernelRecords;
+   return *records;
+}
+
+static std::string &GetReportFileName()
+{
+   static std::string *filename = new std::string;
+   return *filename;
+}
+
+// Protects the records in the kernels launched from several threads.
+static std::mutex &GetKernelRecordsMutex()
+{
+   static std::mutex *mutex = new std::mutex;
+   return *mutex;
+}
+
+// Info given by MFEM_KERNEL_INFO for the next kernel of each thread.
+static MFEM_THREAD_LOCAL const char *next_name = NULL;
+static MFEM_THREAD_LOCAL double next_flops = 0.0, next_bytes = 0.0;
+static MFEM_THREAD_LOCAL bool next_info = false;
+
+static void JSONString(std::ostream &out, const std::string &s)
+{
+   out << '"';
+   for (std::string::size_type i = 0; i < s.size(); i++)
+   {
+      if (s[i] == '"' || s[i] == '\\') { out << '\\'; }
+      out << s[i];
+   }
+   out << '"';
+}
+
+static bool EnableFromEnv()
+{
+   const char *file = std::getenv("MFEM_KERNEL_PROFILE");
+   if (file) { GetReportFileName() = file; }
+   return file != NULL;
+}
+
+} // namespace mfem::internal
+
+
+bool KernelProfiler::enabled = internal::EnableFromEnv();
+
+void KernelProfiler::Enable(const std::string &file)
+{
+   if (!file.empty()) { internal::GetReportFileName() = file; }
+   enabled = true;
+}
+
+void KernelProfiler::Reset()
+{
+   std::lock_guard<std::mutex> lock(internal::GetKernelRecordsMutex());
+   internal::GetKernelRecords().clear();
+   internal::next_info = false;
+}
+
+void KernelProfiler::SetKernelInfo(const char *name, double flops,
+                                   double bytes)
+{
+   internal::next_name = name;
+   internal::next_flops = flops;
+   internal::next_bytes = bytes;
+   internal::next_info = true;
+}
+
+void KernelProfiler::ClearKernelInfo()
+{
+   internal::next_info = false;
+}
+
+void KernelProfiler::Record(const char *file, int line, int n, double seconds)
+{
+   std::lock_guard<std::mutex> lock(internal::GetKernelRecordsMutex());
+   internal::KernelRecord &rec =
+      internal::GetKernelRecords()[std::make_pair(std::string(file), line)];
+   rec.calls++;
+   rec.iterations += n;
+   rec.time += seconds;
+   if (internal::next_info)
+   {
+      if (internal::next_name) { rec.name = internal::next_name; }
+      rec.flops += internal::next_flops * n;
+      rec.bytes += internal::next_bytes * n;
+      internal::next_info = false;
+   }
+   if (rec.name.empty())
+   {
+      std::ostringstream name;
+      name << file << ':' << line;
+      rec.name = name.str();
+   }
+}
+
+double KernelProfiler::Time()
+{
+   if (Device::Allows(Backend::DEVICE_MASK))
+   {
+#ifdef MFEM_USE_CUDA
+      MFEM_DEVICE_SYNC;
+#endif
+#ifdef MFEM_USE_HIP
+      MFEM_GPU_CHECK(hipDeviceSynchronize());
+#endif
+   }
+   using namespace std::chrono;
+   return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+long KernelProfiler::GetCalls(const std::string &name)
+{
+   std::lock_guard<std::mutex> lock(internal::GetKernelRecordsMutex());
+   long calls = 0;
+   internal::KernelRecords &records = internal::GetKernelRecords();
+   internal::KernelRecords::const_iterator it;
+   for (it = records.begin(); it != records.end(); ++it)
+   {
+      if (it->second.name == name) { calls += it->second.calls; }
+   }
+   return calls;
+}
+
+static bool KernelRecordTimeGreater(const internal::KernelRecord &a,
+                                    const internal::KernelRecord &b)
+{
+   return a.time > b.time;
+}
+
+void KernelProfiler::Report(std::ostream &out)
+{
+   // Merge the records with the same name
+   std::lock_guard<std::mutex> lock(internal::GetKernelRecordsMutex());
+   std::map<std::string, internal::KernelRecord> merged;
+   internal::KernelRecords &records = internal::GetKernelRecords();
+   internal::KernelRecords::const_iterator it;
+   for (it = records.begin(); it != records.end(); ++it)
+   {
+      const internal::KernelRecord &rec = it->second;
+      internal::KernelRecord &m = merged[rec.name];
+      m.name = rec.name;
+      m.calls += rec.calls;
+      m.iterations += rec.iterations;
+      m.time += rec.time;
+      m.flops += rec.flops;
+      m.bytes += rec.bytes;
+   }
+   std::vector<internal::KernelRecord> sorted;
+   std::map<std::string, internal::KernelRecord>::const_iterator mt;
+   for (mt = merged.begin(); mt != merged.end(); ++mt)
+   {
+      sorted.push_back(mt->second);
+   }
+   std::stable_sort(sorted.begin(), sorted.end(), KernelRecordTimeGreater);
+
+   out << "{\n  \"kernels\": [";
+   for (std::size_t i = 0; i < sorted.size(); i++)
+   {
+      const internal::KernelRecord &rec = sorted[i];
+      out << (i ? ",\n" : "\n") << "    { \"name\": ";
+      internal::JSONString(out, rec.name);
+      out << ", \"calls\": " << rec.calls
+          << ", \"iterations\": " << rec.iterations
+          << ", \"time\": " << rec.time;
+      if (rec.flops > 0.0 || rec.bytes > 0.0)
+      {
+         const double t = rec.time > 0.0 ? rec.time : 1.0;
+         out << ", \"flops\": " << rec.flops
+             << ", \"bytes\": " << rec.bytes
+             << ", \"gflops\": " << 1e-9 * rec.flops / t
+             << ", \"gbytes_per_s\": " << 1e-9 * rec.bytes / t;
+      }
+      out << " }";
+   }
+   out << "\n  ]\n}\n";
+}
+
+void KernelProfiler::Finalize()
+{
+   const std::string &filename = internal::GetReportFileName();
+   if (filename.empty() || internal::GetKernelRecords().empty()) { return; }
+   std::ofstream out(filename.c_str());
+   MFEM_VERIFY(out, "cannot open the kernel profile file " << filename);
+   out.precision(8);
+   Report(out);
+   Reset();
+}
+
+} // namespace mfem
@@ -0,0 +1,131 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_PROFILER_HPP
+#define MFEM_PROFILER_HPP
+
+#include "../config/config.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace mfem
+{
+
+/** @brief Optional instrumentation of the MFEM_FORALL kernels. */
+/** When enabled, every launch of an MFEM_FORALL kernel records, for its site
+    in the source code (file:line), the number of calls, the total number of
+    iterations and the total wall time. On GPU backends, the device
+    is synchronized before and after each kernel, so that the time is that of
+    the kernel itself.
+
+    A kernel site can be given a name and estimates of its floating point
+    operations and memory traffic per iteration with MFEM_KERNEL_INFO, placed
+    just before the kernel, in the same scope; the report then includes the
+    achieved GFlop/s and GB/s. The info applies to the next kernel launched by
+    the same thread, and is discarded at the end of the scope if no kernel was
+    launched.
+
+    The profiler is enabled either by calling Enable(), or by setting the
+    environment variable MFEM_KERNEL_PROFILE to the name of the report file.
+    When a file name is given, the report is written in JSON format when the
+    Device is destroyed. When disabled, the overhead is one test per kernel
+    launch.
+
+    The records are protected by a mutex, so kernels may be launched
+    concurrently from several host threads. */
+class KernelProfiler
+{
+private:
+   static bool enabled;
+
+public:
+   /** @brief Start recording the kernels. If @a file is not empty, the report
+       is written to it when the Device is destroyed. */
+   static void Enable(const std::string &file = "");
+
+   /// Stop recording the kernels; the records are kept.
+   static void Disable() { enabled = false; }
+
+   /// Return true if the kernels are being recorded.
+   static bool IsEnabled() { return enabled; }
+
+   /// Discard all records.
+   static void Reset();
+
+   /** @brief Set the name and the per-iteration cost of the next kernel
+       launched: @a flops floating point operations and @a bytes bytes moved
+       to or from memory. A NULL @a name keeps the default file:line name. */
+   static void SetKernelInfo(const char *name, double flops, double bytes);
+
+   /// Discard the info given by SetKernelInfo(), if it was not used.
+   static void ClearKernelInfo();
+
+   /// Record a launch of the kernel at @a file:@a line with @a n iterations.
+   static void Record(const char *file, int line, int n, double seconds);
+
+   /// Return the current wall time in seconds, after a device synchronization.
+   static double Time();
+
+   /// Return the number of calls of the kernels with the given name.
+   static long GetCalls(const std::string &name);
+
+   /** @brief Write the records, sorted by decreasing total time, in JSON
+       format. Kernels with the same name, e.g. the same site instantiated in
+       several translation units, are merged. */
+   static void Report(std::ostream &out);
+
+   /** @brief Write the report to the file given to Enable(), if any, and reset
+       the records. Called by the Device destructor. */
+   static void Finalize();
+};
+
+/// Scope guard timing one kernel launch, see ForallWrap().
+class KernelProfilerScope
+{
+private:
+   const char *file;
+   const int line, n;
+   const double start;
+
+public:
+   KernelProfilerScope(const char *file, int line, int n)
+      : file(file), line(line), n(n), start(KernelProfiler::Time()) { }
+
+   ~KernelProfilerScope()
+   { KernelProfiler::Record(file, line, n, KernelProfiler::Time() - start); }
+};
+
+/** @brief Scope guard discarding the kernel info given by MFEM_KERNEL_INFO at
+    the end of its scope. */
+class KernelInfoScope
+{
+public:
+   ~KernelInfoScope()
+   { if (KernelProfiler::IsEnabled()) { KernelProfiler::ClearKernelInfo(); } }
+};
+
+} // namespace mfem
+
+#define MFEM_KERNEL_INFO_CONCAT_(a, b) a##b
+#define MFEM_KERNEL_INFO_CONCAT(a, b) MFEM_KERNEL_INFO_CONCAT_(a, b)
+
+/** @brief Name the next MFEM_FORALL kernel of the current scope and estimate
+    its floating point operations and bytes moved per iteration, see
+    KernelProfiler. The estimates are only evaluated when the profiler is
+    enabled. */
+#define MFEM_KERNEL_INFO(name, flops, bytes)                             \
+   mfem::KernelInfoScope MFEM_KERNEL_INFO_CONCAT(mfem_kernel_info_,      \
+                                                 __LINE__);              \
+   if (mfem::KernelProfiler::IsEnabled())                                \
+   { mfem::KernelProfiler::SetKernelInfo(name, flops, bytes); }
+
+#endif // MFEM_PROFILER_HPP
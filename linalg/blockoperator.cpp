@@ -88,6 +88,62 @@ void BlockOperator::Mult (const Vector & x, Vector & y) const
    }
 }
 
+void BlockOperator::MultiMult(const MultiVector &X, MultiVector &Y) const
+{
+   const int nv = X.NumVectors();
+   MFEM_VERIFY(X.VSize() == width && Y.VSize() == height &&
+               Y.NumVectors() == nv, "incompatible MultiVectors");
+
+   // Reorder the entries of X so that the column block jCol of all vectors is
+   // the contiguous MultiVector starting at col_offsets[jCol]*nv in Xb, and
+   // similarly for the row blocks of Y in Yb.
+   Xb.SetSize(width*nv);
+   Yb.SetSize(height*nv);
+   Vector xv, yv, src, dst;
+   for (int v = 0; v < nv; v++)
+   {
+      X.GetVector(v, xv);
+      for (int jCol = 0; jCol < nColBlocks; ++jCol)
+      {
+         const int bw = col_offsets[jCol+1] - col_offsets[jCol];
+         src.MakeRef(xv, col_offsets[jCol], bw);
+         dst.MakeRef(Xb, col_offsets[jCol]*nv + v*bw, bw);
+         dst = src;
+      }
+   }
+
+   Yb = 0.0;
+   MultiVector xb, yb;
+   for (int iRow = 0; iRow < nRowBlocks; ++iRow)
+   {
+      const int bh = row_offsets[iRow+1] - row_offsets[iRow];
+      yb.MakeRef(Yb, row_offsets[iRow]*nv, bh, nv);
+      tmpm.SetSize(bh, nv);
+      for (int jCol = 0; jCol < nColBlocks; ++jCol)
+      {
+         if (op(iRow,jCol))
+         {
+            const int bw = col_offsets[jCol+1] - col_offsets[jCol];
+            xb.MakeRef(Xb, col_offsets[jCol]*nv, bw, nv);
+            op(iRow,jCol)->MultiMult(xb, tmpm);
+            yb.Add(coef(iRow,jCol), tmpm);
+         }
+      }
+   }
+
+   for (int v = 0; v < nv; v++)
+   {
+      Y.GetVector(v, yv);
+      for (int iRow = 0; iRow < nRowBlocks; ++iRow)
+      {
+         const int bh = row_offsets[iRow+1] - row_offsets[iRow];
+         dst.MakeRef(yv, row_offsets[iRow], bh);
+         src.MakeRef(Yb, row_offsets[iRow]*nv + v*bh, bh);
+         dst = src;
+      }
+   }
+}
+
 // Action of the transpose operator
 void BlockOperator::MultTranspose (const Vector & x, Vector & y) const
 {
@@ -94,6 +94,11 @@ public:
    /// Action of the transpose operator
    virtual void MultTranspose (const Vector & x, Vector & y) const;
 
+   /** @brief Operator application to a block of vectors: each block of the
+       operator is applied once to the corresponding blocks of all the
+       vectors. */
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const;
+
    ~BlockOperator();
 
    //! Controls the ownership of the blocks: if nonzero, BlockOperator will
@@ -118,6 +123,9 @@ private:
    mutable BlockVector xblock;
    mutable BlockVector yblock;
    mutable Vector tmp;
+   //! Block-wise reordered copies of the MultiVectors used in MultiMult.
+   mutable Vector Xb, Yb;
+   mutable MultiVector tmpm;
 };
 
 //! @class BlockDiagonalPreconditioner
@@ -16,14 +16,18 @@
 #include "vector.hpp"
 #include "matrix.hpp"
 #include "densemat.hpp"
+#include "simd.hpp"
 #include "../general/table.hpp"
 #include "../general/globals.hpp"
+#include "../general/forall.hpp"
 
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <algorithm>
 #include <cstdlib>
+#include <cstdint>
+#include <vector>
 #if defined(_MSC_VER) && (_MSC_VER < 1800)
 #include <float.h>
 #define copysign _copysign
@@ -4515,4 +4519,272 @@ DenseTensor &DenseTensor::operator=(double c)
    return *this;
 }
 
+// Return the first address at or after p aligned for simd_double.
+static simd_double *SimdAlign(double *p)
+{
+   const std::uintptr_t a = MFEM_SIMD_DOUBLE_BYTES;
+   return reinterpret_cast<simd_double*>(
+             (reinterpret_cast<std::uintptr_t>(p) + a - 1) & ~(a - 1));
+}
+
+// Host version of BatchLUFactor: the matrices are factored by groups of
+// SIMD_DOUBLES, copied to a buffer where entry j of matrix l of the group is
+// in lane l of S[j]. The pivot search and the row exchanges differ between
+// the matrices and are done lane by lane, while the O(m^3) elimination uses
+// the full SIMD vectors. The lanes past the last matrix hold the identity.
+static void BatchLUFactorSimd(DenseTensor &Mlu, Array<int> &P)
+{
+   constexpr int L = SIMD_DOUBLES;
+   const int m = Mlu.SizeI(), mm = m*m, nb = Mlu.SizeK();
+   const int ng = (nb + L - 1)/L;
+   double *A = Mlu.HostReadWrite();
+   int *piv = P.HostWrite();
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel if (threaded)
+#endif
+   {
+      std::vector<double> buf((mm + 1)*L);
+      simd_double *S = SimdAlign(buf.data());
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (int g = 0; g < ng; g++)
+      {
+         const int k0 = g*L, nl = std::min(L, nb - k0);
+         for (int j = 0; j < mm; j++)
+         {
+            for (int l = 0; l < L; l++)
+            {
+               S[j][l] = (l < nl) ? A[j + (k0+l)*mm] : (j%(m+1) ? 0.0 : 1.0);
+            }
+         }
+         for (int i = 0; i < m; i++)
+         {
+            simd_double d_inv;
+            for (int l = 0; l < L; l++)
+            {
+               int p = i;
+               double a = std::abs(S[i+i*m][l]);
+               for (int j = i+1; j < m; j++)
+               {
+                  const double b = std::abs(S[j+i*m][l]);
+                  if (b > a) { a = b; p = j; }
+               }
+               if (p != i)
+               {
+                  for (int j = 0; j < m; j++)
+                  {
+                     const double t = S[i+j*m][l];
+                     S[i+j*m][l] = S[p+j*m][l];
+                     S[p+j*m][l] = t;
+                  }
+               }
+               if (l < nl) { piv[i + (k0+l)*m] = p; }
+               d_inv[l] = 1.0/S[i+i*m][l];
+            }
+            for (int j = i+1; j < m; j++) { S[j+i*m] = S[j+i*m] * d_inv; }
+            for (int c = i+1; c < m; c++)
+            {
+               const simd_double a_ic = S[i+c*m];
+               for (int j = i+1; j < m; j++)
+               {
+                  S[j+c*m] -= a_ic * S[j+i*m];
+               }
+            }
+         }
+         for (int j = 0; j < mm; j++)
+         {
+            for (int l = 0; l < nl; l++) { A[j + (k0+l)*mm] = S[j][l]; }
+         }
+      }
+   }
+}
+
+void BatchLUFactor(DenseTensor &Mlu, Array<int> &P)
+{
+   const int m = Mlu.SizeI(), nb = Mlu.SizeK();
+   MFEM_VERIFY(Mlu.SizeJ() == m, "the matrices must be square");
+   P.SetSize(m*nb);
+   if (m*nb == 0) { return; }
+   if (Device::Allows(Backend::SIMD) && !Device::Allows(Backend::DEVICE_MASK))
+   {
+      return BatchLUFactorSimd(Mlu, P);
+   }
+   auto A = Reshape(Mlu.ReadWrite(), m, m, nb);
+   auto piv = Reshape(P.Write(), m, nb);
+   MFEM_FORALL(k, nb,
+   {
+      for (int i = 0; i < m; i++)
+      {
+         // pivoting
+         int p = i;
+         double a = fabs(A(i,i,k));
+         for (int j = i+1; j < m; j++)
+         {
+            const double b = fabs(A(j,i,k));
+            if (b > a) { a = b; p = j; }
+         }
+         piv(i,k) = p;
+         if (p != i)
+         {
+            for (int j = 0; j < m; j++)
+            {
+               const double t = A(i,j,k);
+               A(i,j,k) = A(p,j,k);
+               A(p,j,k) = t;
+            }
+         }
+         const double a_ii_inv = 1.0/A(i,i,k);
+         for (int j = i+1; j < m; j++) { A(j,i,k) *= a_ii_inv; }
+         for (int c = i+1; c < m; c++)
+         {
+            const double a_ic = A(i,c,k);
+            for (int j = i+1; j < m; j++) { A(j,c,k) -= a_ic * A(j,i,k); }
+         }
+      }
+   });
+}
+
+// Solve A_k X_k = B_k with the factors of BatchLUFactor, where B_k is the
+// m x r matrix stored at X + k*m*r.
+static void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P,
+                         const int r, double *X_)
+{
+   const int m = Mlu.SizeI(), nb = Mlu.SizeK();
+   auto A = Reshape(Mlu.Read(), m, m, nb);
+   auto piv = Reshape(P.Read(), m, nb);
+   auto X = Reshape(X_, m, r, nb);
+   MFEM_FORALL(k, nb,
+   {
+      for (int c = 0; c < r; c++)
+      {
+         // X <- L^{-1} P X
+         for (int i = 0; i < m; i++)
+         {
+            const int p = piv(i,k);
+            const double t = X(i,c,k);
+            X(i,c,k) = X(p,c,k);
+            X(p,c,k) = t;
+         }
+         for (int j = 0; j < m; j++)
+         {
+            const double x_j = X(j,c,k);
+            for (int i = j+1; i < m; i++) { X(i,c,k) -= A(i,j,k) * x_j; }
+         }
+         // X <- U^{-1} X
+         for (int j = m-1; j >= 0; j--)
+         {
+            const double x_j = X(j,c,k) / A(j,j,k);
+            X(j,c,k) = x_j;
+            for (int i = 0; i < j; i++) { X(i,c,k) -= A(i,j,k) * x_j; }
+         }
+      }
+   });
+}
+
+void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P, Vector &X)
+{
+   const int m = Mlu.SizeI(), nb = Mlu.SizeK();
+   MFEM_VERIFY(X.Size() == m*nb && P.Size() == m*nb, "incompatible sizes");
+   if (m*nb == 0) { return; }
+   BatchLUSolve(Mlu, P, 1, X.ReadWrite());
+}
+
+void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P, DenseTensor &X)
+{
+   const int m = Mlu.SizeI(), nb = Mlu.SizeK();
+   MFEM_VERIFY(X.SizeI() == m && X.SizeK() == nb && P.Size() == m*nb,
+               "incompatible sizes");
+   if (m*nb*X.SizeJ() == 0) { return; }
+   BatchLUSolve(Mlu, P, X.SizeJ(), X.ReadWrite());
+}
+
+void BatchInverse(const DenseTensor &A, DenseTensor &Ainv)
+{
+   const int m = A.SizeI(), nb = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == m, "the matrices must be square");
+   DenseTensor LU(A);
+   Array<int> P;
+   BatchLUFactor(LU, P);
+   if (Ainv.SizeI() != m || Ainv.SizeJ() != m || Ainv.SizeK() != nb)
+   {
+      Ainv.SetSize(m, m, nb);
+   }
+   if (m*nb == 0) { return; }
+   auto I = Reshape(Ainv.Write(), m, m, nb);
+   MFEM_FORALL(k, nb,
+   {
+      for (int j = 0; j < m; j++)
+      {
+         for (int i = 0; i < m; i++) { I(i,j,k) = (i == j) ? 1.0 : 0.0; }
+      }
+   });
+   BatchLUSolve(LU, P, Ainv);
+}
+
+void BatchMult(const DenseTensor &A, const DenseTensor &B, DenseTensor &C)
+{
+   const int m = A.SizeI(), n = A.SizeJ(), r = B.SizeJ(), nb = A.SizeK();
+   MFEM_VERIFY(B.SizeI() == n && B.SizeK() == nb, "incompatible dimensions");
+   if (C.SizeI() != m || C.SizeJ() != r || C.SizeK() != nb)
+   {
+      C.SetSize(m, r, nb);
+   }
+   if (m*r*nb == 0) { return; }
+   auto a = Reshape(A.Read(), m, n, nb);
+   auto b = Reshape(B.Read(), n, r, nb);
+   auto c = Reshape(C.Write(), m, r, nb);
+   MFEM_FORALL(k, nb,
+   {
+      for (int j = 0; j < r; j++)
+      {
+         for (int i = 0; i < m; i++) { c(i,j,k) = 0.0; }
+         for (int l = 0; l < n; l++)
+         {
+            const double b_lj = b(l,j,k);
+            for (int i = 0; i < m; i++) { c(i,j,k) += a(i,l,k) * b_lj; }
+         }
+      }
+   });
+}
+
+void BatchMult(const DenseTensor &A, const Vector &x, Vector &y)
+{
+   const int m = A.SizeI(), n = A.SizeJ(), nb = A.SizeK();
+   MFEM_VERIFY(x.Size() == n*nb && y.Size() == m*nb, "incompatible sizes");
+   if (m*nb == 0) { return; }
+   auto a = Reshape(A.Read(), m, n, nb);
+   auto X = Reshape(x.Read(), n, nb);
+   auto Y = Reshape(y.Write(), m, nb);
+   MFEM_FORALL(k, nb,
+   {
+      for (int i = 0; i < m; i++) { Y(i,k) = 0.0; }
+      for (int j = 0; j < n; j++)
+      {
+         const double x_j = X(j,k);
+         for (int i = 0; i < m; i++) { Y(i,k) += a(i,j,k) * x_j; }
+      }
+   });
+}
+
+void BatchMultTranspose(const DenseTensor &A, const Vector &x, Vector &y)
+{
+   const int m = A.SizeI(), n = A.SizeJ(), nb = A.SizeK();
+   MFEM_VERIFY(x.Size() == m*nb && y.Size() == n*nb, "incompatible sizes");
+   if (n*nb == 0) { return; }
+   auto a = Reshape(A.Read(), m, n, nb);
+   auto X = Reshape(x.Read(), m, nb);
+   auto Y = Reshape(y.Write(), n, nb);
+   MFEM_FORALL(k, nb,
+   {
+      for (int j = 0; j < n; j++)
+      {
+         double d = 0.0;
+         for (int i = 0; i < m; i++) { d += a(i,j,k) * X(i,k); }
+         Y(j,k) = d;
+      }
+   });
+}
+
 }
@@ -705,6 +705,15 @@ public:
       tdata.New(i*j*k, mt);
    }
 
+   /// Resize the tensor, allocating its data with the given MemoryType.
+   void SetSize(int i, int j, int k, MemoryType mt)
+   {
+      tdata.Delete();
+      Mk.UseExternalData(NULL, i, j);
+      nk = k;
+      tdata.New(i*j*k, mt);
+   }
+
    void UseExternalData(double *ext_data, int i, int j, int k)
    {
       tdata.Delete();
@@ -749,6 +758,30 @@ public:
    Memory<double> &GetMemory() { return tdata; }
    const Memory<double> &GetMemory() const { return tdata; }
 
+   /// Shortcut for mfem::Read(GetMemory(), TotalSize(), on_dev).
+   const double *Read(bool on_dev = true) const
+   { return mfem::Read(tdata, TotalSize(), on_dev); }
+
+   /// Shortcut for mfem::Read(GetMemory(), TotalSize(), false).
+   const double *HostRead() const
+   { return mfem::Read(tdata, TotalSize(), false); }
+
+   /// Shortcut for mfem::Write(GetMemory(), TotalSize(), on_dev).
+   double *Write(bool on_dev = true)
+   { return mfem::Write(tdata, TotalSize(), on_dev); }
+
+   /// Shortcut for mfem::Write(GetMemory(), TotalSize(), false).
+   double *HostWrite()
+   { return mfem::Write(tdata, TotalSize(), false); }
+
+   /// Shortcut for mfem::ReadWrite(GetMemory(), TotalSize(), on_dev).
+   double *ReadWrite(bool on_dev = true)
+   { return mfem::ReadWrite(tdata, TotalSize(), on_dev); }
+
+   /// Shortcut for mfem::ReadWrite(GetMemory(), TotalSize(), false).
+   double *HostReadWrite()
+   { return mfem::ReadWrite(tdata, TotalSize(), false); }
+
    /** Matrix-vector product from unassembled element matrices, assuming both
        'x' and 'y' use the same elem_dof table. */
    void AddMult(const Table &elem_dof, const Vector &x, Vector &y) const;
@@ -761,6 +794,47 @@ public:
    ~DenseTensor() { tdata.Delete(); }
 };
 
+/** @name Batched dense linear algebra
+    These functions operate on all the matrices of a DenseTensor, e.g. the
+    element matrices of a mesh, with one MFEM_FORALL kernel, so that they run
+    on the device and, with OpenMP, on all the host threads. With the "simd"
+    backend, BatchLUFactor() factors SIMD_DOUBLES matrices at once on the host,
+    with the entries of the matrices interleaved in the SIMD lanes. */
+///@{
+
+/** @brief Compute in place the LU factorizations with partial pivoting,
+    L.U = P.A_k, of the square matrices A_k = @a Mlu(k). */
+/** The pivots are stored in @a P, resized to SizeI()*SizeK(): P[i+k*SizeI()]
+    is the (0-based) row exchanged with row i at step i of the factorization
+    of A_k, as in LUFactors::Factor() without LAPACK. The matrices must be
+    nonsingular. */
+void BatchLUFactor(DenseTensor &Mlu, Array<int> &P);
+
+/** @brief Solve A_k x_k = b_k for all the matrices of @a Mlu, factored with
+    BatchLUFactor(), where b_k is stored in @a X, of size SizeI()*SizeK(), at
+    offset k*SizeI() and is overwritten by x_k. */
+void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P, Vector &X);
+
+/** @brief Solve A_k X_k = B_k for all the matrices of @a Mlu, factored with
+    BatchLUFactor(), where B_k = @a X(k) is overwritten by X_k. */
+void BatchLUSolve(const DenseTensor &Mlu, const Array<int> &P, DenseTensor &X);
+
+/// Compute the inverses @a Ainv(k) of the square matrices @a A(k).
+void BatchInverse(const DenseTensor &A, DenseTensor &Ainv);
+
+/// Compute the products C(k) = A(k) B(k); @a C is resized if needed.
+void BatchMult(const DenseTensor &A, const DenseTensor &B, DenseTensor &C);
+
+/** @brief Compute the products y_k = A(k) x_k, where x_k and y_k are stored in
+    @a x and @a y at offsets k*A.SizeJ() and k*A.SizeI(), respectively. */
+void BatchMult(const DenseTensor &A, const Vector &x, Vector &y);
+
+/** @brief Compute the products y_k = A(k)^T x_k, where x_k and y_k are stored
+    in @a x and @a y at offsets k*A.SizeI() and k*A.SizeJ(), respectively. */
+void BatchMultTranspose(const DenseTensor &A, const Vector &x, Vector &y);
+
+///@}
+
 
 // Inline methods
 
@@ -389,6 +389,8 @@ public:
 
    /// Get the local diagonal of the matrix.
    void GetDiag(Vector &diag) const;
+   /// Same as GetDiag(Vector&), overriding Operator::AssembleDiagonal().
+   virtual void AssembleDiagonal(Vector &diag) const { GetDiag(diag); }
    /// Get the local diagonal block. NOTE: 'diag' will not own any data.
    void GetDiag(SparseMatrix &diag) const;
    /// Get the local off-diagonal block. NOTE: 'offd' will not own any data.
@@ -0,0 +1,140 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "multigrid.hpp"
+
+namespace mfem
+{
+
+Multigrid::Multigrid()
+   : Solver(0, false), cycle_type(VCYCLE),
+     pre_smoothing_steps(1), post_smoothing_steps(1)
+{ }
+
+Multigrid::~Multigrid()
+{
+   for (int l = 0; l < operators.Size(); l++)
+   {
+      if (own_operators[l]) { delete operators[l]; }
+      if (own_smoothers[l]) { delete smoothers[l]; }
+      delete X[l];
+      delete Y[l];
+      delete R[l];
+      delete Z[l];
+   }
+   for (int l = 0; l < prolongations.Size(); l++)
+   {
+      if (own_prolongations[l]) { delete prolongations[l]; }
+   }
+}
+
+void Multigrid::AddCoarsestLevel(Operator *op, Solver *coarse_solver,
+                                 bool own_op, bool own_solver)
+{
+   MFEM_VERIFY(NumLevels() == 0, "the coarsest level is already set");
+   MFEM_VERIFY(op->Height() == op->Width(), "the operator must be square");
+   operators.Append(op);
+   smoothers.Append(coarse_solver);
+   own_operators.Append(own_op);
+   own_smoothers.Append(own_solver);
+   coarse_solver->iterative_mode = false;
+   X.Append(new Vector(op->Height()));
+   Y.Append(new Vector(op->Height()));
+   R.Append(new Vector(op->Height()));
+   Z.Append(new Vector(op->Height()));
+   height = width = op->Height();
+}
+
+void Multigrid::AddLevel(Operator *op, Solver *smoother,
+                         const Operator *prolongation, bool own_op,
+                         bool own_smoother, bool own_prolongation)
+{
+   MFEM_VERIFY(NumLevels() > 0, "the coarsest level is not set");
+   MFEM_VERIFY(op->Height() == op->Width(), "the operator must be square");
+   MFEM_VERIFY(prolongation->Height() == op->Height() &&
+               prolongation->Width() == operators.Last()->Height(),
+               "incompatible prolongation: " << prolongation->Height() << " x "
+               << prolongation->Width());
+   operators.Append(op);
+   smoothers.Append(smoother);
+   prolongations.Append(prolongation);
+   own_operators.Append(own_op);
+   own_smoothers.Append(own_smoother);
+   own_prolongations.Append(own_prolongation);
+   smoother->iterative_mode = false;
+   X.Append(new Vector(op->Height()));
+   Y.Append(new Vector(op->Height()));
+   R.Append(new Vector(op->Height()));
+   Z.Append(new Vector(op->Height()));
+   height = width = op->Height();
+}
+
+void Multigrid::SmoothingStep(int level) const
+{
+   // y <- y + S (x - A y)
+   operators[level]->Mult(*Y[level], *R[level]);
+   subtract(*X[level], *R[level], *R[level]);
+   smoothers[level]->Mult(*R[level], *Z[level]);
+   *Y[level] += *Z[level];
+}
+
+void Multigrid::Cycle(int level) const
+{
+   if (level == 0)
+   {
+      SmoothingStep(0);
+      return;
+   }
+
+   for (int i = 0; i < pre_smoothing_steps; i++)
+   {
+      SmoothingStep(level);
+   }
+
+   // Coarse grid correction
+   operators[level]->Mult(*Y[level], *R[level]);
+   subtract(*X[level], *R[level], *R[level]);
+   prolongations[level-1]->MultTranspose(*R[level], *X[level-1]);
+   *Y[level-1] = 0.0;
+   const int num_cycles = (cycle_type == WCYCLE && level > 1) ? 2 : 1;
+   for (int c = 0; c < num_cycles; c++)
+   {
+      Cycle(level-1);
+   }
+   prolongations[level-1]->Mult(*Y[level-1], *Z[level]);
+   *Y[level] += *Z[level];
+
+   for (int i = 0; i < post_smoothing_steps; i++)
+   {
+      SmoothingStep(level);
+   }
+}
+
+void Multigrid::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(NumLevels() > 0, "the multigrid hierarchy is empty");
+   MFEM_VERIFY(x.Size() == height && y.Size() == height,
+               "invalid input/output vector sizes");
+   const int fine = GetFinestLevelIndex();
+   *X[fine] = x;
+   if (iterative_mode)
+   {
+      *Y[fine] = y;
+   }
+   else
+   {
+      *Y[fine] = 0.0;
+   }
+   Cycle(fine);
+   y = *Y[fine];
+}
+
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIGRID
+#define MFEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+
+namespace mfem
+{
+
+/** @brief Multigrid solver defined by a hierarchy of operators, smoothers and
+    prolongations. */
+/** Level 0 is the coarsest level. The "smoother" on the coarsest level is
+    applied once per cycle and acts as the coarse solver, e.g. an assembled
+    matrix with a direct solver or an AMG preconditioner. On all other levels,
+    the smoothers are applied in residual-correction form,
+    y <- y + S (x - A y), so any Solver approximating the inverse of the level
+    operator can be used, e.g. OperatorJacobiSmoother or
+    OperatorChebyshevSmoother for matrix-free operators. The restriction from
+    level l+1 to level l is the transpose of the prolongation from level l to
+    level l+1. */
+class Multigrid : public Solver
+{
+public:
+   enum CycleType { VCYCLE, WCYCLE };
+
+protected:
+   Array<Operator*> operators;
+   Array<Solver*> smoothers;
+   Array<const Operator*> prolongations; ///< Size: number of levels - 1
+   Array<bool> own_operators, own_smoothers, own_prolongations;
+
+   CycleType cycle_type;
+   int pre_smoothing_steps, post_smoothing_steps;
+
+   mutable Array<Vector*> X, Y, R, Z;
+
+   /// Perform one smoothing step on @a level, starting from Y[level].
+   void SmoothingStep(int level) const;
+
+   /// One multigrid cycle on @a level, starting from the initial guess Y[level].
+   void Cycle(int level) const;
+
+public:
+   /// Construct an empty multigrid solver, see AddCoarsestLevel() and AddLevel().
+   Multigrid();
+
+   /// Destroy the owned operators, smoothers and prolongations.
+   virtual ~Multigrid();
+
+   /** @brief Set the operator and the coarse solver of the coarsest level. This
+       has to be called first. */
+   void AddCoarsestLevel(Operator *op, Solver *coarse_solver,
+                         bool own_op = true, bool own_solver = true);
+
+   /** @brief Add a finer level with operator @a op, smoother @a smoother and a
+       @a prolongation from the current finest level to the new level. */
+   void AddLevel(Operator *op, Solver *smoother, const Operator *prolongation,
+                 bool own_op = true, bool own_smoother = true,
+                 bool own_prolongation = true);
+
+   /// Return the number of levels.
+   int NumLevels() const { return operators.Size(); }
+
+   /// Return the index of the finest level.
+   int GetFinestLevelIndex() const { return NumLevels() - 1; }
+
+   /// Return the operator on the given @a level.
+   Operator *GetOperatorAtLevel(int level) const { return operators[level]; }
+
+   /// Return the smoother (coarse solver, for level 0) on the given @a level.
+   Solver *GetSmootherAtLevel(int level) const { return smoothers[level]; }
+
+   /// Return the prolongation from @a level to @a level + 1.
+   const Operator *GetProlongationAtLevel(int level) const
+   { return prolongations[level]; }
+
+   /** @brief Set the cycle type and the number of pre- and post-smoothing
+       steps. The default is a V-cycle with one pre- and one post-smoothing
+       step. */
+   void SetCycleType(CycleType cycle, int pre_smoothing = 1,
+                     int post_smoothing = 1)
+   {
+      cycle_type = cycle;
+      pre_smoothing_steps = pre_smoothing;
+      post_smoothing_steps = post_smoothing;
+   }
+
+   /// Apply one multigrid cycle on the finest level.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// The operators are set level by level, see AddLevel().
+   virtual void SetOperator(const Operator &op)
+   { MFEM_ABORT("SetOperator() is not supported, use AddLevel()"); }
+};
+
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIVECTOR
+#define MFEM_MULTIVECTOR
+
+#include "../config/config.hpp"
+#include "vector.hpp"
+
+namespace mfem
+{
+
+/** @brief A block of NumVectors() vectors of size VSize(), stored one after
+    the other (column by column) in the Vector data. */
+/** Operators apply to blocks of vectors with Operator::MultiMult(), which
+    implementations can use to read the operator data once for all the
+    vectors of the block. Note that Size() returns the total size,
+    VSize()*NumVectors(). */
+class MultiVector : public Vector
+{
+protected:
+   int vsize, num_vectors;
+
+public:
+   MultiVector() : vsize(0), num_vectors(0) { }
+
+   /// Create a block of @a nv vectors of size @a vsize.
+   MultiVector(int vsize, int nv)
+      : Vector(vsize*nv), vsize(vsize), num_vectors(nv) { }
+
+   /// Create a block of @a nv vectors of size @a vsize using MemoryType @a mt.
+   MultiVector(int vsize, int nv, MemoryType mt)
+      : Vector(vsize*nv, mt), vsize(vsize), num_vectors(nv) { }
+
+   /// Resize to @a nv vectors of size @a vsize; the data is not preserved.
+   void SetSize(int vsize_, int nv)
+   { Vector::SetSize(vsize_*nv); vsize = vsize_; num_vectors = nv; }
+
+   /** @brief Resize to @a nv vectors of size @a vsize using MemoryType @a mt;
+       the data is not preserved. */
+   void SetSize(int vsize_, int nv, MemoryType mt)
+   { Vector::SetSize(vsize_*nv, mt); vsize = vsize_; num_vectors = nv; }
+
+   /** @brief Make this MultiVector a reference to @a nv vectors of size
+       @a vsize_ stored in @a base, starting at @a offset. */
+   void MakeRef(Vector &base, int offset, int vsize_, int nv)
+   {
+      Vector::MakeRef(base, offset, vsize_*nv);
+      vsize = vsize_; num_vectors = nv;
+   }
+
+   /// Return the size of each vector.
+   int VSize() const { return vsize; }
+
+   /// Return the number of vectors.
+   int NumVectors() const { return num_vectors; }
+
+   /// Make @a v a reference to the vector @a j of the block.
+   void GetVector(int j, Vector &v) { v.MakeRef(*this, j*vsize, vsize); }
+
+   /// Make @a v a reference to the vector @a j of the block (const version).
+   void GetVector(int j, Vector &v) const
+   { v.MakeRef(const_cast<MultiVector&>(*this), j*vsize, vsize); }
+
+   /// Set all the entries to @a value.
+   MultiVector &operator=(double value)
+   { Vector::operator=(value); return *this; }
+};
+
+}
+
+#endif // MFEM_MULTIVECTOR
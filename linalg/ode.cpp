@@ -12,6 +12,10 @@
 #include "operator.hpp"
 #include "ode.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace mfem
 {
 
@@ -344,6 +348,258 @@ const double RK8Solver::c[] =
 };
 
 
+
+AdaptiveODESolver::AdaptiveODESolver(int q)
+   : err_order(q), rel_tol(1e-6), abs_tol(1e-6), dt_min(0.0),
+     dt_max(std::numeric_limits<double>::infinity()), safety(0.9),
+     fac_min(0.2), fac_max(5.0), h(0.0), err_prev(1.0), num_accepted(0),
+     num_rejected(0)
+{
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+void AdaptiveODESolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   y.SetSize(f->Width(), mem_type);
+   err.SetSize(f->Width(), mem_type);
+   h = 0.0;
+   err_prev = 1.0;
+   num_accepted = num_rejected = 0;
+}
+
+double AdaptiveODESolver::ErrorNorm(const Vector &x, const Vector &y,
+                                    const Vector &err) const
+{
+   const int n = x.Size();
+   const double *xd = x.HostRead(), *yd = y.HostRead(), *ed = err.HostRead();
+   double sum[2] = { 0.0, double(n) };
+   for (int i = 0; i < n; i++)
+   {
+      const double w =
+         abs_tol + rel_tol*std::max(std::abs(xd[i]), std::abs(yd[i]));
+      sum[0] += (ed[i]/w)*(ed[i]/w);
+   }
+#ifdef MFEM_USE_MPI
+   if (comm != MPI_COMM_NULL)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, sum, 2, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+   return (sum[1] > 0.0) ? sqrt(sum[0]/sum[1]) : 0.0;
+}
+
+double AdaptiveODESolver::AdaptStep(Vector &x, double &t, double tf)
+{
+   const double q = err_order;
+   double hs = std::min(h, dt_max);
+   bool rejected = false;
+   while (true)
+   {
+      const bool last = (hs >= tf - t);
+      const double hc = last ? tf - t : hs;
+      TryStep(x, t, hc, y, err);
+      const double e = ErrorNorm(x, y, err);
+      if (e <= 1.0 || hc <= dt_min)
+      {
+         // PI controller; no increase right after a rejection
+         double fac = safety*pow(std::max(e, 1e-10), -0.7/q)*
+                      pow(err_prev, 0.4/q);
+         fac = std::min(rejected ? 1.0 : fac_max, std::max(fac_min, fac));
+         // A step shortened to reach tf does not change the controller state
+         if (last && hc < hs) { h = std::min(dt_max, std::max(hs, fac*hc)); }
+         else
+         {
+            h = std::min(dt_max, fac*hc);
+            err_prev = std::max(e, 1e-4);
+         }
+         num_accepted++;
+         AcceptStep();
+         x = y;
+         t = last ? tf : t + hc;
+         return hc;
+      }
+      // When e is NaN, the step is reduced by fac_min
+      num_rejected++;
+      rejected = true;
+      hs = std::max(dt_min, hc*std::max(fac_min, safety*pow(e, -1.0/q)));
+      MFEM_VERIFY(t + hs > t, "the time step size underflows, t = " << t);
+   }
+}
+
+void AdaptiveODESolver::Step(Vector &x, double &t, double &dt)
+{
+   if (h == 0.0) { h = dt; }
+   const double tf = t + dt;
+   while (t < tf) { dt = AdaptStep(x, t, tf); }
+}
+
+void AdaptiveODESolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   if (h == 0.0) { h = dt; }
+   while (t < tf) { dt = AdaptStep(x, t, tf); }
+}
+
+
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, const double *_a,
+                                   const double *_b, const double *_d,
+                                   const double *_c, int q)
+   : AdaptiveODESolver(q), s(_s), a(_a), b(_b), d(_d), c(_c)
+{
+   k = new Vector[s];
+   // The last stage is the solution at t + dt if its row of a is b
+   fsal = (b[s-1] == 0.0 && c[s-2] == 1.0);
+   for (int j = 0; fsal && j < s-1; j++)
+   {
+      fsal = (a[(s-1)*(s-2)/2 + j] == b[j]);
+   }
+   have_k0 = false;
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n, mem_type);
+   }
+   have_k0 = false;
+}
+
+void EmbeddedRKSolver::TryStep(const Vector &x, double t, double h,
+                               Vector &y, Vector &err)
+{
+   // The first stage does not depend on h and is kept after a rejection
+   if (!have_k0)
+   {
+      f->SetTime(t);
+      f->Mult(x, k[0]);
+      have_k0 = true;
+   }
+   for (int l = 0, i = 1; i < s; i++)
+   {
+      add(x, a[l++]*h, k[0], y);
+      for (int j = 1; j < i; j++)
+      {
+         y.Add(a[l++]*h, k[j]);
+      }
+
+      f->SetTime(t + c[i-1]*h);
+      f->Mult(y, k[i]);
+   }
+   if (!fsal)
+   {
+      y = x;
+      for (int i = 0; i < s; i++)
+      {
+         y.Add(b[i]*h, k[i]);
+      }
+   }
+   err = 0.0;
+   for (int i = 0; i < s; i++)
+   {
+      err.Add((b[i] - d[i])*h, k[i]);
+   }
+}
+
+void EmbeddedRKSolver::AcceptStep()
+{
+   if (fsal) { k[0].Swap(k[s-1]); }
+   else { have_k0 = false; }
+}
+
+EmbeddedRKSolver::~EmbeddedRKSolver()
+{
+   delete [] k;
+}
+
+const double BogackiShampineSolver::a[] =
+{
+   1./2.,
+   0., 3./4.,
+   2./9., 1./3., 4./9.
+};
+const double BogackiShampineSolver::b[] = { 2./9., 1./3., 4./9., 0. };
+const double BogackiShampineSolver::d[] = { 7./24., 1./4., 1./3., 1./8. };
+const double BogackiShampineSolver::c[] = { 1./2., 3./4., 1. };
+
+const double DormandPrinceSolver::a[] =
+{
+   1./5.,
+   3./40., 9./40.,
+   44./45., -56./15., 32./9.,
+   19372./6561., -25360./2187., 64448./6561., -212./729.,
+   9017./3168., -355./33., 46732./5247., 49./176., -5103./18656.,
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84.
+};
+const double DormandPrinceSolver::b[] =
+{
+   35./384., 0., 500./1113., 125./192., -2187./6784., 11./84., 0.
+};
+const double DormandPrinceSolver::d[] =
+{
+   5179./57600., 0., 7571./16695., 393./640., -92097./339200., 187./2100.,
+   1./40.
+};
+const double DormandPrinceSolver::c[] =
+{
+   1./5., 3./10., 4./5., 8./9., 1., 1.
+};
+
+
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   dx.SetSize(n, mem_type);
+   k.SetSize(n, mem_type);
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->Mult(x, k);
+      add(A[i], dx, dt, k, dx); // A[0] = 0 ignores the previous dx
+      x.Add(B[i], dx);
+   }
+   t += dt;
+}
+
+const double LSRK3Solver::A[] = { 0., -5./9., -153./128. };
+const double LSRK3Solver::B[] = { 1./3., 15./16., 8./15. };
+const double LSRK3Solver::c[] = { 0., 1./3., 3./4. };
+
+const double LSRK4Solver::A[] =
+{
+   0.,
+   -567301805773./1357537059087.,
+   -2404267990393./2016746695238.,
+   -3550918686646./2091501179385.,
+   -1275806237668./842570457699.
+};
+const double LSRK4Solver::B[] =
+{
+   1432997174477./9575080441755.,
+   5161836677717./13612068292357.,
+   1720146321549./2090206949498.,
+   3134564353537./4481467310338.,
+   2277821191437./14882151754819.
+};
+const double LSRK4Solver::c[] =
+{
+   0.,
+   1432997174477./9575080441755.,
+   2526269341429./6820363962896.,
+   2006345519317./3224310063776.,
+   2802321613138./2924317926251.
+};
+
+
 void BackwardEulerSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -492,6 +748,201 @@ void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
 }
 
 
+void TRBDF2Solver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   k0.SetSize(n, mem_type);
+   k1.SetSize(n, mem_type);
+   k2.SetSize(n, mem_type);
+   z.SetSize(n, mem_type);
+   have_k0 = false;
+}
+
+void TRBDF2Solver::TryStep(const Vector &x, double t, double h, Vector &y,
+                           Vector &err)
+{
+   // with g = 2 - sqrt(2), d = g/2, w = sqrt(2)/4:
+   //   0  |   0
+   //   g  |   d     d
+   //   1  |   w     w     d
+   // -----+-------------------
+   //      |   w     w     d
+   //      | (1-w)/3 (3w+1)/3 d/3   (third order, error estimate)
+   const double g = 2. - sqrt(2.), d = g/2., w = sqrt(2.)/4.;
+   if (!have_k0)
+   {
+      f->SetTime(t);
+      f->Mult(x, k0);
+      have_k0 = true;
+   }
+   add(x, d*h, k0, z);
+   f->SetTime(t + g*h);
+   f->ImplicitSolve(d*h, z, k1);
+
+   add(k0, 1., k1, z);
+   add(x, w*h, z, z);
+   f->SetTime(t + h);
+   f->ImplicitSolve(d*h, z, k2);
+   add(z, d*h, k2, y);
+
+   add((4.*w - 1.)/3.*h, k0, -h/3., k1, err);
+   err.Add(2.*d/3.*h, k2);
+}
+
+void TRBDF2Solver::AcceptStep()
+{
+   // The last stage is f(y, t + h)
+   k0.Swap(k2);
+}
+
+
+IMEXRKSolver::IMEXRKSolver(int _s, const double *_ae, const double *_be,
+                           const double *_ai, const double *_bi,
+                           const double *_c)
+   : s(_s), ae(_ae), be(_be), ai(_ai), bi(_bi), c(_c)
+{
+   ke = new Vector[s];
+   ki = new Vector[s];
+   use_ke.SetSize(s);
+   use_ki.SetSize(s);
+   for (int j = 0; j < s; j++)
+   {
+      use_ke[j] = (be[j] != 0.0);
+      use_ki[j] = (bi[j] != 0.0);
+      for (int i = j+1; i < s; i++)
+      {
+         use_ke[j] = use_ke[j] || (ae[i*(i-1)/2 + j] != 0.0);
+         use_ki[j] = use_ki[j] || (ai[i*(i+1)/2 + j] != 0.0);
+      }
+   }
+}
+
+void IMEXRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n, mem_type);
+   for (int i = 0; i < s; i++)
+   {
+      ke[i].SetSize(n, mem_type);
+      ki[i].SetSize(n, mem_type);
+   }
+}
+
+void IMEXRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   for (int i = 0; i < s; i++)
+   {
+      // y = x + dt sum_{j<i} (ae_ij ke_j + ai_ij ki_j)
+      y = x;
+      for (int j = 0; j < i; j++)
+      {
+         const double a_e = ae[i*(i-1)/2 + j], a_i = ai[i*(i+1)/2 + j];
+         if (a_e != 0.0) { y.Add(a_e*dt, ke[j]); }
+         if (a_i != 0.0) { y.Add(a_i*dt, ki[j]); }
+      }
+
+      f->SetTime(t + c[i]*dt);
+      const double a_ii = ai[i*(i+1)/2 + i];
+      if (a_ii != 0.0)
+      {
+         // solve for ki: ki = f2(y + a_ii*dt*ki, t + c_i*dt)
+         f->SetEvalMode(TimeDependentOperator::ADDITIVE_TERM_2);
+         f->ImplicitSolve(a_ii*dt, y, ki[i]);
+         y.Add(a_ii*dt, ki[i]);
+      }
+      else if (use_ki[i])
+      {
+         f->SetEvalMode(TimeDependentOperator::ADDITIVE_TERM_2);
+         f->Mult(y, ki[i]);
+      }
+      if (use_ke[i])
+      {
+         f->SetEvalMode(TimeDependentOperator::ADDITIVE_TERM_1);
+         f->Mult(y, ke[i]);
+      }
+   }
+   f->SetEvalMode(TimeDependentOperator::NORMAL);
+   for (int i = 0; i < s; i++)
+   {
+      if (be[i] != 0.0) { x.Add(be[i]*dt, ke[i]); }
+      if (bi[i] != 0.0) { x.Add(bi[i]*dt, ki[i]); }
+   }
+   t += dt;
+}
+
+IMEXRKSolver::~IMEXRKSolver()
+{
+   delete [] ki;
+   delete [] ke;
+}
+
+const double IMEXEulerSolver::ae[] = { 1. };
+const double IMEXEulerSolver::be[] = { 1., 0. };
+const double IMEXEulerSolver::ai[] = { 0., 0., 1. };
+const double IMEXEulerSolver::bi[] = { 0., 1. };
+const double IMEXEulerSolver::c[] = { 0., 1. };
+
+// ARS(2,3,2) with g = 1 - 1/sqrt(2) and d = -2 sqrt(2)/3
+const double IMEXRK2Solver::ae[] =
+{
+   1. - 0.707106781186547524400844,
+   -0.942809041582063365867793, 1.942809041582063365867793
+};
+const double IMEXRK2Solver::be[] =
+{
+   0., 0.707106781186547524400844, 1. - 0.707106781186547524400844
+};
+const double IMEXRK2Solver::ai[] =
+{
+   0.,
+   0., 1. - 0.707106781186547524400844,
+   0., 0.707106781186547524400844, 1. - 0.707106781186547524400844
+};
+const double IMEXRK2Solver::bi[] =
+{
+   0., 0.707106781186547524400844, 1. - 0.707106781186547524400844
+};
+const double IMEXRK2Solver::c[] =
+{
+   0., 1. - 0.707106781186547524400844, 1.
+};
+
+// ARS(3,4,3) with g = 0.4358665215..., the root of 6g^3 - 18g^2 + 9g - 1 = 0
+// in (1/6,1/2) as in SDIRK33Solver, b1 = -3g^2/2 + 4g - 1/4 and
+// b2 = 3g^2/2 - 5g + 5/4. The explicit coefficients are given to 10 digits in
+// the paper of Ascher, Ruuth and Spiteri.
+const double IMEXRK3Solver::ae[] =
+{
+   0.435866521508458999416019,
+   0.3212788860, 0.3966543747,
+   -0.105858296, 0.5529291479, 0.5529291479
+};
+const double IMEXRK3Solver::be[] =
+{
+   0., 1.20849664917601007033648, -0.64436317068446906975051,
+   0.435866521508458999416019
+};
+const double IMEXRK3Solver::ai[] =
+{
+   0.,
+   0., 0.435866521508458999416019,
+   0., 0.282066739245770500291990, 0.435866521508458999416019,
+   0., 1.20849664917601007033648, -0.64436317068446906975051,
+   0.435866521508458999416019
+};
+const double IMEXRK3Solver::bi[] =
+{
+   0., 1.20849664917601007033648, -0.64436317068446906975051,
+   0.435866521508458999416019
+};
+const double IMEXRK3Solver::c[] =
+{
+   0., 0.435866521508458999416019, 0.717933260754229499708010, 1.
+};
+
+
 void GeneralizedAlphaSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
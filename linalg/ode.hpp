@@ -15,6 +15,10 @@
 #include "../config/config.hpp"
 #include "operator.hpp"
 
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
+
 namespace mfem
 {
 
@@ -206,6 +210,212 @@ public:
 };
 
 
+/** @brief Abstract base class for the ODE solvers with an embedded error
+    estimate and adaptive time step control. */
+/** Each internal step of size h computes a solution y and an estimate e of
+    its local error. The step is accepted if the weighted RMS norm
+       ||e|| = sqrt( 1/n sum_i (e_i / (abs_tol + rel_tol max(|x_i|,|y_i|)))^2 )
+    is at most 1, and rejected otherwise. The size of the next step, or of the
+    retry, is computed with a PI controller,
+       h_new = h safety ||e||^(-0.7/q) ||e_prev||^(0.4/q),
+    where q is the order of the error estimate and e_prev is the error of the
+    previous accepted step, limited to the range [fac_min h, fac_max h]. After
+    a rejection, h_new = h max(fac_min, safety ||e||^(-1/q)).
+
+    Step() integrates with internal steps from t to t + dt, adjusting the last
+    internal step to reach t + dt exactly, so that the output times of the
+    caller are kept. On output, @a dt is the last internal step size, as
+    required by ODESolver::Step(); the size proposed for the next internal step
+    is kept by the solver and can be queried with GetStepSize(). Run()
+    integrates to the final time with internal steps only, and uses @a dt [in]
+    as the initial step size. */
+class AdaptiveODESolver : public ODESolver
+{
+protected:
+   const int err_order; ///< Order q of the error estimate
+   double rel_tol, abs_tol;
+   double dt_min, dt_max, safety, fac_min, fac_max;
+   double h;        ///< Proposed internal step size; 0 before the first step
+   double err_prev; ///< Error norm of the previous accepted step
+   int num_accepted, num_rejected;
+   Vector y, err;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+#endif
+
+   /** @brief Compute in @a y the solution after a step of size @a h from
+       (@a x, @a t), and in @a err the estimate of its local error. */
+   /** This method may be called repeatedly with the same @a x and @a t and
+       decreasing values of @a h when steps are rejected. */
+   virtual void TryStep(const Vector &x, double t, double h, Vector &y,
+                        Vector &err) = 0;
+
+   /** @brief Called when the step computed by the last call to TryStep() is
+       accepted, before @a x and @a t are updated. */
+   virtual void AcceptStep() { }
+
+   /// Return the weighted RMS norm of @a err, see the class description.
+   double ErrorNorm(const Vector &x, const Vector &y, const Vector &err) const;
+
+   /** @brief Take one accepted internal step from (@a x, @a t), of size at
+       most @a tf - @a t; return the size of the step. */
+   double AdaptStep(Vector &x, double &t, double tf);
+
+public:
+   /// Construct the solver for an error estimate of order @a q.
+   AdaptiveODESolver(int q);
+
+#ifdef MFEM_USE_MPI
+   /** @brief Set the MPI communicator used for the error norm of distributed
+       vectors. */
+   void SetComm(MPI_Comm c) { comm = c; }
+#endif
+
+   /// Set the relative and absolute tolerances of the local error.
+   void SetTolerances(double rtol, double atol)
+   { rel_tol = rtol; abs_tol = atol; }
+
+   /** @brief Set the bounds of the internal step size. Steps of size
+       @a min_dt are accepted regardless of their error. */
+   void SetStepLimits(double min_dt, double max_dt)
+   { dt_min = min_dt; dt_max = max_dt; }
+
+   /** @brief Set the parameters of the step size controller: the safety
+       factor and the bounds of the ratio between consecutive step sizes.
+       The defaults are 0.9, 0.2 and 5. */
+   void SetControlParameters(double safety_, double fac_min_, double fac_max_)
+   { safety = safety_; fac_min = fac_min_; fac_max = fac_max_; }
+
+   /// Return the size proposed for the next internal step.
+   double GetStepSize() const { return h; }
+
+   /// Return the number of accepted internal steps since Init().
+   int GetNumAccepted() const { return num_accepted; }
+
+   /// Return the number of rejected internal steps since Init().
+   int GetNumRejected() const { return num_rejected; }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual void Run(Vector &x, double &t, double &dt, double tf);
+};
+
+
+/** An explicit embedded Runge-Kutta pair with adaptive time step control,
+    corresponding to a general Butcher tableau
+    +--------+----------------------+
+    | c[0]   | a[0]                 |
+    | c[1]   | a[1] a[2]            |
+    | ...    |    ...               |
+    | c[s-2] | ...   a[s(s-1)/2-1]  |
+    +--------+----------------------+
+    |        | b[0] b[1] ... b[s-1] |
+    |        | d[0] d[1] ... d[s-1] |
+    +--------+----------------------+
+    where b are the weights of the solution and d the weights of the embedded
+    solution, of a different order. The error estimate is dt sum_i (b[i] -
+    d[i]) k[i]. If the last stage is the solution at t + dt ("first same as
+    last" property), it is reused as the first stage of the next step. */
+class EmbeddedRKSolver : public AdaptiveODESolver
+{
+private:
+   int s;
+   const double *a, *b, *d, *c;
+   Vector *k;
+   bool fsal, have_k0;
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double h, Vector &y,
+                        Vector &err);
+
+   virtual void AcceptStep();
+
+public:
+   /** @brief Construct the pair from its tableau; @a q is the order of the
+       error estimate, i.e. one plus the lower of the two orders. */
+   EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                    const double *_d, const double *_c, int q);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual ~EmbeddedRKSolver();
+};
+
+
+/** The Bogacki-Shampine 3(2) pair: 4 stages, one of which is reused in the
+    next step. */
+class BogackiShampineSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[6], b[4], d[4], c[3];
+
+public:
+   BogackiShampineSolver() : EmbeddedRKSolver(4, a, b, d, c, 3) { }
+};
+
+
+/** The Dormand-Prince 5(4) pair: 7 stages, one of which is reused in the next
+    step. */
+class DormandPrinceSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[21], b[7], d[7], c[6];
+
+public:
+   DormandPrinceSolver() : EmbeddedRKSolver(7, a, b, d, c, 5) { }
+};
+
+
+/** A low-storage explicit Runge-Kutta method in the 2N form of Williamson:
+    for i = 0,...,s-1,
+       dx <- A[i] dx + dt f(x, t + c[i] dt),
+       x  <- x + B[i] dx,
+    with A[0] = 0. Besides the solution, only the vectors dx and f(x) are
+    stored, independently of the number of stages s. */
+class LowStorageRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *A, *B, *c;
+   Vector dx, k;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c)
+      : s(_s), A(_A), B(_B), c(_c) { }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/// The 3-stage, third order low-storage RK method of Williamson.
+class LSRK3Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[3], B[3], c[3];
+
+public:
+   LSRK3Solver() : LowStorageRKSolver(3, A, B, c) { }
+};
+
+
+/** The 5-stage, fourth order low-storage RK method of Carpenter and Kennedy,
+    with the same storage as LSRK3Solver and a larger stability region than
+    RK4Solver per function evaluation. */
+class LSRK4Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   LSRK4Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
 /// Backward Euler ODE solver. L-stable.
 class BackwardEulerSolver : public ODESolver
 {
@@ -281,6 +491,103 @@ public:
 };
 
 
+/** The TR-BDF2 method with the embedded third order error estimate of Hosea
+    and Shampine, with adaptive time step control. */
+/** An L-stable, second order ESDIRK method: a trapezoidal rule stage to
+    t + g dt, with g = 2 - sqrt(2), followed by a BDF2 stage to t + dt. It
+    requires both the Mult() and the ImplicitSolve() methods of the
+    TimeDependentOperator; the explicit first stage is the last stage of the
+    previous step. */
+class TRBDF2Solver : public AdaptiveODESolver
+{
+protected:
+   Vector k0, k1, k2, z;
+   bool have_k0;
+
+   virtual void TryStep(const Vector &x, double t, double h, Vector &y,
+                        Vector &err);
+
+   virtual void AcceptStep();
+
+public:
+   TRBDF2Solver() : AdaptiveODESolver(3), have_k0(false) { }
+
+   virtual void Init(TimeDependentOperator &_f);
+};
+
+
+/** An implicit-explicit (IMEX) additive Runge-Kutta method for the split
+    f(x,t) = f1(x,t) + f2(x,t), with a non-stiff term f1, treated explicitly,
+    and a stiff term f2, treated with a diagonally implicit method. */
+/** The terms are selected with TimeDependentOperator::SetEvalMode(), as in the
+    IMEX mode of ARKStepSolver: f1 is evaluated with Mult() in the mode
+    ADDITIVE_TERM_1, and f2 with ImplicitSolve(), and Mult() for the stages
+    with a zero diagonal entry, in the mode ADDITIVE_TERM_2. The mode is reset
+    to NORMAL at the end of each step. The two tableaux share the nodes c:
+    +--------+-------------------------+--------------------------+
+    | c[0]   |                         | ai[0]                    |
+    | c[1]   | ae[0]                   | ai[1] ai[2]              |
+    | ...    |    ...                  |    ...                   |
+    | c[s-1] | ...   ae[s(s-1)/2-1]    | ...        ai[s(s+1)/2-1]|
+    +--------+-------------------------+--------------------------+
+    |        | be[0] be[1] ... be[s-1] | bi[0] bi[1] ... bi[s-1]  |
+    +--------+-------------------------+--------------------------+ */
+class IMEXRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *ae, *be, *ai, *bi, *c;
+   Vector y, *ke, *ki;
+   Array<bool> use_ke, use_ki; // Stages used by the later stages or in x
+
+public:
+   IMEXRKSolver(int _s, const double *_ae, const double *_be,
+                const double *_ai, const double *_bi, const double *_c);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual ~IMEXRKSolver();
+};
+
+
+/** The forward-backward Euler IMEX method, ARS(1,1,1) of Ascher, Ruuth and
+    Spiteri. First order. */
+class IMEXEulerSolver : public IMEXRKSolver
+{
+private:
+   static const double ae[1], be[2], ai[3], bi[2], c[2];
+
+public:
+   IMEXEulerSolver() : IMEXRKSolver(2, ae, be, ai, bi, c) { }
+};
+
+
+/** The ARS(2,3,2) IMEX method of Ascher, Ruuth and Spiteri: second order, with
+    an L-stable implicit part. */
+class IMEXRK2Solver : public IMEXRKSolver
+{
+private:
+   static const double ae[3], be[3], ai[6], bi[3], c[3];
+
+public:
+   IMEXRK2Solver() : IMEXRKSolver(3, ae, be, ai, bi, c) { }
+};
+
+
+/** The ARS(3,4,3) IMEX method of Ascher, Ruuth and Spiteri: third order, with
+    an L-stable implicit part. */
+class IMEXRK3Solver : public IMEXRKSolver
+{
+private:
+   static const double ae[6], be[4], ai[10], bi[4], c[4];
+
+public:
+   IMEXRK3Solver() : IMEXRKSolver(4, ae, be, ai, bi, c) { }
+};
+
+
 /// Generalized-alpha ODE solver from "A generalized-α method for integrating
 /// the filtered Navier–Stokes equations with a stabilized finite element
 /// method" by K.E. Jansen, C.H. Whiting and G.M. Hulbert.
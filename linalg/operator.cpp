@@ -109,6 +109,22 @@ void Operator::FormDiscreteOperator(Operator* &Aout)
    Aout = new TripleProductOperator(Rout, this, Pin,false, false, false);
 }
 
+void Operator::MultiMult(const MultiVector &X, MultiVector &Y) const
+{
+   MFEM_VERIFY(X.VSize() == width && Y.VSize() == height &&
+               X.NumVectors() == Y.NumVectors(),
+               "incompatible MultiVectors: X is " << X.VSize() << " x "
+               << X.NumVectors() << ", Y is " << Y.VSize() << " x "
+               << Y.NumVectors());
+   Vector x, y;
+   for (int j = 0; j < X.NumVectors(); j++)
+   {
+      X.GetVector(j, x);
+      Y.GetVector(j, y);
+      Mult(x, y);
+   }
+}
+
 void Operator::PrintMatlab(std::ostream & out, int n, int m) const
 {
    using namespace std;
@@ -215,6 +231,14 @@ ProductOperator::ProductOperator(const Operator *A, const Operator *B,
                << ", B->Height() = " << B->Height());
 }
 
+void ProductOperator::MultiMult(const MultiVector &X, MultiVector &Y) const
+{
+   Z.SetSize(B->Height(), X.NumVectors(), z.GetMemory().GetMemoryType());
+   Z.UseDevice(true);
+   B->MultiMult(X, Z);
+   A->MultiMult(Z, Y);
+}
+
 ProductOperator::~ProductOperator()
 {
    if (ownA) { delete A; }
@@ -239,6 +263,31 @@ RAPOperator::RAPOperator(const Operator &Rt_, const Operator &A_,
    APx.SetSize(A.Height(), mem_type);
 }
 
+void RAPOperator::MultiMult(const MultiVector &X, MultiVector &Y) const
+{
+   const int nv = X.NumVectors();
+   MFEM_VERIFY(Y.NumVectors() == nv && Y.VSize() == height,
+               "incompatible MultiVectors");
+   const MemoryType mem_type = Px.GetMemory().GetMemoryType();
+   PX.SetSize(P.Height(), nv, mem_type); PX.UseDevice(true);
+   APX.SetSize(A.Height(), nv, mem_type); APX.UseDevice(true);
+   P.MultiMult(X, PX);
+   A.MultiMult(PX, APX);
+   Vector apx, y;
+   for (int j = 0; j < nv; j++)
+   {
+      APX.GetVector(j, apx);
+      Y.GetVector(j, y);
+      Rt.MultTranspose(apx, y);
+   }
+}
+
+void RAPOperator::AssembleDiagonal(Vector &diag) const
+{
+   A.AssembleDiagonal(APx);
+   P.MultTranspose(APx, diag);
+}
+
 
 TripleProductOperator::TripleProductOperator(
    const Operator *A, const Operator *B, const Operator *C,
@@ -336,4 +385,47 @@ void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
    });
 }
 
+void ConstrainedOperator::MultiMult(const MultiVector &X, MultiVector &Y) const
+{
+   const int csz = constraint_list.Size();
+   if (csz == 0)
+   {
+      A->MultiMult(X, Y);
+      return;
+   }
+
+   const int nv = X.NumVectors();
+   const int n = height;
+   Z.SetSize(n, nv, z.GetMemory().GetMemoryType());
+   Z.UseDevice(true);
+   Z = X;
+
+   auto idx = constraint_list.Read();
+   // Use read+write access - we are modifying sub-vectors of Z
+   auto d_Z = Z.ReadWrite();
+   MFEM_FORALL(i, csz*nv, d_Z[idx[i % csz] + (i / csz)*n] = 0.0;);
+
+   A->MultiMult(Z, Y);
+
+   auto d_X = X.Read();
+   // Use read+write access - we are modifying sub-vectors of Y
+   auto d_Y = Y.ReadWrite();
+   MFEM_FORALL(i, csz*nv,
+   {
+      const int id = idx[i % csz] + (i / csz)*n;
+      d_Y[id] = d_X[id];
+   });
+}
+
+void ConstrainedOperator::AssembleDiagonal(Vector &diag) const
+{
+   A->AssembleDiagonal(diag);
+
+   const int csz = constraint_list.Size();
+   auto idx = constraint_list.Read();
+   // Use read+write access - we are modifying sub-vector of diag
+   auto d_diag = diag.ReadWrite();
+   MFEM_FORALL(i, csz, d_diag[idx[i]] = 1.0;);
+}
+
 }
@@ -13,6 +13,7 @@
 #define MFEM_OPERATOR
 
 #include "vector.hpp"
+#include "multivector.hpp"
 
 namespace mfem
 {
@@ -69,6 +70,24 @@ public:
    virtual void MultTranspose(const Vector &x, Vector &y) const
    { mfem_error("Operator::MultTranspose() is not overloaded!"); }
 
+   /** @brief Operator application to a block of vectors: `Y_j=A(X_j)` for
+       each vector `j` of @a X. */
+   /** The MultiVector%s @a X and @a Y must have the same number of vectors, of
+       sizes Width() and Height(), respectively. The default implementation
+       calls Mult() for each vector; derived classes can override it to stream
+       the operator data once for the whole block. */
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const;
+
+   /** @brief Computes the diagonal entries into @a diag. Typically, this
+       operation only makes sense for linear Operator%s. The default behavior
+       in class Operator is to generate an error.
+
+       The vector @a diag must be of size Height(). Derived classes are
+       expected to compute the diagonal without forming the full matrix when
+       possible, e.g. with sum-factorized kernels for partial assembly. */
+   virtual void AssembleDiagonal(Vector &diag) const
+   { mfem_error("Operator::AssembleDiagonal() is not overloaded!"); }
+
    /** @brief Evaluate the gradient operator at the point @a x. The default
        behavior in class Operator is to generate an error. */
    virtual Operator &GetGradient(const Vector &x) const
@@ -445,6 +464,7 @@ class ProductOperator : public Operator
    const Operator *A, *B;
    bool ownA, ownB;
    mutable Vector z;
+   mutable MultiVector Z;
 
 public:
    ProductOperator(const Operator *A, const Operator *B, bool ownA, bool ownB);
@@ -452,6 +472,8 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const
    { B->Mult(x, z); A->Mult(z, y); }
 
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const;
+
    virtual void MultTranspose(const Vector &x, Vector &y) const
    { A->MultTranspose(x, z); B->MultTranspose(z, y); }
 
@@ -468,6 +490,7 @@ private:
    const Operator & P;
    mutable Vector Px;
    mutable Vector APx;
+   mutable MultiVector PX, APX;
    MemoryClass mem_class;
 
 public:
@@ -480,9 +503,19 @@ public:
    virtual void Mult(const Vector & x, Vector & y) const
    { P.Mult(x, Px); A.Mult(Px, APx); Rt.MultTranspose(APx, y); }
 
+   /// Operator application to a block of vectors.
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const;
+
    /// Application of the transpose.
    virtual void MultTranspose(const Vector & x, Vector & y) const
    { Rt.Mult(x, APx); A.MultTranspose(APx, Px); P.MultTranspose(Px, y); }
+
+   /** @brief Approximate diagonal of the RAP Operator.
+
+       Computes the diagonal of A and restricts it with P^T. The result is exact
+       when R = P^T and P has at most one unit entry per row, e.g. for the
+       prolongation of a conforming finite element space. */
+   virtual void AssembleDiagonal(Vector &diag) const;
 };
 
 
@@ -525,6 +558,7 @@ protected:
    Operator *A;                 ///< The unconstrained Operator.
    bool own_A;                  ///< Ownership flag for A.
    mutable Vector z, w;         ///< Auxiliary vectors.
+   mutable MultiVector Z;       ///< Auxiliary block of vectors.
    MemoryClass mem_class;
 
 public:
@@ -560,6 +594,16 @@ public:
        the vectors, and "_i" -- the rest of the entries. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /** @brief Constrained operator action on a block of vectors: the same steps
+       as in Mult() are applied to each vector, with a single application of
+       A to the whole block. */
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const;
+
+   /** @brief Diagonal of the constrained operator: the diagonal of A with the
+       entries of the constrained indices/dofs set to 1, consistent with
+       Mult(). */
+   virtual void AssembleDiagonal(Vector &diag) const;
+
    /// Destructor: destroys the unconstrained Operator, if owned.
    virtual ~ConstrainedOperator() { if (own_A) { delete A; } }
 };
@@ -0,0 +1,89 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SIMD
+#define MFEM_SIMD
+
+#include "../config/config.hpp"
+
+// Size in bytes of the simd_double vectors: the width of the widest SIMD
+// registers enabled at compile time, e.g. with -march=native.
+#if defined(__AVX512F__)
+#define MFEM_SIMD_DOUBLE_BYTES 64
+#elif defined(__AVX__)
+#define MFEM_SIMD_DOUBLE_BYTES 32
+#else
+#define MFEM_SIMD_DOUBLE_BYTES 16
+#endif
+
+namespace mfem
+{
+
+/// Number of doubles in a simd_double vector.
+constexpr int SIMD_DOUBLES = MFEM_SIMD_DOUBLE_BYTES / sizeof(double);
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/** @brief SIMD vector of SIMD_DOUBLES doubles, using the vector extensions of
+    GCC and Clang. */
+/** Supports element access with operator[], the arithmetic operators between
+    vectors, and between a vector and a scalar. A value-initialized vector,
+    simd_double(), is zero. */
+typedef double simd_double
+__attribute__((vector_size(MFEM_SIMD_DOUBLE_BYTES)));
+
+#else
+
+/// Portable fallback for simd_double, left to the compiler to vectorize.
+struct simd_double
+{
+   double v[SIMD_DOUBLES];
+
+   double &operator[](int i) { return v[i]; }
+   const double &operator[](int i) const { return v[i]; }
+
+   simd_double &operator+=(const simd_double &b)
+   {
+      for (int i = 0; i < SIMD_DOUBLES; i++) { v[i] += b.v[i]; }
+      return *this;
+   }
+   simd_double &operator-=(const simd_double &b)
+   {
+      for (int i = 0; i < SIMD_DOUBLES; i++) { v[i] -= b.v[i]; }
+      return *this;
+   }
+   simd_double &operator*=(const simd_double &b)
+   {
+      for (int i = 0; i < SIMD_DOUBLES; i++) { v[i] *= b.v[i]; }
+      return *this;
+   }
+   simd_double operator+(const simd_double &b) const
+   { simd_double r = *this; return r += b; }
+   simd_double operator-(const simd_double &b) const
+   { simd_double r = *this; return r -= b; }
+   simd_double operator*(const simd_double &b) const
+   { simd_double r = *this; return r *= b; }
+   simd_double operator*(const double b) const
+   {
+      simd_double r;
+      for (int i = 0; i < SIMD_DOUBLES; i++) { r.v[i] = v[i] * b; }
+      return r;
+   }
+};
+
+inline simd_double operator*(const double a, const simd_double &b)
+{ return b * a; }
+
+#endif
+
+} // namespace mfem
+
+#endif // MFEM_SIMD
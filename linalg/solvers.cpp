@@ -10,6 +10,7 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "linalg.hpp"
+#include "../general/forall.hpp"
 #include "../general/globals.hpp"
 #include <iostream>
 #include <iomanip>
@@ -31,6 +32,7 @@ IterativeSolver::IterativeSolver()
    rel_tol = abs_tol = 0.0;
 #ifdef MFEM_USE_MPI
    dot_prod_type = 0;
+   reduce_request = MPI_REQUEST_NULL;
 #endif
 }
 
@@ -45,6 +47,7 @@ IterativeSolver::IterativeSolver(MPI_Comm _comm)
    rel_tol = abs_tol = 0.0;
    dot_prod_type = 1;
    comm = _comm;
+   reduce_request = MPI_REQUEST_NULL;
 }
 #endif
 
@@ -64,6 +67,70 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::StartReduce(double *buf, int n) const
+{
+#ifndef MFEM_USE_MPI
+   MFEM_CONTRACT_VAR(buf);
+   MFEM_CONTRACT_VAR(n);
+#else
+   if (dot_prod_type == 1)
+   {
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(MPI_IN_PLACE, buf, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &reduce_request);
+#else
+      MPI_Allreduce(MPI_IN_PLACE, buf, n, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#endif
+}
+
+void IterativeSolver::FinishReduce() const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type == 1)
+   {
+      // No-op for MPI_REQUEST_NULL, i.e. without MPI-3
+      MPI_Wait(&reduce_request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
+void IterativeSolver::MultiDot(const MultiVector &X, const MultiVector &Y,
+                               const Array<int> &active, Vector &dots) const
+{
+   const int nv = X.NumVectors();
+   dots.SetSize(nv);
+   Vector x, y;
+   for (int j = 0; j < nv; j++)
+   {
+      if (!active[j]) { dots(j) = 0.0; continue; }
+      X.GetVector(j, x);
+      Y.GetVector(j, y);
+      dots(j) = x * y;
+   }
+   StartReduce(dots.GetData(), nv);
+   FinishReduce();
+}
+
+double IterativeSolver::AddAndDot(const Vector &v1, double alpha,
+                                  const Vector &v2, Vector &v,
+                                  const Vector &w) const
+{
+   double dot = mfem::AddAndDot(v1, alpha, v2, v, w);
+   StartReduce(&dot, 1);
+   FinishReduce();
+   return dot;
+}
+
+void IterativeSolver::Dots(const Vector &x, int k, const Vector *const *y,
+                           double *dots) const
+{
+   InnerProducts(x, k, y, dots);
+   StartReduce(dots, k);
+   FinishReduce();
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -103,6 +170,208 @@ void IterativeSolver::SetOperator(const Operator &op)
 }
 
 
+OperatorJacobiSmoother::OperatorJacobiSmoother(const Operator &a,
+                                               const Vector &d,
+                                               const Array<int> &ess_tdof_list,
+                                               const double damping_)
+   : Solver(a.Height()), oper(&a), damping(damping_)
+{
+   Setup(d, ess_tdof_list);
+}
+
+OperatorJacobiSmoother::OperatorJacobiSmoother(const Operator &a,
+                                               const Array<int> &ess_tdof_list,
+                                               const double damping_)
+   : Solver(a.Height()), oper(&a), damping(damping_)
+{
+   Vector diag(height);
+   a.AssembleDiagonal(diag);
+   Setup(diag, ess_tdof_list);
+}
+
+void OperatorJacobiSmoother::Setup(const Vector &diag,
+                                   const Array<int> &ess_tdof_list)
+{
+   MFEM_VERIFY(diag.Size() == height, "invalid diagonal size");
+   dinv.SetSize(height, Device::GetMemoryType());
+   dinv.UseDevice(true);
+   residual.SetSize(height, Device::GetMemoryType());
+   residual.UseDevice(true);
+
+   const int N = height;
+   auto D = diag.Read();
+   auto DI = dinv.Write();
+   MFEM_FORALL(i, N, DI[i] = 1.0 / D[i];);
+
+   const int csz = ess_tdof_list.Size();
+   auto I = ess_tdof_list.Read();
+   MFEM_FORALL(i, csz, DI[I[i]] = 1.0;);
+}
+
+void OperatorJacobiSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(x.Size() == height && y.Size() == height,
+               "invalid input/output vector sizes");
+   const int N = height;
+   const double damp = damping;
+   auto DI = dinv.Read();
+   if (!iterative_mode)
+   {
+      auto X = x.Read();
+      auto Y = y.Write();
+      MFEM_FORALL(i, N, Y[i] = damp * DI[i] * X[i];);
+      return;
+   }
+   MFEM_VERIFY(oper, "the Operator is required in iterative mode");
+   oper->Mult(y, residual);
+   auto X = x.Read();
+   auto R = residual.Read();
+   auto Y = y.ReadWrite();
+   MFEM_FORALL(i, N, Y[i] += damp * DI[i] * (X[i] - R[i]););
+}
+
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   const Operator &a, const Vector &diag, const Array<int> &ess_tdof_list,
+   int order_, int power_iterations)
+   : Solver(a.Height()), oper(&a), order(order_), max_eig(0.0)
+{
+#ifdef MFEM_USE_MPI
+   parallel = false;
+#endif
+   Setup(diag, ess_tdof_list);
+   if (power_iterations != 0)
+   {
+      max_eig = EstimateMaxEigenvalue(power_iterations);
+   }
+}
+
+#ifdef MFEM_USE_MPI
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   MPI_Comm comm_, const Operator &a, const Vector &diag,
+   const Array<int> &ess_tdof_list, int order_, int power_iterations)
+   : Solver(a.Height()), oper(&a), order(order_), max_eig(0.0),
+     comm(comm_), parallel(true)
+{
+   Setup(diag, ess_tdof_list);
+   if (power_iterations != 0)
+   {
+      max_eig = EstimateMaxEigenvalue(power_iterations);
+   }
+}
+#endif
+
+void OperatorChebyshevSmoother::Setup(const Vector &diag,
+                                      const Array<int> &ess_tdof_list)
+{
+   MFEM_VERIFY(order > 0, "invalid polynomial order: " << order);
+   MFEM_VERIFY(diag.Size() == height, "invalid diagonal size");
+   const MemoryType mt = Device::GetMemoryType();
+   dinv.SetSize(height, mt); dinv.UseDevice(true);
+   r.SetSize(height, mt); r.UseDevice(true);
+   d.SetSize(height, mt); d.UseDevice(true);
+   z.SetSize(height, mt); z.UseDevice(true);
+
+   const int N = height;
+   auto D = diag.Read();
+   auto DI = dinv.Write();
+   MFEM_FORALL(i, N, DI[i] = 1.0 / D[i];);
+
+   const int csz = ess_tdof_list.Size();
+   auto I = ess_tdof_list.Read();
+   MFEM_FORALL(i, csz, DI[I[i]] = 1.0;);
+}
+
+double OperatorChebyshevSmoother::Dot(const Vector &x, const Vector &y) const
+{
+#ifdef MFEM_USE_MPI
+   if (parallel) { return InnerProduct(comm, x, y); }
+#endif
+   return x * y;
+}
+
+double OperatorChebyshevSmoother::EstimateMaxEigenvalue(int iters) const
+{
+   // Power method for the largest eigenvalue of D^{-1} A, using the Rayleigh
+   // quotient (v, A v) / (v, D v) which is appropriate for symmetric A and D.
+   MFEM_VERIFY(iters > 0, "invalid number of power iterations: " << iters);
+   const int N = height;
+   auto DI = dinv.Read();
+   d.Randomize(1);
+   double lambda = 0.0;
+   for (int it = 0; it < iters; it++)
+   {
+      oper->Mult(d, z);
+      // r = D v
+      {
+         auto V = d.Read();
+         auto R = r.Write();
+         MFEM_FORALL(i, N, R[i] = V[i] / DI[i];);
+      }
+      lambda = Dot(d, z) / Dot(d, r);
+      // v = D^{-1} A v, normalized
+      {
+         auto Z = z.Read();
+         auto V = d.Write();
+         MFEM_FORALL(i, N, V[i] = DI[i] * Z[i];);
+      }
+      const double nrm = sqrt(Dot(d, d));
+      MFEM_VERIFY(nrm > 0.0, "the power method failed: zero iterate");
+      d /= nrm;
+   }
+   return lambda;
+}
+
+void OperatorChebyshevSmoother::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_VERIFY(x.Size() == height && y.Size() == height,
+               "invalid input/output vector sizes");
+   MFEM_VERIFY(max_eig > 0.0, "the largest eigenvalue estimate is not set");
+   // Chebyshev acceleration of the Jacobi iteration on the interval [a,b],
+   // see e.g. Y. Saad, "Iterative methods for sparse linear systems",
+   // Algorithm 12.1, and M. Adams et al., "Parallel multigrid smoothing:
+   // polynomial versus Gauss-Seidel", J. Comput. Phys. 188 (2003).
+   const double upper = 1.2 * max_eig;
+   const double lower = 0.3 * max_eig;
+   const double theta = 0.5 * (upper + lower);
+   const double delta = 0.5 * (upper - lower);
+   const double sigma = theta / delta;
+   double rho = 1.0 / sigma;
+
+   const int N = height;
+   auto DI = dinv.Read();
+   if (iterative_mode)
+   {
+      oper->Mult(y, r);
+      subtract(x, r, r);
+   }
+   else
+   {
+      r = x;
+      y.UseDevice(true);
+      y = 0.0;
+   }
+   {
+      const double s = 1.0 / theta;
+      auto R = r.Read();
+      auto D = d.Write();
+      MFEM_FORALL(i, N, D[i] = s * DI[i] * R[i];);
+   }
+   for (int k = 1; k <= order; k++)
+   {
+      y += d;
+      if (k == order) { break; }
+      oper->Mult(d, z);
+      r -= z;
+      const double rho_new = 1.0 / (2.0 * sigma - rho);
+      const double s1 = rho_new * rho;
+      const double s2 = 2.0 * rho_new / delta;
+      auto R = r.Read();
+      auto D = d.ReadWrite();
+      MFEM_FORALL(i, N, D[i] = s1 * D[i] + s2 * DI[i] * R[i];);
+      rho = rho_new;
+   }
+}
+
 void SLISolver::UpdateVectors()
 {
    r.SetSize(width);
@@ -280,6 +549,70 @@ void SLI(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
+void IterativeRefinementSolver::UpdateVectors()
+{
+   r.SetSize(width); r.UseDevice(true);
+   z.SetSize(width); z.UseDevice(true);
+}
+
+void IterativeRefinementSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(inner, "the inner solver is not set");
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   double nom = Norm(r);
+   MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+   const double tol = std::max(rel_tol*nom, abs_tol);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  ||r|| = "
+                << nom << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   inner->iterative_mode = false;
+   converged = (nom <= tol);
+   final_iter = 0;
+   for (int i = 1; !converged && i <= max_iter; i++)
+   {
+      inner->Mult(r, z);  // z = S r
+      x += z;             // x = x + S (b - A x)
+      oper->Mult(x, r);
+      subtract(b, r, r);  // r = b - A x
+      nom = Norm(r);
+      MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+      final_iter = i;
+      converged = (nom <= tol);
+
+      if (print_level == 1 || (print_level == 3 && converged))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  ||r|| = "
+                   << nom << '\n';
+      }
+   }
+   final_norm = nom;
+
+   if (print_level == 2)
+   {
+      mfem::out << "Iterative refinement: Number of iterations: "
+                << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Iterative refinement: No convergence!\n";
+   }
+}
+
+
 void CGSolver::UpdateVectors()
 {
    r.SetSize(width);
@@ -356,16 +689,17 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    {
       alpha = nom/den;
       add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
 
       if (prec)
       {
+         add(r, -alpha, z, r);  //  r = r - alpha A d
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         // r = r - alpha A d, betanom = (r, r)
+         betanom = AddAndDot(r, -alpha, z, r, r);
       }
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
@@ -473,174 +807,586 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
 }
 
 
-inline void GeneratePlaneRotation(double &dx, double &dy,
-                                  double &cs, double &sn)
+// Output of the CG variants at the end of the iteration, as in CGSolver: nom0
+// and nom are the initial and the final values of (B r, r).
+static void PrintCGSummary(const char *name, int print_level, int converged,
+                           int final_iter, double nom0, double nom)
 {
-   if (dy == 0.0)
-   {
-      cs = 1.0;
-      sn = 0.0;
-   }
-   else if (fabs(dy) > fabs(dx))
+   if (print_level == 2 && converged)
    {
-      double temp = dx / dy;
-      sn = 1.0 / sqrt( 1.0 + temp*temp );
-      cs = temp * sn;
+      mfem::out << name << ": Number of iterations: " << final_iter << '\n';
    }
-   else
+   else if (print_level == 3 || (print_level >= 0 && !converged &&
+                                 print_level != 1))
    {
-      double temp = dy / dx;
-      cs = 1.0 / sqrt( 1.0 + temp*temp );
-      sn = temp * cs;
+      mfem::out << "   Iteration : " << setw(3) << final_iter
+                << "  (B r, r) = " << nom << '\n';
    }
-}
-
-inline void ApplyPlaneRotation(double &dx, double &dy, double &cs, double &sn)
-{
-   double temp = cs * dx + sn * dy;
-   dy = -sn * dx + cs * dy;
-   dx = temp;
-}
-
-inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
-                   Array<Vector*> &v)
-{
-   Vector y(s);
-
-   // Backsolve:
-   for (int i = k; i >= 0; i--)
+   if (print_level >= 0 && !converged)
    {
-      y(i) /= h(i,i);
-      for (int j = i - 1; j >= 0; j--)
-      {
-         y(j) -= h(j,i) * y(i);
-      }
+      mfem::out << name << ": No convergence!" << '\n';
    }
-
-   for (int j = 0; j <= k; j++)
+   if ((print_level >= 1 || (print_level >= 0 && !converged)) && final_iter)
    {
-      x.Add(y(j), *v[j]);
+      mfem::out << "Average reduction factor = "
+                << pow (nom/nom0, 0.5/final_iter) << '\n';
    }
 }
 
-void GMRESSolver::Mult(const Vector &b, Vector &x) const
+void CGSolver::MultiMult(const MultiVector &B, MultiVector &X) const
 {
-   // Generalized Minimum Residual method following the algorithm
-   // on p. 20 of the SIAM Templates book.
-
-   int n = width;
-
-   DenseMatrix H(m+1, m);
-   Vector s(m+1), cs(m+1), sn(m+1);
-   Vector r(n), w(n);
-   Array<Vector *> v;
+   const int nv = B.NumVectors();
+   MFEM_VERIFY(B.VSize() == height && X.VSize() == width &&
+               X.NumVectors() == nv, "incompatible MultiVectors");
 
-   double resid;
-   int i, j, k;
+   const MemoryType mt = r.GetMemory().GetMemoryType();
+   R.SetSize(width, nv, mt); R.UseDevice(true);
+   D.SetSize(width, nv, mt); D.UseDevice(true);
+   Z.SetSize(width, nv, mt); Z.UseDevice(true);
 
    if (iterative_mode)
    {
-      oper->Mult(x, r);
+      oper->MultiMult(X, R);
+      subtract(B, R, R); // R = B - A X
    }
    else
    {
-      x = 0.0;
+      R = B;
+      X = 0.0;
    }
 
    if (prec)
    {
-      if (iterative_mode)
-      {
-         subtract(b, r, w);
-         prec->Mult(w, r);    // r = M (b - A x)
-      }
-      else
-      {
-         prec->Mult(b, r);
-      }
+      prec->MultiMult(R, Z); // Z = M R
+      D = Z;
    }
    else
    {
-      if (iterative_mode)
-      {
-         subtract(b, r, r);
-      }
-      else
-      {
-         r = b;
-      }
+      D = R;
    }
-   double beta = Norm(r);  // beta = ||r||
-   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
 
-   final_norm = std::max(rel_tol*beta, abs_tol);
-
-   if (beta <= final_norm)
+   // The vectors with active[j] != 0 are still iterating.
+   Array<int> active(nv), conv(nv), iters(nv);
+   active = 1;
+   Vector nom, den, betanom;
+   MultiDot(D, R, active, nom);
+   MFEM_ASSERT(IsFinite(nom.Max()), "nom = " << nom.Max());
+   Vector nom0(nom), r0(nv);
+   int num_active = 0;
+   for (int j = 0; j < nv; j++)
    {
-      final_norm = beta;
-      final_iter = 0;
-      converged = 1;
-      goto finish;
+      r0(j) = std::max(nom(j)*rel_tol*rel_tol, abs_tol*abs_tol);
+      conv[j] = (nom(j) <= r0(j));
+      active[j] = !conv[j];
+      iters[j] = 0;
+      num_active += active[j];
    }
 
    if (print_level == 1 || print_level == 3)
    {
-      mfem::out << "   Pass : " << setw(2) << 1
-                << "   Iteration : " << setw(3) << 0
-                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+                << nom.Max() << (print_level == 3 ? " ...\n" : "\n");
    }
 
-   v.SetSize(m+1, NULL);
-
-   for (j = 1; j <= max_iter; )
+   Vector x, r, d, z;
+   for (int i = 1; num_active > 0 && i <= max_iter; i++)
    {
-      if (v[0] == NULL) { v[0] = new Vector(n); }
-      v[0]->Set(1.0/beta, r);
-      s = 0.0; s(0) = beta;
-
-      for (i = 0; i < m && j <= max_iter; i++, j++)
+      oper->MultiMult(D, Z); // Z = A D
+      MultiDot(D, Z, active, den);
+      for (int j = 0; j < nv; j++)
       {
-         if (prec)
+         if (!active[j]) { continue; }
+         MFEM_ASSERT(IsFinite(den(j)), "den = " << den(j));
+         if (den(j) <= 0.0 && print_level >= 0)
          {
-            oper->Mult(*v[i], r);
-            prec->Mult(r, w);        // w = M A v[i]
+            mfem::out << "PCG: The operator is not positive definite. "
+                      << "(Ad, d) = " << den(j) << '\n';
          }
-         else
+         if (den(j) == 0.0)
          {
-            oper->Mult(*v[i], w);
+            active[j] = 0;
+            iters[j] = i - 1;
+            num_active--;
+            continue;
          }
+         const double alpha = nom(j)/den(j);
+         X.GetVector(j, x); R.GetVector(j, r);
+         D.GetVector(j, d); Z.GetVector(j, z);
+         add(x,  alpha, d, x); // x = x + alpha d
+         add(r, -alpha, z, r); // r = r - alpha A d
+      }
 
-         for (k = 0; k <= i; k++)
-         {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
-         }
+      if (prec)
+      {
+         prec->MultiMult(R, Z); // Z = M R
+         MultiDot(R, Z, active, betanom);
+      }
+      else
+      {
+         MultiDot(R, R, active, betanom);
+      }
+      MFEM_ASSERT(IsFinite(betanom.Max()), "betanom = " << betanom.Max());
 
-         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
-         MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
-         if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
-         v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i
+                   << "  max (B r, r) = " << betanom.Max() << '\n';
+      }
 
-         for (k = 0; k < i; k++)
+      for (int j = 0; j < nv; j++)
+      {
+         if (!active[j]) { continue; }
+         iters[j] = i;
+         if (betanom(j) < r0(j))
          {
-            ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
+            nom(j) = betanom(j);
+            conv[j] = 1;
+            active[j] = 0;
+            num_active--;
+            continue;
          }
+         const double beta = betanom(j)/nom(j);
+         D.GetVector(j, d);
+         if (prec) { Z.GetVector(j, z); }
+         else { R.GetVector(j, z); }
+         add(z, beta, d, d); // d = z + beta d
+         nom(j) = betanom(j);
+      }
+   }
 
-         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
-         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
-         ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+   converged = 1;
+   final_iter = 0;
+   for (int j = 0; j < nv; j++)
+   {
+      converged = converged && conv[j];
+      final_iter = std::max(final_iter, iters[j]);
+   }
+   PrintCGSummary("PCG", print_level, converged, final_iter, nom0.Max(),
+                  nom.Max());
+   final_norm = sqrt(nom.Max());
+}
 
-         resid = fabs(s(i+1));
-         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+void SingleReductionCGSolver::UpdateVectors()
+{
+   r.SetSize(width); r.UseDevice(true);
+   u.SetSize(width); u.UseDevice(true);
+   w.SetSize(width); w.UseDevice(true);
+   p.SetSize(width); p.UseDevice(true);
+   s.SetSize(width); s.UseDevice(true);
+}
 
-         if (resid <= final_norm)
-         {
-            Update(x, i, H, s, v);
-            final_norm = resid;
-            final_iter = j;
-            converged = 1;
-            goto finish;
-         }
+void SingleReductionCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Conjugate gradient method with the recurrence of Chronopoulos and Gear,
+   // "s-step iterative methods for symmetric linear systems", J. Comput. Appl.
+   // Math. 25 (1989): the recurrence s = A p gives (A p, p) from (A u, u).
+   double dots[2], nom = 0.0, nom0 = 0.0, nom_old = 0.0, r0 = 0.0;
+   double alpha = 0.0, beta, den;
+
+   x.UseDevice(true);
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   p = 0.0;
+   s = 0.0;
+
+   const int N = width;
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      if (prec)
+      {
+         prec->Mult(r, u);  // u = B r
+      }
+      else
+      {
+         u = r;
+      }
+      oper->Mult(u, w);     // w = A u
+
+      dots[0] = r * u;
+      dots[1] = w * u;
+      StartReduce(dots, 2);
+      FinishReduce();
+      nom = dots[0];
+      MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+      MFEM_ASSERT(IsFinite(dots[1]), "(A u, u) = " << dots[1]);
+
+      if (i == 0)
+      {
+         nom0 = nom;
+         r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (i == 0 && print_level == 3))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << nom << (i == 0 && print_level == 3 ? " ...\n" : "\n");
+      }
+      if (nom <= r0)
+      {
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      beta = (i == 0) ? 0.0 : nom/nom_old;
+      den = (i == 0) ? dots[1] : dots[1] - beta*nom/alpha; // den = (A p, p)
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "SingleReductionCG: The operator is not positive "
+                      "definite. (Ap, p) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = nom/den;
+      nom_old = nom;
+
+      // p = u + beta p, s = w + beta s, x = x + alpha p, r = r - alpha s
+      auto d_u = u.Read();
+      auto d_w = w.Read();
+      auto d_p = p.ReadWrite();
+      auto d_s = s.ReadWrite();
+      auto d_x = x.ReadWrite();
+      auto d_r = r.ReadWrite();
+      MFEM_FORALL(k, N,
+      {
+         d_p[k] = d_u[k] + beta*d_p[k];
+         d_s[k] = d_w[k] + beta*d_s[k];
+         d_x[k] += alpha*d_p[k];
+         d_r[k] -= alpha*d_s[k];
+      });
+   }
+   PrintCGSummary("SingleReductionCG", print_level, converged, final_iter,
+                  nom0, nom);
+   final_norm = sqrt(nom);
+}
+
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width); r.UseDevice(true);
+   u.SetSize(width); u.UseDevice(true);
+   w.SetSize(width); w.UseDevice(true);
+   m.SetSize(width); m.UseDevice(true);
+   n.SetSize(width); n.UseDevice(true);
+   z.SetSize(width); z.UseDevice(true);
+   q.SetSize(width); q.UseDevice(true);
+   s.SetSize(width); s.UseDevice(true);
+   p.SetSize(width); p.UseDevice(true);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Preconditioned pipelined CG, Algorithm 4 in P. Ghysels and W. Vanroose,
+   // "Hiding global synchronization latency in the preconditioned conjugate
+   // gradient algorithm", Parallel Comput. 40 (2014). The recurrences keep
+   // u = B r, w = A u, s = A p, q = B s and z = A q.
+   double dots[2], nom = 0.0, nom0 = 0.0, nom_old = 0.0, r0 = 0.0;
+   double alpha = 0.0, beta, den;
+
+   x.UseDevice(true);
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+   {
+      prec->Mult(r, u);  // u = B r
+   }
+   else
+   {
+      u = r;
+   }
+   oper->Mult(u, w);     // w = A u
+   z = 0.0;
+   q = 0.0;
+   s = 0.0;
+   p = 0.0;
+
+   const int N = width;
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      dots[0] = r * u;
+      dots[1] = w * u;
+      StartReduce(dots, 2);
+
+      // Overlapped with the reduction
+      if (prec)
+      {
+         prec->Mult(w, m);  // m = B w
+      }
+      else
+      {
+         m = w;
+      }
+      oper->Mult(m, n);     // n = A m
+
+      FinishReduce();
+      nom = dots[0];
+      MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+      MFEM_ASSERT(IsFinite(dots[1]), "(A u, u) = " << dots[1]);
+
+      if (i == 0)
+      {
+         nom0 = nom;
+         r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (i == 0 && print_level == 3))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << nom << (i == 0 && print_level == 3 ? " ...\n" : "\n");
+      }
+      if (nom <= r0)
+      {
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      beta = (i == 0) ? 0.0 : nom/nom_old;
+      den = (i == 0) ? dots[1] : dots[1] - beta*nom/alpha; // den = (A p, p)
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "PipelinedCG: The operator is not positive "
+                      "definite. (Ap, p) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = nom/den;
+      nom_old = nom;
+
+      auto d_m = m.Read();
+      auto d_n = n.Read();
+      auto d_z = z.ReadWrite();
+      auto d_q = q.ReadWrite();
+      auto d_s = s.ReadWrite();
+      auto d_p = p.ReadWrite();
+      auto d_x = x.ReadWrite();
+      auto d_r = r.ReadWrite();
+      auto d_u = u.ReadWrite();
+      auto d_w = w.ReadWrite();
+      MFEM_FORALL(k, N,
+      {
+         d_z[k] = d_n[k] + beta*d_z[k];
+         d_q[k] = d_m[k] + beta*d_q[k];
+         d_s[k] = d_w[k] + beta*d_s[k];
+         d_p[k] = d_u[k] + beta*d_p[k];
+         d_x[k] += alpha*d_p[k];
+         d_r[k] -= alpha*d_s[k];
+         d_u[k] -= alpha*d_q[k];
+         d_w[k] -= alpha*d_z[k];
+      });
+   }
+   PrintCGSummary("PipelinedCG", print_level, converged, final_iter,
+                  nom0, nom);
+   final_norm = sqrt(nom);
+}
+
+
+inline void GeneratePlaneRotation(double &dx, double &dy,
+                                  double &cs, double &sn)
+{
+   if (dy == 0.0)
+   {
+      cs = 1.0;
+      sn = 0.0;
+   }
+   else if (fabs(dy) > fabs(dx))
+   {
+      double temp = dx / dy;
+      sn = 1.0 / sqrt( 1.0 + temp*temp );
+      cs = temp * sn;
+   }
+   else
+   {
+      double temp = dy / dx;
+      cs = 1.0 / sqrt( 1.0 + temp*temp );
+      sn = temp * cs;
+   }
+}
+
+inline void ApplyPlaneRotation(double &dx, double &dy, double &cs, double &sn)
+{
+   double temp = cs * dx + sn * dy;
+   dy = -sn * dx + cs * dy;
+   dx = temp;
+}
+
+inline void Update(Vector &x, int k, DenseMatrix &h, Vector &s,
+                   Array<Vector*> &v)
+{
+   Vector y(s);
+
+   // Backsolve:
+   for (int i = k; i >= 0; i--)
+   {
+      y(i) /= h(i,i);
+      for (int j = i - 1; j >= 0; j--)
+      {
+         y(j) -= h(j,i) * y(i);
+      }
+   }
+
+   // x += sum_j y(j) v[j] in one sweep
+   LinearCombination(k+1, y.GetData(), v.GetData(), 1.0, x);
+}
+
+void GMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Generalized Minimum Residual method following the algorithm
+   // on p. 20 of the SIAM Templates book.
+
+   int n = width;
+
+   DenseMatrix H(m+1, m);
+   Vector s(m+1), cs(m+1), sn(m+1);
+   Vector r(n), w(n);
+   Array<Vector *> v;
+
+   double resid;
+   int i, j, k;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+   }
+   else
+   {
+      x = 0.0;
+   }
+
+   if (prec)
+   {
+      if (iterative_mode)
+      {
+         subtract(b, r, w);
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         prec->Mult(b, r);
+      }
+   }
+   else
+   {
+      if (iterative_mode)
+      {
+         subtract(b, r, r);
+      }
+      else
+      {
+         r = b;
+      }
+   }
+   double beta = Norm(r);  // beta = ||r||
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   final_norm = std::max(rel_tol*beta, abs_tol);
+
+   if (beta <= final_norm)
+   {
+      final_norm = beta;
+      final_iter = 0;
+      converged = 1;
+      goto finish;
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   v.SetSize(m+1, NULL);
+
+   for (j = 1; j <= max_iter; )
+   {
+      if (v[0] == NULL) { v[0] = new Vector(n); }
+      v[0]->Set(1.0/beta, r);
+      s = 0.0; s(0) = beta;
+
+      for (i = 0; i < m && j <= max_iter; i++, j++)
+      {
+         if (prec)
+         {
+            oper->Mult(*v[i], r);
+            prec->Mult(r, w);        // w = M A v[i]
+         }
+         else
+         {
+            oper->Mult(*v[i], w);
+         }
+
+         // Modified Gram-Schmidt, where each update w -= H(k,i) * v[k] is
+         // fused with the next inner product, H(k+1,i) = w * v[k+1], and the
+         // last one with H(i+1,i) = ||w||.
+         H(0,i) = Dot(w, *v[0]);
+         for (k = 0; k <= i; k++)
+         {
+            const Vector &next = (k < i) ? *v[k+1] : w;
+            H(k+1,i) = AddAndDot(w, -H(k,i), *v[k], w, next);
+         }
+         H(i+1,i) = sqrt(H(i+1,i));    // H(i+1,i) = ||w||
+         MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
+         if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
+         v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
+
+         for (k = 0; k < i; k++)
+         {
+            ApplyPlaneRotation(H(k,i), H(k+1,i), cs(k), sn(k));
+         }
+
+         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+
+         resid = fabs(s(i+1));
+         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+
+         if (resid <= final_norm)
+         {
+            Update(x, i, H, s, v);
+            final_norm = resid;
+            final_iter = j;
+            converged = 1;
+            goto finish;
+         }
 
          if (print_level == 1)
          {
@@ -703,6 +1449,247 @@ finish:
    }
 }
 
+// Update the vector c of X with the Krylov basis V, see Update()
+static void MultiUpdate(MultiVector &X, int c, int k, DenseMatrix &h,
+                        const DenseMatrix &S, Array<MultiVector*> &V)
+{
+   Vector y(k+1);
+   for (int i = 0; i <= k; i++) { y(i) = S(i,c); }
+
+   // Backsolve:
+   for (int i = k; i >= 0; i--)
+   {
+      y(i) /= h(i,i);
+      for (int j = i - 1; j >= 0; j--)
+      {
+         y(j) -= h(j,i) * y(i);
+      }
+   }
+
+   Vector x, v;
+   X.GetVector(c, x);
+   for (int j = 0; j <= k; j++)
+   {
+      V[j]->GetVector(c, v);
+      x.Add(y(j), v);
+   }
+}
+
+void GMRESSolver::MultiMult(const MultiVector &B, MultiVector &X) const
+{
+   const int n = width, nv = B.NumVectors();
+   MFEM_VERIFY(B.VSize() == height && X.VSize() == width &&
+               X.NumVectors() == nv, "incompatible MultiVectors");
+
+   // The Hessenberg matrix, the rotations and the right-hand side of the
+   // least squares problem of the vector c are H(c), and the columns c of CS,
+   // SN and S.
+   DenseTensor H(m+1, m, nv);
+   DenseMatrix S(m+1, nv), CS(m+1, nv), SN(m+1, nv);
+   MultiVector R(n, nv), W(n, nv);
+   R.UseDevice(true);
+   W.UseDevice(true);
+   Array<MultiVector *> V(m+1);
+   V = NULL;
+
+   // The vectors with active[c] != 0 are still iterating.
+   Array<int> active(nv), conv(nv), iters(nv);
+   active = 1;
+   conv = 0;
+   iters = 0;
+   Vector beta, tol(nv), resid(nv), dots;
+   Vector r, w, v;
+
+   // R = M (B - A X)
+   if (iterative_mode) { oper->MultiMult(X, R); }
+   else { X = 0.0; }
+   if (prec)
+   {
+      if (iterative_mode) { subtract(B, R, W); }
+      else { W = B; }
+      prec->MultiMult(W, R);
+   }
+   else
+   {
+      if (iterative_mode) { subtract(B, R, R); }
+      else { R = B; }
+   }
+   MultiDot(R, R, active, beta);
+   int num_active = 0;
+   for (int c = 0; c < nv; c++)
+   {
+      beta(c) = sqrt(beta(c));
+      MFEM_ASSERT(IsFinite(beta(c)), "beta = " << beta(c));
+      tol(c) = std::max(rel_tol*beta(c), abs_tol);
+      resid(c) = beta(c);
+      conv[c] = (beta(c) <= tol(c));
+      active[c] = !conv[c];
+      num_active += active[c];
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  max ||B r|| = " << beta.Max()
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   int i, j = 1;
+   while (num_active > 0 && j <= max_iter)
+   {
+      if (V[0] == NULL)
+      {
+         V[0] = new MultiVector(n, nv);
+         V[0]->UseDevice(true);
+         *V[0] = 0.0;
+      }
+      for (int c = 0; c < nv; c++)
+      {
+         if (!active[c]) { continue; }
+         R.GetVector(c, r);
+         V[0]->GetVector(c, v);
+         v.Set(1.0/beta(c), r);
+         for (int k = 0; k <= m; k++) { S(k,c) = 0.0; }
+         S(0,c) = beta(c);
+      }
+
+      for (i = 0; i < m && j <= max_iter && num_active > 0; i++, j++)
+      {
+         if (prec)
+         {
+            oper->MultiMult(*V[i], R);
+            prec->MultiMult(R, W);   // W = M A V[i]
+         }
+         else
+         {
+            oper->MultiMult(*V[i], W);
+         }
+
+         for (int k = 0; k <= i; k++)
+         {
+            MultiDot(W, *V[k], active, dots);
+            for (int c = 0; c < nv; c++)
+            {
+               if (!active[c]) { continue; }
+               H(k,i,c) = dots(c);    // H(k,i) = w * v[k]
+               W.GetVector(c, w);
+               V[k]->GetVector(c, v);
+               w.Add(-H(k,i,c), v);   // w -= H(k,i) * v[k]
+            }
+         }
+
+         MultiDot(W, W, active, dots);
+         if (V[i+1] == NULL)
+         {
+            V[i+1] = new MultiVector(n, nv);
+            V[i+1]->UseDevice(true);
+            *V[i+1] = 0.0;
+         }
+         for (int c = 0; c < nv; c++)
+         {
+            if (!active[c]) { continue; }
+            DenseMatrix &Hc = H(c);
+            Hc(i+1,i) = sqrt(dots(c)); // H(i+1,i) = ||w||
+            MFEM_ASSERT(IsFinite(Hc(i+1,i)), "Norm(w) = " << Hc(i+1,i));
+            W.GetVector(c, w);
+            V[i+1]->GetVector(c, v);
+            v.Set(1.0/Hc(i+1,i), w);    // v[i+1] = w / H(i+1,i)
+
+            for (int k = 0; k < i; k++)
+            {
+               ApplyPlaneRotation(Hc(k,i), Hc(k+1,i), CS(k,c), SN(k,c));
+            }
+            GeneratePlaneRotation(Hc(i,i), Hc(i+1,i), CS(i,c), SN(i,c));
+            ApplyPlaneRotation(Hc(i,i), Hc(i+1,i), CS(i,c), SN(i,c));
+            ApplyPlaneRotation(S(i,c), S(i+1,c), CS(i,c), SN(i,c));
+
+            resid(c) = fabs(S(i+1,c));
+            MFEM_ASSERT(IsFinite(resid(c)), "resid = " << resid(c));
+            iters[c] = j;
+            if (resid(c) <= tol(c))
+            {
+               MultiUpdate(X, c, i, Hc, S, V);
+               conv[c] = 1;
+               active[c] = 0;
+               num_active--;
+            }
+         }
+
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  max ||B r|| = " << resid.Max() << '\n';
+         }
+      }
+      if (num_active == 0) { break; }
+
+      if (print_level == 1 && j <= max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      for (int c = 0; c < nv; c++)
+      {
+         if (active[c]) { MultiUpdate(X, c, i-1, H(c), S, V); }
+      }
+
+      oper->MultiMult(X, R);
+      if (prec)
+      {
+         subtract(B, R, W);
+         prec->MultiMult(W, R);    // R = M (B - A X)
+      }
+      else
+      {
+         subtract(B, R, R);
+      }
+      MultiDot(R, R, active, beta);
+      for (int c = 0; c < nv; c++)
+      {
+         if (!active[c]) { continue; }
+         beta(c) = sqrt(beta(c));
+         MFEM_ASSERT(IsFinite(beta(c)), "beta = " << beta(c));
+         resid(c) = beta(c);
+         if (beta(c) <= tol(c))
+         {
+            conv[c] = 1;
+            active[c] = 0;
+            num_active--;
+         }
+      }
+   }
+
+   converged = 1;
+   final_iter = 0;
+   for (int c = 0; c < nv; c++)
+   {
+      converged = converged && conv[c];
+      final_iter = std::max(final_iter, iters[c]);
+   }
+   final_norm = resid.Max();
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  max ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "GMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "GMRES: No convergence!\n";
+   }
+   for (i = 0; i < V.Size(); i++)
+   {
+      delete V[i];
+   }
+}
+
 void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 {
    DenseMatrix H(m+1,m);
@@ -850,6 +1837,307 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 }
 
 
+void SStepGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   // The basis block W = [w_1, ..., w_s] generated from the last basis vector
+   // v_j, with w_1 = M A v_j / sigma and w_{l+1} = M A w_l / sigma, satisfies
+   // W = V C + Y R after the orthogonalization, where V = [v_0, ..., v_j] and
+   // Y are the new basis vectors. The columns j, ..., j+s-1 of the Arnoldi
+   // matrix H are then obtained from C, R and the previous columns of H, see
+   // M. Hoemmen, "Communication-avoiding Krylov subspace methods", PhD thesis,
+   // UC Berkeley (2010).
+   MFEM_VERIFY(s >= 1 && m >= 1, "invalid parameters: s = " << s
+               << ", m = " << m);
+   const int n = width;
+
+   // H: Arnoldi matrix, Hr: H after the Givens rotations
+   DenseMatrix H(m+1, m), Hr(m+1, m);
+   Vector g(m+1), cs(m+1), sn(m+1);
+   Vector r(n), w(n);
+   Array<Vector *> v(m+1);
+   v = NULL;
+
+   // Work space of one block: the reduction buffer for C and the Gram matrix
+   // G of the block, the total projection coefficients Ctot, the factor R and
+   // its inverse, and the coefficients of a column of H
+   Vector buf, coef(m+1);
+   DenseMatrix Ctot, R, Rinv;
+
+   double beta, resid, tol;
+   double sigma = 0.0; // estimate of ||M A||, from the columns of H
+   int k;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, w);
+   }
+   else
+   {
+      x = 0.0;
+      w = b;
+   }
+   if (prec)
+   {
+      prec->Mult(w, r);  // r = M (b - A x)
+   }
+   else
+   {
+      r = w;
+   }
+   beta = Norm(r);
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+   tol = std::max(rel_tol*beta, abs_tol);
+   converged = (beta <= tol);
+   final_iter = 0;
+
+   if (!converged && (print_level == 1 || print_level == 3))
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   while (!converged && final_iter < max_iter)
+   {
+      if (v[0] == NULL) { v[0] = new Vector(n); }
+      v[0]->Set(1.0/beta, r);
+      g = 0.0; g(0) = beta;
+      H = 0.0;
+
+      // i: number of columns of H computed in this cycle
+      int i = 0;
+      bool stop = false;
+      while (!stop && i < m && final_iter < max_iter)
+      {
+         // Block size; the first block has size 1 to estimate sigma
+         int sb = (sigma == 0.0) ? 1 : std::min(s, m - i);
+         sb = std::min(sb, max_iter - final_iter);
+         const int nb = i + 1; // number of vectors in V
+         const double scale = (sigma == 0.0) ? 1.0 : sigma;
+
+         // Generate the block W in v[nb], ..., v[nb+sb-1]
+         for (int l = 0; l < sb; l++)
+         {
+            if (v[nb+l] == NULL) { v[nb+l] = new Vector(n); }
+            Vector &wl = *v[nb+l];
+            if (prec)
+            {
+               oper->Mult(*v[nb+l-1], w);
+               prec->Mult(w, wl);     // w_l = M A w_{l-1}
+            }
+            else
+            {
+               oper->Mult(*v[nb+l-1], wl);
+            }
+            wl *= 1.0/scale;
+         }
+
+         // Two passes of block classical Gram-Schmidt, one reduction each,
+         // with the Gram matrix of the projected block in the second pass
+         Ctot.SetSize(nb, sb);
+         Ctot = 0.0;
+         for (int pass = 0; pass < 2; pass++)
+         {
+            buf.SetSize(nb*sb + (pass ? sb*sb : 0));
+            DenseMatrix C(buf.GetData(), nb, sb);
+            for (int l = 0; l < sb; l++)
+            {
+               for (k = 0; k < nb; k++) { C(k,l) = *v[k] * *v[nb+l]; }
+            }
+            if (pass)
+            {
+               DenseMatrix G(buf.GetData() + nb*sb, sb, sb);
+               for (int l = 0; l < sb; l++)
+               {
+                  for (k = 0; k <= l; k++) { G(k,l) = *v[nb+k] * *v[nb+l]; }
+               }
+            }
+            StartReduce(buf.GetData(), buf.Size());
+            FinishReduce();
+            for (int l = 0; l < sb; l++)
+            {
+               for (k = 0; k < nb; k++)
+               {
+                  v[nb+l]->Add(-C(k,l), *v[k]);
+                  Ctot(k,l) += C(k,l);
+               }
+            }
+            if (!pass) { continue; }
+
+            // Cholesky factorization R^T R of the Gram matrix of the
+            // projected block, G - C^T C. The block is truncated at the first
+            // vector numerically dependent on the previous ones.
+            DenseMatrix G(buf.GetData() + nb*sb, sb, sb);
+            R.SetSize(sb);
+            R = 0.0;
+            int rank = sb;
+            for (int l = 0; l < sb && rank == sb; l++)
+            {
+               for (int t = 0; t <= l; t++)
+               {
+                  double a = G(t,l);
+                  for (k = 0; k < nb; k++) { a -= C(k,t)*C(k,l); }
+                  for (k = 0; k < t; k++) { a -= R(k,t)*R(k,l); }
+                  if (t < l)
+                  {
+                     R(t,l) = a/R(t,t);
+                  }
+                  else if (a > (l ? 1e-14*G(l,l) : 0.0))
+                  {
+                     R(l,l) = sqrt(a);
+                  }
+                  else
+                  {
+                     rank = l;
+                  }
+               }
+            }
+            sb = rank;
+         }
+
+         if (sb == 0)
+         {
+            // Breakdown: M A v_i is in the span of V
+            for (k = 0; k < nb; k++) { H(k,i) = scale*Ctot(k,0); }
+         }
+         else
+         {
+            // New basis vectors Y = (W - V C) R^{-1}
+            for (int l = 0; l < sb; l++)
+            {
+               Vector &yl = *v[nb+l];
+               for (k = 0; k < l; k++) { yl.Add(-R(k,l), *v[nb+k]); }
+               yl *= 1.0/R(l,l);
+            }
+            Rinv.SetSize(sb);
+            Rinv = 0.0;
+            for (int l = 0; l < sb; l++)
+            {
+               Rinv(l,l) = 1.0/R(l,l);
+               for (int t = l-1; t >= 0; t--)
+               {
+                  double a = 0.0;
+                  for (k = t+1; k <= l; k++) { a += R(t,k)*Rinv(k,l); }
+                  Rinv(t,l) = -a/R(t,t);
+               }
+            }
+
+            // Column i: M A v_i = scale w_1
+            for (k = 0; k < nb; k++) { H(k,i) = scale*Ctot(k,0); }
+            H(nb,i) = scale*R(0,0);
+
+            // Columns i+c, c = 1, ..., sb-1: M A y_c with
+            // y_c = sum_l (w_l - V C_l) Rinv(l,c-1), M A w_l = scale w_{l+1}
+            for (int c = 1; c < sb; c++)
+            {
+               coef.SetSize(nb + c + 1);
+               coef = 0.0;
+               for (int l = 0; l < c; l++)
+               {
+                  const double ril = Rinv(l,c-1);
+                  if (ril == 0.0) { continue; }
+                  // + scale c_{l+1}
+                  for (k = 0; k < nb; k++)
+                  {
+                     coef(k) += ril*scale*Ctot(k,l+1);
+                  }
+                  for (k = 0; k <= l+1; k++)
+                  {
+                     coef(nb+k) += ril*scale*R(k,l+1);
+                  }
+                  // - (M A V) C_l = - H(:,0:i) C_l
+                  for (int t = 0; t < nb; t++)
+                  {
+                     const double a = ril*Ctot(t,l);
+                     for (k = 0; k <= t+1; k++) { coef(k) -= a*H(k,t); }
+                  }
+               }
+               for (k = 0; k <= nb + c; k++) { H(k,i+c) = coef(k); }
+            }
+         }
+
+         // Givens rotations of the new columns
+         for (int c = 0; c < std::max(sb, 1); c++, i++)
+         {
+            final_iter++;
+            double col_norm = 0.0;
+            for (k = 0; k <= i+1; k++)
+            {
+               Hr(k,i) = H(k,i);
+               col_norm += H(k,i)*H(k,i);
+            }
+            sigma = std::max(sigma, sqrt(col_norm));
+            for (k = 0; k < i; k++)
+            {
+               ApplyPlaneRotation(Hr(k,i), Hr(k+1,i), cs(k), sn(k));
+            }
+            GeneratePlaneRotation(Hr(i,i), Hr(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(Hr(i,i), Hr(i+1,i), cs(i), sn(i));
+            ApplyPlaneRotation(g(i), g(i+1), cs(i), sn(i));
+
+            resid = fabs(g(i+1));
+            MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+            if (print_level == 1)
+            {
+               mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                         << "   Iteration : " << setw(3) << final_iter
+                         << "  ||B r|| = " << resid << '\n';
+            }
+            if (resid <= tol || sb == 0)
+            {
+               i++;
+               stop = true;
+               break;
+            }
+         }
+      }
+
+      Update(x, i-1, Hr, g, v);
+
+      // The residual of the restart, also checking the convergence
+      oper->Mult(x, r);
+      subtract(b, r, w);
+      if (prec)
+      {
+         prec->Mult(w, r);    // r = M (b - A x)
+      }
+      else
+      {
+         r = w;
+      }
+      beta = Norm(r);
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+      converged = (beta <= tol);
+      if (print_level == 1 && !converged && final_iter < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+   }
+   final_norm = beta;
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "SStepGMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "SStepGMRES: No convergence!\n";
+   }
+   for (int i = 0; i < v.Size(); i++)
+   {
+      delete v[i];
+   }
+}
+
+
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit)
 {
@@ -943,8 +2231,10 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       else
       {
          beta = (rho_1/rho_2) * (alpha/omega);
-         add(p, -omega, v, p);  //  p = p - omega * v
-         add(r, beta, p, p);    //  p = r + beta * p
+         //  p = r + beta * (p - omega * v)
+         const double a[2] = { 1.0, -beta*omega };
+         const Vector *rv[2] = { &r, &v };
+         LinearCombination(2, a, rv, beta, p);
       }
       if (prec)
       {
@@ -956,8 +2246,7 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       }
       oper->Mult(phat, v);     //  v = A * phat
       alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
+      resid = sqrt(AddAndDot(r, -alpha, v, s, s)); //  s = r - alpha * v
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (resid < tol_goal)
       {
@@ -982,13 +2271,18 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
          shat = s;
       }
       oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
-      x.Add(alpha, phat);   //  x += alpha * phat
-      x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
+      double dots[2];
+      const Vector *st[2] = { &s, &t };
+      Dots(t, 2, st, dots);
+      omega = dots[0] / dots[1];
+      //  x += alpha * phat + omega * shat
+      const double a[2] = { alpha, omega };
+      const Vector *ps[2] = { &phat, &shat };
+      LinearCombination(2, a, ps, 1.0, x);
+      //  r = s - omega * t
+      resid = sqrt(AddAndDot(s, -omega, t, r, r));
 
       rho_2 = rho_1;
-      resid = Norm(r);
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (print_level >= 0)
       {
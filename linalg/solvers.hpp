@@ -35,6 +35,7 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable MPI_Request reduce_request;
 #endif
 
 protected:
@@ -51,6 +52,32 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Start the global sum of the @a n local values in @a buf, e.g.
+       several local inner products x * y, in a single reduction. */
+   /** With MPI-3, the reduction is non-blocking and can be overlapped with
+       the application of the operator and the preconditioner. The sums are
+       available in @a buf after FinishReduce(). */
+   void StartReduce(double *buf, int n) const;
+
+   /// Complete the reduction started with StartReduce().
+   void FinishReduce() const;
+
+   /** @brief Compute the inner products of the vectors of @a X and @a Y with
+       nonzero @a active flags in a single reduction; the other entries of
+       @a dots are set to zero. */
+   void MultiDot(const MultiVector &X, const MultiVector &Y,
+                 const Array<int> &active, Vector &dots) const;
+
+   /** @brief Set v = v1 + alpha v2 and return the inner product (v, w), with
+       the fused kernel mfem::AddAndDot(). */
+   double AddAndDot(const Vector &v1, double alpha, const Vector &v2,
+                    Vector &v, const Vector &w) const;
+
+   /** @brief Compute the inner products of @a x with the @a k vectors @a y in
+       one sweep and a single reduction, see mfem::InnerProducts(). */
+   void Dots(const Vector &x, int k, const Vector *const *y,
+             double *dots) const;
+
 public:
    IterativeSolver();
 
@@ -75,6 +102,95 @@ public:
 };
 
 
+/// Jacobi smoothing for a given Operator and its diagonal.
+/** The diagonal can be computed without assembling the Operator, e.g. with
+    BilinearForm::AssembleDiagonal() for AssemblyLevel::PARTIAL. The essential
+    (constrained) true dofs are treated as identity rows. */
+class OperatorJacobiSmoother : public Solver
+{
+public:
+   /** @brief Setup a Jacobi smoother for the Operator @a a with diagonal @a d.
+       The Operator @a a is used only when the smoother is in iterative mode. */
+   OperatorJacobiSmoother(const Operator &a, const Vector &d,
+                          const Array<int> &ess_tdof_list,
+                          const double damping = 1.0);
+
+   /** @brief Setup a Jacobi smoother for the Operator @a a, computing its
+       diagonal with Operator::AssembleDiagonal(). */
+   OperatorJacobiSmoother(const Operator &a, const Array<int> &ess_tdof_list,
+                          const double damping = 1.0);
+
+   /// Apply the smoother: y = y + damping D^{-1} (x - A y).
+   /** When not in iterative mode, y is assumed to be zero on input. */
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void SetOperator(const Operator &op) { oper = &op; }
+
+private:
+   void Setup(const Vector &diag, const Array<int> &ess_tdof_list);
+
+   const Operator *oper; // Not owned
+   const double damping;
+   Vector dinv;
+   mutable Vector residual;
+};
+
+/// Chebyshev accelerated smoothing for a given Operator and its diagonal.
+/** Applies a polynomial of degree @a order in D^{-1} A, chosen to damp the
+    eigenvalues of D^{-1} A in the interval [0.3 lmax, 1.2 lmax], where lmax is
+    an estimate of the largest eigenvalue of D^{-1} A. Every application of the
+    smoother performs @a order actions of the Operator. The essential
+    (constrained) true dofs are treated as identity rows. */
+class OperatorChebyshevSmoother : public Solver
+{
+public:
+   /** @brief Setup a Chebyshev smoother estimating the largest eigenvalue of
+       D^{-1} A with @a power_iterations steps of the power method. */
+   /** With @a power_iterations = 0, no estimate is computed, and it must be
+       given with SetMaxEigenvalueEstimate() before the smoother is applied. */
+   OperatorChebyshevSmoother(const Operator &a, const Vector &d,
+                             const Array<int> &ess_tdof_list, int order,
+                             int power_iterations = 10);
+
+#ifdef MFEM_USE_MPI
+   /** @brief Parallel version of the constructor estimating the largest
+       eigenvalue, using global inner products over @a comm. */
+   OperatorChebyshevSmoother(MPI_Comm comm, const Operator &a,
+                             const Vector &d,
+                             const Array<int> &ess_tdof_list, int order,
+                             int power_iterations = 10);
+#endif
+
+   /// Return the (unscaled) estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalueEstimate() const { return max_eig; }
+
+   /// Set the estimate of the largest eigenvalue of D^{-1} A, e.g. one known
+   /// from a previous setup, replacing the power method estimate.
+   void SetMaxEigenvalueEstimate(double max_eig_estimate)
+   { max_eig = max_eig_estimate; }
+
+   /// Apply the smoother. When not in iterative mode, y is assumed to be zero.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual void SetOperator(const Operator &op) { oper = &op; }
+
+private:
+   void Setup(const Vector &diag, const Array<int> &ess_tdof_list);
+   double EstimateMaxEigenvalue(int power_iterations) const;
+   double Dot(const Vector &x, const Vector &y) const;
+
+   const Operator *oper; // Not owned
+   const int order;
+   double max_eig;
+   Vector dinv;
+   mutable Vector r, d, z;
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm;
+   bool parallel;
+#endif
+};
+
+
 /// Stationary linear iteration: x <- x + B (b - A x)
 class SLISolver : public IterativeSolver
 {
@@ -107,11 +223,51 @@ void SLI(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/// Mixed precision iterative refinement: x <- x + S (b - A x)
+/** The residual b - A x is computed in double precision with the Operator A
+    given to SetOperator(), and the correction is computed by an inner Solver
+    S, given to SetInnerSolver(), for a cheaper approximation of A. Typically,
+    S is a CGSolver or GMRESSolver with a loose relative tolerance, e.g. 1e-3,
+    for a SinglePrecisionCSRMatrix copy of A, or for a BilinearForm whose
+    integrators store their partially assembled data in single precision, see
+    DiffusionIntegrator::SetSinglePrecisionPA(). Most of the memory traffic is
+    then in the inner solver, while the final accuracy is that of the double
+    precision residual.
+
+    The iteration stops when ||b - A x|| <= max(rel_tol ||b - A x_0||, abs_tol)
+    or after max_iter corrections. */
+class IterativeRefinementSolver : public IterativeSolver
+{
+protected:
+   Solver *inner;
+   mutable Vector r, z;
+
+   void UpdateVectors();
+
+public:
+   IterativeRefinementSolver() : inner(NULL) { }
+
+#ifdef MFEM_USE_MPI
+   IterativeRefinementSolver(MPI_Comm _comm)
+      : IterativeSolver(_comm), inner(NULL) { }
+#endif
+
+   /** @brief Set the inner solver computing the corrections. Its Operator is
+       not changed and its iterative_mode is set to false. */
+   void SetInnerSolver(Solver &s) { inner = &s; }
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// Conjugate gradient method
 class CGSolver : public IterativeSolver
 {
 protected:
    mutable Vector r, d, z;
+   mutable MultiVector R, D, Z;
 
    void UpdateVectors();
 
@@ -126,6 +282,16 @@ public:
    { IterativeSolver::SetOperator(op); UpdateVectors(); }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve the systems with the right-hand sides in @a B by running
+       the CG iterations of all the vectors together. */
+   /** Each vector follows the same iterations as with Mult(), but the operator
+       and the preconditioner are applied to the whole block with MultiMult(),
+       and the inner products of an iteration are summed in one reduction. The
+       vectors that converge are left unchanged while the others continue;
+       GetNumIterations() returns the maximum over the vectors and
+       GetConverged() is true only if all the vectors converged. */
+   virtual void MultiMult(const MultiVector &B, MultiVector &X) const;
 };
 
 /// Conjugate gradient method. (tolerances are squared)
@@ -139,6 +305,58 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/** @brief Conjugate gradient method with a single global reduction per
+    iteration (Chronopoulos and Gear). */
+/** The two inner products of each iteration, (B r, r) and (A B r, B r), are
+    computed together, at the cost of one additional vector update. The
+    iterates are the same as with CGSolver in exact arithmetic. */
+class SingleReductionCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, p, s;
+
+   void UpdateVectors();
+
+public:
+   SingleReductionCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   SingleReductionCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/// Pipelined conjugate gradient method (Ghysels and Vanroose).
+/** As in SingleReductionCGSolver, the inner products of each iteration are
+    combined in a single reduction, which is in addition overlapped with the
+    application of the preconditioner and of the operator. This requires
+    several additional vectors and vector updates, and can reduce the
+    attainable accuracy compared to CGSolver. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, z, q, s, p;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
@@ -156,6 +374,11 @@ public:
    void SetKDim(int dim) { m = dim; }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve the systems with the right-hand sides in @a B by running
+       the GMRES iterations of all the vectors together, see
+       CGSolver::MultiMult(). */
+   virtual void MultiMult(const MultiVector &B, MultiVector &X) const;
 };
 
 /// FGMRES method
@@ -176,6 +399,38 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/// Communication-avoiding s-step GMRES method.
+/** The Krylov basis is extended by blocks of @a s vectors, generated by @a s
+    consecutive applications of the operator and the preconditioner, and then
+    orthogonalized together with two passes of block classical Gram-Schmidt
+    followed by a Cholesky QR factorization. Each block needs two global
+    reductions, instead of the i+2 reductions of the i-th iteration of
+    GMRESSolver. Like GMRESSolver, the method is left preconditioned and the
+    preconditioned residual norm is minimized. The block size should be small,
+    e.g. 2 to 8, since the conditioning of the monomial basis of each block
+    degrades with @a s; a numerically dependent block is truncated. */
+class SStepGMRESSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+   int s; // see SetSStep()
+
+public:
+   SStepGMRESSolver() { m = 50; s = 4; }
+
+#ifdef MFEM_USE_MPI
+   SStepGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; s = 4; }
+#endif
+
+   /// Set the number of iteration to perform between restarts, default is 50.
+   void SetKDim(int dim) { m = dim; }
+
+   /// Set the number of basis vectors generated per block, default is 4.
+   void SetSStep(int step) { s = step; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// GMRES method. (tolerances are squared)
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit);
@@ -12,6 +12,8 @@
 // Implementation of sparse matrix
 
 #include "linalg.hpp"
+#include "spmv.hpp"
+#include "simd.hpp"
 #include "../general/forall.hpp"
 #include "../general/table.hpp"
 #include "../general/sort_pairs.hpp"
@@ -35,6 +37,7 @@ SparseMatrix::SparseMatrix(int nrows, int ncols)
      ColPtrJ(NULL),
      ColPtrNode(NULL),
      At(NULL),
+     spmv(NULL),
      isSorted(false)
 {
    // We probably do not need to set the ownership flags here.
@@ -58,6 +61,7 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n)
      ColPtrJ(NULL),
      ColPtrNode(NULL),
      At(NULL),
+     spmv(NULL),
      isSorted(false)
 {
    I.Wrap(i, height+1, true);
@@ -76,6 +80,7 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n,
      ColPtrJ(NULL),
      ColPtrNode(NULL),
      At(NULL),
+     spmv(NULL),
      isSorted(issorted)
 {
    I.Wrap(i, height+1, ownij);
@@ -103,6 +108,7 @@ SparseMatrix::SparseMatrix(int nrows, int ncols, int rowsize)
    , ColPtrJ(NULL)
    , ColPtrNode(NULL)
    , At(NULL)
+   , spmv(NULL)
    , isSorted(false)
 {
 #ifdef MFEM_USE_MEMALLOC
@@ -180,6 +186,7 @@ SparseMatrix::SparseMatrix(const SparseMatrix &mat, bool copy_graph)
    ColPtrJ = NULL;
    ColPtrNode = NULL;
    At = NULL;
+   spmv = NULL;
    isSorted = mat.isSorted;
 }
 
@@ -189,6 +196,7 @@ SparseMatrix::SparseMatrix(const Vector &v)
    , ColPtrJ(NULL)
    , ColPtrNode(NULL)
    , At(NULL)
+   , spmv(NULL)
    , isSorted(true)
 {
 #ifdef MFEM_USE_MEMALLOC
@@ -243,6 +251,7 @@ void SparseMatrix::SetEmpty()
    ColPtrJ = NULL;
    ColPtrNode = NULL;
    At = NULL;
+   spmv = NULL;
 #ifdef MFEM_USE_MEMALLOC
    NodesMem = NULL;
 #endif
@@ -576,6 +585,12 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
       return;
    }
 
+   if (spmv && !Device::Allows(Backend::DEVICE_MASK))
+   {
+      spmv->AddMult(x, y, a);
+      return;
+   }
+
 #ifndef MFEM_USE_LEGACY_OPENMP
    const int height = this->height;
    const int nnz = J.Capacity();
@@ -613,6 +628,52 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 #endif
 }
 
+void SparseMatrix::MultiMult(const MultiVector &X, MultiVector &Y) const
+{
+   MFEM_VERIFY(X.VSize() == width && Y.VSize() == height &&
+               X.NumVectors() == Y.NumVectors(),
+               "incompatible MultiVectors: X is " << X.VSize() << " x "
+               << X.NumVectors() << ", Y is " << Y.VSize() << " x "
+               << Y.NumVectors());
+   if (!Finalized())
+   {
+      Operator::MultiMult(X, Y);
+      return;
+   }
+
+   // Number of vectors processed with each pass over the matrix.
+   const int max_nv = 8;
+   const int height = this->height;
+   const int width = this->width;
+   const int nv = X.NumVectors();
+   const int nnz = J.Capacity();
+   auto d_I = Read(I, height+1);
+   auto d_J = Read(J, nnz);
+   auto d_A = Read(A, nnz);
+   auto d_X = X.Read();
+   Y.UseDevice(true);
+   auto d_Y = Y.Write();
+   for (int v0 = 0; v0 < nv; v0 += max_nv)
+   {
+      const int nvb = std::min(max_nv, nv - v0);
+      const double *d_x = d_X + v0*width;
+      double *d_y = d_Y + v0*height;
+      MFEM_FORALL(i, height,
+      {
+         double d[max_nv];
+         for (int v = 0; v < nvb; v++) { d[v] = 0.0; }
+         const int end = d_I[i+1];
+         for (int j = d_I[i]; j < end; j++)
+         {
+            const double a = d_A[j];
+            const int col = d_J[j];
+            for (int v = 0; v < nvb; v++) { d[v] += a * d_x[col + v*width]; }
+         }
+         for (int v = 0; v < nvb; v++) { d_y[i + v*height] = d[v]; }
+      });
+   }
+}
+
 void SparseMatrix::MultTranspose(const Vector &x, Vector &y) const
 {
    if (Finalized()) { y.UseDevice(true); }
@@ -648,6 +709,10 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
    {
       At->AddMult(x, y, a);
    }
+   else if (spmv && !Device::Allows(Backend::DEVICE_MASK))
+   {
+      spmv->AddMultTranspose(x, y, a);
+   }
    else
    {
       MFEM_VERIFY(Device::IsDisabled(), "transpose action on device is not "
@@ -679,6 +744,35 @@ void SparseMatrix::ResetTranspose() const
    At = NULL;
 }
 
+void SparseMatrix::BuildSellCSigma(int C, int sigma) const
+{
+   if (C == 0) { C = SIMD_DOUBLES; }
+   if (sigma == 0) { sigma = 32*C; }
+   SpMVFormat *sell = new SellCSigmaMatrix(*this, C, sigma);
+   delete spmv;
+   spmv = sell;
+}
+
+void SparseMatrix::BuildBlockCSR(int vdim, bool interleaved) const
+{
+   SpMVFormat *bsr = new BlockCSRMatrix(*this, vdim, interleaved);
+   delete spmv;
+   spmv = bsr;
+}
+
+void SparseMatrix::BuildSinglePrecision() const
+{
+   SpMVFormat *sp = new SinglePrecisionCSRMatrix(*this);
+   delete spmv;
+   spmv = sp;
+}
+
+void SparseMatrix::ResetSpMVFormat() const
+{
+   delete spmv;
+   spmv = NULL;
+}
+
 void SparseMatrix::PartMult(
    const Array<int> &rows, const Vector &x, Vector &y) const
 {
@@ -2901,6 +2995,7 @@ void SparseMatrix::Destroy()
    delete NodesMem;
 #endif
    delete At;
+   delete spmv;
 }
 
 int SparseMatrix::ActualWidth() const
@@ -3078,12 +3173,10 @@ SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
 {
    int nrowsA, ncolsA, nrowsB, ncolsB;
    const int *A_i, *A_j, *B_i, *B_j;
-   int *C_i, *C_j, *B_marker;
+   int *C_i, *C_j;
    const double *A_data, *B_data;
    double *C_data;
-   int ia, ib, ic, ja, jb, num_nonzeros;
-   int row_start, counter;
-   double a_entry, b_entry;
+   int num_bad_rows;
    SparseMatrix *C;
 
    nrowsA = A.Height();
@@ -3102,45 +3195,61 @@ SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
    B_j    = B.GetJ();
    B_data = B.GetData();
 
-   B_marker = new int[ncolsB];
-
-   for (ib = 0; ib < ncolsB; ib++)
-   {
-      B_marker[ib] = -1;
-   }
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+#endif
 
+   // The rows of C are computed independently, with one marker array per
+   // thread. Since each thread processes its rows in increasing order, the
+   // markers left by its previous rows are smaller than the current row_start.
    if (OAB == NULL)
    {
       C_i = new int[nrowsA+1];
 
-      C_i[0] = num_nonzeros = 0;
-      for (ic = 0; ic < nrowsA; ic++)
+      // Symbolic pass: count the entries in each row of C
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel if (threaded)
+#endif
       {
-         for (ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+         int *B_marker = new int[ncolsB];
+         for (int ib = 0; ib < ncolsB; ib++)
          {
-            ja = A_j[ia];
-            for (ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+            B_marker[ib] = -1;
+         }
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(static)
+#endif
+         for (int ic = 0; ic < nrowsA; ic++)
+         {
+            int num_nonzeros = 0;
+            for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
             {
-               jb = B_j[ib];
-               if (B_marker[jb] != ic)
+               const int ja = A_j[ia];
+               for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
                {
-                  B_marker[jb] = ic;
-                  num_nonzeros++;
+                  const int jb = B_j[ib];
+                  if (B_marker[jb] != ic)
+                  {
+                     B_marker[jb] = ic;
+                     num_nonzeros++;
+                  }
                }
             }
+            C_i[ic+1] = num_nonzeros;
          }
-         C_i[ic+1] = num_nonzeros;
+         delete [] B_marker;
       }
 
-      C_j    = new int[num_nonzeros];
-      C_data = new double[num_nonzeros];
-
-      C = new SparseMatrix(C_i, C_j, C_data, nrowsA, ncolsB);
-
-      for (ib = 0; ib < ncolsB; ib++)
+      C_i[0] = 0;
+      for (int ic = 0; ic < nrowsA; ic++)
       {
-         B_marker[ib] = -1;
+         C_i[ic+1] += C_i[ic];
       }
+
+      C_j    = new int[C_i[nrowsA]];
+      C_data = new double[C_i[nrowsA]];
+
+      C = new SparseMatrix(C_i, C_j, C_data, nrowsA, ncolsB);
    }
    else
    {
@@ -3153,50 +3262,63 @@ SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
                   << " ncolsB = " << ncolsB
                   << ", C->Width() = " << C->Width());
 
-      // C_i    = C -> GetI(); // not used
+      C_i    = C -> GetI();
       C_j    = C -> GetJ();
       C_data = C -> GetData();
    }
 
-   counter = 0;
-   for (ic = 0; ic < nrowsA; ic++)
+   // Numeric pass, also filling C_j when C is new
+   num_bad_rows = 0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (threaded)
+#endif
    {
-      // row_start = C_i[ic];
-      row_start = counter;
-      for (ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+      int *B_marker = new int[ncolsB];
+      for (int ib = 0; ib < ncolsB; ib++)
+      {
+         B_marker[ib] = -1;
+      }
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(static) reduction(+:num_bad_rows)
+#endif
+      for (int ic = 0; ic < nrowsA; ic++)
       {
-         ja = A_j[ia];
-         a_entry = A_data[ia];
-         for (ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+         const int row_start = C_i[ic];
+         int counter = row_start;
+         for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
          {
-            jb = B_j[ib];
-            b_entry = B_data[ib];
-            if (B_marker[jb] < row_start)
+            const int ja = A_j[ia];
+            const double a_entry = A_data[ia];
+            for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
             {
-               B_marker[jb] = counter;
-               if (OAB == NULL)
+               const int jb = B_j[ib];
+               const double b_entry = B_data[ib];
+               if (B_marker[jb] < row_start)
                {
-                  C_j[counter] = jb;
+                  B_marker[jb] = counter;
+                  if (OAB == NULL)
+                  {
+                     C_j[counter] = jb;
+                  }
+                  C_data[counter] = a_entry*b_entry;
+                  counter++;
+               }
+               else
+               {
+                  C_data[B_marker[jb]] += a_entry*b_entry;
                }
-               C_data[counter] = a_entry*b_entry;
-               counter++;
-            }
-            else
-            {
-               C_data[B_marker[jb]] += a_entry*b_entry;
             }
          }
+         if (counter != C_i[ic+1]) { num_bad_rows++; }
       }
+      delete [] B_marker;
    }
 
    MFEM_VERIFY(
-      OAB == NULL || counter == OAB->NumNonZeroElems(),
-      "With pre-allocated output matrix, number of non-zeros ("
-      << OAB->NumNonZeroElems()
-      << ") did not match number of entries changed from matrix-matrix multiply, "
-      << counter);
-
-   delete [] B_marker;
+      num_bad_rows == 0,
+      "With pre-allocated output matrix, the number of non-zeros in "
+      << num_bad_rows << " rows did not match the number of entries changed "
+      "from matrix-matrix multiply");
 
    return C;
 }
@@ -3356,12 +3478,212 @@ SparseMatrix *RAP (const SparseMatrix &A, const SparseMatrix &R,
 SparseMatrix *RAP(const SparseMatrix &Rt, const SparseMatrix &A,
                   const SparseMatrix &P)
 {
-   SparseMatrix * R = Transpose(Rt);
-   SparseMatrix * RA = Mult(*R,A);
-   delete R;
-   SparseMatrix * out = Mult(*RA, P);
-   delete RA;
-   return out;
+   SparseRAP rap(Rt, P);
+   return rap.Mult(A);
+}
+
+SparseRAP::SparseRAP(const SparseMatrix &Rt, const SparseMatrix &P)
+   : R(Transpose(Rt)), P(P)
+{
+   MFEM_VERIFY(P.Finalized(), "P must be finalized");
+}
+
+void SparseRAP::CheckSizes(const SparseMatrix &A) const
+{
+   MFEM_VERIFY(A.Finalized(), "A must be finalized");
+   MFEM_VERIFY(R->Width() == A.Height() && A.Width() == P.Height(),
+               "incompatible sizes: R is " << R->Height() << " x "
+               << R->Width() << ", A is " << A.Height() << " x " << A.Width()
+               << ", P is " << P.Height() << " x " << P.Width());
+}
+
+SparseMatrix *SparseRAP::Symbolic(const SparseMatrix &A) const
+{
+   CheckSizes(A);
+
+   const int nrows = R->Height(), nmid = A.Width(), ncols = P.Width();
+   const int *R_i = R->GetI(), *R_j = R->GetJ();
+   const int *A_i = A.GetI(), *A_j = A.GetJ();
+   const int *P_i = P.GetI(), *P_j = P.GetJ();
+
+   int *C_i = new int[nrows+1];
+   int *C_j = NULL;
+
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+#endif
+
+   // Two passes over the rows: count the entries, then fill C_j
+   for (int pass = 0; pass < 2; pass++)
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel if (threaded)
+#endif
+      {
+         int *A_marker = new int[nmid], *A_cols = new int[nmid];
+         int *P_marker = new int[ncols];
+         for (int l = 0; l < nmid; l++) { A_marker[l] = -1; }
+         for (int j = 0; j < ncols; j++) { P_marker[j] = -1; }
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(static)
+#endif
+         for (int i = 0; i < nrows; i++)
+         {
+            // Columns of the row i of R A
+            int num_A_cols = 0;
+            for (int rk = R_i[i]; rk < R_i[i+1]; rk++)
+            {
+               const int k = R_j[rk];
+               for (int al = A_i[k]; al < A_i[k+1]; al++)
+               {
+                  const int l = A_j[al];
+                  if (A_marker[l] != i)
+                  {
+                     A_marker[l] = i;
+                     A_cols[num_A_cols++] = l;
+                  }
+               }
+            }
+            // Columns of the row i of (R A) P
+            int counter = (pass == 0) ? 0 : C_i[i];
+            for (int t = 0; t < num_A_cols; t++)
+            {
+               const int l = A_cols[t];
+               for (int pj = P_i[l]; pj < P_i[l+1]; pj++)
+               {
+                  const int j = P_j[pj];
+                  if (P_marker[j] != i)
+                  {
+                     P_marker[j] = i;
+                     if (pass == 1) { C_j[counter] = j; }
+                     counter++;
+                  }
+               }
+            }
+            if (pass == 0)
+            {
+               C_i[i+1] = counter;
+            }
+            else
+            {
+               std::sort(C_j + C_i[i], C_j + counter);
+            }
+         }
+         delete [] P_marker;
+         delete [] A_cols;
+         delete [] A_marker;
+      }
+
+      if (pass == 0)
+      {
+         C_i[0] = 0;
+         for (int i = 0; i < nrows; i++) { C_i[i+1] += C_i[i]; }
+         C_j = new int[C_i[nrows]];
+      }
+   }
+
+   double *C_data = new double[C_i[nrows]];
+   for (int p = 0; p < C_i[nrows]; p++) { C_data[p] = 0.0; }
+
+   return new SparseMatrix(C_i, C_j, C_data, nrows, ncols);
+}
+
+void SparseRAP::Numeric(const SparseMatrix &A, SparseMatrix &C) const
+{
+   CheckSizes(A);
+   MFEM_VERIFY(C.Finalized() && C.Height() == R->Height() &&
+               C.Width() == P.Width(), "invalid matrix C");
+
+   const int nrows = R->Height(), nmid = A.Width(), ncols = P.Width();
+   const int *R_i = R->GetI(), *R_j = R->GetJ();
+   const int *A_i = A.GetI(), *A_j = A.GetJ();
+   const int *P_i = P.GetI(), *P_j = P.GetJ();
+   const int *C_i = C.GetI(), *C_j = C.GetJ();
+   const double *R_data = R->GetData(), *A_data = A.GetData();
+   const double *P_data = P.GetData();
+   double *C_data = C.GetData();
+   int num_missing = 0;
+
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel if (threaded)
+#endif
+   {
+      // Sparse accumulator of the row of R A, and the position in C_data of
+      // the columns of the current row of C
+      int *A_marker = new int[nmid], *A_cols = new int[nmid];
+      double *RA_row = new double[nmid];
+      int *C_pos = new int[ncols];
+      for (int l = 0; l < nmid; l++) { A_marker[l] = -1; }
+      for (int j = 0; j < ncols; j++) { C_pos[j] = -1; }
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(static) reduction(+:num_missing)
+#endif
+      for (int i = 0; i < nrows; i++)
+      {
+         int num_A_cols = 0;
+         for (int rk = R_i[i]; rk < R_i[i+1]; rk++)
+         {
+            const int k = R_j[rk];
+            const double r_entry = R_data[rk];
+            for (int al = A_i[k]; al < A_i[k+1]; al++)
+            {
+               const int l = A_j[al];
+               if (A_marker[l] != i)
+               {
+                  A_marker[l] = i;
+                  A_cols[num_A_cols++] = l;
+                  RA_row[l] = r_entry*A_data[al];
+               }
+               else
+               {
+                  RA_row[l] += r_entry*A_data[al];
+               }
+            }
+         }
+
+         for (int p = C_i[i]; p < C_i[i+1]; p++)
+         {
+            C_pos[C_j[p]] = p;
+            C_data[p] = 0.0;
+         }
+         for (int t = 0; t < num_A_cols; t++)
+         {
+            const int l = A_cols[t];
+            const double ra_entry = RA_row[l];
+            for (int pj = P_i[l]; pj < P_i[l+1]; pj++)
+            {
+               const int p = C_pos[P_j[pj]];
+               if (p >= 0)
+               {
+                  C_data[p] += ra_entry*P_data[pj];
+               }
+               else
+               {
+                  num_missing++;
+               }
+            }
+         }
+         for (int p = C_i[i]; p < C_i[i+1]; p++)
+         {
+            C_pos[C_j[p]] = -1;
+         }
+      }
+      delete [] C_pos;
+      delete [] RA_row;
+      delete [] A_cols;
+      delete [] A_marker;
+   }
+
+   MFEM_VERIFY(num_missing == 0, "the sparsity pattern of C does not contain "
+               "the pattern of R A P");
+}
+
+SparseMatrix *SparseRAP::Mult(const SparseMatrix &A) const
+{
+   SparseMatrix *C = Symbolic(A);
+   Numeric(A, *C);
+   return C;
 }
 
 SparseMatrix *Mult_AtDA (const SparseMatrix &A, const Vector &D,
@@ -3628,6 +3950,7 @@ void SparseMatrix::Swap(SparseMatrix &other)
    mfem::Swap(ColPtrJ, other.ColPtrJ);
    mfem::Swap(ColPtrNode, other.ColPtrNode);
    mfem::Swap(At, other.At);
+   mfem::Swap(spmv, other.spmv);
 
 #ifdef MFEM_USE_MEMALLOC
    mfem::Swap(NodesMem, other.NodesMem);
@@ -24,6 +24,8 @@
 namespace mfem
 {
 
+class SpMVFormat;
+
 class
 #if defined(__alignas_is_defined)
    alignas(double)
@@ -69,6 +71,11 @@ protected:
    /// Transpose of A. Owned. Used to perform MultTranspose() on devices.
    mutable SparseMatrix *At;
 
+   /** @brief Copy of this matrix in another storage format. Owned. Used to
+       perform the (transpose) action on the host, see BuildSellCSigma() and
+       BuildBlockCSR(). */
+   mutable SpMVFormat *spmv;
+
 #ifdef MFEM_USE_MEMALLOC
    typedef MemAlloc <RowNode, 1024> RowNodeAlloc;
    RowNodeAlloc * NodesMem;
@@ -252,6 +259,9 @@ public:
    /// Returns the Diagonal of A
    void GetDiag(Vector & d) const;
 
+   /// Same as GetDiag(), overriding Operator::AssembleDiagonal().
+   virtual void AssembleDiagonal(Vector &diag) const { GetDiag(diag); }
+
    /// Produces a DenseMatrix from a SparseMatrix
    DenseMatrix *ToDenseMatrix() const;
 
@@ -267,6 +277,10 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** @brief Matrix multiplication with a block of vectors, Y = A * X, reading
+       the matrix once for every 8 vectors of the block. */
+   virtual void MultiMult(const MultiVector &X, MultiVector &Y) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
@@ -299,6 +313,58 @@ public:
        more details. */
    void ResetTranspose() const;
 
+   /** @brief Build and store internally a copy of this matrix in the sliced
+       ELLPACK format SELL-C-sigma (SellCSigmaMatrix), which will be used in the
+       methods Mult(), AddMult(), MultTranspose() and AddMultTranspose() on the
+       host. */
+   /** The slices have @a C rows, 1, 2, 4, 8 or 16, by default the number of
+       doubles in a SIMD register, SIMD_DOUBLES. The rows are sorted by length
+       within windows of @a sigma rows, by default 32 * C. The format is suited
+       to SIMD execution on matrices with irregular row lengths.
+
+       Warning: any changes in this matrix will invalidate the internal copy. To
+       rebuild it, call this method again; to remove it, call
+       ResetSpMVFormat(). The copy is not used when a device backend, e.g.
+       CUDA, is enabled, and the transpose action with the copy is not
+       threaded.
+
+       This method can only be used when the sparse matrix is finalized. */
+   void BuildSellCSigma(int C = 0, int sigma = 0) const;
+
+   /** @brief Build and store internally a copy of this matrix in the block CSR
+       format (BlockCSRMatrix) with dense @a vdim x @a vdim blocks, which will
+       be used in the methods Mult(), AddMult(), MultTranspose() and
+       AddMultTranspose() on the host. */
+   /** This format is suited to the matrices of vector finite element spaces
+       with @a vdim components, whose entries couple all the components of two
+       nodes. If @a interleaved is true, the components of a node are
+       consecutive (Ordering::byVDIM), otherwise each component is stored in a
+       contiguous section (Ordering::byNODES).
+
+       See BuildSellCSigma() for the invalidation of the internal copy. */
+   void BuildBlockCSR(int vdim, bool interleaved = true) const;
+
+   /** @brief Build and store internally a copy of this matrix with single
+       precision values (SinglePrecisionCSRMatrix), which will be used in the
+       methods Mult(), AddMult(), MultTranspose() and AddMultTranspose() on the
+       host. */
+   /** This reduces the memory traffic of the products with matrices used in
+       preconditioners and smoothers, whose accuracy is not affected by the
+       perturbation of the entries. To use the single precision copy of a
+       matrix that is also needed in double precision, e.g. as the inner
+       operator of IterativeRefinementSolver, construct a
+       SinglePrecisionCSRMatrix directly.
+
+       See BuildSellCSigma() for the invalidation of the internal copy. */
+   void BuildSinglePrecision() const;
+
+   /** Reset (destroy) the internal copy of this matrix built with
+       BuildSellCSigma(), BuildBlockCSR() or BuildSinglePrecision(). */
+   void ResetSpMVFormat() const;
+
+   /// Return the internal copy of this matrix used for SpMV, or NULL.
+   const SpMVFormat *GetSpMVFormat() const { return spmv; }
+
    void PartMult(const Array<int> &rows, const Vector &x, Vector &y) const;
    void PartAddMult(const Array<int> &rows, const Vector &x, Vector &y,
                     const double a=1.0) const;
@@ -613,6 +679,44 @@ SparseMatrix *RAP(const SparseMatrix &A, const SparseMatrix &R,
 SparseMatrix *RAP(const SparseMatrix &Rt, const SparseMatrix &A,
                   const SparseMatrix &P);
 
+/** @brief Fused sparse triple product C = R A P, with R = Rt^T, split into a
+    symbolic and a numeric phase. */
+/** The rows of C are computed independently, threaded with the OpenMP backend,
+    without forming R A or A P: the row of R A is accumulated in a per-thread
+    work array and immediately multiplied by P. The sparsity pattern of C can
+    be computed once with Symbolic() and reused by Numeric() when only the
+    values of A change, e.g. in every iteration of a nonlinear solver.
+
+    All matrices must be finalized. The matrix P must not be destroyed before
+    this object; the values of R are copied from Rt at construction. */
+class SparseRAP
+{
+protected:
+   SparseMatrix *R; // owned
+   const SparseMatrix &P;
+
+   void CheckSizes(const SparseMatrix &A) const;
+
+public:
+   /// Prepare the products R A P with R = Rt^T.
+   SparseRAP(const SparseMatrix &Rt, const SparseMatrix &P);
+
+   /** @brief Return a new matrix with the sparsity pattern of R A P, with
+       sorted column indices and zero values. */
+   SparseMatrix *Symbolic(const SparseMatrix &A) const;
+
+   /** @brief Compute the values of R A P in @a C, whose sparsity pattern must
+       contain the pattern of the product, e.g. from Symbolic(). */
+   /** The entries of @a C outside of the pattern of the product are set to
+       zero. */
+   void Numeric(const SparseMatrix &A, SparseMatrix &C) const;
+
+   /// Return a new matrix C = R A P.
+   SparseMatrix *Mult(const SparseMatrix &A) const;
+
+   ~SparseRAP() { delete R; }
+};
+
 /// Matrix multiplication A^t D A. All matrices must be finalized.
 SparseMatrix *Mult_AtDA(const SparseMatrix &A, const Vector &D,
                         SparseMatrix *OAtDA = NULL);
@@ -15,6 +15,9 @@
 #include "matrix.hpp"
 #include "sparsemat.hpp"
 #include "sparsesmoothers.hpp"
+#include "densemat.hpp"
+#include "../general/device.hpp"
+#include <algorithm>
 #include <iostream>
 
 namespace mfem
@@ -108,4 +111,390 @@ void DSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+
+// Levels with fewer rows than this are solved by a single thread, since the
+// cost of starting the threads would dominate.
+static const int ilu_min_threaded_rows = 256;
+
+void TriangularLevels::Setup(int n, const int *I, const int *J,
+                             const int *diag, bool lower)
+{
+   Array<int> level(n);
+   int num_levels = 0;
+   for (int r = 0; r < n; r++)
+   {
+      const int i = lower ? r : n-1-r;
+      const int begin = lower ? I[i] : diag[i]+1;
+      const int end = lower ? diag[i] : I[i+1];
+      int l = 0;
+      for (int p = begin; p < end; p++)
+      {
+         l = std::max(l, level[J[p]] + 1);
+      }
+      level[i] = l;
+      num_levels = std::max(num_levels, l + 1);
+   }
+
+   level_ptr.SetSize(num_levels + 1);
+   level_ptr = 0;
+   for (int i = 0; i < n; i++) { level_ptr[level[i]+1]++; }
+   level_ptr.PartialSum();
+
+   Array<int> pos(num_levels);
+   for (int l = 0; l < num_levels; l++) { pos[l] = level_ptr[l]; }
+   rows.SetSize(n);
+   for (int i = 0; i < n; i++) { rows[pos[level[i]]++] = i; }
+}
+
+void SparseILU::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(height == width, "the SparseMatrix must be square");
+
+   SymbolicFactor();
+   NumericFactor();
+   lower.Setup(height, I, J, diag, true);
+   upper.Setup(height, I, J, diag, false);
+}
+
+void SparseILU::SymbolicFactor()
+{
+   const int n = height;
+   const int *Ai = oper->HostReadI();
+   const int *Aj = oper->HostReadJ();
+
+   // The column indices of the current row i are kept in a sorted linked
+   // list, starting at next[n] and ending with n.
+   Array<int> next(n+1), row_level(n), marker(n), cols;
+   Array<int> level; // fill level of the entries in J
+   marker = -1;
+
+   I.SetSize(n+1);
+   diag.SetSize(n);
+   J.SetSize(0);
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      cols.SetSize(0);
+      cols.Append(i);
+      for (int p = Ai[i]; p < Ai[i+1]; p++) { cols.Append(Aj[p]); }
+      cols.Sort();
+      cols.Unique();
+
+      int prev = n;
+      for (int c = 0; c < cols.Size(); c++)
+      {
+         const int j = cols[c];
+         next[prev] = j;
+         prev = j;
+         marker[j] = i;
+         row_level[j] = 0;
+      }
+      next[prev] = n;
+
+      // Add the fill-in from the rows k < i, in increasing order
+      for (int k = next[n]; k < i; k = next[k])
+      {
+         const int level_ik = row_level[k];
+         prev = k;
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int j = J[q];
+            const int level_ij = level_ik + level[q] + 1;
+            if (level_ij > fill_level) { continue; }
+            if (marker[j] == i)
+            {
+               row_level[j] = std::min(row_level[j], level_ij);
+               continue;
+            }
+            while (next[prev] < j) { prev = next[prev]; }
+            next[j] = next[prev];
+            next[prev] = j;
+            marker[j] = i;
+            row_level[j] = level_ij;
+            prev = j;
+         }
+      }
+
+      for (int j = next[n]; j < n; j = next[j])
+      {
+         if (j == i) { diag[i] = J.Size(); }
+         J.Append(j);
+         level.Append(row_level[j]);
+      }
+      I[i+1] = J.Size();
+   }
+}
+
+void SparseILU::NumericFactor()
+{
+   const int n = height;
+   const int *Ai = oper->HostReadI();
+   const int *Aj = oper->HostReadJ();
+   const double *Aa = oper->HostReadData();
+
+   // For the symmetric variant, the position of the transposed entry of each
+   // entry in the lower part
+   Array<int> tpos;
+   if (symmetric)
+   {
+      tpos.SetSize(J.Size());
+      for (int i = 0; i < n; i++)
+      {
+         for (int p = I[i]; p < diag[i]; p++)
+         {
+            const int k = J[p];
+            const int *row_k = J.GetData() + I[k];
+            const int *end_k = J.GetData() + I[k+1];
+            const int *t = std::lower_bound(row_k, end_k, i);
+            MFEM_VERIFY(t != end_k && *t == i,
+                        "the sparsity pattern of the matrix is not symmetric");
+            tpos[p] = t - J.GetData();
+         }
+      }
+   }
+
+   Array<int> pos(n);
+   pos = -1;
+   LU.SetSize(J.Size());
+   LU = 0.0;
+   inv_diag.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      for (int p = I[i]; p < I[i+1]; p++) { pos[J[p]] = p; }
+      for (int p = Ai[i]; p < Ai[i+1]; p++) { LU(pos[Aj[p]]) += Aa[p]; }
+
+      for (int p = I[i]; p < diag[i]; p++)
+      {
+         const int k = J[p];
+         LU(p) = (symmetric ? LU(tpos[p]) : LU(p)) * inv_diag(k);
+         for (int q = diag[k]+1; q < I[k+1]; q++)
+         {
+            const int j = pos[J[q]];
+            if (j >= 0) { LU(j) -= LU(p) * LU(q); }
+         }
+      }
+
+      const double pivot = LU(diag[i]);
+      if (symmetric)
+      {
+         MFEM_VERIFY(pivot > 0.0, "non-positive pivot in row " << i);
+      }
+      else
+      {
+         MFEM_VERIFY(pivot != 0.0, "zero pivot in row " << i);
+      }
+      inv_diag(i) = 1.0/pivot;
+
+      for (int p = I[i]; p < I[i+1]; p++) { pos[J[p]] = -1; }
+   }
+}
+
+void SparseILU::Mult(const Vector &x, Vector &y) const
+{
+   const int *Ip = I, *Jp = J, *Dp = diag;
+   const double *LUp = LU.HostRead(), *inv_d = inv_diag.HostRead();
+   const double *xd = x.HostRead();
+   double *yd = y.HostReadWrite();
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+#endif
+
+   // Forward substitution with the unit lower triangular L
+   const int *rows = lower.GetRows();
+   for (int l = 0; l < lower.NumLevels(); l++)
+   {
+      const int begin = lower.Begin(l), end = lower.End(l);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for \
+      if (threaded && end-begin >= ilu_min_threaded_rows)
+#endif
+      for (int r = begin; r < end; r++)
+      {
+         const int i = rows[r];
+         double s = xd[i];
+         for (int p = Ip[i]; p < Dp[i]; p++) { s -= LUp[p] * yd[Jp[p]]; }
+         yd[i] = s;
+      }
+   }
+
+   // Backward substitution with U
+   rows = upper.GetRows();
+   for (int l = 0; l < upper.NumLevels(); l++)
+   {
+      const int begin = upper.Begin(l), end = upper.End(l);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for \
+      if (threaded && end-begin >= ilu_min_threaded_rows)
+#endif
+      for (int r = begin; r < end; r++)
+      {
+         const int i = rows[r];
+         double s = yd[i];
+         for (int p = Dp[i]+1; p < Ip[i+1]; p++) { s -= LUp[p] * yd[Jp[p]]; }
+         yd[i] = s * inv_d[i];
+      }
+   }
+}
+
+void SparseBlockILU::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(height == width, "the SparseMatrix must be square");
+   MFEM_VERIFY(height % block_size == 0,
+               "the size is not a multiple of the block size");
+
+   const int b = block_size, bb = b*b, nb = height/b;
+   const int *Ai = oper->HostReadI();
+   const int *Aj = oper->HostReadJ();
+   const double *Aa = oper->HostReadData();
+
+   // Block sparsity pattern, with sorted block column indices
+   Array<int> marker(nb), cols;
+   marker = -1;
+   I.SetSize(nb+1);
+   diag.SetSize(nb);
+   J.SetSize(0);
+   I[0] = 0;
+   for (int ib = 0; ib < nb; ib++)
+   {
+      cols.SetSize(0);
+      cols.Append(ib);
+      marker[ib] = ib;
+      for (int i = ib*b; i < (ib+1)*b; i++)
+      {
+         for (int p = Ai[i]; p < Ai[i+1]; p++)
+         {
+            const int jb = Aj[p]/b;
+            if (marker[jb] != ib) { marker[jb] = ib; cols.Append(jb); }
+         }
+      }
+      cols.Sort();
+      for (int c = 0; c < cols.Size(); c++)
+      {
+         if (cols[c] == ib) { diag[ib] = J.Size(); }
+         J.Append(cols[c]);
+      }
+      I[ib+1] = J.Size();
+   }
+
+   // Block ILU(0) factorization, storing the inverses of the diagonal blocks
+   Array<int> pos(nb), ipiv(b);
+   pos = -1;
+   DenseMatrix T(b), F(b);
+   LU.SetSize(J.Size()*bb);
+   LU = 0.0;
+   double *LUd = LU.HostReadWrite();
+   for (int ib = 0; ib < nb; ib++)
+   {
+      for (int p = I[ib]; p < I[ib+1]; p++) { pos[J[p]] = p; }
+      for (int r = 0; r < b; r++)
+      {
+         const int i = ib*b + r;
+         for (int p = Ai[i]; p < Ai[i+1]; p++)
+         {
+            const int j = Aj[p];
+            LUd[pos[j/b]*bb + r + (j%b)*b] += Aa[p];
+         }
+      }
+
+      for (int p = I[ib]; p < diag[ib]; p++)
+      {
+         const int kb = J[p];
+         DenseMatrix L_ik(LUd + p*bb, b, b);
+         DenseMatrix D_k_inv(LUd + diag[kb]*bb, b, b);
+         mfem::Mult(L_ik, D_k_inv, T);
+         std::copy(T.Data(), T.Data() + bb, L_ik.Data());
+         for (int q = diag[kb]+1; q < I[kb+1]; q++)
+         {
+            const int j = pos[J[q]];
+            if (j >= 0)
+            {
+               LUFactors::SubMult(b, b, b, L_ik.Data(), LUd + q*bb,
+                                  LUd + j*bb);
+            }
+         }
+      }
+
+      double *D_i = LUd + diag[ib]*bb;
+      std::copy(D_i, D_i + bb, F.Data());
+      LUFactors lu(F.Data(), ipiv);
+      lu.Factor(b);
+      for (int r = 0; r < b; r++)
+      {
+         MFEM_VERIFY(F(r,r) != 0.0, "singular diagonal block " << ib);
+      }
+      lu.GetInverseMatrix(b, D_i);
+
+      for (int p = I[ib]; p < I[ib+1]; p++) { pos[J[p]] = -1; }
+   }
+
+   lower.Setup(nb, I, J, diag, true);
+   upper.Setup(nb, I, J, diag, false);
+   z.SetSize(height);
+}
+
+void SparseBlockILU::Mult(const Vector &x, Vector &y) const
+{
+   const int b = block_size, bb = b*b;
+   const int *Ip = I, *Jp = J, *Dp = diag;
+   const double *LUd = LU.HostRead();
+   const double *xd = x.HostRead();
+   double *yd = y.HostReadWrite();
+   double *zd = z.HostWrite();
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+#endif
+
+   // Forward substitution with the block unit lower triangular L
+   const int *rows = lower.GetRows();
+   for (int l = 0; l < lower.NumLevels(); l++)
+   {
+      const int begin = lower.Begin(l), end = lower.End(l);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for \
+      if (threaded && (end-begin)*b >= ilu_min_threaded_rows)
+#endif
+      for (int r = begin; r < end; r++)
+      {
+         const int ib = rows[r];
+         double *y_i = yd + ib*b;
+         for (int k = 0; k < b; k++) { y_i[k] = xd[ib*b + k]; }
+         for (int p = Ip[ib]; p < Dp[ib]; p++)
+         {
+            LUFactors::SubMult(b, b, 1, LUd + p*bb, yd + Jp[p]*b, y_i);
+         }
+      }
+   }
+
+   // Backward substitution with the block upper triangular U
+   rows = upper.GetRows();
+   for (int l = 0; l < upper.NumLevels(); l++)
+   {
+      const int begin = upper.Begin(l), end = upper.End(l);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for \
+      if (threaded && (end-begin)*b >= ilu_min_threaded_rows)
+#endif
+      for (int r = begin; r < end; r++)
+      {
+         const int ib = rows[r];
+         double *y_i = yd + ib*b, *z_i = zd + ib*b;
+         for (int k = 0; k < b; k++) { z_i[k] = y_i[k]; }
+         for (int p = Dp[ib]+1; p < Ip[ib+1]; p++)
+         {
+            LUFactors::SubMult(b, b, 1, LUd + p*bb, yd + Jp[p]*b, z_i);
+         }
+         const double *D_inv = LUd + Dp[ib]*bb;
+         for (int k = 0; k < b; k++) { y_i[k] = 0.0; }
+         for (int c = 0; c < b; c++)
+         {
+            for (int k = 0; k < b; k++) { y_i[k] += D_inv[k + c*b] * z_i[c]; }
+         }
+      }
+   }
+}
+
 }
@@ -73,6 +73,123 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Level scheduling of the rows of a triangular factor stored in CSR
+    format: the rows of a level only depend on rows of the previous levels, so
+    they can be solved concurrently. */
+class TriangularLevels
+{
+protected:
+   Array<int> level_ptr; ///< Offsets of the levels in 'rows'.
+   Array<int> rows;      ///< Row indices, ordered by level.
+
+public:
+   /** @brief Compute the levels of the lower (@a lower = true) or the upper
+       triangular part of the n x n CSR pattern @a I, @a J, where @a diag gives
+       the position of the diagonal entry of each row. */
+   void Setup(int n, const int *I, const int *J, const int *diag, bool lower);
+
+   /// Return the number of levels.
+   int NumLevels() const { return level_ptr.Size() - 1; }
+
+   /// Return the first and the last + 1 positions of @a level in GetRows().
+   int Begin(int level) const { return level_ptr[level]; }
+   int End(int level) const { return level_ptr[level+1]; }
+
+   /// Return the row indices, ordered by level.
+   const int *GetRows() const { return rows; }
+};
+
+/** @brief Incomplete LU factorization, ILU(k), of a SparseMatrix. */
+/** The factorization keeps the fill-in entries of level at most k, where the
+    entries of the matrix have level 0, so ILU(0) keeps the sparsity pattern of
+    the matrix. The L and U factors are stored together in CSR format, with the
+    unit diagonal of L omitted. The triangular solves in Mult() are scheduled
+    by levels (TriangularLevels) and threaded with the OpenMP backend. The
+    preconditioner is recomputed by SetOperator(). */
+class SparseILU : public SparseSmoother
+{
+protected:
+   int fill_level;
+   bool symmetric; ///< Set L = U^T D^{-1}, see SparseIC.
+
+   Array<int> I, J, diag; ///< Sparsity pattern of the factors.
+   Vector LU, inv_diag;   ///< Values of the factors, inverse of diag(U).
+   TriangularLevels lower, upper;
+
+   /// Compute the sparsity pattern of the ILU(fill_level) factors.
+   void SymbolicFactor();
+
+   /// Compute the values of the factors from those of the operator.
+   void NumericFactor();
+
+public:
+   /// Create an ILU(@a fill) preconditioner; the matrix is set later.
+   SparseILU(int fill = 0)
+      : fill_level(fill), symmetric(false) { }
+
+   /// Create an ILU(@a fill) preconditioner for the matrix @a a.
+   SparseILU(const SparseMatrix &a, int fill = 0)
+      : fill_level(fill), symmetric(false) { SetOperator(a); }
+
+   /// Set the matrix and compute its incomplete factorization.
+   virtual void SetOperator(const Operator &a);
+
+   /// Apply the preconditioner: solve (L U) y = x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Return the number of nonzero entries of the factors.
+   int NumNonZeros() const { return J.Size(); }
+};
+
+/** @brief Incomplete Cholesky factorization, IC(k), of a symmetric positive
+    definite SparseMatrix. */
+/** The upper factor U is computed as in SparseILU, while L is set to
+    U^T D^{-1}, where D = diag(U), so that the preconditioner U^T D^{-1} U is
+    symmetric and can be used with CG. The pivots are required to be
+    positive. */
+class SparseIC : public SparseILU
+{
+public:
+   /// Create an IC(@a fill) preconditioner; the matrix is set later.
+   SparseIC(int fill = 0) : SparseILU(fill) { symmetric = true; }
+
+   /// Create an IC(@a fill) preconditioner for the matrix @a a.
+   SparseIC(const SparseMatrix &a, int fill = 0)
+      : SparseILU(fill) { symmetric = true; SetOperator(a); }
+};
+
+/** @brief Block ILU(0) factorization of a SparseMatrix with dense square
+    blocks of a fixed size, e.g. the element blocks of DG discretizations. */
+/** The block rows [i*b, (i+1)*b), where b is the block size, are factored
+    keeping the block sparsity pattern of the matrix: a block is part of the
+    pattern if any of its entries is stored in the matrix. The inverses of the
+    diagonal blocks are stored, and the triangular solves in Mult() are
+    scheduled by levels of block rows and threaded with the OpenMP backend. */
+class SparseBlockILU : public SparseSmoother
+{
+protected:
+   int block_size;
+
+   Array<int> I, J, diag; ///< Block sparsity pattern of the factors.
+   Vector LU;             ///< Column-major blocks; inverted diagonal blocks.
+   TriangularLevels lower, upper;
+   mutable Vector z;
+
+public:
+   /// Create a block ILU(0) preconditioner; the matrix is set later.
+   SparseBlockILU(int block_size_) : block_size(block_size_) { }
+
+   /// Create a block ILU(0) preconditioner for the matrix @a a.
+   SparseBlockILU(const SparseMatrix &a, int block_size_)
+      : block_size(block_size_) { SetOperator(a); }
+
+   /// Set the matrix and compute its block incomplete factorization.
+   virtual void SetOperator(const Operator &a);
+
+   /// Apply the preconditioner: solve (L U) y = x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 }
 
 #endif
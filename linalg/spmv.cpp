@@ -0,0 +1,409 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the SpMV storage formats SELL-C-sigma, BSR and CSR with
+// single precision values
+
+#include "spmv.hpp"
+#include "sparsemat.hpp"
+#include "../general/device.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+SellCSigmaMatrix::SellCSigmaMatrix(const SparseMatrix &A, int C_, int sigma_)
+   : SpMVFormat(A.Height(), A.Width()), C(C_)
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(C == 1 || C == 2 || C == 4 || C == 8 || C == 16,
+               "C = " << C << " is not supported");
+   sigma = std::max(C, ((sigma_ + C - 1)/C)*C);
+   num_slices = (height + C - 1)/C;
+
+   const int *Ai = A.HostReadI();
+   const int *Aj = A.HostReadJ();
+   const double *Aa = A.HostReadData();
+
+   // Sort the rows by decreasing length within each window of sigma rows
+   rows.SetSize(num_slices*C);
+   rows = -1;
+   for (int i = 0; i < height; i++) { rows[i] = i; }
+   for (int w = 0; w < height; w += sigma)
+   {
+      std::stable_sort(rows.GetData() + w,
+                       rows.GetData() + std::min(w + sigma, height),
+                       [Ai](int i, int j) { return Ai[i+1]-Ai[i] >
+                                                   Ai[j+1]-Ai[j]; });
+   }
+
+   slice_ptr.SetSize(num_slices+1);
+   slice_ptr[0] = 0;
+   for (int s = 0; s < num_slices; s++)
+   {
+      int slice_width = 0;
+      for (int r = 0; r < C; r++)
+      {
+         const int i = rows[s*C + r];
+         if (i >= 0) { slice_width = std::max(slice_width, Ai[i+1]-Ai[i]); }
+      }
+      slice_ptr[s+1] = slice_ptr[s] + slice_width*C;
+   }
+
+   // The padding entries are zeros in column 0
+   col.SetSize(slice_ptr[num_slices]);
+   val.SetSize(slice_ptr[num_slices]);
+   col = 0;
+   val = 0.0;
+   for (int s = 0; s < num_slices; s++)
+   {
+      for (int r = 0; r < C; r++)
+      {
+         const int i = rows[s*C + r];
+         if (i < 0) { continue; }
+         for (int k = 0; k < Ai[i+1]-Ai[i]; k++)
+         {
+            col[slice_ptr[s] + k*C + r] = Aj[Ai[i] + k];
+            val(slice_ptr[s] + k*C + r) = Aa[Ai[i] + k];
+         }
+      }
+   }
+}
+
+template <int C>
+static void SellCSigmaAddMult(const int num_slices, const int *slice_ptr,
+                              const int *rows, const int *col,
+                              const double *val, const double *x, double *y,
+                              const double a)
+{
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int s = 0; s < num_slices; s++)
+   {
+      double sum[C];
+      for (int r = 0; r < C; r++) { sum[r] = 0.0; }
+      for (int p = slice_ptr[s]; p < slice_ptr[s+1]; p += C)
+      {
+         for (int r = 0; r < C; r++) { sum[r] += val[p+r] * x[col[p+r]]; }
+      }
+      for (int r = 0; r < C; r++)
+      {
+         const int i = rows[s*C + r];
+         if (i >= 0) { y[i] += a * sum[r]; }
+      }
+   }
+}
+
+template <int C>
+static void SellCSigmaAddMultTranspose(const int num_slices,
+                                       const int *slice_ptr, const int *rows,
+                                       const int *col, const double *val,
+                                       const double *x, double *y,
+                                       const double a)
+{
+   for (int s = 0; s < num_slices; s++)
+   {
+      double xs[C];
+      for (int r = 0; r < C; r++)
+      {
+         const int i = rows[s*C + r];
+         xs[r] = (i >= 0) ? a * x[i] : 0.0;
+      }
+      for (int p = slice_ptr[s]; p < slice_ptr[s+1]; p += C)
+      {
+         for (int r = 0; r < C; r++) { y[col[p+r]] += val[p+r] * xs[r]; }
+      }
+   }
+}
+
+void SellCSigmaMatrix::AddMult(const Vector &x, Vector &y, double a) const
+{
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   switch (C)
+   {
+      case 1: SellCSigmaAddMult<1>(num_slices, slice_ptr, rows, col,
+                                      val.GetData(), xp, yp, a); break;
+      case 2: SellCSigmaAddMult<2>(num_slices, slice_ptr, rows, col,
+                                      val.GetData(), xp, yp, a); break;
+      case 4: SellCSigmaAddMult<4>(num_slices, slice_ptr, rows, col,
+                                      val.GetData(), xp, yp, a); break;
+      case 8: SellCSigmaAddMult<8>(num_slices, slice_ptr, rows, col,
+                                      val.GetData(), xp, yp, a); break;
+      case 16: SellCSigmaAddMult<16>(num_slices, slice_ptr, rows, col,
+                                        val.GetData(), xp, yp, a); break;
+   }
+}
+
+void SellCSigmaMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                        double a) const
+{
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   switch (C)
+   {
+      case 1: SellCSigmaAddMultTranspose<1>(num_slices, slice_ptr, rows, col,
+                                               val.GetData(), xp, yp, a);
+         break;
+      case 2: SellCSigmaAddMultTranspose<2>(num_slices, slice_ptr, rows, col,
+                                               val.GetData(), xp, yp, a);
+         break;
+      case 4: SellCSigmaAddMultTranspose<4>(num_slices, slice_ptr, rows, col,
+                                               val.GetData(), xp, yp, a);
+         break;
+      case 8: SellCSigmaAddMultTranspose<8>(num_slices, slice_ptr, rows, col,
+                                               val.GetData(), xp, yp, a);
+         break;
+      case 16: SellCSigmaAddMultTranspose<16>(num_slices, slice_ptr, rows,
+                                                 col, val.GetData(), xp, yp,
+                                                 a);
+         break;
+   }
+}
+
+BlockCSRMatrix::BlockCSRMatrix(const SparseMatrix &A, int vdim_,
+                               bool interleaved_)
+   : SpMVFormat(A.Height(), A.Width()),
+     vdim(vdim_),
+     interleaved(interleaved_)
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(vdim > 0 && height % vdim == 0 && width % vdim == 0,
+               "the sizes are not multiples of vdim = " << vdim);
+   num_block_rows = height/vdim;
+   num_block_cols = width/vdim;
+
+   const int *Ai = A.HostReadI();
+   const int *Aj = A.HostReadJ();
+   const double *Aa = A.HostReadData();
+   const int b = vdim, bb = b*b, nbr = num_block_rows, nbc = num_block_cols;
+
+   // Block sparsity pattern, with sorted block column indices
+   Array<int> marker(nbc), cols;
+   marker = -1;
+   I.SetSize(nbr+1);
+   J.SetSize(0);
+   I[0] = 0;
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      cols.SetSize(0);
+      for (int r = 0; r < b; r++)
+      {
+         const int i = interleaved ? ib*b + r : ib + r*nbr;
+         for (int p = Ai[i]; p < Ai[i+1]; p++)
+         {
+            const int jb = interleaved ? Aj[p]/b : Aj[p] % nbc;
+            if (marker[jb] != ib) { marker[jb] = ib; cols.Append(jb); }
+         }
+      }
+      cols.Sort();
+      J.Append(cols);
+      I[ib+1] = J.Size();
+   }
+
+   Array<int> pos(nbc);
+   val.SetSize(J.Size()*bb);
+   val = 0.0;
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      for (int p = I[ib]; p < I[ib+1]; p++) { pos[J[p]] = p; }
+      for (int r = 0; r < b; r++)
+      {
+         const int i = interleaved ? ib*b + r : ib + r*nbr;
+         for (int p = Ai[i]; p < Ai[i+1]; p++)
+         {
+            const int jb = interleaved ? Aj[p]/b : Aj[p] % nbc;
+            const int c = interleaved ? Aj[p] % b : Aj[p]/nbc;
+            val(pos[jb]*bb + r + c*b) += Aa[p];
+         }
+      }
+   }
+}
+
+// Row of component c of the block row (or column) ib, out of nb blocks.
+static inline int BlockCSRIndex(const bool interleaved, const int b,
+                                const int nb, const int ib, const int c)
+{
+   return interleaved ? ib*b + c : ib + c*nb;
+}
+
+template <int T_B>
+static void BlockCSRAddMult(const int vdim, const bool interleaved,
+                            const int nbr, const int nbc,
+                            const int *I, const int *J, const double *val,
+                            const double *x, double *y, const double a)
+{
+   const int B = T_B ? T_B : vdim;
+   constexpr int MB = T_B ? T_B : 1;
+   const int BB = B*B;
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      if (T_B)
+      {
+         // Accumulate the B rows of the block row together
+         double sum[MB];
+         for (int r = 0; r < B; r++) { sum[r] = 0.0; }
+         for (int p = I[ib]; p < I[ib+1]; p++)
+         {
+            const double *blk = val + p*BB;
+            for (int c = 0; c < B; c++)
+            {
+               const double xc = x[BlockCSRIndex(interleaved, B, nbc, J[p], c)];
+               for (int r = 0; r < B; r++) { sum[r] += blk[r + c*B] * xc; }
+            }
+         }
+         for (int r = 0; r < B; r++)
+         {
+            y[BlockCSRIndex(interleaved, B, nbr, ib, r)] += a * sum[r];
+         }
+         continue;
+      }
+      for (int r = 0; r < B; r++)
+      {
+         double sum = 0.0;
+         for (int p = I[ib]; p < I[ib+1]; p++)
+         {
+            const double *blk = val + p*BB;
+            for (int c = 0; c < B; c++)
+            {
+               sum += blk[r + c*B] * x[BlockCSRIndex(interleaved, B, nbc,
+                                                     J[p], c)];
+            }
+         }
+         y[BlockCSRIndex(interleaved, B, nbr, ib, r)] += a * sum;
+      }
+   }
+}
+
+template <int T_B>
+static void BlockCSRAddMultTranspose(const int vdim, const bool interleaved,
+                                     const int nbr, const int nbc,
+                                     const int *I, const int *J,
+                                     const double *val, const double *x,
+                                     double *y, const double a)
+{
+   const int B = T_B ? T_B : vdim;
+   const int BB = B*B;
+   for (int ib = 0; ib < nbr; ib++)
+   {
+      for (int p = I[ib]; p < I[ib+1]; p++)
+      {
+         const double *blk = val + p*BB;
+         for (int c = 0; c < B; c++)
+         {
+            double sum = 0.0;
+            for (int r = 0; r < B; r++)
+            {
+               sum += blk[r + c*B] * x[BlockCSRIndex(interleaved, B, nbr,
+                                                     ib, r)];
+            }
+            y[BlockCSRIndex(interleaved, B, nbc, J[p], c)] += a * sum;
+         }
+      }
+   }
+}
+
+void BlockCSRMatrix::AddMult(const Vector &x, Vector &y, double a) const
+{
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   const int nbr = num_block_rows, nbc = num_block_cols;
+   switch (vdim)
+   {
+      case 2: BlockCSRAddMult<2>(vdim, interleaved, nbr, nbc, I, J,
+                                    val.GetData(), xp, yp, a); break;
+      case 3: BlockCSRAddMult<3>(vdim, interleaved, nbr, nbc, I, J,
+                                    val.GetData(), xp, yp, a); break;
+      case 4: BlockCSRAddMult<4>(vdim, interleaved, nbr, nbc, I, J,
+                                    val.GetData(), xp, yp, a); break;
+      default: BlockCSRAddMult<0>(vdim, interleaved, nbr, nbc, I, J,
+                                     val.GetData(), xp, yp, a); break;
+   }
+}
+
+void BlockCSRMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                      double a) const
+{
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   const int nbr = num_block_rows, nbc = num_block_cols;
+   switch (vdim)
+   {
+      case 2: BlockCSRAddMultTranspose<2>(vdim, interleaved, nbr, nbc, I, J,
+                                             val.GetData(), xp, yp, a);
+         break;
+      case 3: BlockCSRAddMultTranspose<3>(vdim, interleaved, nbr, nbc, I, J,
+                                             val.GetData(), xp, yp, a);
+         break;
+      default: BlockCSRAddMultTranspose<0>(vdim, interleaved, nbr, nbc, I, J,
+                                              val.GetData(), xp, yp, a);
+         break;
+   }
+}
+
+SinglePrecisionCSRMatrix::SinglePrecisionCSRMatrix(const SparseMatrix &A)
+   : SpMVFormat(A.Height(), A.Width())
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   const int nnz = A.NumNonZeroElems();
+   const int *Ai = A.HostReadI();
+   const int *Aj = A.HostReadJ();
+   const double *Aa = A.HostReadData();
+   I.SetSize(height+1);
+   J.SetSize(nnz);
+   val.SetSize(nnz);
+   for (int i = 0; i <= height; i++) { I[i] = Ai[i]; }
+   for (int k = 0; k < nnz; k++)
+   {
+      J[k] = Aj[k];
+      val[k] = (float) Aa[k];
+   }
+}
+
+void SinglePrecisionCSRMatrix::AddMult(const Vector &x, Vector &y,
+                                       double a) const
+{
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   const int *Ip = I.GetData(), *Jp = J.GetData();
+   const float *vp = val.GetData();
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      double d = 0.0;
+      for (int k = Ip[i]; k < Ip[i+1]; k++) { d += vp[k] * xp[Jp[k]]; }
+      yp[i] += a * d;
+   }
+}
+
+void SinglePrecisionCSRMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                                double a) const
+{
+   const double *xp = x.HostRead();
+   double *yp = y.HostReadWrite();
+   for (int i = 0; i < height; i++)
+   {
+      const double xi = a * xp[i];
+      for (int k = I[i]; k < I[i+1]; k++) { yp[J[k]] += val[k] * xi; }
+   }
+}
+
+} // namespace mfem
@@ -0,0 +1,143 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SPMV
+#define MFEM_SPMV
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "vector.hpp"
+#include "operator.hpp"
+
+namespace mfem
+{
+
+class SparseMatrix;
+
+/** @brief Abstract copy of a finalized SparseMatrix in a storage format
+    tailored to the matrix-vector product on the host. */
+/** See SparseMatrix::BuildSellCSigma(), SparseMatrix::BuildBlockCSR() and
+    SparseMatrix::BuildSinglePrecision(). A copy can also be used on its own,
+    as an Operator independent of the SparseMatrix. */
+class SpMVFormat : public Operator
+{
+public:
+   SpMVFormat(int h, int w) : Operator(h, w) { }
+
+   /// y = A * x
+   virtual void Mult(const Vector &x, Vector &y) const
+   { y = 0.0; AddMult(x, y, 1.0); }
+
+   /// y = A^T * x
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { y = 0.0; AddMultTranspose(x, y, 1.0); }
+
+   /// y += a * A * x
+   virtual void AddMult(const Vector &x, Vector &y, double a) const = 0;
+
+   /// y += a * A^T * x
+   virtual void AddMultTranspose(const Vector &x, Vector &y,
+                                 double a) const = 0;
+
+   /// Return the number of stored entries, including the padding.
+   virtual int NumStoredEntries() const = 0;
+
+   virtual ~SpMVFormat() { }
+};
+
+/** @brief Sliced ELLPACK format with sorting window, SELL-C-sigma. */
+/** The rows are grouped into slices of C rows, stored column by column with
+    the rows of the slice padded to the length of the longest one, so that the
+    C rows of a slice are processed together in SIMD lanes. To reduce the
+    padding, the rows are first sorted by decreasing length within windows of
+    sigma consecutive rows. */
+class SellCSigmaMatrix : public SpMVFormat
+{
+protected:
+   int C, sigma, num_slices;
+   Array<int> slice_ptr; ///< Offsets of the slices in 'col' and 'val'.
+   Array<int> rows;      ///< Row of each slice lane; -1 for padding lanes.
+   Array<int> col;       ///< Column indices, column-major in each slice.
+   Vector val;           ///< Values, column-major in each slice.
+
+public:
+   /** @brief Copy the finalized matrix @a A in SELL-C-sigma format, with
+       @a C rows per slice and a sorting window of @a sigma rows, rounded up to
+       a multiple of @a C. */
+   SellCSigmaMatrix(const SparseMatrix &A, int C, int sigma);
+
+   virtual void AddMult(const Vector &x, Vector &y, double a) const;
+
+   virtual void AddMultTranspose(const Vector &x, Vector &y, double a) const;
+
+   virtual int NumStoredEntries() const { return col.Size(); }
+
+   int GetC() const { return C; }
+   int GetSigma() const { return sigma; }
+};
+
+/** @brief Block compressed sparse row format (BSR) with dense square blocks,
+    for the systems of vector finite element spaces. */
+/** The rows and the columns are grouped into blocks of @a vdim entries, the
+    components of a node. A block is stored, densely and column-major, if any
+    of its entries is stored in the SparseMatrix. */
+class BlockCSRMatrix : public SpMVFormat
+{
+protected:
+   int vdim, num_block_rows, num_block_cols;
+   bool interleaved;
+   Array<int> I, J; ///< Block sparsity pattern.
+   Vector val;      ///< Column-major blocks.
+
+public:
+   /** @brief Copy the finalized matrix @a A in BSR format with vdim x vdim
+       blocks. */
+   /** If @a interleaved is true, the @a vdim components of each node are
+       consecutive, as with Ordering::byVDIM. Otherwise, each component is
+       stored in a contiguous section, as with Ordering::byNODES. */
+   BlockCSRMatrix(const SparseMatrix &A, int vdim, bool interleaved = true);
+
+   virtual void AddMult(const Vector &x, Vector &y, double a) const;
+
+   virtual void AddMultTranspose(const Vector &x, Vector &y, double a) const;
+
+   virtual int NumStoredEntries() const { return val.Size(); }
+
+   int GetVDim() const { return vdim; }
+};
+
+/** @brief Compressed sparse row format with single precision values. */
+/** The values are stored as floats and the products are computed in double
+    precision, so that the matrix-vector product reads 8 bytes per entry
+    instead of 12, at the cost of a relative perturbation of the entries of
+    about 1e-7. This is suited to preconditioners, smoothers and the inner
+    solver of IterativeRefinementSolver, whose accuracy is recovered by an
+    outer iteration with the original matrix. */
+class SinglePrecisionCSRMatrix : public SpMVFormat
+{
+protected:
+   Array<int> I, J;
+   Array<float> val;
+
+public:
+   /// Copy the finalized matrix @a A with single precision values.
+   SinglePrecisionCSRMatrix(const SparseMatrix &A);
+
+   virtual void AddMult(const Vector &x, Vector &y, double a) const;
+
+   virtual void AddMultTranspose(const Vector &x, Vector &y, double a) const;
+
+   virtual int NumStoredEntries() const { return val.Size(); }
+};
+
+} // namespace mfem
+
+#endif // MFEM_SPMV
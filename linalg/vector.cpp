@@ -13,6 +13,7 @@
 
 #include "vector.hpp"
 #include "dtensor.hpp"
+#include "simd.hpp"
 #include "../general/forall.hpp"
 
 #if defined(MFEM_USE_SUNDIALS) && defined(MFEM_USE_MPI)
@@ -26,6 +27,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <limits>
+#include <vector>
 
 namespace mfem
 {
@@ -1042,6 +1044,182 @@ vector_min_cpu:
 }
 
 
+// Number of entries in the blocks of the host implementation of the fused
+// vector kernels, a multiple of SIMD_DOUBLES.
+static const int FUSED_BLOCK = 2048;
+
+// Call body(i, sum) for i = 0,...,N-1 on the host, where body updates the
+// entries i of the vectors and adds its contribution to the nr sums
+// sum[r*SIMD_DOUBLES], r = 0,...,nr-1. The consecutive entries are added to
+// separate partial sums, so that the compiler can vectorize the loop over
+// SIMD_DOUBLES entries. The nr sums are returned in red.
+template <typename Body>
+static void FusedHostReduce(const int N, const int nr, double *red,
+                            Body &&body)
+{
+   const int nb = (N + FUSED_BLOCK - 1) / FUSED_BLOCK;
+   std::vector<double> part(nb*nr*SIMD_DOUBLES, 0.0);
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int b = 0; b < nb; b++)
+   {
+      double *sum = part.data() + b*nr*SIMD_DOUBLES;
+      const int end = std::min(N, (b+1)*FUSED_BLOCK);
+      int i = b*FUSED_BLOCK;
+      for (; i + SIMD_DOUBLES <= end; i += SIMD_DOUBLES)
+      {
+         for (int l = 0; l < SIMD_DOUBLES; l++) { body(i+l, sum+l); }
+      }
+      for (int l = 0; i < end; i++, l++) { body(i, sum+l); }
+   }
+   for (int r = 0; r < nr; r++) { red[r] = 0.0; }
+   for (int b = 0; b < nb; b++)
+   {
+      for (int r = 0; r < nr; r++)
+      {
+         for (int l = 0; l < SIMD_DOUBLES; l++)
+         {
+            red[r] += part[(b*nr + r)*SIMD_DOUBLES + l];
+         }
+      }
+   }
+}
+
+static inline bool FusedOnDevice(bool use_dev)
+{
+   return use_dev && Device::Allows(Backend::DEVICE_MASK);
+}
+
+double AddAndDot(const Vector &v1, double alpha, const Vector &v2, Vector &v,
+                 const Vector &w)
+{
+   MFEM_ASSERT(v.Size() == v1.Size() && v.Size() == v2.Size() &&
+               v.Size() == w.Size(), "incompatible Vectors!");
+
+   const int N = v.Size();
+   const bool use_dev = v1.UseDevice() || v2.UseDevice() || v.UseDevice() ||
+                        w.UseDevice();
+   if (FusedOnDevice(use_dev))
+   {
+      // Note: get read access first, in case v is the same as v1/v2.
+      auto d_v1 = v1.Read();
+      auto d_v2 = v2.Read();
+      auto d_v = v.Write();
+      MFEM_FORALL(i, N, d_v[i] = d_v1[i] + alpha*d_v2[i];);
+      return v * w;
+   }
+
+   const double *h_v1 = v1.HostRead();
+   const double *h_v2 = v2.HostRead();
+   const double *h_w = w.HostRead();
+   double *h_v = v.HostWrite();
+   double dot;
+   FusedHostReduce(N, 1, &dot, [=](int i, double *sum)
+   {
+      const double vi = h_v1[i] + alpha*h_v2[i];
+      h_v[i] = vi;
+      sum[0] += vi*h_w[i];
+   });
+   return dot;
+}
+
+void LinearCombination(int k, const double *a, const Vector *const *x,
+                       double b, Vector &y)
+{
+   const int N = y.Size();
+   bool use_dev = y.UseDevice();
+   for (int j = 0; j < k; j++)
+   {
+      MFEM_ASSERT(x[j]->Size() == N, "incompatible Vectors!");
+      use_dev = use_dev || x[j]->UseDevice();
+   }
+   if (FusedOnDevice(use_dev))
+   {
+      // Update y with up to four vectors per kernel
+      for (int j0 = 0; j0 == 0 || j0 < k; j0 += 4)
+      {
+         const int nj = std::min(4, k - j0);
+         const double b0 = (j0 == 0) ? b : 1.0;
+         const double a0 = (nj > 0) ? a[j0] : 0.0;
+         const double a1 = (nj > 1) ? a[j0+1] : 0.0;
+         const double a2 = (nj > 2) ? a[j0+2] : 0.0;
+         const double a3 = (nj > 3) ? a[j0+3] : 0.0;
+         auto d_x0 = (nj > 0) ? x[j0]->Read() : NULL;
+         auto d_x1 = (nj > 1) ? x[j0+1]->Read() : d_x0;
+         auto d_x2 = (nj > 2) ? x[j0+2]->Read() : d_x0;
+         auto d_x3 = (nj > 3) ? x[j0+3]->Read() : d_x0;
+         auto d_y = (b0 == 0.0) ? y.Write() : y.ReadWrite();
+         MFEM_FORALL(i, N,
+         {
+            double yi = (b0 == 0.0) ? 0.0 : b0*d_y[i];
+            if (nj > 0) { yi += a0*d_x0[i]; }
+            if (nj > 1) { yi += a1*d_x1[i]; }
+            if (nj > 2) { yi += a2*d_x2[i]; }
+            if (nj > 3) { yi += a3*d_x3[i]; }
+            d_y[i] = yi;
+         });
+      }
+      return;
+   }
+
+   std::vector<const double *> h_x(k);
+   for (int j = 0; j < k; j++) { h_x[j] = x[j]->HostRead(); }
+   double *h_y = (b == 0.0) ? y.HostWrite() : y.HostReadWrite();
+   const double *const *xp = h_x.data();
+#ifdef MFEM_USE_OPENMP
+   const bool threaded = Device::Allows(Backend::OMP_MASK);
+   #pragma omp parallel for schedule(static) if (threaded)
+#endif
+   for (int i0 = 0; i0 < N; i0 += FUSED_BLOCK)
+   {
+      // Update the block of y with all the vectors while it is in cache
+      const int end = std::min(N, i0 + FUSED_BLOCK);
+      if (b == 0.0)
+      {
+         for (int i = i0; i < end; i++) { h_y[i] = 0.0; }
+      }
+      else if (b != 1.0)
+      {
+         for (int i = i0; i < end; i++) { h_y[i] *= b; }
+      }
+      for (int j = 0; j < k; j++)
+      {
+         const double aj = a[j], *xj = xp[j];
+         for (int i = i0; i < end; i++) { h_y[i] += aj*xj[i]; }
+      }
+   }
+}
+
+void InnerProducts(const Vector &x, int k, const Vector *const *y,
+                   double *dots)
+{
+   const int N = x.Size();
+   bool use_dev = x.UseDevice();
+   for (int j = 0; j < k; j++)
+   {
+      MFEM_ASSERT(y[j]->Size() == N, "incompatible Vectors!");
+      use_dev = use_dev || y[j]->UseDevice();
+   }
+   if (FusedOnDevice(use_dev))
+   {
+      for (int j = 0; j < k; j++) { dots[j] = x * (*y[j]); }
+      return;
+   }
+
+   const double *h_x = x.HostRead();
+   std::vector<const double *> h_y(k);
+   for (int j = 0; j < k; j++) { h_y[j] = y[j]->HostRead(); }
+   const double *const *yp = h_y.data();
+   FusedHostReduce(N, k, dots, [=](int i, double *sum)
+   {
+      const double xi = h_x[i];
+      for (int j = 0; j < k; j++) { sum[j*SIMD_DOUBLES] += xi*yp[j][i]; }
+   });
+}
+
+
 #ifdef MFEM_USE_SUNDIALS
 
 Vector::Vector(N_Vector nv)
@@ -567,6 +567,37 @@ inline double InnerProduct(MPI_Comm comm, const Vector &x, const Vector &y)
 }
 #endif
 
+/** @name Fused vector kernels */
+/** These kernels combine vector updates and the local inner products that
+    follow them in one sweep over the data, in order to read each vector once.
+    On the host, the work is split in blocks of fixed size, threaded with the
+    "omp" backend, and the partial sums of the blocks are added in order, so
+    that the results do not depend on the number of threads. On devices, the
+    updates are fused in one kernel and the inner products are computed with
+    the device reduction of Vector::operator*(). As with InnerProduct(const
+    Vector &, const Vector &), the inner products are local to each MPI rank.
+*/
+///@{
+
+/** @brief Set v = v1 + alpha v2 and return the inner product of the updated
+    vector v with w. */
+/** The vector v may be the same as v1 or v2, and w may be the same as v, e.g.
+    to compute the squared norm of v. */
+double AddAndDot(const Vector &v1, double alpha, const Vector &v2, Vector &v,
+                 const Vector &w);
+
+/** @brief Set y = b y + sum_{j<k} a[j] x[j], where x is an array of @a k
+    vectors. */
+/** When @a b is 0, y is not read. */
+void LinearCombination(int k, const double *a, const Vector *const *x,
+                       double b, Vector &y);
+
+/// Compute the inner products dots[j] = (x, y[j]) of x with @a k vectors.
+void InnerProducts(const Vector &x, int k, const Vector *const *y,
+                   double *dots);
+
+///@}
+
 } // namespace mfem
 
 #endif
@@ -0,0 +1,362 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the bounding volume hierarchies
+
+#include "bvh.hpp"
+#include "mesh.hpp"
+#include "../fem/fem.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace mfem
+{
+
+void BoundingBoxTree::Build(int dim_, const Array<double> &bbox)
+{
+   dim = dim_;
+   MFEM_VERIFY(dim > 0 && bbox.Size() % (2*dim) == 0, "invalid boxes");
+   const int n = bbox.Size()/(2*dim);
+   boxes = bbox;
+   ids.SetSize(n);
+   for (int i = 0; i < n; i++) { ids[i] = i; }
+
+   Array<double> centers(n*dim);
+   for (int i = 0; i < n; i++)
+   {
+      for (int d = 0; d < dim; d++)
+      {
+         const double *b = &boxes[2*dim*i];
+         centers[i*dim+d] = 0.5*(b[d] + b[dim+d]);
+      }
+   }
+
+   node_first.SetSize(0);
+   node_size.SetSize(0);
+   node_right.SetSize(0);
+   if (n > 0) { BuildNode(0, n, centers); }
+   node_box.SetSize(2*dim*GetNNodes());
+   RefitNodes();
+}
+
+int BoundingBoxTree::BuildNode(int first, int size,
+                               const Array<double> &centers)
+{
+   const int node = node_right.Size();
+   node_first.Append(first);
+   node_size.Append(size);
+   node_right.Append(-1);
+   if (size <= max_leaf_size) { return node; }
+
+   // Split at the median of the centers along the longest direction
+   int axis = 0;
+   double max_ext = -1.0;
+   for (int d = 0; d < dim; d++)
+   {
+      double cmin = std::numeric_limits<double>::infinity();
+      double cmax = -cmin;
+      for (int i = first; i < first + size; i++)
+      {
+         cmin = std::min(cmin, centers[ids[i]*dim+d]);
+         cmax = std::max(cmax, centers[ids[i]*dim+d]);
+      }
+      if (cmax - cmin > max_ext) { max_ext = cmax - cmin; axis = d; }
+   }
+   const int mid = size/2;
+   const int d = dim;
+   int *begin = ids.GetData() + first;
+   std::nth_element(begin, begin + mid, begin + size, [&](int a, int b)
+   { return centers[a*d+axis] < centers[b*d+axis]; });
+
+   BuildNode(first, mid, centers);
+   const int right = BuildNode(first + mid, size - mid, centers);
+   node_right[node] = right; // after the Append() calls of the children
+   return node;
+}
+
+void BoundingBoxTree::RefitNodes()
+{
+   // The children of a node follow it, so the nodes are processed in reverse
+   for (int n = GetNNodes() - 1; n >= 0; n--)
+   {
+      double *nb = &node_box[2*dim*n];
+      if (node_right[n] < 0)
+      {
+         for (int d = 0; d < dim; d++)
+         {
+            nb[d] = std::numeric_limits<double>::infinity();
+            nb[dim+d] = -nb[d];
+         }
+         for (int i = node_first[n]; i < node_first[n] + node_size[n]; i++)
+         {
+            const double *b = &boxes[2*dim*ids[i]];
+            for (int d = 0; d < dim; d++)
+            {
+               nb[d] = std::min(nb[d], b[d]);
+               nb[dim+d] = std::max(nb[dim+d], b[dim+d]);
+            }
+         }
+      }
+      else
+      {
+         const double *lb = &node_box[2*dim*(n+1)];
+         const double *rb = &node_box[2*dim*node_right[n]];
+         for (int d = 0; d < dim; d++)
+         {
+            nb[d] = std::min(lb[d], rb[d]);
+            nb[dim+d] = std::max(lb[dim+d], rb[dim+d]);
+         }
+      }
+   }
+}
+
+void BoundingBoxTree::Refit(const Array<double> &bbox)
+{
+   MFEM_VERIFY(bbox.Size() == boxes.Size(), "the number of boxes changed");
+   boxes = bbox;
+   RefitNodes();
+}
+
+void BoundingBoxTree::Clear()
+{
+   boxes.SetSize(0);
+   ids.SetSize(0);
+   node_box.SetSize(0);
+   node_first.SetSize(0);
+   node_size.SetSize(0);
+   node_right.SetSize(0);
+}
+
+void BoundingBoxTree::FindBoxes(const double *x, Array<int> &found) const
+{
+   found.SetSize(0);
+   if (GetNNodes() == 0) { return; }
+
+   // The depth of the tree is about log2(n/max_leaf_size)
+   const int max_stack = 64;
+   int stack[max_stack], top = 0;
+   stack[top++] = 0;
+   while (top > 0)
+   {
+      const int n = stack[--top];
+      const double *nb = &node_box[2*dim*n];
+      bool inside = true;
+      for (int d = 0; d < dim; d++)
+      {
+         inside = inside && (nb[d] <= x[d] && x[d] <= nb[dim+d]);
+      }
+      if (!inside) { continue; }
+      if (node_right[n] < 0)
+      {
+         for (int i = node_first[n]; i < node_first[n] + node_size[n]; i++)
+         {
+            const double *b = &boxes[2*dim*ids[i]];
+            bool in_box = true;
+            for (int d = 0; d < dim; d++)
+            {
+               in_box = in_box && (b[d] <= x[d] && x[d] <= b[dim+d]);
+            }
+            if (in_box) { found.Append(ids[i]); }
+         }
+      }
+      else
+      {
+         MFEM_ASSERT(top + 2 <= max_stack, "BoundingBoxTree is too deep");
+         stack[top++] = node_right[n];
+         stack[top++] = n + 1;
+      }
+   }
+}
+
+void BoundingBoxTree::GetNodeBoxes(int depth, Array<double> &bbox) const
+{
+   bbox.SetSize(0);
+   if (GetNNodes() == 0) { return; }
+
+   Array<int> nodes, levels;
+   nodes.Append(0);
+   levels.Append(0);
+   while (nodes.Size() > 0)
+   {
+      const int n = nodes.Last(), level = levels.Last();
+      nodes.DeleteLast();
+      levels.DeleteLast();
+      if (node_right[n] < 0 || level == depth)
+      {
+         bbox.Append(&node_box[2*dim*n], 2*dim);
+      }
+      else
+      {
+         nodes.Append(node_right[n]);
+         levels.Append(level + 1);
+         nodes.Append(n + 1);
+         levels.Append(level + 1);
+      }
+   }
+}
+
+
+void ElementBoxTree::GetElementBoxes(Mesh &mesh, Array<double> &bbox) const
+{
+   const int sdim = mesh.SpaceDimension();
+   const int ne = mesh.GetNE();
+   bbox.SetSize(2*sdim*ne);
+
+   const GridFunction *nodes = mesh.GetNodes();
+   Array<int> vert;
+   DenseMatrix pts;
+   for (int i = 0; i < ne; i++)
+   {
+      double *b = &bbox[2*sdim*i];
+      for (int d = 0; d < sdim; d++)
+      {
+         b[d] = std::numeric_limits<double>::infinity();
+         b[sdim+d] = -b[d];
+      }
+      double pad;
+      if (nodes == NULL)
+      {
+         // The straight elements are in the convex hull of their vertices
+         mesh.GetElementVertices(i, vert);
+         for (int j = 0; j < vert.Size(); j++)
+         {
+            const double *v = mesh.GetVertex(vert[j]);
+            for (int d = 0; d < sdim; d++)
+            {
+               b[d] = std::min(b[d], v[d]);
+               b[sdim+d] = std::max(b[sdim+d], v[d]);
+            }
+         }
+         pad = 1e-12;
+      }
+      else
+      {
+         const Geometry::Type geom = mesh.GetElementBaseGeometry(i);
+         const int order = nodes->FESpace()->GetFE(i)->GetOrder();
+         RefinedGeometry *RefG =
+            GlobGeometryRefiner.Refine(geom, std::max(2, 2*order));
+         mesh.GetElementTransformation(i)->Transform(RefG->RefPts, pts);
+         for (int j = 0; j < pts.Width(); j++)
+         {
+            for (int d = 0; d < sdim; d++)
+            {
+               b[d] = std::min(b[d], pts(d,j));
+               b[sdim+d] = std::max(b[sdim+d], pts(d,j));
+            }
+         }
+         pad = padding;
+      }
+      double ext = 0.0;
+      for (int d = 0; d < sdim; d++) { ext = std::max(ext, b[sdim+d] - b[d]); }
+      for (int d = 0; d < sdim; d++)
+      {
+         b[d] -= pad*ext;
+         b[sdim+d] += pad*ext;
+      }
+   }
+}
+
+std::uint64_t ElementBoxTree::CoordinatesChecksum(const Mesh &mesh)
+{
+   // 64-bit FNV-1a hash of the bits of the coordinates
+   static_assert(sizeof(double) == sizeof(std::uint64_t),
+                 "the coordinates are hashed as 64-bit words");
+   std::uint64_t hash = UINT64_C(14695981039346656037);
+   std::uint64_t bits;
+   const GridFunction *nodes = mesh.GetNodes();
+   if (nodes)
+   {
+      const double *x = nodes->HostRead();
+      for (int i = 0; i < nodes->Size(); i++)
+      {
+         std::memcpy(&bits, x + i, sizeof(bits));
+         hash = (hash ^ bits) * UINT64_C(1099511628211);
+      }
+   }
+   else
+   {
+      const int sdim = mesh.SpaceDimension();
+      for (int i = 0; i < mesh.GetNV(); i++)
+      {
+         const double *v = mesh.GetVertex(i);
+         for (int d = 0; d < sdim; d++)
+         {
+            std::memcpy(&bits, v + d, sizeof(bits));
+            hash = (hash ^ bits) * UINT64_C(1099511628211);
+         }
+      }
+   }
+   return hash;
+}
+
+void ElementBoxTree::SetElementCenters(Mesh &mesh)
+{
+   const int sdim = mesh.SpaceDimension();
+   const int ne = mesh.GetNE();
+   centers.SetSize(sdim*ne);
+   Vector center;
+   for (int i = 0; i < ne; i++)
+   {
+      center.SetDataAndSize(centers.GetData() + sdim*i, sdim);
+      mesh.GetElementTransformation(i)->Transform(
+         Geometries.GetCenter(mesh.GetElementBaseGeometry(i)), center);
+   }
+}
+
+const Table &ElementBoxTree::GetVertexToElementTable(Mesh &mesh)
+{
+   if (vert_elem.Size() <= 0)
+   {
+      Table *vtoel = mesh.GetVertexToElementTable();
+      vert_elem.Swap(*vtoel);
+      delete vtoel;
+   }
+   return vert_elem;
+}
+
+void ElementBoxTree::Update(Mesh &mesh)
+{
+   if (mesh.GetNE() == 0)
+   {
+      Clear();
+   }
+   else if (mesh.GetSequence() != sequence || mesh.GetNE() != num_elements ||
+            mesh.SpaceDimension() != dim)
+   {
+      Array<double> bbox;
+      GetElementBoxes(mesh, bbox);
+      Build(mesh.SpaceDimension(), bbox);
+      SetElementCenters(mesh);
+      vert_elem.Clear();
+      sequence = mesh.GetSequence();
+      num_elements = mesh.GetNE();
+      checksum = CoordinatesChecksum(mesh);
+   }
+   else
+   {
+      // The checksum detects the modifications of the coordinates that were
+      // not reported with NodesMoved()
+      const std::uint64_t cs = CoordinatesChecksum(mesh);
+      if (moved || cs != checksum)
+      {
+         Array<double> bbox;
+         GetElementBoxes(mesh, bbox);
+         Refit(bbox);
+         SetElementCenters(mesh);
+         checksum = cs;
+      }
+   }
+   moved = false;
+}
+
+} // namespace mfem
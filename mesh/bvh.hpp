@@ -0,0 +1,153 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BVH
+#define MFEM_BVH
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../general/table.hpp"
+
+#include <cstdint>
+
+namespace mfem
+{
+
+class Mesh;
+
+/** @brief Bounding volume hierarchy: a binary tree of axis-aligned bounding
+    boxes, used to find the boxes containing a point in logarithmic time. */
+/** A box is given by its 2*dim coordinates: the minimum in each direction,
+    followed by the maximum in each direction. The tree is built by recursive
+    median splits of the box centers along the longest direction, with up to
+    4 boxes in each leaf. The nodes are stored in depth-first order. */
+class BoundingBoxTree
+{
+protected:
+   static const int max_leaf_size = 4;
+
+   int dim;
+   Array<double> boxes;    ///< The input boxes, 2*dim values per box
+   Array<int> ids;         ///< Box indices, ordered by the tree leaves
+   Array<double> node_box; ///< Bounding box of each node
+   /// First entry in @a ids and number of boxes of each node
+   Array<int> node_first, node_size;
+   /// Right child of each node, or -1 for leaves; the left child is node+1
+   Array<int> node_right;
+
+   int BuildNode(int first, int size, const Array<double> &centers);
+   void RefitNodes();
+
+public:
+   BoundingBoxTree() : dim(0) { }
+
+   /** @brief Build the tree of the boxes in @a bbox, with 2*@a dim_
+       coordinates per box. */
+   void Build(int dim_, const Array<double> &bbox);
+
+   /** @brief Update the boxes, keeping the structure of the tree, e.g. when
+       the boxes move. */
+   /** The number of boxes must not change. The queries remain exact, but the
+       tree may become less efficient after large motions. */
+   void Refit(const Array<double> &bbox);
+
+   /// Remove all the boxes.
+   void Clear();
+
+   /// Return the space dimension of the boxes.
+   int Dimension() const { return dim; }
+
+   /// Return the number of boxes.
+   int GetNBoxes() const { return ids.Size(); }
+
+   /// Return the number of nodes of the tree.
+   int GetNNodes() const { return node_right.Size(); }
+
+   /// Set @a found to the indices of the boxes that contain the point @a x.
+   void FindBoxes(const double *x, Array<int> &found) const;
+
+   /** @brief Set @a bbox to the boxes of the nodes at the given @a depth of
+       the tree, and of the leaves above it. */
+   /** These boxes cover all the boxes of the tree; with depth 0, @a bbox is
+       the bounding box of all the boxes. */
+   void GetNodeBoxes(int depth, Array<double> &bbox) const;
+};
+
+
+/** @brief Bounding volume hierarchy of the elements of a Mesh, used for point
+    location by Mesh::FindPoints(). */
+/** The box of an element without mesh nodes is the bounding box of its
+    vertices. For meshes with nodes, e.g. curved high-order meshes, it is the
+    bounding box of the element transformation sampled on a refined grid,
+    enlarged by a relative padding to account for the parts of the element
+    between the samples. */
+class ElementBoxTree : public BoundingBoxTree
+{
+protected:
+   long sequence;
+   int num_elements;
+   bool moved;
+   std::uint64_t checksum; ///< Checksum of the coordinates of the boxes
+   double padding;
+   Array<double> centers;  ///< Element centers, sdim values per element
+   Table vert_elem;        ///< Vertex-to-element table, built on demand
+
+   void GetElementBoxes(Mesh &mesh, Array<double> &bbox) const;
+
+   /// Compute the centers of the elements of @a mesh.
+   void SetElementCenters(Mesh &mesh);
+
+   /** @brief Return a checksum of the node coordinates of @a mesh, or of its
+       vertex coordinates if it has no nodes. */
+   static std::uint64_t CoordinatesChecksum(const Mesh &mesh);
+
+public:
+   ElementBoxTree()
+      : sequence(-1), num_elements(-1), moved(false), checksum(0),
+        padding(0.05) { }
+
+   /** @brief Build the tree for the elements of @a mesh, or update it after
+       the mesh nodes have moved. */
+   /** The tree is rebuilt when the Mesh::GetSequence() or the number of
+       elements change. Otherwise, it is refitted if the nodes moved: after
+       NodesMoved(), or when the checksum of the coordinates changed, e.g.
+       after a modification through Mesh::GetNodes(). */
+   void Update(Mesh &mesh);
+
+   /// Mark the boxes for update by the next call to Update().
+   void NodesMoved() { moved = true; }
+
+   /// Remove all the boxes; the tree will be rebuilt by Update().
+   void Clear()
+   {
+      BoundingBoxTree::Clear();
+      sequence = -1;
+      centers.SetSize(0);
+      vert_elem.Clear();
+   }
+
+   /** @brief Return the centers of the elements, mapped from the reference
+       element centers, with Dimension() values per element. */
+   /** They are updated with the boxes by Update(). */
+   const Array<double> &GetElementCenters() const { return centers; }
+
+   /** @brief Return the vertex-to-element table of @a mesh, built on the first
+       call after the tree was (re)built by Update(). */
+   const Table &GetVertexToElementTable(Mesh &mesh);
+
+   /** @brief Set the relative padding of the boxes of curved elements; the
+       default is 0.05. */
+   void SetPadding(double pad) { padding = pad; Clear(); }
+};
+
+} // namespace mfem
+
+#endif
@@ -5837,6 +5837,7 @@ void Mesh::MoveVertices(const Vector &displacements)
       {
          vertices[i](j) += displacements(j*nv+i);
       }
+   NodesUpdated();
 }
 
 void Mesh::GetVertices(Vector &vert_coord) const
@@ -5857,6 +5858,7 @@ void Mesh::SetVertices(const Vector &vert_coord)
       {
          vertices[i](j) = vert_coord(j*nv+i);
       }
+   NodesUpdated();
 }
 
 void Mesh::GetNode(int i, double *coord) const
@@ -5896,6 +5898,7 @@ void Mesh::SetNode(int i, const double *coord)
       }
 
    }
+   NodesUpdated();
 }
 
 void Mesh::MoveNodes(const Vector &displacements)
@@ -5903,6 +5906,7 @@ void Mesh::MoveNodes(const Vector &displacements)
    if (Nodes)
    {
       (*Nodes) += displacements;
+      NodesUpdated();
    }
    else
    {
@@ -5927,6 +5931,7 @@ void Mesh::SetNodes(const Vector &node_coord)
    if (Nodes)
    {
       (*Nodes) = node_coord;
+      NodesUpdated();
    }
    else
    {
@@ -5946,12 +5951,14 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
       delete NURBSext;
       NURBSext = nodes.FESpace()->StealNURBSext();
    }
+   NodesUpdated();
 }
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
+   NodesUpdated();
    // TODO:
    // if (nodes)
    //    nodes->FESpace()->MakeNURBSextOwner();
@@ -7204,6 +7211,8 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
    mfem::Swap(bdr_attributes, other.bdr_attributes);
 
    mfem::Swap(geom_factors, other.geom_factors);
+   elem_box_tree.Clear();
+   other.elem_box_tree.Clear();
 
    if (non_geometry)
    {
@@ -9297,6 +9306,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
       xnew.ProjectCoefficient(f_pert);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::Transform(VectorCoefficient &deformation)
@@ -9321,6 +9331,7 @@ void Mesh::Transform(VectorCoefficient &deformation)
       xnew.ProjectCoefficient(deformation);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::RemoveUnusedVertices()
@@ -9559,94 +9570,103 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    InverseElementTransformation *inv_tr = inv_trans;
    inv_tr = inv_tr ? inv_tr : new InverseElementTransformation;
 
-   // For each point in 'point_mat', find the element whose center is closest.
-   Vector min_dist(npts);
-   Array<int> e_idx(npts);
-   min_dist = std::numeric_limits<double>::max();
-   e_idx = -1;
-
-   Vector pt(spaceDim);
-   for (int i = 0; i < GetNE(); i++)
+   // For each point in 'point_mat', try the elements whose bounding boxes
+   // contain it, found in the bounding volume hierarchy of the elements.
+   const BoundingBoxTree &tree = GetElementBoxTree();
+   int pts_found = 0;
+   Array<int> cand;
+   Vector pt(NULL, spaceDim);
+   for (int k = 0; k < npts; k++)
    {
-      GetElementTransformation(i)->Transform(
-         Geometries.GetCenter(GetElementBaseGeometry(i)), pt);
-      for (int k = 0; k < npts; k++)
+      pt.SetData(data+k*spaceDim);
+      tree.FindBoxes(pt.GetData(), cand);
+      for (int e = 0; e < cand.Size(); e++)
       {
-         double dist = pt.DistanceTo(data+k*spaceDim);
-         if (dist < min_dist(k))
+         inv_tr->SetTransformation(*GetElementTransformation(cand[e]));
+         int res = inv_tr->Transform(pt, ips[k]);
+         if (res == InverseElementTransformation::Inside)
          {
-            min_dist(k) = dist;
-            e_idx[k] = i;
+            elem_ids[k] = cand[e];
+            pts_found++;
+            break;
          }
       }
    }
 
-   // Checks if the points lie in the closest element
-   int pts_found = 0;
-   pt.NewDataAndSize(NULL, spaceDim);
-   for (int k = 0; k < npts; k++)
+   // Some points inside the bounding box of the mesh may not be found, e.g. in
+   // curved elements extending beyond their padded boxes. For these, try the
+   // element whose center is the closest, its vertex neighbors and, for
+   // non-conforming meshes, its neighbors in the NCMesh.
+   Array<int> missing;
+   if (pts_found != npts)
    {
-      pt.SetData(data+k*spaceDim);
-      inv_tr->SetTransformation(*GetElementTransformation(e_idx[k]));
-      int res = inv_tr->Transform(pt, ips[k]);
-      if (res == InverseElementTransformation::Inside)
+      Array<double> root;
+      tree.GetNodeBoxes(0, root);
+      for (int k = 0; k < npts; k++)
       {
-         elem_ids[k] = e_idx[k];
-         pts_found++;
+         if (elem_ids[k] != -1) { continue; }
+         const double *x = data+k*spaceDim;
+         bool inside = true;
+         for (int d = 0; d < spaceDim; d++)
+         {
+            inside = inside && root[d] <= x[d] && x[d] <= root[spaceDim+d];
+         }
+         if (inside) { missing.Append(k); }
       }
    }
-   if (pts_found != npts)
+   if (missing.Size() > 0)
    {
-      Array<int> vertices;
-      Table *vtoel = GetVertexToElementTable();
-      for (int k = 0; k < npts; k++)
+      const Array<double> &centers = elem_box_tree.GetElementCenters();
+      const Table &vtoel = elem_box_tree.GetVertexToElementTable(*this);
+      Array<int> vertices, neigh;
+      for (int m = 0; m < missing.Size(); m++)
       {
-         if (elem_ids[k] != -1) { continue; }
-         // Try all vertex-neighbors of element e_idx[k]
+         const int k = missing[m];
          pt.SetData(data+k*spaceDim);
-         GetElementVertices(e_idx[k], vertices);
+         int e_min = 0;
+         double d_min = std::numeric_limits<double>::max();
+         for (int i = 0; i < GetNE(); i++)
+         {
+            const double dist = pt.DistanceTo(centers.GetData() + spaceDim*i);
+            if (dist < d_min) { d_min = dist; e_min = i; }
+         }
+         cand.SetSize(1);
+         cand[0] = e_min;
+         GetElementVertices(e_min, vertices);
          for (int v = 0; v < vertices.Size(); v++)
          {
-            int vv = vertices[v];
-            int ne = vtoel->RowSize(vv);
-            const int* els = vtoel->GetRow(vv);
-            for (int e = 0; e < ne; e++)
+            const int *els = vtoel.GetRow(vertices[v]);
+            for (int j = 0; j < vtoel.RowSize(vertices[v]); j++)
             {
-               if (els[e] == e_idx[k]) { continue; }
-               inv_tr->SetTransformation(*GetElementTransformation(els[e]));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = els[e];
-                  pts_found++;
-                  goto next_point;
-               }
+               if (cand.Find(els[j]) == -1) { cand.Append(els[j]); }
             }
          }
-         // Try neighbours for non-conforming meshes
+         // The neighbors across hanging nodes of non-conforming meshes may
+         // not share a vertex with the element
          if (ncmesh)
          {
-            Array<int> neigh;
-            int le = ncmesh->leaf_elements[e_idx[k]];
-            ncmesh->FindNeighbors(le,neigh);
-            for (int e = 0; e < neigh.Size(); e++)
+            neigh.SetSize(0);
+            ncmesh->FindNeighbors(ncmesh->leaf_elements[e_min], neigh);
+            for (int j = 0; j < neigh.Size(); j++)
             {
-               int nn = neigh[e];
+               const int nn = neigh[j];
                if (ncmesh->IsGhost(ncmesh->elements[nn])) { continue; }
-               int el = ncmesh->elements[nn].index;
-               inv_tr->SetTransformation(*GetElementTransformation(el));
-               int res = inv_tr->Transform(pt, ips[k]);
-               if (res == InverseElementTransformation::Inside)
-               {
-                  elem_ids[k] = el;
-                  pts_found++;
-                  goto next_point;
-               }
+               const int el = ncmesh->elements[nn].index;
+               if (cand.Find(el) == -1) { cand.Append(el); }
+            }
+         }
+         for (int e = 0; e < cand.Size(); e++)
+         {
+            inv_tr->SetTransformation(*GetElementTransformation(cand[e]));
+            int res = inv_tr->Transform(pt, ips[k]);
+            if (res == InverseElementTransformation::Inside)
+            {
+               elem_ids[k] = cand[e];
+               pts_found++;
+               break;
             }
          }
-      next_point: ;
       }
-      delete vtoel;
    }
    if (inv_trans == NULL) { delete inv_tr; }
 
@@ -9673,10 +9693,13 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
    const int ND   = fe->GetDof();
    const int NQ   = ir.GetNPoints();
 
+   const QuadratureInterpolator *qi = fespace->GetQuadratureInterpolator(ir);
+   // The tensor product evaluation requires the lexicographic ordering
+   const ElementDofOrdering e_ordering = qi->UsesTensorProducts() ?
+                                         ElementDofOrdering::LEXICOGRAPHIC :
+                                         ElementDofOrdering::NATIVE;
    Vector Enodes(vdim*ND*NE);
-   // For now, we are not using tensor product evaluation
-   const Operator *elem_restr = fespace->GetElementRestriction(
-                                   ElementDofOrdering::NATIVE);
+   const Operator *elem_restr = fespace->GetElementRestriction(e_ordering);
    elem_restr->Mult(*nodes, Enodes);
 
    unsigned eval_flags = 0;
@@ -9696,9 +9719,6 @@ GeometricFactors::GeometricFactors(const Mesh *mesh, const IntegrationRule &ir,
       eval_flags |= QuadratureInterpolator::DETERMINANTS;
    }
 
-   const QuadratureInterpolator *qi = fespace->GetQuadratureInterpolator(ir);
-   // For now, we are not using tensor product evaluation (not implemented)
-   qi->DisableTensorProducts();
    qi->Mult(Enodes, eval_flags, X, J, detJ);
 }
 
@@ -19,6 +19,7 @@
 #include "tetrahedron.hpp"
 #include "vertex.hpp"
 #include "ncmesh.hpp"
+#include "bvh.hpp"
 #include "../fem/eltrans.hpp"
 #include "../fem/coefficient.hpp"
 #include "../general/gzstream.hpp"
@@ -190,6 +191,9 @@ public:
 protected:
    Operation last_operation;
 
+   /// Element bounding boxes for point location, see GetElementBoxTree().
+   ElementBoxTree elem_box_tree;
+
    void Init();
    void InitTables();
    void SetEmpty();  // Init all data members with empty values
@@ -1019,6 +1023,14 @@ public:
    void GetNodes(Vector &node_coord) const;
    void SetNodes(const Vector &node_coord);
 
+   /** @brief Notify the Mesh that its nodes or vertices were modified
+       directly, e.g. through GetNodes(), so that the element bounding boxes
+       used by FindPoints() are updated. */
+   /** The methods of Mesh that move the nodes or vertices call it. Direct
+       modifications are also detected by FindPoints() with a checksum of the
+       coordinates, so calling this method is optional. */
+   void NodesUpdated() { elem_box_tree.NodesMoved(); }
+
    /// Return a pointer to the internal node GridFunction (may be NULL).
    GridFunction *GetNodes() { return Nodes; }
    const GridFunction *GetNodes() const { return Nodes; }
@@ -1207,6 +1219,12 @@ public:
    /** For high-order meshes, the geometry is first refined @a ref times. */
    void GetBoundingBox(Vector &min, Vector &max, int ref = 2);
 
+   /** @brief Return the bounding volume hierarchy of the elements, built on
+       first use and updated after mesh refinement and mesh motion. */
+   /** The indices of the boxes are the element indices. */
+   const BoundingBoxTree &GetElementBoxTree()
+   { elem_box_tree.Update(*this); return elem_box_tree; }
+
    void GetCharacteristics(double &h_min, double &h_max,
                            double &kappa_min, double &kappa_max,
                            Vector *Vh = NULL, Vector *Vk = NULL);
@@ -1241,6 +1259,14 @@ public:
        The DenseMatrix @a point_mat describes the given points - one point for
        each column; it should have SpaceDimension() rows.
 
+       The candidate elements of each point are the elements whose bounding
+       boxes contain it, found in logarithmic time with GetElementBoxTree().
+       The boxes are updated when the nodes or vertices change. For the points
+       inside the bounding box of the mesh that are not found in these
+       elements, the element whose center is the closest, its vertex neighbors
+       and, for non-conforming meshes, its neighbors in the NCMesh are tried.
+       The element centers are cached with the boxes.
+
        The InverseElementTransformation object, @a inv_trans, is used to attempt
        the element transformation inversion. If NULL pointer is given, the
        method will use a default constructed InverseElementTransformation. Note
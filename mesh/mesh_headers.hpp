@@ -23,6 +23,7 @@
 #include "hexahedron.hpp"
 #include "tetrahedron.hpp"
 #include "ncmesh.hpp"
+#include "bvh.hpp"
 #include "mesh.hpp"
 #include "mesh_operators.hpp"
 #include "nurbs.hpp"
@@ -5253,6 +5253,141 @@ int ParMesh::FindPoints(DenseMatrix& point_mat, Array<int>& elem_id,
    return pts_found;
 }
 
+int ParMesh::FindPointsDistributed(const DenseMatrix &point_mat,
+                                   Array<int> &ranks, Array<int> &elem_ids,
+                                   Array<IntegrationPoint> &ips, bool warn)
+{
+   const int sdim = spaceDim;
+   const int npts = point_mat.Width();
+   MFEM_VERIFY(npts == 0 || point_mat.Height() == sdim,
+               "Invalid points matrix");
+   ranks.SetSize(npts);
+   elem_ids.SetSize(npts);
+   ips.SetSize(npts);
+   ranks = -1;
+   elem_ids = -1;
+
+   // Global coarse index: the boxes of the first levels of the element box
+   // trees of all the ranks, with their owning ranks
+   const int coarse_depth = 3;
+   Array<double> my_boxes;
+   GetElementBoxTree().GetNodeBoxes(coarse_depth, my_boxes);
+   int my_size = my_boxes.Size();
+   Array<int> box_cnt(NRanks), box_displ(NRanks+1);
+   MPI_Allgather(&my_size, 1, MPI_INT, box_cnt.GetData(), 1, MPI_INT, MyComm);
+   box_displ[0] = 0;
+   for (int r = 0; r < NRanks; r++)
+   {
+      box_displ[r+1] = box_displ[r] + box_cnt[r];
+   }
+   Array<double> all_boxes(box_displ[NRanks]);
+   MPI_Allgatherv(my_boxes.GetData(), my_size, MPI_DOUBLE,
+                  all_boxes.GetData(), box_cnt.GetData(),
+                  box_displ.GetData(), MPI_DOUBLE, MyComm);
+   Array<int> box_rank(all_boxes.Size()/(2*sdim));
+   for (int r = 0; r < NRanks; r++)
+   {
+      for (int b = box_displ[r]/(2*sdim); b < box_displ[r+1]/(2*sdim); b++)
+      {
+         box_rank[b] = r;
+      }
+   }
+   BoundingBoxTree coarse_index;
+   coarse_index.Build(sdim, all_boxes);
+
+   // Send each point to the candidate ranks, sorted by rank
+   Array<Pair<int,int> > send; // (rank, local point)
+   Array<int> boxes, cand_ranks;
+   for (int k = 0; k < npts; k++)
+   {
+      coarse_index.FindBoxes(&point_mat(0,k), boxes);
+      cand_ranks.SetSize(boxes.Size());
+      for (int b = 0; b < boxes.Size(); b++)
+      {
+         cand_ranks[b] = box_rank[boxes[b]];
+      }
+      cand_ranks.Sort();
+      cand_ranks.Unique();
+      for (int i = 0; i < cand_ranks.Size(); i++)
+      {
+         send.Append(Pair<int,int>(cand_ranks[i], k));
+      }
+   }
+   SortPairs<int,int>(send, send.Size());
+
+   const int nsend = send.Size();
+   Array<int> send_cnt(NRanks), recv_cnt(NRanks);
+   send_cnt = 0;
+   for (int i = 0; i < nsend; i++) { send_cnt[send[i].one]++; }
+   MPI_Alltoall(send_cnt.GetData(), 1, MPI_INT, recv_cnt.GetData(), 1, MPI_INT,
+                MyComm);
+
+   // Counts and displacements of the messages with m values per point
+   Array<int> scnt(NRanks), sdsp(NRanks), rcnt(NRanks), rdsp(NRanks);
+   int nrecv = 0;
+   for (int r = 0; r < NRanks; r++) { nrecv += recv_cnt[r]; }
+   auto set_counts = [&](int m)
+   {
+      for (int r = 0; r < NRanks; r++)
+      {
+         scnt[r] = m*send_cnt[r];
+         rcnt[r] = m*recv_cnt[r];
+         sdsp[r] = (r == 0) ? 0 : sdsp[r-1] + scnt[r-1];
+         rdsp[r] = (r == 0) ? 0 : rdsp[r-1] + rcnt[r-1];
+      }
+   };
+
+   Array<double> send_pts(sdim*nsend);
+   for (int i = 0; i < nsend; i++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         send_pts[sdim*i+d] = point_mat(d, send[i].two);
+      }
+   }
+   DenseMatrix recv_pts(sdim, nrecv);
+   set_counts(sdim);
+   MPI_Alltoallv(send_pts.GetData(), scnt.GetData(), sdsp.GetData(),
+                 MPI_DOUBLE, recv_pts.Data(), rcnt.GetData(), rdsp.GetData(),
+                 MPI_DOUBLE, MyComm);
+
+   // Locate the received points in the local elements and send back the
+   // element index and the reference coordinates
+   Array<int> recv_elem;
+   Array<IntegrationPoint> recv_ips;
+   if (nrecv > 0) { Mesh::FindPoints(recv_pts, recv_elem, recv_ips, false); }
+   Array<double> send_res(4*nrecv), recv_res(4*nsend);
+   for (int i = 0; i < nrecv; i++)
+   {
+      send_res[4*i+0] = recv_elem[i];
+      send_res[4*i+1] = recv_ips[i].x;
+      send_res[4*i+2] = recv_ips[i].y;
+      send_res[4*i+3] = recv_ips[i].z;
+   }
+   set_counts(4);
+   MPI_Alltoallv(send_res.GetData(), rcnt.GetData(), rdsp.GetData(),
+                 MPI_DOUBLE, recv_res.GetData(), scnt.GetData(),
+                 sdsp.GetData(), MPI_DOUBLE, MyComm);
+
+   // The results are in increasing rank order for each point
+   int pts_found = 0;
+   for (int i = 0; i < nsend; i++)
+   {
+      const int k = send[i].two;
+      const int el = (int)recv_res[4*i];
+      if (ranks[k] >= 0 || el < 0) { continue; }
+      ranks[k] = send[i].one;
+      elem_ids[k] = el;
+      ips[k].Set3(&recv_res[4*i+1]);
+      pts_found++;
+   }
+   if (warn && pts_found != npts)
+   {
+      MFEM_WARNING((npts-pts_found) << " points were not found");
+   }
+   return pts_found;
+}
+
 static void PrintVertex(const Vertex &v, int space_dim, ostream &out)
 {
    out << v(0);
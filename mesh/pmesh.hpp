@@ -332,6 +332,23 @@ public:
                           Array<IntegrationPoint>& ips, bool warn = true,
                           InverseElementTransformation *inv_trans = NULL);
 
+   /** @brief Find the points of @a point_mat, which may be different on each
+       rank, on the ranks that own them. */
+   /** Each rank contributes the boxes of the first levels of its element box
+       tree, see Mesh::GetElementBoxTree(), to a global coarse index, and the
+       points are sent only to the ranks with a coarse box that contains them.
+
+       For the local point k, @a ranks[k] is the lowest rank that found it,
+       @a elem_ids[k] is the index of the element in that rank and @a ips[k]
+       are the reference coordinates in the element. For the points that were
+       not found, @a ranks[k] and @a elem_ids[k] are set to -1.
+
+       This is a collective call. @returns The number of local points that
+       were found. */
+   int FindPointsDistributed(const DenseMatrix &point_mat, Array<int> &ranks,
+                             Array<int> &elem_ids,
+                             Array<IntegrationPoint> &ips, bool warn = true);
+
    /// Debugging method
    void PrintSharedEntities(const char *fname_prefix) const;
 
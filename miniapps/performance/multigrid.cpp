@@ -0,0 +1,176 @@
+//                   MFEM Multigrid Miniapp - Geometric Multigrid
+//
+// Compile with: make multigrid
+//
+// Sample runs:  multigrid -m ../../data/star.mesh -gr 2 -or 2
+//               multigrid -m ../../data/fichera.mesh -gr 1 -or 2
+//               multigrid -m ../../data/beam-hex.mesh -r 1 -gr 0 -or 3
+//               multigrid -m ../../data/inline-quad.mesh -r 2 -gr 3 -or 0
+//
+// Description:  This miniapp solves the Laplace problem -Delta u = 1 with
+//               homogeneous Dirichlet boundary conditions using CG
+//               preconditioned with a geometric multigrid V-cycle. The
+//               multigrid hierarchy starts from a linear (order 1) space on the
+//               initial mesh, adds a number of uniformly refined levels
+//               (h-multigrid), followed by a number of levels where the
+//               polynomial order is doubled (p-multigrid).
+//
+//               All levels except the coarsest one use partial assembly and
+//               Chebyshev smoothing based on the PA diagonal, so the memory
+//               footprint is that of the matrix-free operators. The coarsest
+//               level is fully assembled and solved with CG+GS.
+//
+//               The setup time of each level and the iteration count and time
+//               of the solve are reported, which allows studying the h- and
+//               p-independence of the convergence.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace mfem;
+
+// Geometric multigrid for the diffusion (Laplace) operator
+class DiffusionMultigrid : public GeometricMultigrid
+{
+private:
+   ConstantCoefficient one;
+
+   virtual void AddIntegrators(BilinearForm &form)
+   {
+      form.AddDomainIntegrator(new DiffusionIntegrator(one));
+   }
+
+public:
+   DiffusionMultigrid(FiniteElementSpaceHierarchy &fespaces,
+                      const Array<int> &ess_bdr)
+      : GeometricMultigrid(fespaces, ess_bdr), one(1.0) { }
+};
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/star.mesh";
+   int ref_levels = 0;
+   int geometric_refinements = 2;
+   int order_refinements = 2;
+   int smoother_order = 2;
+   bool wcycle = false;
+   const char *device_config = "cpu";
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of uniform refinements of the coarsest mesh.");
+   args.AddOption(&geometric_refinements, "-gr", "--geometric-refinements",
+                  "Number of geometric (h-) multigrid levels.");
+   args.AddOption(&order_refinements, "-or", "--order-refinements",
+                  "Number of order (p-) multigrid levels; the order is doubled"
+                  " on each level.");
+   args.AddOption(&smoother_order, "-so", "--smoother-order",
+                  "Order of the Chebyshev smoothers.");
+   args.AddOption(&wcycle, "-w", "--w-cycle", "-v", "--v-cycle",
+                  "Use W-cycles instead of V-cycles.");
+   args.AddOption(&device_config, "-d", "--device",
+                  "Device configuration string, see Device::Configure().");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 2. Enable hardware devices such as GPUs, and programming models such as
+   //    CUDA, OCCA, RAJA and OpenMP based on command line options.
+   Device device(device_config);
+   device.Print();
+
+   // 3. Read the mesh and refine it to obtain the coarsest mesh.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   const int dim = mesh->Dimension();
+   for (int l = 0; l < ref_levels; l++)
+   {
+      mesh->UniformRefinement();
+   }
+
+   // 4. Define the multigrid hierarchy of finite element spaces, starting
+   //    with a linear space on the coarsest mesh.
+   FiniteElementCollection *coarse_fec = new H1_FECollection(1, dim);
+   FiniteElementSpace *coarse_fespace = new FiniteElementSpace(mesh,
+                                                               coarse_fec);
+   FiniteElementSpaceHierarchy fespaces(mesh, coarse_fespace, true, true);
+   for (int l = 0; l < geometric_refinements; l++)
+   {
+      fespaces.AddUniformlyRefinedLevel();
+   }
+   int order = 1;
+   for (int l = 0; l < order_refinements; l++)
+   {
+      order *= 2;
+      fespaces.AddOrderRefinedLevel(new H1_FECollection(order, dim));
+   }
+   FiniteElementSpace &fespace = fespaces.GetFinestFESpace();
+   cout << "Number of levels:              " << fespaces.GetNumLevels()
+        << "\nNumber of finite element unknowns: " << fespace.GetTrueVSize()
+        << endl;
+
+   // 5. Set up the linear form b(.) and the grid function x on the finest
+   //    level.
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fespace);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   GridFunction x(&fespace);
+   x = 0.0;
+
+   // 6. Assemble the multigrid levels, measuring the setup time per level.
+   Array<int> ess_bdr(mesh->bdr_attributes.Max());
+   ess_bdr = 1;
+   DiffusionMultigrid M(fespaces, ess_bdr);
+   M.SetSmootherOrder(smoother_order);
+   if (wcycle) { M.SetCycleType(Multigrid::WCYCLE); }
+
+   StopWatch timer;
+   double setup_time = 0.0;
+   for (int l = 0; l < fespaces.GetNumLevels(); l++)
+   {
+      timer.Clear();
+      timer.Start();
+      M.AssembleLevel(l);
+      timer.Stop();
+      setup_time += timer.RealTime();
+      cout << "Level " << l << ": order "
+           << fespaces.GetFESpaceAtLevel(l).GetOrder(0) << ", "
+           << fespaces.GetFESpaceAtLevel(l).GetTrueVSize()
+           << " unknowns, setup time " << timer.RealTime() << " s" << endl;
+   }
+   cout << "Total setup time: " << setup_time << " s" << endl;
+
+   // 7. Solve the linear system A X = B with CG preconditioned by multigrid.
+   OperatorHandle A;
+   Vector X, B;
+   M.FormFineLinearSystem(x, b, A, X, B);
+
+   CGSolver cg;
+   cg.SetRelTol(1e-12);
+   cg.SetMaxIter(2000);
+   cg.SetPrintLevel(1);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(M);
+
+   timer.Clear();
+   timer.Start();
+   cg.Mult(B, X);
+   timer.Stop();
+   cout << "CG iterations: " << cg.GetNumIterations()
+        << ", solve time: " << timer.RealTime() << " s" << endl;
+
+   // 8. Recover the solution as a finite element grid function.
+   M.RecoverFineFEMSolution(X, b, x);
+
+   return cg.GetConverged() ? 0 : 1;
+}
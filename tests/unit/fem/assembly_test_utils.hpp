@@ -0,0 +1,107 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_ASSEMBLY_TEST_UTILS
+#define MFEM_ASSEMBLY_TEST_UTILS
+
+// Common data and checks of the tests of the assembly levels (partial,
+// element and matrix-free assembly) against full assembly.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+namespace assembly_test
+{
+
+using namespace mfem;
+
+/// Variable coefficient of the integrators.
+inline double coeffFunction(const Vector &x)
+{
+   return 2.0 + x(0) * x(0) + 0.5 * x(1);
+}
+
+/// Perturbation of the unit square or cube, vanishing on its boundary.
+inline void perturbation(const Vector &x, Vector &p)
+{
+   p = 0.0;
+   const double s = x(0) * (1.0 - x(0)) * x(1) * (1.0 - x(1));
+   p(0) = 0.3 * s;
+   p(1) = -0.2 * s;
+}
+
+/** Return a perturbed Cartesian mesh of the unit square or cube with @a ne
+    elements in each direction, so that the Jacobians are not constant. With
+    @a mesh_order > 0, the mesh has nodes of that order and its elements are
+    curved; otherwise the vertices are moved. */
+inline Mesh *MakePerturbedMesh(int dim, int ne = 2, int mesh_order = 0)
+{
+   Mesh *mesh;
+   if (dim == 2)
+   {
+      mesh = new Mesh(ne, ne, Element::QUADRILATERAL, 1, 1.0, 1.0);
+   }
+   else
+   {
+      mesh = new Mesh(ne, ne, ne, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+   }
+   if (mesh_order > 0)
+   {
+      mesh->SetCurvature(mesh_order);
+      VectorFunctionCoefficient pert(dim, perturbation);
+      GridFunction dx(mesh->GetNodes()->FESpace());
+      dx.ProjectCoefficient(pert);
+      *mesh->GetNodes() += dx;
+   }
+   else
+   {
+      Vector p(dim);
+      for (int i = 0; i < mesh->GetNV(); i++)
+      {
+         Vector v(mesh->GetVertex(i), dim);
+         perturbation(v, p);
+         v += p;
+      }
+   }
+   return mesh;
+}
+
+/** Compare the action and the diagonal of @a form, using any assembly level,
+    with those of the fully assembled @a faform. Both forms are assembled. */
+inline void CompareForms(BilinearForm &form, BilinearForm &faform)
+{
+   form.Assemble();
+   faform.Assemble();
+   faform.Finalize();
+   const SparseMatrix &A = faform.SpMat();
+   const int n = A.Height();
+
+   Array<int> ess_tdof_list;
+   OperatorHandle op;
+   form.FormSystemMatrix(ess_tdof_list, op);
+
+   Vector x(n), y(n), fa_y(n);
+   x.Randomize(1);
+   op->Mult(x, y);
+   A.Mult(x, fa_y);
+   y -= fa_y;
+   REQUIRE(y.Normlinf() < 1.e-12 * fa_y.Normlinf());
+
+   Vector diag(n), fa_diag(n);
+   form.AssembleDiagonal(diag);
+   A.GetDiag(fa_diag);
+   diag -= fa_diag;
+   REQUIRE(diag.Normlinf() < 1.e-12 * fa_diag.Normlinf());
+}
+
+} // namespace assembly_test
+
+#endif
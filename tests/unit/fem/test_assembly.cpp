@@ -0,0 +1,284 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace assembly
+{
+
+static double coeffFunction(const Vector &x)
+{
+   return 1.0 + x(0) * x(0) + 0.5 * x(1);
+}
+
+static void vectorFunction(const Vector &x, Vector &v)
+{
+   v = 0.0;
+   v(0) = 1.0 + x(1);
+   v(1) = -0.5 + x(0) * x(0);
+}
+
+// Check that the elements of each color do not share any dofs
+static void CheckColoring(const FiniteElementSpace &fes, bool bdr)
+{
+   const Array<int> *offsets, *elements;
+   fes.GetElementColoring(offsets, elements, bdr);
+   const int ne = bdr ? fes.GetNBE() : fes.GetNE();
+   REQUIRE(offsets->Last() == ne);
+
+   Array<int> owner(fes.GetNDofs()), dofs, count(ne);
+   count = 0;
+   for (int c = 0; c < offsets->Size() - 1; c++)
+   {
+      owner = -1;
+      for (int j = (*offsets)[c]; j < (*offsets)[c+1]; j++)
+      {
+         const int e = (*elements)[j];
+         count[e]++;
+         if (bdr) { fes.GetBdrElementDofs(e, dofs); }
+         else { fes.GetElementDofs(e, dofs); }
+         for (int d = 0; d < dofs.Size(); d++)
+         {
+            const int dof = (dofs[d] >= 0) ? dofs[d] : -1 - dofs[d];
+            REQUIRE((owner[dof] == -1 || owner[dof] == e));
+            owner[dof] = e;
+         }
+      }
+   }
+   for (int e = 0; e < ne; e++) { REQUIRE(count[e] == 1); }
+}
+
+// Assemble the form sequentially and with the threaded element loops, and
+// compare the two matrices
+static void CompareAssembly(BilinearForm &a_seq, BilinearForm &a_thr)
+{
+   a_seq.Assemble();
+   a_seq.Finalize();
+   a_thr.EnableThreadedAssembly();
+   a_thr.Assemble();
+   a_thr.Finalize();
+
+   const SparseMatrix &A = a_seq.SpMat(), &B = a_thr.SpMat();
+   const int n = A.Height();
+   REQUIRE(B.Height() == n);
+   Vector x(n), y_seq(n), y_thr(n);
+   x.Randomize(1);
+   A.Mult(x, y_seq);
+   B.Mult(x, y_thr);
+   y_thr -= y_seq;
+   REQUIRE(y_thr.Normlinf() < 1.e-12 * y_seq.Normlinf());
+
+   // Reassembly into the same matrix
+   a_thr.Update();
+   a_thr.Assemble();
+   a_thr.Finalize();
+   a_thr.SpMat().Mult(x, y_thr);
+   y_thr -= y_seq;
+   REQUIRE(y_thr.Normlinf() < 1.e-12 * y_seq.Normlinf());
+}
+
+static void CompareAssembly(LinearForm &b_seq, LinearForm &b_thr)
+{
+   b_seq.Assemble();
+   b_thr.EnableThreadedAssembly();
+   b_thr.Assemble();
+   b_thr -= b_seq;
+   REQUIRE(b_thr.Normlinf() < 1.e-12 * b_seq.Normlinf());
+}
+
+TEST_CASE("Threaded assembly", "[BilinearForm], [LinearForm]")
+{
+   FunctionCoefficient coeff(coeffFunction);
+   VectorFunctionCoefficient vcoeff(2, vectorFunction);
+
+   SECTION("Scalar H1, triangles")
+   {
+      Mesh mesh(4, 3, Element::TRIANGLE, 1, 2.0, 1.5);
+      H1_FECollection fec(3, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      CheckColoring(fes, false);
+      CheckColoring(fes, true);
+
+      BilinearForm a_seq(&fes), a_thr(&fes);
+      for (BilinearForm *a : {&a_seq, &a_thr})
+      {
+         a->AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         a->AddDomainIntegrator(new MassIntegrator);
+         a->AddBoundaryIntegrator(new MassIntegrator(coeff));
+      }
+      CompareAssembly(a_seq, a_thr);
+
+      LinearForm b_seq(&fes), b_thr(&fes);
+      for (LinearForm *b : {&b_seq, &b_thr})
+      {
+         b->AddDomainIntegrator(new DomainLFIntegrator(coeff));
+         b->AddBoundaryIntegrator(new BoundaryLFIntegrator(coeff));
+      }
+      CompareAssembly(b_seq, b_thr);
+   }
+
+   SECTION("Elasticity, hexahedra")
+   {
+      Mesh mesh(3, 2, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+      H1_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec, 3);
+      CheckColoring(fes, false);
+
+      ConstantCoefficient lambda(2.0), mu(1.0);
+      Array<int> bdr(mesh.bdr_attributes.Max());
+      bdr = 0;
+      bdr[0] = 1;
+      BilinearForm a_seq(&fes), a_thr(&fes);
+      for (BilinearForm *a : {&a_seq, &a_thr})
+      {
+         a->AddDomainIntegrator(new ElasticityIntegrator(lambda, mu));
+         a->AddBoundaryIntegrator(new VectorMassIntegrator, bdr);
+      }
+      CompareAssembly(a_seq, a_thr);
+
+      Vector f(3);
+      f = 1.0;
+      VectorConstantCoefficient fcoeff(f);
+      LinearForm b_seq(&fes), b_thr(&fes);
+      for (LinearForm *b : {&b_seq, &b_thr})
+      {
+         b->AddDomainIntegrator(new VectorDomainLFIntegrator(fcoeff));
+         b->AddBoundaryIntegrator(new VectorBoundaryLFIntegrator(fcoeff), bdr);
+      }
+      CompareAssembly(b_seq, b_thr);
+   }
+
+   SECTION("H(curl), signed dofs")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE, 1, 1.0, 1.0);
+      ND_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      CheckColoring(fes, false);
+
+      BilinearForm a_seq(&fes), a_thr(&fes);
+      for (BilinearForm *a : {&a_seq, &a_thr})
+      {
+         a->AddDomainIntegrator(new CurlCurlIntegrator(coeff));
+         a->AddDomainIntegrator(new VectorFEMassIntegrator);
+      }
+      CompareAssembly(a_seq, a_thr);
+
+      LinearForm b_seq(&fes), b_thr(&fes);
+      for (LinearForm *b : {&b_seq, &b_thr})
+      {
+         b->AddDomainIntegrator(new VectorFEDomainLFIntegrator(vcoeff));
+      }
+      CompareAssembly(b_seq, b_thr);
+   }
+}
+
+// Assemble the forms with a varying coefficient @a c, sequentially and reusing
+// the sparsity, and compare the matrices after each reassembly; the last
+// reassemblies also use the threaded element loops
+static void CompareReassembly(BilinearForm &a_seq, BilinearForm &a_reuse,
+                              ConstantCoefficient &c)
+{
+   a_reuse.EnableSparsityReuse();
+   const int n = a_seq.Height();
+   Vector x(n), y_seq(n), y_reuse(n);
+   x.Randomize(1);
+   for (int it = 0; it < 4; it++)
+   {
+      c.constant = 1.0 + it;
+      a_reuse.EnableThreadedAssembly(it >= 2);
+      // Keep the zero entries, which may change in the next iterations
+      a_seq.Update();
+      a_seq.Assemble(0);
+      a_seq.Finalize(0);
+      a_reuse.Update();
+      a_reuse.Assemble();
+      a_reuse.Finalize();
+      REQUIRE(a_reuse.SpMat().Finalized());
+      a_seq.SpMat().Mult(x, y_seq);
+      a_reuse.SpMat().Mult(x, y_reuse);
+      y_reuse -= y_seq;
+      REQUIRE(y_reuse.Normlinf() < 1.e-12 * y_seq.Normlinf());
+   }
+}
+
+TEST_CASE("Sparsity reuse", "[BilinearForm]")
+{
+   ConstantCoefficient c(1.0);
+   FunctionCoefficient coeff(coeffFunction);
+
+   SECTION("Scalar H1, quadrilaterals")
+   {
+      Mesh mesh(3, 4, Element::QUADRILATERAL, 1, 1.0, 2.0);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a_seq(&fes), a_reuse(&fes);
+      for (BilinearForm *a : {&a_seq, &a_reuse})
+      {
+         a->AddDomainIntegrator(new DiffusionIntegrator(c));
+         a->AddBoundaryIntegrator(new MassIntegrator(coeff));
+      }
+      CompareReassembly(a_seq, a_reuse, c);
+   }
+
+   SECTION("Vector H1, tetrahedra")
+   {
+      Mesh mesh(2, 2, 1, Element::TETRAHEDRON, 1, 1.0, 1.0, 1.0);
+      H1_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec, 3, Ordering::byVDIM);
+
+      ConstantCoefficient mu(1.0);
+      BilinearForm a_seq(&fes), a_reuse(&fes);
+      for (BilinearForm *a : {&a_seq, &a_reuse})
+      {
+         a->AddDomainIntegrator(new ElasticityIntegrator(c, mu));
+      }
+      CompareReassembly(a_seq, a_reuse, c);
+   }
+
+   SECTION("H(curl), signed dofs")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE, 1, 1.0, 1.0);
+      ND_FECollection fec(1, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a_seq(&fes), a_reuse(&fes);
+      for (BilinearForm *a : {&a_seq, &a_reuse})
+      {
+         a->AddDomainIntegrator(new CurlCurlIntegrator(c));
+         a->AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+      }
+      CompareReassembly(a_seq, a_reuse, c);
+   }
+
+   SECTION("DG with face integrators")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL, 1, 1.0, 1.0);
+      DG_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      const double sigma = -1.0, kappa = 9.0;
+      BilinearForm a_seq(&fes), a_reuse(&fes);
+      for (BilinearForm *a : {&a_seq, &a_reuse})
+      {
+         a->AddDomainIntegrator(new DiffusionIntegrator(c));
+         a->AddInteriorFaceIntegrator(
+            new DGDiffusionIntegrator(c, sigma, kappa));
+         a->AddBdrFaceIntegrator(new DGDiffusionIntegrator(c, sigma, kappa));
+      }
+      CompareReassembly(a_seq, a_reuse, c);
+   }
+}
+
+} // namespace assembly
@@ -0,0 +1,139 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "assembly_test_utils.hpp"
+
+using namespace mfem;
+using namespace assembly_test;
+
+namespace ea_kernels
+{
+
+static void velocityFunction(const Vector &x, Vector &v)
+{
+   v = 0.0;
+   v(0) = 1.0 + x(1);
+   v(1) = -0.5 + x(0) * x(0);
+}
+
+// Compare the action, the transposed action and the diagonal of the element
+// assembled form with those of the fully assembled one.
+static void CompareEAForms(BilinearForm &eaform, BilinearForm &faform)
+{
+   CompareForms(eaform, faform);
+
+   // The constrained operator does not provide a transpose, so apply the
+   // extension directly (the mesh is conforming, there is no prolongation)
+   const SparseMatrix &A = faform.SpMat();
+   const int n = A.Height();
+   Vector x(n), ea_y(n), fa_y(n);
+   x.Randomize(1);
+   EABilinearFormExtension ea_ext(&eaform);
+   ea_ext.Assemble();
+   ea_ext.MultTranspose(x, ea_y);
+   // The transpose action of a SparseMatrix on device backends requires the
+   // explicit transpose
+   A.BuildTranspose();
+   A.MultTranspose(x, fa_y);
+   ea_y -= fa_y;
+   REQUIRE(ea_y.Normlinf() < 1.e-12 * fa_y.Normlinf());
+}
+
+TEST_CASE("EA mass and diffusion", "[ElementAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int integrator = 0; integrator < 3; ++integrator)
+      {
+         for (int order = 1; order < 5; ++order)
+         {
+            Mesh *mesh = MakePerturbedMesh(dim);
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            FunctionCoefficient coeff(coeffFunction);
+
+            BilinearForm eaform(&fes);
+            BilinearForm faform(&fes);
+            eaform.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+            if (integrator != 1)
+            {
+               eaform.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+               faform.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+            }
+            if (integrator != 0)
+            {
+               eaform.AddDomainIntegrator(new MassIntegrator(coeff));
+               faform.AddDomainIntegrator(new MassIntegrator(coeff));
+            }
+            CompareEAForms(eaform, faform);
+
+            delete mesh;
+         }
+      }
+   }
+}
+
+TEST_CASE("EA non-symmetric and vector integrators", "[ElementAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int order = 1; order < 4; ++order)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim);
+         FunctionCoefficient coeff(coeffFunction);
+
+         SECTION("Convection")
+         {
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            VectorFunctionCoefficient vel(dim, velocityFunction);
+            BilinearForm eaform(&fes);
+            BilinearForm faform(&fes);
+            eaform.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+            eaform.AddDomainIntegrator(new ConvectionIntegrator(vel));
+            faform.AddDomainIntegrator(new ConvectionIntegrator(vel));
+            CompareEAForms(eaform, faform);
+         }
+
+         SECTION("H(curl)")
+         {
+            ND_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            BilinearForm eaform(&fes);
+            BilinearForm faform(&fes);
+            eaform.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+            eaform.AddDomainIntegrator(new CurlCurlIntegrator(coeff));
+            eaform.AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+            faform.AddDomainIntegrator(new CurlCurlIntegrator(coeff));
+            faform.AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+            CompareEAForms(eaform, faform);
+         }
+
+         SECTION("Vector diffusion")
+         {
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec, dim);
+            BilinearForm eaform(&fes);
+            BilinearForm faform(&fes);
+            eaform.SetAssemblyLevel(AssemblyLevel::ELEMENT);
+            eaform.AddDomainIntegrator(new VectorDiffusionIntegrator(coeff));
+            faform.AddDomainIntegrator(new VectorDiffusionIntegrator(coeff));
+            CompareEAForms(eaform, faform);
+         }
+
+         delete mesh;
+      }
+   }
+}
+
+} // namespace ea_kernels
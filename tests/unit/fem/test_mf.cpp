@@ -0,0 +1,64 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "assembly_test_utils.hpp"
+
+using namespace mfem;
+using namespace assembly_test;
+
+namespace mf_kernels
+{
+
+TEST_CASE("MF mass and diffusion", "[MatrixFree]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      // A mesh order of 0 gives a mesh without nodes
+      for (int mesh_order = 0; mesh_order < 3; ++mesh_order)
+      {
+         for (int integrator = 0; integrator < 3; ++integrator)
+         {
+            for (int order = 1; order < 5; ++order)
+            {
+               Mesh *mesh = MakePerturbedMesh(dim, 2, mesh_order);
+               H1_FECollection fec(order, dim);
+               FiniteElementSpace fes(mesh, &fec);
+               FunctionCoefficient coeff(coeffFunction);
+               ConstantCoefficient one(1.0);
+               Coefficient &q = (order % 2) ? (Coefficient&) coeff : one;
+
+               BilinearForm mfform(&fes);
+               BilinearForm faform(&fes);
+               mfform.SetAssemblyLevel(AssemblyLevel::NONE);
+               if (integrator != 1)
+               {
+                  mfform.AddDomainIntegrator(new DiffusionIntegrator(q));
+                  faform.AddDomainIntegrator(new DiffusionIntegrator(q));
+               }
+               if (integrator != 0)
+               {
+                  mfform.AddDomainIntegrator(new MassIntegrator(q));
+                  faform.AddDomainIntegrator(new MassIntegrator(q));
+               }
+               CompareForms(mfform, faform);
+               // The matrix-free assembly does not add nodes to the mesh
+               REQUIRE((mesh->GetNodes() != NULL) == (mesh_order > 0));
+
+               delete mesh;
+            }
+         }
+      }
+   }
+}
+
+} // namespace mf_kernels
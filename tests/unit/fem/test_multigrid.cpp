@@ -0,0 +1,181 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace multigrid
+{
+
+// Return |(P x, y) - (x, P^T y)| relative to |(P x, y)| for random x and y.
+static double TransposeError(const Operator &P)
+{
+   Vector x(P.Width()), y(P.Height()), Px(P.Height()), Pty(P.Width());
+   x.Randomize(1);
+   y.Randomize(2);
+   P.Mult(x, Px);
+   P.MultTranspose(y, Pty);
+   const double Pxy = Px * y;
+   return std::abs(Pxy - x * Pty) / std::abs(Pxy);
+}
+
+static double linearFunction(const Vector &x)
+{
+   return 1.0 + x(0) - 2.0 * x(1);
+}
+
+static Mesh *MakeMesh(int dim)
+{
+   if (dim == 2)
+   {
+      return new Mesh(2, 3, Element::QUADRILATERAL, true, 1.0, 1.0);
+   }
+   return new Mesh(2, 1, 2, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+}
+
+class DiffusionMultigrid : public GeometricMultigrid
+{
+private:
+   ConstantCoefficient one;
+
+   virtual void AddIntegrators(BilinearForm &form)
+   {
+      form.AddDomainIntegrator(new DiffusionIntegrator(one));
+   }
+
+public:
+   DiffusionMultigrid(FiniteElementSpaceHierarchy &fespaces,
+                      const Array<int> &ess_bdr)
+      : GeometricMultigrid(fespaces, ess_bdr), one(1.0) { }
+};
+
+// Solve the Laplace problem on the finest level of a hierarchy with h_levels
+// uniformly refined levels, followed by p_levels levels with doubled order,
+// using CG preconditioned by a multigrid V-cycle, and return the number of
+// iterations.
+static int MultigridIterations(int dim, int h_levels, int p_levels)
+{
+   Mesh *mesh = MakeMesh(dim);
+   H1_FECollection fec(1, dim);
+   FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+   FiniteElementSpaceHierarchy fespaces(mesh, fes, true, true);
+   for (int l = 0; l < h_levels; l++) { fespaces.AddUniformlyRefinedLevel(); }
+   for (int l = 0, order = 1; l < p_levels; l++)
+   {
+      order *= 2;
+      fespaces.AddOrderRefinedLevel(new H1_FECollection(order, dim));
+   }
+
+   Array<int> ess_bdr(mesh->bdr_attributes.Max());
+   ess_bdr = 1;
+   DiffusionMultigrid M(fespaces, ess_bdr);
+   M.Assemble();
+   REQUIRE(M.NumLevels() == 1 + h_levels + p_levels);
+
+   FiniteElementSpace &fine = fespaces.GetFinestFESpace();
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fine);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   GridFunction x(&fine);
+   x = 0.0;
+
+   OperatorHandle A;
+   Vector X, B;
+   M.FormFineLinearSystem(x, b, A, X, B);
+
+   // One V-cycle reduces the residual of the fine problem
+   Vector Y(X.Size()), R(X.Size());
+   M.Mult(B, Y);
+   A->Mult(Y, R);
+   subtract(B, R, R);
+   REQUIRE(R.Norml2() < 0.5 * B.Norml2());
+
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(100);
+   cg.SetPrintLevel(-1);
+   cg.SetOperator(*A);
+   cg.SetPreconditioner(M);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("Multigrid transfer operators", "[Multigrid]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      SECTION("RefinementOperator, dim = " + std::to_string(dim))
+      {
+         Mesh *mesh = MakeMesh(dim);
+         H1_FECollection fec(2, dim);
+         FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+         mesh->UniformRefinement();
+         const Operator *T = fes->GetUpdateOperator();
+         REQUIRE(T != NULL);
+         REQUIRE(TransposeError(*T) < 1e-12);
+         delete fes;
+         delete mesh;
+      }
+
+      SECTION("Hierarchy prolongations, dim = " + std::to_string(dim))
+      {
+         Mesh *mesh = MakeMesh(dim);
+         H1_FECollection fec(1, dim);
+         FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+         FiniteElementSpaceHierarchy fespaces(mesh, fes, true, true);
+         // h-refinement, then p-refinement, which uses PRefinementOperator
+         fespaces.AddUniformlyRefinedLevel();
+         fespaces.AddOrderRefinedLevel(new H1_FECollection(2, dim));
+         fespaces.AddOrderRefinedLevel(new H1_FECollection(3, dim));
+         for (int l = 0; l < fespaces.GetFinestLevelIndex(); l++)
+         {
+            const Operator *P = fespaces.GetProlongationAtLevel(l);
+            REQUIRE(P->Width() ==
+                    fespaces.GetFESpaceAtLevel(l).GetTrueVSize());
+            REQUIRE(P->Height() ==
+                    fespaces.GetFESpaceAtLevel(l+1).GetTrueVSize());
+            REQUIRE(TransposeError(*P) < 1e-12);
+
+            // The prolongation of a coarse function is exact
+            FiniteElementSpace &cfes = fespaces.GetFESpaceAtLevel(l);
+            FiniteElementSpace &ffes = fespaces.GetFESpaceAtLevel(l+1);
+            FunctionCoefficient lin(linearFunction);
+            GridFunction xc(&cfes), xf(&ffes), pf(&ffes);
+            xc.ProjectCoefficient(lin);
+            xf.ProjectCoefficient(lin);
+            P->Mult(xc, pf);
+            pf -= xf;
+            REQUIRE(pf.Normlinf() < 1e-12);
+         }
+      }
+   }
+}
+
+TEST_CASE("Geometric multigrid", "[Multigrid]")
+{
+   // The V-cycle preconditioner gives iteration counts that are bounded
+   // independently of the number of h- and p-levels
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      const int it_h1 = MultigridIterations(dim, 1, 0);
+      const int it_h2 = MultigridIterations(dim, 2, 0);
+      const int it_hp = MultigridIterations(dim, 2, 2);
+      REQUIRE(it_h1 <= 15);
+      REQUIRE(it_h2 <= it_h1 + 3);
+      REQUIRE(it_hp <= 25);
+   }
+}
+
+} // namespace multigrid
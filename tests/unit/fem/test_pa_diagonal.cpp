@@ -0,0 +1,145 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "assembly_test_utils.hpp"
+
+using namespace mfem;
+using namespace assembly_test;
+
+namespace pa_diagonal
+{
+
+TEST_CASE("PA diagonal", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int integrator = 0; integrator < 3; ++integrator)
+      {
+         for (int order = 1; order < 5; ++order)
+         {
+            Mesh *mesh = MakePerturbedMesh(dim);
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            FunctionCoefficient coeff(coeffFunction);
+
+            BilinearForm paform(&fes);
+            BilinearForm faform(&fes);
+            paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            if (integrator != 1)
+            {
+               paform.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+               faform.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+            }
+            if (integrator != 0)
+            {
+               paform.AddDomainIntegrator(new MassIntegrator(coeff));
+               faform.AddDomainIntegrator(new MassIntegrator(coeff));
+            }
+            paform.Assemble();
+            faform.Assemble();
+            faform.Finalize();
+
+            Vector pa_diag(fes.GetVSize()), fa_diag(fes.GetVSize());
+            paform.AssembleDiagonal(pa_diag);
+            faform.SpMat().GetDiag(fa_diag);
+
+            pa_diag -= fa_diag;
+            REQUIRE(pa_diag.Normlinf() < 1.e-12 * fa_diag.Normlinf());
+
+            delete mesh;
+         }
+      }
+   }
+}
+
+TEST_CASE("PA smoothers", "[PartialAssembly]")
+{
+   const int dim = 2, order = 3;
+   Mesh *mesh = MakePerturbedMesh(dim);
+   mesh->UniformRefinement();
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+
+   Array<int> ess_tdof_list;
+   Array<int> ess_bdr(mesh->bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   BilinearForm a(&fes);
+   a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.Assemble();
+
+   GridFunction x(&fes);
+   x = 0.0;
+   LinearForm b(&fes);
+   ConstantCoefficient one(1.0);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   OperatorHandle A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+
+   Vector diag(fes.GetTrueVSize());
+   a.AssembleDiagonal(diag);
+
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(500);
+   cg.SetOperator(*A);
+
+   X = 0.0;
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   const int cg_its = cg.GetNumIterations();
+   Vector X_ref(X);
+
+   SECTION("Jacobi")
+   {
+      OperatorJacobiSmoother jacobi(*A, ess_tdof_list);
+      cg.SetPreconditioner(jacobi);
+      X = 0.0;
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() < cg_its);
+      X -= X_ref;
+      REQUIRE(X.Normlinf() < 1e-8);
+   }
+
+   SECTION("Chebyshev")
+   {
+      OperatorChebyshevSmoother cheby(*A, diag, ess_tdof_list, 3);
+      REQUIRE(cheby.GetMaxEigenvalueEstimate() > 0.0);
+      cg.SetPreconditioner(cheby);
+      X = 0.0;
+      cg.Mult(B, X);
+      REQUIRE(cg.GetConverged());
+      REQUIRE(cg.GetNumIterations() < cg_its);
+      X -= X_ref;
+      REQUIRE(X.Normlinf() < 1e-8);
+
+      // A smoother with a given estimate, instead of the power method
+      OperatorChebyshevSmoother given(*A, diag, ess_tdof_list, 3, 0);
+      given.SetMaxEigenvalueEstimate(cheby.GetMaxEigenvalueEstimate());
+      Vector Y(B.Size()), Y_ref(B.Size());
+      cheby.Mult(B, Y_ref);
+      given.Mult(B, Y);
+      Y -= Y_ref;
+      REQUIRE(Y.Normlinf() == 0.0);
+   }
+
+   delete mesh;
+}
+
+} // namespace pa_diagonal
@@ -0,0 +1,266 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "assembly_test_utils.hpp"
+
+using namespace mfem;
+using namespace assembly_test;
+
+namespace pa_kernels
+{
+
+TEST_CASE("PA element coloring", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      Mesh *mesh = MakePerturbedMesh(dim, 3);
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(mesh, &fec);
+      const ElementRestriction *R = dynamic_cast<const ElementRestriction*>(
+                                       fes.GetElementRestriction(
+                                          ElementDofOrdering::LEXICOGRAPHIC));
+      REQUIRE(R != NULL);
+      const Array<int> *offsets, *elements;
+      R->GetElementColoring(offsets, elements);
+      REQUIRE(elements->Size() == mesh->GetNE());
+      REQUIRE((*offsets)[offsets->Size()-1] == mesh->GetNE());
+
+      // Every dof is touched by at most one element of each color
+      const Array<int> &map = R->GatherMap();
+      const int nd = fes.GetFE(0)->GetDof();
+      Array<int> seen(fes.GetNDofs());
+      for (int c = 0; c < offsets->Size() - 1; c++)
+      {
+         seen = 0;
+         for (int k = (*offsets)[c]; k < (*offsets)[c+1]; k++)
+         {
+            const int e = (*elements)[k];
+            for (int d = 0; d < nd; d++)
+            {
+               const int j = map[d + nd*e];
+               seen[j >= 0 ? j : -1-j]++;
+            }
+         }
+         REQUIRE(seen.Max() <= 1);
+      }
+      delete mesh;
+   }
+}
+
+TEST_CASE("PA element restriction transpose", "[PartialAssembly]")
+{
+   // Each dof gathers its own E-vector entries ("owner computes"); compare
+   // with a sequential scatter-add over the elements
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int ordering = 0; ordering < 2; ++ordering)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim, 3);
+         H1_FECollection fec(2, dim);
+         FiniteElementSpace fes(mesh, &fec, dim,
+                                ordering ? Ordering::byVDIM : Ordering::byNODES);
+         const Operator *R =
+            fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+         const int ne = mesh->GetNE(), nd = fes.GetFE(0)->GetDof();
+         Vector x(R->Height()), y(R->Width()), y_ref(R->Width());
+         x.Randomize(1);
+         R->MultTranspose(x, y);
+
+         y_ref = 0.0;
+         Array<int> vdofs;
+         for (int e = 0; e < ne; e++)
+         {
+            fes.GetElementVDofs(e, vdofs);
+            for (int c = 0; c < dim; c++)
+            {
+               for (int d = 0; d < nd; d++)
+               {
+                  y_ref(vdofs[d + nd*c]) += x(d + nd*(c + dim*e));
+               }
+            }
+         }
+         y -= y_ref;
+         REQUIRE(y.Normlinf() < 1e-12);
+         delete mesh;
+      }
+   }
+}
+
+TEST_CASE("PA mass and diffusion action", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int order = 1; order < 5; ++order)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim, 3);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         FunctionCoefficient coeff(coeffFunction);
+
+         BilinearForm paform(&fes);
+         BilinearForm faform(&fes);
+         paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         paform.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         paform.AddDomainIntegrator(new MassIntegrator(coeff));
+         faform.AddDomainIntegrator(new DiffusionIntegrator(coeff));
+         faform.AddDomainIntegrator(new MassIntegrator(coeff));
+         paform.Assemble();
+         faform.Assemble();
+         faform.Finalize();
+
+         Array<int> ess_tdof_list;
+         OperatorHandle pa_op;
+         paform.FormSystemMatrix(ess_tdof_list, pa_op);
+
+         const int n = fes.GetVSize();
+         Vector x(n), pa_y(n), fa_y(n);
+         x.Randomize(1);
+         pa_op->Mult(x, pa_y);
+         faform.SpMat().Mult(x, fa_y);
+         pa_y -= fa_y;
+         REQUIRE(pa_y.Normlinf() < 1.e-12 * fa_y.Normlinf());
+
+         delete mesh;
+      }
+   }
+}
+
+TEST_CASE("PA specialized kernels", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      const Geometry::Type geom = (dim == 2) ? Geometry::SQUARE : Geometry::CUBE;
+      for (int order = 1; order < 9; ++order)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim, 1);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         // Gauss rules with Q1D = D1D and Q1D = D1D + 1 points in 1D
+         for (int q = 0; q < 2; ++q)
+         {
+            const int D1D = order + 1, Q1D = D1D + q;
+            const IntegrationRule &ir = IntRules.Get(geom, 2*Q1D - 1);
+            DiffusionIntegrator diffusion;
+            MassIntegrator mass;
+            diffusion.SetIntRule(&ir);
+            mass.SetIntRule(&ir);
+            diffusion.AssemblePA(fes);
+            mass.AssemblePA(fes);
+            REQUIRE(diffusion.HasSpecializedPAKernel());
+            REQUIRE(mass.HasSpecializedPAKernel());
+         }
+         delete mesh;
+      }
+   }
+}
+
+TEST_CASE("PA mass and diffusion action with Gauss rules",
+          "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      const Geometry::Type geom = (dim == 2) ? Geometry::SQUARE : Geometry::CUBE;
+      for (int order = 1; order < 4; ++order)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim, 2);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         FunctionCoefficient coeff(coeffFunction);
+         // Gauss rule with Q1D = D1D + 1 points in 1D
+         const IntegrationRule &ir = IntRules.Get(geom, 2*order + 3);
+
+         BilinearForm paform(&fes);
+         BilinearForm faform(&fes);
+         paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         for (int i = 0; i < 2; i++)
+         {
+            BilinearForm &form = (i == 0) ? paform : faform;
+            DiffusionIntegrator *diffusion = new DiffusionIntegrator(coeff);
+            diffusion->SetIntRule(&ir);
+            form.AddDomainIntegrator(diffusion);
+            form.AddDomainIntegrator(new MassIntegrator(coeff, &ir));
+         }
+         paform.Assemble();
+         faform.Assemble();
+         faform.Finalize();
+
+         Array<int> ess_tdof_list;
+         OperatorHandle pa_op;
+         paform.FormSystemMatrix(ess_tdof_list, pa_op);
+
+         const int n = fes.GetVSize();
+         Vector x(n), pa_y(n), fa_y(n);
+         x.Randomize(1);
+         pa_op->Mult(x, pa_y);
+         faform.SpMat().Mult(x, fa_y);
+         pa_y -= fa_y;
+         REQUIRE(pa_y.Normlinf() < 1.e-12 * fa_y.Normlinf());
+
+         delete mesh;
+      }
+   }
+}
+
+TEST_CASE("PA mass and diffusion E-vector action", "[PartialAssembly]")
+{
+   // Apply AddMultPA() on E-vectors, bypassing the fused L-vector action of
+   // the BilinearForm, so that the table kernels are used for all the
+   // registered sizes
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      const Geometry::Type geom = (dim == 2) ? Geometry::SQUARE : Geometry::CUBE;
+      for (int order = 1; order < 9; ++order)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim, 1);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec);
+         FunctionCoefficient coeff(coeffFunction);
+         const Operator *R =
+            fes.GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+         const int n = fes.GetVSize();
+         Vector x(n), pa_y(n), fa_y(n);
+         Vector xe(R->Height()), ye(R->Height());
+         x.Randomize(1);
+         R->Mult(x, xe);
+         // Gauss rules with Q1D = D1D and Q1D = D1D + 1 points in 1D
+         for (int q = 0; q < 2; ++q)
+         {
+            const int Q1D = order + 1 + q;
+            const IntegrationRule &ir = IntRules.Get(geom, 2*Q1D - 1);
+            for (int i = 0; i < 2; ++i)
+            {
+               BilinearFormIntegrator *integ;
+               if (i == 0) { integ = new DiffusionIntegrator(coeff); }
+               else { integ = new MassIntegrator(coeff); }
+               integ->SetIntRule(&ir);
+               integ->AssemblePA(fes);
+               REQUIRE(integ->HasSpecializedPAKernel());
+               ye = 0.0;
+               integ->AddMultPA(xe, ye);
+               R->MultTranspose(ye, pa_y);
+
+               BilinearForm faform(&fes);
+               faform.AddDomainIntegrator(integ);
+               faform.Assemble();
+               faform.Finalize();
+               faform.SpMat().Mult(x, fa_y);
+               pa_y -= fa_y;
+               REQUIRE(pa_y.Normlinf() < 1.e-12 * fa_y.Normlinf());
+            }
+         }
+         delete mesh;
+      }
+   }
+}
+
+} // namespace pa_kernels
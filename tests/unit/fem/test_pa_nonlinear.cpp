@@ -0,0 +1,183 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace pa_nonlinear
+{
+
+static void deformation(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05 * sin(2.0 * x(1));
+   y(1) += 0.03 * x(0) * x(0);
+   if (x.Size() == 3) { y(2) += 0.04 * x(0) * x(1); }
+}
+
+static void identity(const Vector &x, Vector &y)
+{
+   y = x;
+}
+
+static double muFunction(const Vector &x)
+{
+   return 1.0 + 0.5 * x(0);
+}
+
+static double Error(const Vector &x, const Vector &y)
+{
+   Vector diff(x);
+   diff -= y;
+   return diff.Normlinf() / std::max(1.0, y.Normlinf());
+}
+
+// Compare the action and the gradient action of the partially assembled
+// hyperelastic form with the fully assembled one
+static void CompareForms(FiniteElementSpace &fes, HyperelasticModel &model)
+{
+   Mesh &mesh = *fes.GetMesh();
+   const int dim = mesh.Dimension();
+   NonlinearForm n_fa(&fes), n_pa(&fes);
+   n_fa.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+   n_pa.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+   n_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   n_pa.Setup();
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 0;
+   ess_bdr[0] = 1;
+   n_fa.SetEssentialBC(ess_bdr);
+   n_pa.SetEssentialBC(ess_bdr);
+
+   GridFunction x(&fes);
+   VectorFunctionCoefficient def(dim, deformation);
+   x.ProjectCoefficient(def);
+   Vector X(fes.GetTrueVSize());
+   x.GetTrueDofs(X);
+
+   Vector y_fa(X.Size()), y_pa(X.Size());
+   n_fa.Mult(X, y_fa);
+   n_pa.Mult(X, y_pa);
+   REQUIRE(Error(y_pa, y_fa) < 1e-12);
+
+   Operator &grad_fa = n_fa.GetGradient(X);
+   Operator &grad_pa = n_pa.GetGradient(X);
+   REQUIRE(dynamic_cast<SparseMatrix*>(&grad_pa) == NULL);
+   Vector d(X.Size());
+   d.Randomize(1);
+   grad_fa.Mult(d, y_fa);
+   grad_pa.Mult(d, y_pa);
+   REQUIRE(Error(y_pa, y_fa) < 1e-12);
+}
+
+TEST_CASE("PA Nonlinear Form", "[PartialAssembly], [NonlinearForm]")
+{
+   NeoHookeanModel neo_hookean(1.0, 5.0);
+   InverseHarmonicModel inverse_harmonic;
+
+   SECTION("Quadrilaterals")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL, 1, 1.0, 1.0);
+      for (int order = 1; order <= 3; order++)
+      {
+         H1_FECollection fec(order, 2);
+         FiniteElementSpace fes(&mesh, &fec, 2);
+         CompareForms(fes, neo_hookean);
+         CompareForms(fes, inverse_harmonic);
+      }
+   }
+
+   SECTION("Hexahedra")
+   {
+      Mesh mesh(2, 2, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+      H1_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec, 3);
+      CompareForms(fes, neo_hookean);
+   }
+
+   SECTION("Triangles, variable coefficient")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE, 1, 1.0, 1.0);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec, 2, Ordering::byVDIM);
+      FunctionCoefficient mu(muFunction);
+      ConstantCoefficient K(5.0);
+      NeoHookeanModel model(mu, K);
+      CompareForms(fes, model);
+   }
+
+   SECTION("Non-conforming mesh")
+   {
+      Mesh mesh(2, 2, Element::QUADRILATERAL, 1, 1.0, 1.0);
+      mesh.EnsureNCMesh();
+      Array<int> refs;
+      refs.Append(0);
+      mesh.GeneralRefinement(refs);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec, 2);
+      REQUIRE(fes.GetProlongationMatrix() != NULL);
+      CompareForms(fes, neo_hookean);
+   }
+}
+
+TEST_CASE("PA Nonlinear Newton", "[PartialAssembly], [NonlinearForm]")
+{
+   // Solve a hyperelastic problem with a prescribed deformation of the
+   // boundary, using the matrix-free gradient in the Newton iterations
+   Mesh mesh(3, 3, Element::QUADRILATERAL, 1, 1.0, 1.0);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec, 2);
+   NeoHookeanModel model(1.0, 5.0);
+
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   GridFunction x_fa(&fes), x_pa(&fes), x_def(&fes);
+   VectorFunctionCoefficient def(2, deformation), ref(2, identity);
+   x_def.ProjectCoefficient(def);
+   // Start the interior from the reference configuration
+   x_fa.ProjectCoefficient(ref);
+   Array<int> ess_tdofs;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   for (int i = 0; i < ess_tdofs.Size(); i++)
+   {
+      x_fa(ess_tdofs[i]) = x_def(ess_tdofs[i]);
+   }
+   x_pa = x_fa;
+
+   Vector zero;
+   for (int pa = 0; pa <= 1; pa++)
+   {
+      NonlinearForm form(&fes);
+      form.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+      if (pa) { form.SetAssemblyLevel(AssemblyLevel::PARTIAL); }
+      form.Setup();
+      form.SetEssentialBC(ess_bdr);
+
+      CGSolver cg;
+      cg.SetRelTol(1e-12);
+      cg.SetMaxIter(500);
+      NewtonSolver newton;
+      newton.SetSolver(cg);
+      newton.SetOperator(form);
+      newton.SetRelTol(1e-10);
+      newton.SetAbsTol(0.0);
+      newton.SetMaxIter(10);
+      GridFunction &x = pa ? x_pa : x_fa;
+      newton.Mult(zero, x);
+      REQUIRE(newton.GetConverged());
+   }
+   REQUIRE(Error(x_pa, x_fa) < 1e-8);
+}
+
+} // namespace pa_nonlinear
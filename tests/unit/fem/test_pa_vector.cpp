@@ -0,0 +1,113 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+#include "assembly_test_utils.hpp"
+
+using namespace mfem;
+using namespace assembly_test;
+
+namespace pa_vector
+{
+
+TEST_CASE("PA H(curl) integrators", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int integrator = 0; integrator < 3; ++integrator)
+      {
+         for (int order = 1; order < 4; ++order)
+         {
+            Mesh *mesh = MakePerturbedMesh(dim);
+            ND_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            FunctionCoefficient coeff(coeffFunction);
+
+            BilinearForm paform(&fes);
+            BilinearForm faform(&fes);
+            paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            if (integrator != 1)
+            {
+               paform.AddDomainIntegrator(new CurlCurlIntegrator(coeff));
+               faform.AddDomainIntegrator(new CurlCurlIntegrator(coeff));
+            }
+            if (integrator != 0)
+            {
+               paform.AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+               faform.AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+            }
+            CompareForms(paform, faform);
+
+            delete mesh;
+         }
+      }
+   }
+}
+
+TEST_CASE("PA H(div) integrators", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int integrator = 0; integrator < 3; ++integrator)
+      {
+         for (int order = 0; order < 3; ++order)
+         {
+            Mesh *mesh = MakePerturbedMesh(dim);
+            RT_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            FunctionCoefficient coeff(coeffFunction);
+
+            BilinearForm paform(&fes);
+            BilinearForm faform(&fes);
+            paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            if (integrator != 1)
+            {
+               paform.AddDomainIntegrator(new DivDivIntegrator(coeff));
+               faform.AddDomainIntegrator(new DivDivIntegrator(coeff));
+            }
+            if (integrator != 0)
+            {
+               paform.AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+               faform.AddDomainIntegrator(new VectorFEMassIntegrator(coeff));
+            }
+            CompareForms(paform, faform);
+
+            delete mesh;
+         }
+      }
+   }
+}
+
+TEST_CASE("PA vector diffusion", "[PartialAssembly]")
+{
+   for (int dim = 2; dim < 4; ++dim)
+   {
+      for (int order = 1; order < 4; ++order)
+      {
+         Mesh *mesh = MakePerturbedMesh(dim);
+         H1_FECollection fec(order, dim);
+         FiniteElementSpace fes(mesh, &fec, dim);
+         FunctionCoefficient coeff(coeffFunction);
+
+         BilinearForm paform(&fes);
+         BilinearForm faform(&fes);
+         paform.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+         paform.AddDomainIntegrator(new VectorDiffusionIntegrator(coeff));
+         faform.AddDomainIntegrator(new VectorDiffusionIntegrator(coeff));
+         CompareForms(paform, faform);
+
+         delete mesh;
+      }
+   }
+}
+
+} // namespace pa_vector
@@ -0,0 +1,192 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "catch.hpp"
+#include "mfem.hpp"
+
+using namespace mfem;
+
+namespace quadinterpolator
+{
+
+static void transformation(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1 * sin(2.0 * x(1));
+   y(1) += 0.1 * x(0) * x(0);
+   if (x.Size() == 3) { y(2) += 0.1 * x(0) * x(1); }
+}
+
+static void vectorFunction(const Vector &x, Vector &v)
+{
+   for (int i = 0; i < v.Size(); i++)
+   {
+      v(i) = cos(x(0) + i) * (1.0 + x(1) * x(x.Size() - 1));
+   }
+}
+
+static double Error(const Vector &x, const Vector &y)
+{
+   Vector diff(x);
+   diff -= y;
+   return diff.Normlinf() / std::max(1.0, y.Normlinf());
+}
+
+// Compare the tensor product evaluations of the function @a x with the general
+// evaluations, and check MultTranspose() against Mult() with both
+static void CompareEvaluations(const GridFunction &x, const IntegrationRule &ir)
+{
+   const FiniteElementSpace &fes = *x.FESpace();
+   const int ne = fes.GetNE();
+   const int dim = fes.GetMesh()->Dimension();
+   const int vdim = fes.GetVDim();
+   const int nq = ir.GetNPoints() * ne;
+
+   QuadratureInterpolator qi_tensor(fes, ir), qi_full(fes, ir);
+   qi_full.DisableTensorProducts();
+   REQUIRE(qi_tensor.UsesTensorProducts());
+   REQUIRE(!qi_full.UsesTensorProducts());
+
+   const Operator *R_lex =
+      fes.GetElementRestriction(ElementDofOrdering::LEXICOGRAPHIC);
+   const Operator *R_nat = fes.GetElementRestriction(ElementDofOrdering::NATIVE);
+   Vector e_lex(R_lex->Height()), e_nat(R_nat->Height());
+   R_lex->Mult(x, e_lex);
+   R_nat->Mult(x, e_nat);
+
+   unsigned flags = QuadratureInterpolator::VALUES |
+                    QuadratureInterpolator::DERIVATIVES;
+   if (vdim == dim) { flags |= QuadratureInterpolator::DETERMINANTS; }
+   Vector val_t(nq*vdim), der_t(nq*vdim*dim), det_t(nq);
+   Vector val_f(nq*vdim), der_f(nq*vdim*dim), det_f(nq);
+   qi_tensor.Mult(e_lex, flags, val_t, der_t, det_t);
+   qi_full.Mult(e_nat, flags, val_f, der_f, det_f);
+   REQUIRE(Error(val_t, val_f) < 1e-12);
+   REQUIRE(Error(der_t, der_f) < 1e-12);
+   if (vdim == dim)
+   {
+      REQUIRE(Error(det_t, det_f) < 1e-12);
+
+      // Determinants without the derivatives
+      Vector no_der, det(nq);
+      qi_tensor.Mult(e_lex, QuadratureInterpolator::DETERMINANTS,
+                     val_t, no_der, det);
+      REQUIRE(Error(det, det_f) < 1e-12);
+   }
+
+   // Check that <Mult(e), q> = <e, MultTranspose(q)>
+   Vector q_val(nq*vdim), q_der(nq*vdim*dim);
+   q_val.Randomize(1);
+   q_der.Randomize(2);
+   const unsigned tflags = QuadratureInterpolator::VALUES |
+                           QuadratureInterpolator::DERIVATIVES;
+   const double q_dot = val_f * q_val + der_f * q_der;
+   Vector e_t(e_lex.Size()), e_f(e_nat.Size());
+   qi_tensor.MultTranspose(tflags, q_val, q_der, e_t);
+   qi_full.MultTranspose(tflags, q_val, q_der, e_f);
+   REQUIRE(fabs(e_lex * e_t - q_dot) < 1e-12 * std::max(1.0, fabs(q_dot)));
+   REQUIRE(fabs(e_nat * e_f - q_dot) < 1e-12 * std::max(1.0, fabs(q_dot)));
+
+   // Transpose of the values and of the derivatives only
+   qi_tensor.MultTranspose(QuadratureInterpolator::VALUES, q_val, q_der, e_t);
+   REQUIRE(fabs(e_lex * e_t - val_f * q_val) <
+           1e-12 * std::max(1.0, fabs(val_f * q_val)));
+   qi_tensor.MultTranspose(QuadratureInterpolator::DERIVATIVES,
+                           q_val, q_der, e_t);
+   REQUIRE(fabs(e_lex * e_t - der_f * q_der) <
+           1e-12 * std::max(1.0, fabs(der_f * q_der)));
+}
+
+static void TestSpaces(Mesh &mesh, int max_order)
+{
+   const int dim = mesh.Dimension();
+   mesh.SetCurvature(3);
+   mesh.Transform(transformation);
+   for (int order = 1; order <= max_order; order++)
+   {
+      H1_FECollection fec(order, dim);
+      for (int vdim = 1; vdim <= dim; vdim += dim - 1)
+      {
+         FiniteElementSpace fes(&mesh, &fec, vdim);
+         GridFunction x(&fes);
+         VectorFunctionCoefficient coeff(vdim, vectorFunction);
+         x.ProjectCoefficient(coeff);
+         // Integration rules with as many and more points than dofs in 1D
+         for (int ir_order = 2*order - 1; ir_order <= 2*order + 2; ir_order++)
+         {
+            const IntegrationRule &ir =
+               IntRules.Get(mesh.GetElementBaseGeometry(0), ir_order);
+            CompareEvaluations(x, ir);
+         }
+      }
+   }
+}
+
+TEST_CASE("Tensor QuadratureInterpolator", "[QuadratureInterpolator]")
+{
+   SECTION("Quadrilaterals")
+   {
+      Mesh mesh(3, 2, Element::QUADRILATERAL, 1, 1.0, 1.5);
+      // Order 6 uses the kernels for general sizes
+      TestSpaces(mesh, 6);
+   }
+
+   SECTION("Hexahedra")
+   {
+      Mesh mesh(2, 2, 1, Element::HEXAHEDRON, 1, 1.0, 1.0, 0.5);
+      TestSpaces(mesh, 4);
+   }
+
+   SECTION("Geometric factors")
+   {
+      Mesh mesh(2, 3, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+      mesh.SetCurvature(2);
+      mesh.Transform(transformation);
+      const IntegrationRule &ir = IntRules.Get(Geometry::CUBE, 5);
+      const int flags = GeometricFactors::COORDINATES |
+                        GeometricFactors::JACOBIANS |
+                        GeometricFactors::DETERMINANTS;
+      const GeometricFactors *geom = mesh.GetGeometricFactors(ir, flags);
+
+      const int nq = ir.GetNPoints();
+      double err = 0.0;
+      for (int e = 0; e < mesh.GetNE(); e++)
+      {
+         ElementTransformation *T = mesh.GetElementTransformation(e);
+         for (int q = 0; q < nq; q++)
+         {
+            T->SetIntPoint(&ir.IntPoint(q));
+            const DenseMatrix &J = T->Jacobian();
+            err = std::max(err, fabs(geom->detJ(q + nq*e) - T->Weight()));
+            for (int i = 0; i < 3; i++)
+            {
+               for (int j = 0; j < 3; j++)
+               {
+                  const int k = q + nq*(i + 3*(j + 3*e));
+                  err = std::max(err, fabs(geom->J(k) - J(i,j)));
+               }
+            }
+         }
+      }
+      REQUIRE(err < 1e-12);
+   }
+
+   SECTION("Non-tensor elements")
+   {
+      Mesh mesh(2, 2, Element::TRIANGLE, 1, 1.0, 1.0);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      QuadratureInterpolator qi(fes, IntRules.Get(Geometry::TRIANGLE, 4));
+      REQUIRE(!qi.UsesTensorProducts());
+   }
+}
+
+} // namespace quadinterpolator
@@ -0,0 +1,42 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+using namespace mfem;
+
+#include "catch.hpp"
+#include "general/forall.hpp"
+
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
+TEST_CASE("MFEM_FORALL OpenMP partitioning", "[General]")
+{
+#ifdef MFEM_USE_OPENMP
+   // With the "omp" backend, loops of the same length give each thread the
+   // same contiguous range of indices
+   if (!Device::Allows(Backend::OMP)) { return; }
+   const int N = 1000;
+   Array<int> first(N), second(N);
+   int *d_first = first.HostWrite(), *d_second = second.HostWrite();
+   MFEM_FORALL(i, N, d_first[i] = omp_get_thread_num(););
+   MFEM_FORALL(i, N, d_second[i] = omp_get_thread_num(););
+   bool same = true, contiguous = true;
+   for (int i = 0; i < N; i++)
+   {
+      same = same && (first[i] == second[i]);
+      contiguous = contiguous && (i == 0 || first[i] >= first[i-1]);
+   }
+   REQUIRE(same);
+   REQUIRE(contiguous);
+#endif
+}
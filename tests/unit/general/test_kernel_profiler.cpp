@@ -0,0 +1,76 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+using namespace mfem;
+
+#include "catch.hpp"
+#include "general/forall.hpp"
+
+#include <sstream>
+
+static void ScaleKernel(Vector &v, const double a)
+{
+   MFEM_KERNEL_INFO("ScaleKernel", 1.0, 2.0*sizeof(double));
+   double *d_v = v.ReadWrite();
+   MFEM_FORALL(i, v.Size(), d_v[i] *= a;);
+}
+
+// Give the info of a kernel that is skipped, e.g. for an empty input
+static void SkippedKernel(Vector &v)
+{
+   MFEM_KERNEL_INFO("SkippedKernel", 1.0, 1.0);
+   if (v.Size() == 0) { return; }
+   double *d_v = v.ReadWrite();
+   MFEM_FORALL(i, v.Size(), d_v[i] = 0.0;);
+}
+
+static void UnnamedKernel(Vector &v)
+{
+   double *d_v = v.ReadWrite();
+   MFEM_FORALL(i, v.Size(), d_v[i] += 1.0;);
+}
+
+TEST_CASE("Kernel Profiler", "[General]")
+{
+   const bool was_enabled = KernelProfiler::IsEnabled();
+   Vector v(100);
+   v = 1.0;
+
+   KernelProfiler::Disable();
+   KernelProfiler::Reset();
+   ScaleKernel(v, 2.0);
+   REQUIRE(KernelProfiler::GetCalls("ScaleKernel") == 0);
+
+   KernelProfiler::Enable();
+   for (int k = 0; k < 3; k++) { ScaleKernel(v, 2.0); }
+   REQUIRE(KernelProfiler::GetCalls("ScaleKernel") == 3);
+   REQUIRE(v(0) == 16.0);
+
+   std::ostringstream report;
+   KernelProfiler::Report(report);
+   const std::string json = report.str();
+   REQUIRE(json.find("\"name\": \"ScaleKernel\", \"calls\": 3, "
+                     "\"iterations\": 300") != std::string::npos);
+   REQUIRE(json.find("\"flops\": 300") != std::string::npos);
+   REQUIRE(json.find("\"bytes\": 4800") != std::string::npos);
+
+   // The info of a skipped kernel does not apply to the next kernel
+   Vector empty;
+   SkippedKernel(empty);
+   UnnamedKernel(v);
+   REQUIRE(KernelProfiler::GetCalls("SkippedKernel") == 0);
+   REQUIRE(v(0) == 17.0);
+
+   KernelProfiler::Reset();
+   REQUIRE(KernelProfiler::GetCalls("ScaleKernel") == 0);
+   if (!was_enabled) { KernelProfiler::Disable(); }
+}
@@ -155,3 +155,97 @@ TEST_CASE("DenseMatrix A*B^T methods",
    }
 }
 
+
+TEST_CASE("Batched dense linear algebra", "[DenseMatrix]")
+{
+   const int m = 7, nb = 11;
+   const double tol = 1e-10;
+   DenseTensor A(m, m, nb);
+   Vector a(A.Data(), A.TotalSize());
+   a.Randomize(1);
+   for (int k = 0; k < nb; k++)
+   {
+      // Shift the diagonal, then scale down the first row to force pivoting
+      for (int j = 0; j < m; j++) { A(j,j,k) += 2.0; }
+      for (int j = 0; j < m; j++) { A(0,j,k) *= 1e-2; }
+   }
+
+   SECTION("BatchLUFactor and BatchLUSolve")
+   {
+      DenseTensor LU(A);
+      Array<int> P;
+      BatchLUFactor(LU, P);
+      REQUIRE(P.Size() == m*nb);
+
+      Vector b(m*nb), x(m*nb);
+      b.Randomize(2);
+      x = b;
+      BatchLUSolve(LU, P, x);
+      Vector Ax(m*nb);
+      BatchMult(A, x, Ax);
+      Ax -= b;
+      REQUIRE(Ax.Normlinf() < tol);
+
+      // Compare with LUFactors for each matrix
+      for (int k = 0; k < nb; k++)
+      {
+         DenseMatrix A_k(A(k));
+         Vector x_k(m);
+         for (int i = 0; i < m; i++) { x_k(i) = b(i + k*m); }
+         DenseMatrixInverse inv(A_k);
+         Vector y_k(m);
+         inv.Mult(x_k, y_k);
+         for (int i = 0; i < m; i++) { y_k(i) -= x(i + k*m); }
+         REQUIRE(y_k.Normlinf() < tol);
+      }
+   }
+
+   SECTION("BatchInverse")
+   {
+      DenseTensor Ainv, I;
+      BatchInverse(A, Ainv);
+      BatchMult(A, Ainv, I);
+      REQUIRE(I.SizeI() == m);
+      REQUIRE(I.SizeJ() == m);
+      REQUIRE(I.SizeK() == nb);
+      for (int k = 0; k < nb; k++)
+      {
+         for (int j = 0; j < m; j++) { I(j,j,k) -= 1.0; }
+         REQUIRE(I(k).MaxMaxNorm() < tol);
+      }
+   }
+
+   SECTION("BatchMult")
+   {
+      const int r = 3;
+      DenseTensor B(m, r, nb), C;
+      Vector bv(B.Data(), B.TotalSize());
+      bv.Randomize(3);
+      BatchMult(A, B, C);
+      DenseMatrix C_k(m, r);
+      for (int k = 0; k < nb; k++)
+      {
+         Mult(A(k), B(k), C_k);
+         C_k -= C(k);
+         REQUIRE(C_k.MaxMaxNorm() < tol);
+      }
+
+      Vector x(m*nb), y(m*nb), yt(m*nb), y_k(m), yt_k(m);
+      x.Randomize(4);
+      BatchMult(A, x, y);
+      BatchMultTranspose(A, x, yt);
+      for (int k = 0; k < nb; k++)
+      {
+         Vector x_k(x.GetData() + k*m, m);
+         A(k).Mult(x_k, y_k);
+         A(k).MultTranspose(x_k, yt_k);
+         for (int i = 0; i < m; i++)
+         {
+            y_k(i) -= y(i + k*m);
+            yt_k(i) -= yt(i + k*m);
+         }
+         REQUIRE(y_k.Normlinf() < tol);
+         REQUIRE(yt_k.Normlinf() < tol);
+      }
+   }
+}
@@ -0,0 +1,201 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace ilu
+{
+
+// Upwind finite difference convection-diffusion operator on an n x n grid,
+// with convection velocity (c, c/2).
+static SparseMatrix *ConvectionDiffusion(int n, double c)
+{
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int iy = 0; iy < n; iy++)
+   {
+      for (int ix = 0; ix < n; ix++)
+      {
+         const int i = ix + iy*n;
+         A->Add(i, i, 4.0 + 1.5*c);
+         if (ix > 0) { A->Add(i, i-1, -1.0 - c); }
+         if (ix < n-1) { A->Add(i, i+1, -1.0); }
+         if (iy > 0) { A->Add(i, i-n, -1.0 - 0.5*c); }
+         if (iy < n-1) { A->Add(i, i+n, -1.0); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Block tridiagonal matrix with dense, diagonally dominant b x b blocks.
+static SparseMatrix *BlockTridiagonal(int nb, int b)
+{
+   SparseMatrix *A = new SparseMatrix(nb*b);
+   Vector r(3*b*b*nb);
+   r.Randomize(3);
+   int k = 0;
+   for (int ib = 0; ib < nb; ib++)
+   {
+      for (int jb = std::max(ib-1, 0); jb <= std::min(ib+1, nb-1); jb++)
+      {
+         for (int i = 0; i < b; i++)
+         {
+            for (int j = 0; j < b; j++)
+            {
+               const double d = (ib == jb && i == j) ? 4.0*b : 0.0;
+               A->Add(ib*b + i, jb*b + j, d + r(k++));
+            }
+         }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+static int GMRESIterations(const SparseMatrix &A, Solver *prec)
+{
+   GMRESSolver gmres;
+   gmres.SetOperator(A);
+   if (prec) { gmres.SetPreconditioner(*prec); }
+   gmres.SetRelTol(1e-10);
+   gmres.SetMaxIter(1000);
+   gmres.SetKDim(50);
+   gmres.SetPrintLevel(-1);
+   Vector b(A.Height()), x(A.Height());
+   b.Randomize(1);
+   x = 0.0;
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+   return gmres.GetNumIterations();
+}
+
+TEST_CASE("Sparse ILU", "[ILU]")
+{
+   SECTION("ILU(0) is exact for tridiagonal matrices")
+   {
+      const int n = 20;
+      SparseMatrix *A = new SparseMatrix(n);
+      for (int i = 0; i < n; i++)
+      {
+         A->Add(i, i, 3.0);
+         if (i > 0) { A->Add(i, i-1, -1.0 - 0.1*i); }
+         if (i < n-1) { A->Add(i, i+1, -1.0); }
+      }
+      A->Finalize();
+      SparseILU ilu(*A);
+      REQUIRE(ilu.NumNonZeros() == A->NumNonZeroElems());
+      Vector x(n), b(n), y(n);
+      x.Randomize(2);
+      A->Mult(x, b);
+      ilu.Mult(b, y);
+      y -= x;
+      REQUIRE(y.Normlinf() < 1e-12);
+      delete A;
+   }
+
+   SECTION("ILU(k) for a convection-diffusion operator")
+   {
+      SparseMatrix *A = ConvectionDiffusion(32, 10.0);
+      SparseILU ilu0(*A, 0), ilu2(*A, 2);
+      REQUIRE(ilu0.NumNonZeros() == A->NumNonZeroElems());
+      REQUIRE(ilu2.NumNonZeros() > ilu0.NumNonZeros());
+
+      const int it_none = GMRESIterations(*A, NULL);
+      const int it_ilu0 = GMRESIterations(*A, &ilu0);
+      const int it_ilu2 = GMRESIterations(*A, &ilu2);
+      REQUIRE(2*it_ilu0 < it_none);
+      REQUIRE(it_ilu2 < it_ilu0);
+      delete A;
+   }
+
+   SECTION("IC(0) is symmetric and preconditions CG")
+   {
+      SparseMatrix *A = ConvectionDiffusion(32, 0.0);
+      SparseIC ic(*A);
+      Vector u(A->Height()), v(A->Height()), Mu(A->Height()),
+             Mv(A->Height());
+      u.Randomize(4);
+      v.Randomize(5);
+      ic.Mult(u, Mu);
+      ic.Mult(v, Mv);
+      REQUIRE(fabs(u*Mv - v*Mu) < 1e-12*fabs(u*Mv));
+
+      int it[2];
+      for (int k = 0; k < 2; k++)
+      {
+         CGSolver cg;
+         cg.SetOperator(*A);
+         if (k == 1) { cg.SetPreconditioner(ic); }
+         cg.SetRelTol(1e-10);
+         cg.SetMaxIter(1000);
+         cg.SetPrintLevel(-1);
+         Vector b(A->Height()), x(A->Height());
+         b.Randomize(1);
+         x = 0.0;
+         cg.Mult(b, x);
+         REQUIRE(cg.GetConverged());
+         it[k] = cg.GetNumIterations();
+      }
+      REQUIRE(2*it[1] < it[0]);
+      delete A;
+   }
+
+   SECTION("Block ILU(0) is exact for block tridiagonal matrices")
+   {
+      const int nb = 10, b = 4;
+      SparseMatrix *A = BlockTridiagonal(nb, b);
+      SparseBlockILU ilu(*A, b);
+      Vector x(nb*b), y(nb*b), z(nb*b);
+      x.Randomize(2);
+      A->Mult(x, y);
+      ilu.Mult(y, z);
+      z -= x;
+      REQUIRE(z.Normlinf() < 1e-12*x.Normlinf());
+      delete A;
+   }
+
+   SECTION("Block ILU(0) for a DG advection-diffusion operator")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL, 1, 1.0, 1.0);
+      const int order = 2;
+      DG_FECollection fec(order, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      Vector velocity(2);
+      velocity(0) = 20.0;
+      velocity(1) = 10.0;
+      VectorConstantCoefficient v(velocity);
+      ConstantCoefficient one(1.0);
+
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new ConvectionIntegrator(v, 1.0));
+      a.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(one, -1.0, 2.0));
+      a.AddInteriorFaceIntegrator(
+         new TransposeIntegrator(new DGTraceIntegrator(v, -1.0, 0.5)));
+      a.AddBdrFaceIntegrator(new DGDiffusionIntegrator(one, -1.0, 2.0));
+      a.AddBdrFaceIntegrator(
+         new TransposeIntegrator(new DGTraceIntegrator(v, -1.0, 0.5)));
+      a.Assemble();
+      a.Finalize();
+      const SparseMatrix &A = a.SpMat();
+
+      DSmoother jacobi(A);
+      SparseBlockILU ilu(A, fes.GetFE(0)->GetDof());
+      const int it_jacobi = GMRESIterations(A, &jacobi);
+      const int it_ilu = GMRESIterations(A, &ilu);
+      REQUIRE(2*it_ilu < it_jacobi);
+   }
+}
+
+} // namespace ilu
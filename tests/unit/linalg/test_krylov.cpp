@@ -0,0 +1,150 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace krylov
+{
+
+// Finite difference convection-diffusion operator on an n x n grid, with
+// convection velocity (c, c/2); symmetric positive definite for c = 0.
+static SparseMatrix *ConvectionDiffusion(int n, double c)
+{
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int iy = 0; iy < n; iy++)
+   {
+      for (int ix = 0; ix < n; ix++)
+      {
+         const int i = ix + iy*n;
+         A->Add(i, i, 4.0 + 1.5*c);
+         if (ix > 0) { A->Add(i, i-1, -1.0 - c); }
+         if (ix < n-1) { A->Add(i, i+1, -1.0); }
+         if (iy > 0) { A->Add(i, i-n, -1.0 - 0.5*c); }
+         if (iy < n-1) { A->Add(i, i+n, -1.0); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Solve A x = b with the given solver, check the residual and return the
+// number of iterations.
+static int Solve(IterativeSolver &solver, const SparseMatrix &A, Solver *prec,
+                 double rtol, Vector &x)
+{
+   solver.SetOperator(A);
+   if (prec) { solver.SetPreconditioner(*prec); }
+   solver.SetRelTol(rtol);
+   solver.SetMaxIter(1000);
+   solver.SetPrintLevel(-1);
+   Vector b(A.Height()), r(A.Height());
+   b.Randomize(1);
+   x.SetSize(A.Height());
+   x = 0.0;
+   solver.Mult(b, x);
+   REQUIRE(solver.GetConverged());
+   A.Mult(x, r);
+   r -= b;
+   REQUIRE(r.Norml2() < 1e3 * rtol * b.Norml2());
+   return solver.GetNumIterations();
+}
+
+TEST_CASE("Single reduction and pipelined CG", "[Krylov]")
+{
+   SparseMatrix *A = ConvectionDiffusion(30, 0.0);
+   DSmoother jacobi(*A);
+   Solver *precs[2] = { NULL, &jacobi };
+   for (int k = 0; k < 2; k++)
+   {
+      Vector x_cg, x;
+      CGSolver cg;
+      const int it_cg = Solve(cg, *A, precs[k], 1e-10, x_cg);
+
+      SingleReductionCGSolver srcg;
+      const int it_srcg = Solve(srcg, *A, precs[k], 1e-10, x);
+      REQUIRE(std::abs(it_srcg - it_cg) <= 2);
+      x -= x_cg;
+      REQUIRE(x.Normlinf() < 1e-6 * x_cg.Normlinf());
+
+      PipelinedCGSolver pcg;
+      const int it_pcg = Solve(pcg, *A, precs[k], 1e-10, x);
+      REQUIRE(std::abs(it_pcg - it_cg) <= 2);
+      x -= x_cg;
+      REQUIRE(x.Normlinf() < 1e-6 * x_cg.Normlinf());
+   }
+   delete A;
+}
+
+TEST_CASE("s-step GMRES", "[Krylov]")
+{
+   SparseMatrix *A = ConvectionDiffusion(30, 2.0);
+   DSmoother jacobi(*A);
+   Solver *precs[2] = { NULL, &jacobi };
+   for (int k = 0; k < 2; k++)
+   {
+      for (int m = 10; m <= 50; m += 40)
+      {
+         Vector x_gmres, x;
+         GMRESSolver gmres;
+         gmres.SetKDim(m);
+         const int it_gmres = Solve(gmres, *A, precs[k], 1e-8, x_gmres);
+
+         for (int s = 1; s <= 8; s *= 2)
+         {
+            SStepGMRESSolver sgmres;
+            sgmres.SetKDim(m);
+            sgmres.SetSStep(s);
+            const int it = Solve(sgmres, *A, precs[k], 1e-8, x);
+            REQUIRE(it <= it_gmres + it_gmres/10 + 2);
+         }
+      }
+   }
+   delete A;
+}
+
+TEST_CASE("s-step GMRES breakdown", "[Krylov]")
+{
+   // The Krylov space of a diagonal matrix with 3 distinct eigenvalues has
+   // dimension 3: the basis blocks are truncated.
+   const int n = 30;
+   SparseMatrix A(n);
+   for (int i = 0; i < n; i++) { A.Add(i, i, 1.0 + i%3); }
+   A.Finalize();
+   Vector x;
+   SStepGMRESSolver sgmres;
+   sgmres.SetSStep(4);
+   REQUIRE(Solve(sgmres, A, NULL, 1e-12, x) <= 4);
+}
+
+TEST_CASE("GMRES and BiCGSTAB", "[Krylov]")
+{
+   SparseMatrix *A = ConvectionDiffusion(30, 2.0);
+   DSmoother jacobi(*A);
+   Solver *precs[2] = { NULL, &jacobi };
+   for (int k = 0; k < 2; k++)
+   {
+      Vector x_gmres, x;
+      GMRESSolver gmres;
+      gmres.SetKDim(50);
+      Solve(gmres, *A, precs[k], 1e-10, x_gmres);
+
+      BiCGSTABSolver bicgstab;
+      Solve(bicgstab, *A, precs[k], 1e-10, x);
+      x -= x_gmres;
+      REQUIRE(x.Normlinf() < 1e-6 * x_gmres.Normlinf());
+   }
+   delete A;
+}
+
+} // namespace krylov
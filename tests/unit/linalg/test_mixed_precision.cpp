@@ -0,0 +1,190 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace mixed_precision
+{
+
+// Finite difference Laplacian on an n x n grid, scaled by 1/3 so that its
+// entries are not exactly representable in single precision.
+static SparseMatrix *Laplacian(int n)
+{
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int iy = 0; iy < n; iy++)
+   {
+      for (int ix = 0; ix < n; ix++)
+      {
+         const int i = ix + iy*n;
+         A->Add(i, i, 4.0/3.0);
+         if (ix > 0) { A->Add(i, i-1, -1.0/3.0); }
+         if (ix < n-1) { A->Add(i, i+1, -1.0/3.0); }
+         if (iy > 0) { A->Add(i, i-n, -1.0/3.0); }
+         if (iy < n-1) { A->Add(i, i+n, -1.0/3.0); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Return the max norm of A x - B x relative to the max norm of A x.
+static double RelativeError(const Operator &A, const Operator &B,
+                            bool transpose = false)
+{
+   Vector x(transpose ? A.Height() : A.Width());
+   Vector y(transpose ? A.Width() : A.Height()), z(y.Size());
+   x.Randomize(1);
+   if (transpose) { A.MultTranspose(x, y); B.MultTranspose(x, z); }
+   else { A.Mult(x, y); B.Mult(x, z); }
+   z -= y;
+   return z.Normlinf() / y.Normlinf();
+}
+
+TEST_CASE("Single precision SparseMatrix", "[MixedPrecision]")
+{
+   SparseMatrix *A = Laplacian(15);
+
+   SECTION("SinglePrecisionCSRMatrix")
+   {
+      SinglePrecisionCSRMatrix A_sp(*A);
+      REQUIRE(A_sp.NumStoredEntries() == A->NumNonZeroElems());
+      const double err = RelativeError(*A, A_sp);
+      REQUIRE(err > 0.0);
+      REQUIRE(err < 1e-6);
+      // The transpose action of the reference on device backends requires
+      // the explicit transpose
+      A->BuildTranspose();
+      REQUIRE(RelativeError(*A, A_sp, true) < 1e-6);
+   }
+
+   SECTION("BuildSinglePrecision")
+   {
+      SparseMatrix A_csr(*A);
+      A->BuildSinglePrecision();
+      REQUIRE(A->GetSpMVFormat() != NULL);
+      REQUIRE(RelativeError(A_csr, *A) < 1e-6);
+      A_csr.BuildTranspose();
+      REQUIRE(RelativeError(A_csr, *A, true) < 1e-6);
+      A->ResetSpMVFormat();
+      REQUIRE(RelativeError(A_csr, *A) < 1e-15);
+   }
+
+   delete A;
+}
+
+TEST_CASE("Iterative refinement", "[MixedPrecision]")
+{
+   SparseMatrix *A = Laplacian(20);
+   SinglePrecisionCSRMatrix A_sp(*A);
+   DSmoother jacobi(*A);
+
+   CGSolver cg;
+   cg.SetOperator(A_sp);
+   cg.SetPreconditioner(jacobi);
+   cg.SetRelTol(1e-4);
+   cg.SetMaxIter(500);
+   cg.SetPrintLevel(-1);
+
+   IterativeRefinementSolver ir;
+   ir.SetOperator(*A);
+   ir.SetInnerSolver(cg);
+   ir.SetRelTol(1e-12);
+   ir.SetMaxIter(20);
+   ir.SetPrintLevel(-1);
+
+   Vector b(A->Height()), x(A->Width()), r(A->Height());
+   b.Randomize(3);
+   x = 0.0;
+   ir.Mult(b, x);
+   REQUIRE(ir.GetConverged());
+   // Each correction reduces the residual by at least the inner tolerance,
+   // up to the single precision perturbation of the operator.
+   REQUIRE(ir.GetNumIterations() <= 5);
+   A->Mult(x, r);
+   subtract(b, r, r);
+   REQUIRE(r.Norml2() <= 1e-12 * b.Norml2());
+
+   delete A;
+}
+
+TEST_CASE("Single precision partial assembly", "[MixedPrecision]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(3, 3, Element::QUADRILATERAL, 1, 1.0, 1.0) :
+                   new Mesh(2, 2, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+      const Geometry::Type geom = mesh->GetElementBaseGeometry(0);
+      // Default rules and Gauss rules with Q1D = D1D + 1 points in 1D
+      for (int order = 1; order <= 3; order++)
+      {
+         for (int gauss = 0; gauss <= 1; gauss++)
+         {
+            H1_FECollection fec(order, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            ConstantCoefficient one(1.0), third(1.0/3.0);
+            const IntegrationRule *ir =
+               gauss ? &IntRules.Get(geom, 2*order + 3) : NULL;
+            BilinearForm a(&fes), a_sp(&fes);
+            a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            DiffusionIntegrator *diff = new DiffusionIntegrator(one);
+            diff->SetIntRule(ir);
+            a.AddDomainIntegrator(diff);
+            a.AddDomainIntegrator(new MassIntegrator(third, ir));
+            a.Assemble();
+
+            diff = new DiffusionIntegrator(one);
+            diff->SetIntRule(ir);
+            MassIntegrator *mass = new MassIntegrator(third, ir);
+            diff->SetSinglePrecisionPA();
+            mass->SetSinglePrecisionPA();
+            a_sp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+            a_sp.AddDomainIntegrator(diff);
+            a_sp.AddDomainIntegrator(mass);
+            a_sp.Assemble();
+
+            Array<int> ess_tdof_list;
+            OperatorHandle A, A_sp;
+            a.FormSystemMatrix(ess_tdof_list, A);
+            a_sp.FormSystemMatrix(ess_tdof_list, A_sp);
+            const double err = RelativeError(*A, *A_sp);
+            REQUIRE(err > 0.0);
+            REQUIRE(err < 1e-5);
+
+            const int n = A->Height();
+            MultiVector X(n, 3), Y(n, 3);
+            Vector x, y, z(n);
+            X.Randomize(2);
+            A_sp->MultiMult(X, Y);
+            for (int j = 0; j < 3; j++)
+            {
+               X.GetVector(j, x);
+               Y.GetVector(j, y);
+               A_sp->Mult(x, z);
+               z -= y;
+               REQUIRE(z.Normlinf() < 1e-12 * y.Normlinf());
+            }
+
+            Vector diag(fes.GetTrueVSize()), diag_sp(fes.GetTrueVSize());
+            a.AssembleDiagonal(diag);
+            a_sp.AssembleDiagonal(diag_sp);
+            diag_sp -= diag;
+            REQUIRE(diag_sp.Normlinf() < 1e-5 * diag.Normlinf());
+         }
+      }
+      delete mesh;
+   }
+}
+
+}
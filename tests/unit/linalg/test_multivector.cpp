@@ -0,0 +1,194 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace multivector
+{
+
+// Finite difference convection-diffusion operator on an n x n grid, with
+// convection velocity (c, c/2); symmetric positive definite for c = 0.
+static SparseMatrix *ConvectionDiffusion(int n, double c)
+{
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int iy = 0; iy < n; iy++)
+   {
+      for (int ix = 0; ix < n; ix++)
+      {
+         const int i = ix + iy*n;
+         A->Add(i, i, 4.0 + 1.5*c);
+         if (ix > 0) { A->Add(i, i-1, -1.0 - c); }
+         if (ix < n-1) { A->Add(i, i+1, -1.0); }
+         if (iy > 0) { A->Add(i, i-n, -1.0 - 0.5*c); }
+         if (iy < n-1) { A->Add(i, i+n, -1.0); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Return the max norm of the difference between A.MultiMult(X) and the
+// vector-by-vector application of A, relative to the max norm of A X.
+static double MultiMultError(const Operator &A, int nv)
+{
+   MultiVector X(A.Width(), nv), Y(A.Height(), nv);
+   X.Randomize(nv);
+   A.MultiMult(X, Y);
+   Vector x, y, z(A.Height());
+   double err = 0.0, nrm = 0.0;
+   for (int j = 0; j < nv; j++)
+   {
+      X.GetVector(j, x);
+      Y.GetVector(j, y);
+      A.Mult(x, z);
+      nrm = std::max(nrm, z.Normlinf());
+      z -= y;
+      err = std::max(err, z.Normlinf());
+   }
+   return err / nrm;
+}
+
+TEST_CASE("MultiVector operator application", "[MultiVector]")
+{
+   SECTION("SparseMatrix")
+   {
+      SparseMatrix *A = ConvectionDiffusion(12, 1.0);
+      for (int nv = 1; nv <= 11; nv += 5)
+      {
+         REQUIRE(MultiMultError(*A, nv) < 1e-15);
+      }
+      delete A;
+   }
+
+   SECTION("BlockOperator")
+   {
+      SparseMatrix *A = ConvectionDiffusion(6, 0.0);
+      SparseMatrix *C = ConvectionDiffusion(6, 2.0);
+      Array<int> offsets(3);
+      offsets[0] = 0;
+      offsets[1] = A->Height();
+      offsets[2] = A->Height() + C->Height();
+      BlockOperator op(offsets);
+      op.SetBlock(0, 0, A);
+      op.SetBlock(0, 1, C, 2.0);
+      op.SetBlock(1, 1, A, -1.0);
+      REQUIRE(MultiMultError(op, 3) < 1e-15);
+      delete C;
+      delete A;
+   }
+
+   SECTION("Partial assembly")
+   {
+      for (int dim = 2; dim <= 3; dim++)
+      {
+         Mesh *mesh = (dim == 2) ?
+                      new Mesh(3, 3, Element::QUADRILATERAL, 1, 1.0, 1.0) :
+                      new Mesh(2, 2, 2, Element::HEXAHEDRON, 1, 1.0, 1.0, 1.0);
+         const Geometry::Type geom = mesh->GetElementBaseGeometry(0);
+         // Default rules and Gauss rules with Q1D = D1D + 1 points in 1D
+         for (int order = 1; order <= 3; order++)
+         {
+            for (int gauss = 0; gauss <= 1; gauss++)
+            {
+               H1_FECollection fec(order, dim);
+               FiniteElementSpace fes(mesh, &fec);
+               ConstantCoefficient one(1.0);
+               const IntegrationRule *ir =
+                  gauss ? &IntRules.Get(geom, 2*order + 3) : NULL;
+               BilinearForm a(&fes);
+               a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+               DiffusionIntegrator *diff = new DiffusionIntegrator(one);
+               diff->SetIntRule(ir);
+               a.AddDomainIntegrator(diff);
+               a.AddDomainIntegrator(new MassIntegrator(one, ir));
+               a.Assemble();
+
+               Array<int> ess_tdof_list;
+               Array<int> ess_bdr(mesh->bdr_attributes.Max());
+               ess_bdr = 1;
+               fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+               OperatorHandle A;
+               a.FormSystemMatrix(ess_tdof_list, A);
+               for (int nv = 1; nv <= 3; nv++)
+               {
+                  REQUIRE(MultiMultError(*A, nv) < 1e-12);
+               }
+            }
+         }
+         delete mesh;
+      }
+   }
+}
+
+// Solve A X = B for a block of nv right-hand sides with MultiMult and check
+// that each solution and the iteration count match those of Mult.
+static void CheckMultiSolve(IterativeSolver &solver, const SparseMatrix &A,
+                            int nv)
+{
+   solver.SetOperator(A);
+   solver.SetRelTol(1e-10);
+   solver.SetMaxIter(1000);
+   solver.SetPrintLevel(-1);
+   const int n = A.Height();
+   MultiVector B(n, nv), X(n, nv);
+   B.Randomize(1);
+   X = 0.0;
+   solver.MultiMult(B, X);
+   REQUIRE(solver.GetConverged());
+   const int multi_iter = solver.GetNumIterations();
+
+   int max_iter = 0;
+   Vector b, x_multi, x(n);
+   for (int j = 0; j < nv; j++)
+   {
+      B.GetVector(j, b);
+      X.GetVector(j, x_multi);
+      x = 0.0;
+      solver.Mult(b, x);
+      REQUIRE(solver.GetConverged());
+      max_iter = std::max(max_iter, solver.GetNumIterations());
+      x -= x_multi;
+      REQUIRE(x.Normlinf() < 1e-12 * x_multi.Normlinf());
+   }
+   REQUIRE(std::abs(multi_iter - max_iter) <= 1);
+}
+
+TEST_CASE("MultiVector Krylov solvers", "[MultiVector]")
+{
+   SparseMatrix *A = ConvectionDiffusion(20, 0.0);
+   SparseMatrix *N = ConvectionDiffusion(20, 2.0);
+   DSmoother jacobi(*A), jacobi_N(*N);
+
+   SECTION("CG")
+   {
+      CGSolver cg;
+      CheckMultiSolve(cg, *A, 4);
+      cg.SetPreconditioner(jacobi);
+      CheckMultiSolve(cg, *A, 4);
+   }
+
+   SECTION("GMRES")
+   {
+      GMRESSolver gmres;
+      gmres.SetKDim(20);
+      CheckMultiSolve(gmres, *N, 3);
+      gmres.SetPreconditioner(jacobi_N);
+      CheckMultiSolve(gmres, *N, 3);
+   }
+
+   delete N;
+   delete A;
+}
+
+}
@@ -0,0 +1,253 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace ode
+{
+
+// The linear system dx/dt = A x + s(t) with A = [ -a  b; -b  -c ] and the
+// forcing s(t) = [ cos(t); 0 ].
+class LinearODE : public TimeDependentOperator
+{
+   const double a, b, c;
+
+public:
+   LinearODE(double a_, double b_, double c_)
+      : TimeDependentOperator(2, 0.0), a(a_), b(b_), c(c_) { }
+
+   virtual void Mult(const Vector &x, Vector &k) const
+   {
+      k(0) = -a*x(0) + b*x(1) + cos(GetTime());
+      k(1) = -b*x(0) - c*x(1);
+   }
+
+   // Solve k = A (x + dt k) + s(t), i.e. (I - dt A) k = A x + s(t)
+   virtual void ImplicitSolve(const double dt, const Vector &x, Vector &k)
+   {
+      Vector r(2);
+      Mult(x, r);
+      const double m00 = 1. + dt*a, m01 = -dt*b, m10 = dt*b, m11 = 1. + dt*c;
+      const double det = m00*m11 - m01*m10;
+      k(0) = ( m11*r(0) - m01*r(1))/det;
+      k(1) = (-m10*r(0) + m00*r(1))/det;
+   }
+};
+
+// The system of LinearODE split into the non-stiff term f1(x,t) = [ b x_1 +
+// cos(t); -b x_0 ] and the stiff term f2(x) = [ -a x_0; -c x_1 ], selected with
+// the evaluation mode.
+class SplitLinearODE : public TimeDependentOperator
+{
+   const double a, b, c;
+
+public:
+   SplitLinearODE(double a_, double b_, double c_)
+      : TimeDependentOperator(2, 0.0), a(a_), b(b_), c(c_) { }
+
+   virtual void Mult(const Vector &x, Vector &k) const
+   {
+      const bool f1 = (GetEvalMode() != ADDITIVE_TERM_2);
+      const bool f2 = (GetEvalMode() != ADDITIVE_TERM_1);
+      k = 0.0;
+      if (f1) { k(0) += b*x(1) + cos(GetTime()); k(1) -= b*x(0); }
+      if (f2) { k(0) -= a*x(0); k(1) -= c*x(1); }
+   }
+
+   // Only used for the stiff term: solve k = f2(x + dt k)
+   virtual void ImplicitSolve(const double dt, const Vector &x, Vector &k)
+   {
+      REQUIRE(GetEvalMode() == ADDITIVE_TERM_2);
+      k(0) = -a*x(0)/(1. + dt*a);
+      k(1) = -c*x(1)/(1. + dt*c);
+   }
+};
+
+// Return the error at time tf of the solver with n fixed time steps
+static double FixedStepError(ODESolver &solver, TimeDependentOperator &ode,
+                             const Vector &x0, const Vector &x_ref, double tf,
+                             int n)
+{
+   Vector x(x0);
+   solver.Init(ode);
+   double t = 0.0, dt = tf/n;
+   for (int i = 0; i < n; i++) { solver.Step(x, t, dt); }
+   REQUIRE(std::abs(t - tf) < 1e-12);
+   x -= x_ref;
+   return x.Normlinf();
+}
+
+// Reference solution at time tf with RK8 and a fine fixed time step
+static void Reference(LinearODE &ode, const Vector &x0, double tf, Vector &x)
+{
+   RK8Solver rk8;
+   rk8.Init(ode);
+   x = x0;
+   double t = 0.0, dt = tf/4000;
+   for (int i = 0; i < 4000; i++) { rk8.Step(x, t, dt); }
+}
+
+TEST_CASE("Adaptive ODE solvers", "[ODE]")
+{
+   Vector x0(2), x(2), x_ref(2);
+   x0(0) = 1.0;
+   x0(1) = 0.5;
+
+   SECTION("Explicit embedded pairs")
+   {
+      LinearODE ode(0.5, 4.0, 0.1);
+      const double tf = 3.0;
+      Reference(ode, x0, tf, x_ref);
+      BogackiShampineSolver bs;
+      DormandPrinceSolver dp;
+      AdaptiveODESolver *solvers[2] = { &bs, &dp };
+      for (int i = 0; i < 2; i++)
+      {
+         AdaptiveODESolver &solver = *solvers[i];
+         double prev_err = 1.0;
+         int prev_steps = 0;
+         for (double tol = 1e-4; tol > 1e-9; tol *= 1e-2)
+         {
+            solver.SetTolerances(tol, tol);
+            solver.Init(ode);
+            x = x0;
+            double t = 0.0, dt = 1.0;
+            solver.Run(x, t, dt, tf);
+            REQUIRE(t == tf);
+            x -= x_ref;
+            const double err = x.Normlinf();
+            // The global error follows the local tolerance
+            REQUIRE(err < 100*tol);
+            REQUIRE(err < prev_err);
+            REQUIRE(solver.GetNumAccepted() > prev_steps);
+            // The initial step of size 1 is too large
+            REQUIRE(solver.GetNumRejected() > 0);
+            prev_err = err;
+            prev_steps = solver.GetNumAccepted();
+         }
+      }
+   }
+
+   SECTION("Output times")
+   {
+      LinearODE ode(0.5, 4.0, 0.1);
+      Reference(ode, x0, 1.0, x_ref);
+      DormandPrinceSolver dp;
+      dp.SetTolerances(1e-8, 1e-8);
+      dp.Init(ode);
+      x = x0;
+      double t = 0.0;
+      for (int i = 0; i < 10; i++)
+      {
+         double dt = 0.1;
+         dp.Step(x, t, dt);
+         REQUIRE(std::abs(t - 0.1*(i+1)) < 1e-14);
+         REQUIRE(dt <= 0.1 + 1e-14);
+      }
+      x -= x_ref;
+      REQUIRE(x.Normlinf() < 1e-6);
+      // The output times add at most one internal step each
+      const int num_steps = dp.GetNumAccepted();
+      dp.Init(ode);
+      x = x0;
+      t = 0.0;
+      double dt = 0.1;
+      dp.Run(x, t, dt, 1.0);
+      REQUIRE(num_steps <= dp.GetNumAccepted() + 10);
+   }
+
+   SECTION("TR-BDF2 on a stiff problem")
+   {
+      LinearODE ode(1000.0, 1.0, 1.0);
+      const double tf = 2.0;
+      Reference(ode, x0, tf, x_ref);
+      TRBDF2Solver trbdf2;
+      trbdf2.SetTolerances(1e-6, 1e-6);
+      trbdf2.Init(ode);
+      x = x0;
+      double t = 0.0, dt = 1e-3;
+      trbdf2.Run(x, t, dt, tf);
+      REQUIRE(t == tf);
+      x -= x_ref;
+      REQUIRE(x.Normlinf() < 1e-4);
+      // An explicit method would need more than 1000 steps
+      REQUIRE(trbdf2.GetNumAccepted() < 500);
+   }
+}
+
+TEST_CASE("Low-storage and IMEX Runge-Kutta solvers", "[ODE]")
+{
+   Vector x0(2), x_ref(2);
+   x0(0) = 1.0;
+   x0(1) = 0.5;
+   const double tf = 1.0;
+
+   SECTION("Low-storage explicit RK")
+   {
+      LinearODE ode(0.5, 4.0, 0.1);
+      Reference(ode, x0, tf, x_ref);
+      LSRK3Solver lsrk3;
+      LSRK4Solver lsrk4;
+      ODESolver *solvers[2] = { &lsrk3, &lsrk4 };
+      for (int i = 0; i < 2; i++)
+      {
+         const int order = 3 + i;
+         const double e1 = FixedStepError(*solvers[i], ode, x0, x_ref, tf, 40);
+         const double e2 = FixedStepError(*solvers[i], ode, x0, x_ref, tf, 80);
+         const double rate = log(e1/e2)/log(2.0);
+         REQUIRE(std::abs(rate - order) < 0.2);
+      }
+   }
+
+   SECTION("IMEX convergence")
+   {
+      LinearODE ode(0.5, 4.0, 0.1);
+      Reference(ode, x0, tf, x_ref);
+      SplitLinearODE split(0.5, 4.0, 0.1);
+      IMEXEulerSolver imex1;
+      IMEXRK2Solver imex2;
+      IMEXRK3Solver imex3;
+      ODESolver *solvers[3] = { &imex1, &imex2, &imex3 };
+      for (int i = 0; i < 3; i++)
+      {
+         const int order = 1 + i;
+         // The second order error term of ARS(2,3,2) is small compared to the
+         // higher order terms at large time steps
+         const double e1 = FixedStepError(*solvers[i], split, x0, x_ref, tf,
+                                          320);
+         const double e2 = FixedStepError(*solvers[i], split, x0, x_ref, tf,
+                                          640);
+         const double rate = log(e1/e2)/log(2.0);
+         REQUIRE(std::abs(rate - order) < 0.2);
+         REQUIRE(split.GetEvalMode() == TimeDependentOperator::NORMAL);
+      }
+   }
+
+   SECTION("IMEX on a stiff problem")
+   {
+      LinearODE ode(1000.0, 1.0, 1.0);
+      Reference(ode, x0, tf, x_ref);
+      SplitLinearODE split(1000.0, 1.0, 1.0);
+      IMEXRK2Solver imex2;
+      IMEXRK3Solver imex3;
+      ODESolver *solvers[2] = { &imex2, &imex3 };
+      for (int i = 0; i < 2; i++)
+      {
+         // The explicit methods need dt < 3e-3 for the stiff term
+         REQUIRE(FixedStepError(*solvers[i], split, x0, x_ref, tf, 20) < 1e-3);
+      }
+   }
+}
+
+}
@@ -0,0 +1,172 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace spgemm
+{
+
+static SparseMatrix *RandomMatrix(int m, int n, int seed)
+{
+   SparseMatrix *A = new SparseMatrix(m, n);
+   Vector r(3*m);
+   r.Randomize(seed);
+   for (int i = 0; i < m; i++)
+   {
+      const int len = 1 + int(r(i)*5);
+      for (int k = 0; k < len; k++)
+      {
+         const int j = (i*3 + k*k*7 + int(r(m+i)*n)) % n;
+         A->Add(i, j, r(2*m+i) - 0.25*k);
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Dense reference of A B
+static void DenseMult(const SparseMatrix &A, const SparseMatrix &B,
+                      DenseMatrix &AB)
+{
+   DenseMatrix dA, dB;
+   A.ToDenseMatrix(dA);
+   B.ToDenseMatrix(dB);
+   AB.SetSize(A.Height(), B.Width());
+   Mult(dA, dB, AB);
+}
+
+static double MaxDiff(const SparseMatrix &A, const DenseMatrix &B)
+{
+   DenseMatrix dA;
+   A.ToDenseMatrix(dA);
+   dA -= B;
+   return dA.MaxMaxNorm();
+}
+
+TEST_CASE("SparseMatrix products", "[SparseMatrix]")
+{
+   SparseMatrix *A = RandomMatrix(40, 30, 1);
+   SparseMatrix *B = RandomMatrix(30, 50, 2);
+   SparseMatrix *P = RandomMatrix(30, 20, 3);
+
+   SECTION("Mult")
+   {
+      DenseMatrix AB;
+      DenseMult(*A, *B, AB);
+      SparseMatrix *C = Mult(*A, *B);
+      REQUIRE(MaxDiff(*C, AB) < 1e-12);
+
+      // Reuse the pattern of C with new values of A
+      *A *= 2.0;
+      Mult(*A, *B, C);
+      AB *= 2.0;
+      REQUIRE(MaxDiff(*C, AB) < 1e-12);
+      delete C;
+   }
+
+   SECTION("RAP")
+   {
+      SparseMatrix *At = Transpose(*A);
+      SparseMatrix *AtA = Mult(*At, *A);
+      DenseMatrix PtAtAP;
+      SparseMatrix *Pt = Transpose(*P);
+      SparseMatrix *AtAP = Mult(*AtA, *P);
+      DenseMult(*Pt, *AtAP, PtAtAP);
+
+      SparseMatrix *C = RAP(*P, *AtA, *P);
+      REQUIRE(MaxDiff(*C, PtAtAP) < 1e-12);
+      REQUIRE(C->Height() == P->Width());
+      REQUIRE(C->Width() == P->Width());
+
+      // The fused product has sorted rows and keeps the structural symmetry
+      for (int i = 0; i < C->Height(); i++)
+      {
+         for (int p = C->GetI()[i]+1; p < C->GetI()[i+1]; p++)
+         {
+            REQUIRE(C->GetJ()[p-1] < C->GetJ()[p]);
+         }
+      }
+      SparseMatrix *Ct = Transpose(*C);
+      REQUIRE(Ct->NumNonZeroElems() == C->NumNonZeroElems());
+      for (int p = 0; p < C->NumNonZeroElems(); p++)
+      {
+         REQUIRE(Ct->GetJ()[p] == C->GetJ()[p]);
+      }
+      delete Ct;
+
+      // Same result as the non-fused product R (A P)
+      SparseMatrix *C2 = Mult(*Pt, *AtAP);
+      DenseMatrix dC2;
+      C2->ToDenseMatrix(dC2);
+      REQUIRE(MaxDiff(*C, dC2) < 1e-12);
+      delete C2;
+
+      delete C;
+      delete AtAP;
+      delete Pt;
+      delete AtA;
+      delete At;
+   }
+
+   SECTION("SparseRAP")
+   {
+      SparseMatrix *Rt = RandomMatrix(30, 10, 4);
+      SparseMatrix *Q = RandomMatrix(50, 15, 5);
+      SparseRAP rap(*Rt, *Q);
+
+      SparseMatrix *C = rap.Symbolic(*B);
+      REQUIRE(C->Height() == 10);
+      REQUIRE(C->Width() == 15);
+      REQUIRE(C->MaxNorm() == 0.0);
+
+      SparseMatrix *R = Transpose(*Rt);
+      SparseMatrix *RB = Mult(*R, *B);
+      for (int it = 0; it < 3; it++)
+      {
+         // Only the values of B change
+         *B *= (it + 1.0);
+         Mult(*R, *B, RB);
+         DenseMatrix RBQ;
+         DenseMult(*RB, *Q, RBQ);
+
+         rap.Numeric(*B, *C);
+         REQUIRE(MaxDiff(*C, RBQ) < 1e-12 * RBQ.MaxMaxNorm());
+      }
+
+      // A larger pattern is allowed, with zeros outside the product
+      SparseMatrix *C_full = new SparseMatrix(10, 15);
+      for (int i = 0; i < 10; i++)
+      {
+         for (int j = 0; j < 15; j++) { C_full->Set(i, j, 1.0); }
+      }
+      C_full->Finalize(0);
+      rap.Numeric(*B, *C_full);
+      DenseMatrix dC;
+      C->ToDenseMatrix(dC);
+      REQUIRE(MaxDiff(*C_full, dC) == 0.0);
+
+      delete C_full;
+      delete RB;
+      delete R;
+      delete C;
+      delete Q;
+      delete Rt;
+   }
+
+   delete P;
+   delete B;
+   delete A;
+}
+
+} // namespace spgemm
@@ -0,0 +1,119 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace spmv
+{
+
+// Random m x n matrix with rows of irregular lengths, and with the entries
+// coupling all components of two nodes when vdim > 1.
+static SparseMatrix *RandomMatrix(int m, int n, int vdim, bool interleaved)
+{
+   const int mb = m/vdim, nb = n/vdim;
+   SparseMatrix *A = new SparseMatrix(m, n);
+   Vector r(4*mb);
+   r.Randomize(7);
+   for (int ib = 0; ib < mb; ib++)
+   {
+      const int len = 1 + int(r(ib)*12) % nb;
+      for (int k = 0; k < len; k++)
+      {
+         const int jb = (ib*7 + k*k*3 + int(r(mb+ib)*nb)) % nb;
+         for (int i = 0; i < vdim; i++)
+         {
+            for (int j = 0; j < vdim; j++)
+            {
+               const int row = interleaved ? ib*vdim + i : ib + i*mb;
+               const int col = interleaved ? jb*vdim + j : jb + j*nb;
+               A->Add(row, col, 1.0 + row - 0.5*col + k);
+            }
+         }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+// Compare the actions of A with and without the SpMV format built in A.
+static void CompareActions(SparseMatrix &A, SparseMatrix &A_csr)
+{
+   Vector x(A.Width()), xt(A.Height());
+   Vector y(A.Height()), y_csr(A.Height()), yt(A.Width()), yt_csr(A.Width());
+   x.Randomize(1);
+   xt.Randomize(2);
+
+   A.Mult(x, y);
+   A_csr.Mult(x, y_csr);
+   y -= y_csr;
+   REQUIRE(y.Normlinf() < 1e-12 * y_csr.Normlinf());
+
+   y_csr.Randomize(3);
+   y = y_csr;
+   A.AddMult(x, y, -0.5);
+   A_csr.AddMult(x, y_csr, -0.5);
+   y -= y_csr;
+   REQUIRE(y.Normlinf() < 1e-12 * y_csr.Normlinf());
+
+   // The transpose action of the CSR format on device backends requires the
+   // explicit transpose
+   A_csr.BuildTranspose();
+   A.MultTranspose(xt, yt);
+   A_csr.MultTranspose(xt, yt_csr);
+   yt -= yt_csr;
+   REQUIRE(yt.Normlinf() < 1e-12 * yt_csr.Normlinf());
+}
+
+TEST_CASE("SparseMatrix SpMV formats", "[SparseMatrix]")
+{
+   SECTION("SELL-C-sigma")
+   {
+      SparseMatrix *A = RandomMatrix(101, 57, 1, true);
+      SparseMatrix A_csr(*A);
+      const int C[5] = {1, 2, 4, 8, 16};
+      for (int k = 0; k < 5; k++)
+      {
+         for (int sigma = 1; sigma <= 128; sigma *= 8)
+         {
+            A->BuildSellCSigma(C[k], sigma);
+            REQUIRE(A->GetSpMVFormat()->NumStoredEntries() >=
+                    A->NumNonZeroElems());
+            CompareActions(*A, A_csr);
+         }
+      }
+      A->BuildSellCSigma();
+      CompareActions(*A, A_csr);
+      A->ResetSpMVFormat();
+      REQUIRE(A->GetSpMVFormat() == NULL);
+      delete A;
+   }
+
+   SECTION("Block CSR")
+   {
+      for (int vdim = 1; vdim <= 5; vdim++)
+      {
+         for (int interleaved = 0; interleaved < 2; interleaved++)
+         {
+            SparseMatrix *A = RandomMatrix(30*vdim, 20*vdim, vdim,
+                                           interleaved);
+            SparseMatrix A_csr(*A);
+            A->BuildBlockCSR(vdim, interleaved);
+            CompareActions(*A, A_csr);
+            delete A;
+         }
+      }
+   }
+}
+
+} // namespace spmv
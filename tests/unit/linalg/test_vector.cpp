@@ -0,0 +1,81 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace vector
+{
+
+// Sizes smaller than a SIMD vector, with a tail, and with several blocks
+static const int sizes[4] = { 1, 7, 2048, 5003 };
+
+TEST_CASE("Fused vector kernels", "[Vector]")
+{
+   for (int t = 0; t < 4; t++)
+   {
+      const int n = sizes[t];
+      Vector x(n), y(n), z(n), v(n), v_ref(n);
+      x.Randomize(1);
+      y.Randomize(2);
+      z.Randomize(3);
+      const double tol = 1e-14*n;
+
+      // AddAndDot
+      add(x, -0.5, y, v_ref);
+      double dot = AddAndDot(x, -0.5, y, v, z);
+      REQUIRE(std::abs(dot - v_ref*z) < tol);
+      v -= v_ref;
+      REQUIRE(v.Normlinf() < 1e-15);
+
+      // In place update with the squared norm of the result
+      v = x;
+      dot = AddAndDot(v, 2.0, y, v, v);
+      add(x, 2.0, y, v_ref);
+      REQUIRE(std::abs(dot - v_ref*v_ref) < tol);
+      v -= v_ref;
+      REQUIRE(v.Normlinf() < 1e-15);
+
+      // LinearCombination
+      const double a[3] = { 1.0, -2.0, 0.25 };
+      const Vector *xyz[3] = { &x, &y, &z };
+      for (int b = 0; b < 3; b++)
+      {
+         v = y;
+         LinearCombination(3, a, xyz, b, v);
+         v_ref = y;
+         v_ref *= b;
+         v_ref.Add(a[0], x);
+         v_ref.Add(a[1], y);
+         v_ref.Add(a[2], z);
+         v -= v_ref;
+         REQUIRE(v.Normlinf() < 1e-14);
+      }
+      // With b = 0, the initial values, here NaN, are not used
+      v = std::numeric_limits<double>::quiet_NaN();
+      LinearCombination(1, a+1, xyz+1, 0.0, v);
+      v_ref.Set(a[1], y);
+      v -= v_ref;
+      REQUIRE(v.Normlinf() < 1e-15);
+
+      // InnerProducts
+      double dots[3];
+      InnerProducts(y, 3, xyz, dots);
+      for (int j = 0; j < 3; j++)
+      {
+         REQUIRE(std::abs(dots[j] - y*(*xyz[j])) < tol);
+      }
+   }
+}
+
+} // namespace vector
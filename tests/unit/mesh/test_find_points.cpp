@@ -0,0 +1,218 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace find_points
+{
+
+static double rand_real() { return rand()/double(RAND_MAX); }
+
+TEST_CASE("Bounding box tree", "[Mesh]")
+{
+   const int dim = 3, n = 200;
+   srand(1);
+   Array<double> boxes(2*dim*n);
+   for (int i = 0; i < n; i++)
+   {
+      for (int d = 0; d < dim; d++)
+      {
+         const double c = rand_real(), h = 0.1*rand_real();
+         boxes[2*dim*i+d] = c - h;
+         boxes[2*dim*i+dim+d] = c + h;
+      }
+   }
+   BoundingBoxTree tree;
+   tree.Build(dim, boxes);
+   REQUIRE(tree.GetNBoxes() == n);
+
+   Array<int> found, brute;
+   double x[dim];
+   for (int k = 0; k < 100; k++)
+   {
+      for (int d = 0; d < dim; d++) { x[d] = rand_real(); }
+      tree.FindBoxes(x, found);
+      brute.SetSize(0);
+      for (int i = 0; i < n; i++)
+      {
+         bool inside = true;
+         for (int d = 0; d < dim; d++)
+         {
+            inside = inside && boxes[2*dim*i+d] <= x[d] &&
+                     x[d] <= boxes[2*dim*i+dim+d];
+         }
+         if (inside) { brute.Append(i); }
+      }
+      found.Sort();
+      REQUIRE(found.Size() == brute.Size());
+      for (int i = 0; i < found.Size(); i++) { REQUIRE(found[i] == brute[i]); }
+   }
+
+   // The coarse boxes cover all the boxes
+   Array<double> coarse;
+   tree.GetNodeBoxes(2, coarse);
+   REQUIRE(coarse.Size() == 4*2*dim);
+   for (int i = 0; i < n; i++)
+   {
+      bool covered = false;
+      for (int c = 0; c < 4 && !covered; c++)
+      {
+         bool inside = true;
+         for (int d = 0; d < dim; d++)
+         {
+            inside = inside && coarse[2*dim*c+d] <= boxes[2*dim*i+d] &&
+                     boxes[2*dim*i+dim+d] <= coarse[2*dim*c+dim+d];
+         }
+         covered = inside;
+      }
+      REQUIRE(covered);
+   }
+}
+
+// Smooth deformation of the unit square or cube
+static void Deform(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(M_PI*x(1));
+   y(1) += 0.1*sin(M_PI*x(0))*x(0);
+   if (x.Size() == 3) { y(2) += 0.05*sin(2*M_PI*x(0)*x(1)); }
+}
+
+// Map random reference points of random elements to physical points, locate
+// them with FindPoints and check the elements and reference coordinates.
+static void CheckFindPoints(Mesh &mesh)
+{
+   const int sdim = mesh.SpaceDimension(), npts = 50;
+   DenseMatrix pts(sdim, npts);
+   Array<int> elems(npts);
+   Array<IntegrationPoint> ips_ref(npts);
+   Vector x;
+   for (int k = 0; k < npts; k++)
+   {
+      elems[k] = rand() % mesh.GetNE();
+      IntegrationPoint &ip = ips_ref[k];
+      ip.x = 0.05 + 0.4*rand_real();
+      ip.y = 0.05 + 0.4*rand_real();
+      ip.z = (sdim == 3) ? 0.05 + 0.4*rand_real() : 0.0;
+      if (mesh.GetElementBaseGeometry(elems[k]) == Geometry::SQUARE)
+      {
+         ip.x *= 2.0;
+         ip.y *= 2.0;
+      }
+      ElementTransformation *T = mesh.GetElementTransformation(elems[k]);
+      T->SetIntPoint(&ip);
+      pts.GetColumnReference(k, x);
+      T->Transform(ip, x);
+   }
+
+   // The default tolerances are too strict for the moved points
+   InverseElementTransformation inv_tr;
+   inv_tr.SetReferenceTol(1e-12);
+   inv_tr.SetPhysicalRelTol(1e-12);
+   Array<int> elem_ids;
+   Array<IntegrationPoint> ips;
+   REQUIRE(mesh.FindPoints(pts, elem_ids, ips, true, &inv_tr) == npts);
+   for (int k = 0; k < npts; k++)
+   {
+      REQUIRE(elem_ids[k] == elems[k]);
+      REQUIRE(std::abs(ips[k].x - ips_ref[k].x) < 1e-8);
+      REQUIRE(std::abs(ips[k].y - ips_ref[k].y) < 1e-8);
+      REQUIRE(std::abs(ips[k].z - ips_ref[k].z) < 1e-8);
+   }
+
+   // After a motion of the mesh, the moved points are found
+   Vector disp;
+   mesh.GetNodes(disp);
+   disp = 0.0;
+   const GridFunction *nodes = mesh.GetNodes();
+   if (nodes)
+   {
+      const FiniteElementSpace *fes = nodes->FESpace();
+      for (int i = 0; i < fes->GetNDofs(); i++)
+      {
+         disp(fes->DofToVDof(i, 0)) = 1.0;
+      }
+   }
+   else
+   {
+      for (int i = 0; i < mesh.GetNV(); i++) { disp(i) = 1.0; }
+   }
+   mesh.MoveNodes(disp);
+   for (int k = 0; k < npts; k++) { pts(0,k) += 1.0; }
+   REQUIRE(mesh.FindPoints(pts, elem_ids, ips, true, &inv_tr) == npts);
+   for (int k = 0; k < npts; k++) { REQUIRE(elem_ids[k] == elems[k]); }
+
+   // The points are also found after a motion of the mesh made directly,
+   // through GetNodes() or GetVertex(), without calling NodesUpdated()
+   if (nodes)
+   {
+      *mesh.GetNodes() -= disp;
+   }
+   else
+   {
+      for (int i = 0; i < mesh.GetNV(); i++) { mesh.GetVertex(i)[0] -= 1.0; }
+   }
+   for (int k = 0; k < npts; k++) { pts(0,k) -= 1.0; }
+   REQUIRE(mesh.FindPoints(pts, elem_ids, ips, true, &inv_tr) == npts);
+   for (int k = 0; k < npts; k++) { REQUIRE(elem_ids[k] == elems[k]); }
+
+   // A point outside of the mesh is not found
+   DenseMatrix out(sdim, 1);
+   out = -10.0;
+   REQUIRE(mesh.FindPoints(out, elem_ids, ips, false) == 0);
+   REQUIRE(elem_ids[0] == -1);
+}
+
+TEST_CASE("Mesh FindPoints", "[Mesh]")
+{
+   srand(2);
+
+   SECTION("Straight quadrilaterals")
+   {
+      Mesh mesh(8, 8, Element::QUADRILATERAL, true, 1.0, 1.0);
+      mesh.Transform(Deform);
+      CheckFindPoints(mesh);
+   }
+
+   SECTION("Curved triangles")
+   {
+      Mesh mesh(6, 6, Element::TRIANGLE, true, 1.0, 1.0);
+      mesh.SetCurvature(2);
+      mesh.Transform(Deform);
+      CheckFindPoints(mesh);
+   }
+
+   SECTION("Non-conforming curved quadrilaterals")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL, true, 1.0, 1.0);
+      mesh.EnsureNCMesh();
+      Array<int> refs;
+      refs.Append(5);
+      refs.Append(10);
+      mesh.GeneralRefinement(refs);
+      mesh.SetCurvature(2);
+      mesh.Transform(Deform);
+      CheckFindPoints(mesh);
+   }
+
+   SECTION("Curved hexahedra")
+   {
+      Mesh mesh(3, 3, 3, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+      mesh.SetCurvature(3);
+      mesh.Transform(Deform);
+      CheckFindPoints(mesh);
+   }
+}
+
+} // namespace find_points
@@ -0,0 +1,125 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#ifdef MFEM_USE_MPI
+
+using namespace mfem;
+
+namespace pfind_points
+{
+
+static double rand_real() { return rand()/double(RAND_MAX); }
+
+// Smooth deformation of the unit square or cube
+static void Deform(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(M_PI*x(1));
+   y(1) += 0.1*sin(M_PI*x(0))*x(0);
+   if (x.Size() == 3) { y(2) += 0.05*sin(2*M_PI*x(0)*x(1)); }
+}
+
+// Locate different points on each rank with FindPointsDistributed and check
+// the ranks, elements and reference coordinates against the serial
+// FindPoints on the global mesh. The checks are made after the collective
+// calls, so that a failure on one rank does not block the others.
+static void CheckFindPointsDistributed(Mesh &mesh)
+{
+   int num_procs, myid;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+
+   // Partition the elements in contiguous blocks; the local elements of each
+   // rank keep the order of the global mesh
+   const int ne = mesh.GetNE();
+   Array<int> partitioning(ne);
+   Array<int> local_id(ne);
+   Array<int> count(num_procs);
+   count = 0;
+   for (int i = 0; i < ne; i++)
+   {
+      partitioning[i] = (i * num_procs) / ne;
+      local_id[i] = count[partitioning[i]]++;
+   }
+   ParMesh pmesh(MPI_COMM_WORLD, mesh, partitioning.GetData());
+
+   // Random points in random elements, different on each rank, and one point
+   // outside of the mesh
+   srand(3 + myid);
+   const int sdim = mesh.SpaceDimension(), npts = 40 + 10*myid;
+   DenseMatrix pts(sdim, npts + 1);
+   Vector x;
+   for (int k = 0; k < npts; k++)
+   {
+      const int e = rand() % ne;
+      IntegrationPoint ip;
+      ip.x = 0.05 + 0.4*rand_real();
+      ip.y = 0.05 + 0.4*rand_real();
+      ip.z = (sdim == 3) ? 0.05 + 0.4*rand_real() : 0.0;
+      if (mesh.GetElementBaseGeometry(e) == Geometry::SQUARE)
+      {
+         ip.x *= 2.0;
+         ip.y *= 2.0;
+      }
+      pts.GetColumnReference(k, x);
+      mesh.GetElementTransformation(e)->Transform(ip, x);
+   }
+   pts.GetColumnReference(npts, x);
+   x = -10.0;
+
+   Array<int> ranks, elem_ids;
+   Array<IntegrationPoint> ips;
+   const int found =
+      pmesh.FindPointsDistributed(pts, ranks, elem_ids, ips, false);
+
+   Array<int> s_elem_ids;
+   Array<IntegrationPoint> s_ips;
+   const int s_found = mesh.FindPoints(pts, s_elem_ids, s_ips, false);
+
+   REQUIRE(s_found == npts);
+   REQUIRE(found == s_found);
+   for (int k = 0; k < npts; k++)
+   {
+      const int e = s_elem_ids[k];
+      REQUIRE(ranks[k] == partitioning[e]);
+      REQUIRE(elem_ids[k] == local_id[e]);
+      REQUIRE(std::abs(ips[k].x - s_ips[k].x) < 1e-10);
+      REQUIRE(std::abs(ips[k].y - s_ips[k].y) < 1e-10);
+      REQUIRE(std::abs(ips[k].z - s_ips[k].z) < 1e-10);
+   }
+   REQUIRE(ranks[npts] == -1);
+   REQUIRE(elem_ids[npts] == -1);
+}
+
+TEST_CASE("ParMesh FindPointsDistributed", "[Parallel], [Mesh]")
+{
+   SECTION("Straight quadrilaterals")
+   {
+      Mesh mesh(8, 8, Element::QUADRILATERAL, true, 1.0, 1.0);
+      mesh.Transform(Deform);
+      CheckFindPointsDistributed(mesh);
+   }
+
+   SECTION("Curved hexahedra")
+   {
+      Mesh mesh(4, 4, 4, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+      mesh.SetCurvature(2);
+      mesh.Transform(Deform);
+      CheckFindPointsDistributed(mesh);
+   }
+}
+
+} // namespace pfind_points
+
+#endif // MFEM_USE_MPI
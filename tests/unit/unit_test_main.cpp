@@ -9,5 +9,37 @@
 // terms of the GNU Lesser General Public License (as published by the Free
 // Software Foundation) version 2.1 dated February 1999.
 
-#define CATCH_CONFIG_MAIN     // This tells Catch to provide a main() - only do this in one cpp file
+#include "mfem.hpp"
+
+#define CATCH_CONFIG_RUNNER
 #include "catch.hpp"
+
+#include <cstring>
+#include <vector>
+
+// The option --device <config> sets the Device configuration used by the
+// tests, e.g. unit_tests --device simd "[PartialAssembly]"; the default is
+// "cpu". In parallel builds, MPI is initialized for the tests tagged
+// [Parallel], which can also be run on several ranks, e.g.
+// mpirun -np 4 unit_tests "[Parallel]".
+int main(int argc, char *argv[])
+{
+#ifdef MFEM_USE_MPI
+   mfem::MPI_Session mpi(argc, argv);
+#endif
+   const char *device_config = "cpu";
+   std::vector<char*> catch_argv;
+   for (int i = 0; i < argc; i++)
+   {
+      if (i + 1 < argc && !std::strcmp(argv[i], "--device"))
+      {
+         device_config = argv[++i];
+      }
+      else
+      {
+         catch_argv.push_back(argv[i]);
+      }
+   }
+   mfem::Device device(device_config);
+   return Catch::Session().run(int(catch_argv.size()), catch_argv.data());
+}